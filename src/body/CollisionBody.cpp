@@ -39,7 +39,9 @@ using namespace reactphysics3d;
  */
 CollisionBody::CollisionBody(const Transform& transform, CollisionWorld& world, bodyindex id)
               : Body(id), mType(DYNAMIC), mTransform(transform), mProxyCollisionShapes(NULL),
-                mNbCollisionShapes(0), mContactManifoldsList(NULL), mWorld(world) {
+                mNbCollisionShapes(0), mContactManifoldsList(NULL), mWorld(world),
+                mIsCompoundBroadPhaseEnabled(false), mCompoundBroadPhaseID(-1),
+                mIsEditingCollisionShapes(false) {
 
 }
 
@@ -69,6 +71,8 @@ CollisionBody::~CollisionBody() {
 ProxyShape* CollisionBody::addCollisionShape(CollisionShape* collisionShape,
                                              const Transform& transform) {
 
+    assert(!mWorld.isInReadOnlyQueryMode());
+
     // Create a new proxy collision shape to attach the collision shape to the body
     ProxyShape* proxyShape = new (mWorld.mMemoryAllocator.allocate(
                                       sizeof(ProxyShape))) ProxyShape(this, collisionShape,
@@ -83,12 +87,16 @@ ProxyShape* CollisionBody::addCollisionShape(CollisionShape* collisionShape,
         mProxyCollisionShapes = proxyShape;
     }
 
-    // Compute the world-space AABB of the new collision shape
-    AABB aabb;
-    collisionShape->computeAABB(aabb, mTransform * transform);
+    // If the collision shapes are not being edited
+    if (!mIsEditingCollisionShapes) {
 
-    // Notify the collision detection about this new collision shape
-    mWorld.mCollisionDetection.addProxyCollisionShape(proxyShape, aabb);
+        // Compute the world-space AABB of the new collision shape
+        AABB aabb;
+        collisionShape->computeAABB(aabb, mTransform * transform);
+
+        // Notify the collision detection about this new collision shape
+        mWorld.mCollisionDetection.addProxyCollisionShape(proxyShape, aabb);
+    }
 
     mNbCollisionShapes++;
 
@@ -105,13 +113,15 @@ ProxyShape* CollisionBody::addCollisionShape(CollisionShape* collisionShape,
  */
 void CollisionBody::removeCollisionShape(const ProxyShape* proxyShape) {
 
+    assert(!mWorld.isInReadOnlyQueryMode());
+
     ProxyShape* current = mProxyCollisionShapes;
 
     // If the the first proxy shape is the one to remove
     if (current == proxyShape) {
         mProxyCollisionShapes = current->mNext;
 
-        if (mIsActive) {
+        if (mIsActive && current->mBroadPhaseID != -1) {
             mWorld.mCollisionDetection.removeProxyCollisionShape(current);
         }
 
@@ -131,7 +141,7 @@ void CollisionBody::removeCollisionShape(const ProxyShape* proxyShape) {
             ProxyShape* elementToRemove = current->mNext;
             current->mNext = elementToRemove->mNext;
 
-            if (mIsActive) {
+            if (mIsActive && elementToRemove->mBroadPhaseID != -1) {
                 mWorld.mCollisionDetection.removeProxyCollisionShape(elementToRemove);
             }
 
@@ -157,7 +167,7 @@ void CollisionBody::removeAllCollisionShapes() {
         // Remove the proxy collision shape
         ProxyShape* nextElement = current->mNext;
 
-        if (mIsActive) {
+        if (mIsActive && current->mBroadPhaseID != -1) {
             mWorld.mCollisionDetection.removeProxyCollisionShape(current);
         }
 
@@ -191,6 +201,14 @@ void CollisionBody::resetContactManifoldsList() {
 // Update the broad-phase state for this body (because it has moved for instance)
 void CollisionBody::updateBroadPhaseState() const {
 
+    assert(!mWorld.isInReadOnlyQueryMode());
+
+    // If the body is in compound mode, only the compound is updated in the broad-phase
+    if (mCompoundBroadPhaseID != -1) {
+        mWorld.mCollisionDetection.updateCompoundBody(this, Vector3(0, 0, 0));
+        return;
+    }
+
     // For all the proxy collision shapes of the body
     for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
 
@@ -202,6 +220,9 @@ void CollisionBody::updateBroadPhaseState() const {
 // Update the broad-phase state of a proxy collision shape of the body
 void CollisionBody::updateProxyShapeInBroadPhase(ProxyShape* proxyShape, bool forceReinsert) const {
 
+    // If the proxy shape has not been added to the broad-phase yet
+    if (proxyShape->mBroadPhaseID == -1) return;
+
     // Recompute the world-space AABB of the collision shape
     AABB aabb;
     proxyShape->getCollisionShape()->computeAABB(aabb, mTransform * proxyShape->getLocalToBodyTransform());
@@ -216,6 +237,8 @@ void CollisionBody::updateProxyShapeInBroadPhase(ProxyShape* proxyShape, bool fo
  */
 void CollisionBody::setIsActive(bool isActive) {
 
+    assert(!mWorld.isInReadOnlyQueryMode());
+
     // If the state does not change
     if (mIsActive == isActive) return;
 
@@ -241,7 +264,9 @@ void CollisionBody::setIsActive(bool isActive) {
         for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
 
             // Remove the proxy shape from the collision detection
-            mWorld.mCollisionDetection.removeProxyCollisionShape(shape);
+            if (shape->mBroadPhaseID != -1) {
+                mWorld.mCollisionDetection.removeProxyCollisionShape(shape);
+            }
         }
 
         // Reset the contact manifold list of the body
@@ -249,6 +274,86 @@ void CollisionBody::setIsActive(bool isActive) {
     }
 }
 
+// Start editing the collision shapes of the body
+/// Until endCollisionShapesEdit() is called, the collision shapes added to the body are
+/// not inserted into the broad-phase (and the mass properties of a rigid body are not
+/// recomputed). Use this when adding many collision shapes to a body. The world must
+/// not be updated or queried while the collision shapes of a body are being edited.
+void CollisionBody::beginCollisionShapesEdit() {
+
+    assert(!mWorld.isInReadOnlyQueryMode());
+    assert(!mIsEditingCollisionShapes);
+
+    mIsEditingCollisionShapes = true;
+}
+
+// Finish editing the collision shapes of the body
+/// The collision shapes added since the call to beginCollisionShapesEdit() are
+/// inserted into the broad-phase in a single pass.
+void CollisionBody::endCollisionShapesEdit() {
+
+    assert(!mWorld.isInReadOnlyQueryMode());
+    assert(mIsEditingCollisionShapes);
+
+    mIsEditingCollisionShapes = false;
+
+    // If the body is not active, its proxy shapes are not in the broad-phase
+    if (!mIsActive) return;
+
+    // For each proxy shape that has not been added to the broad-phase yet
+    for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
+
+        if (shape->mBroadPhaseID != -1) continue;
+
+        // Compute the world-space AABB of the collision shape
+        AABB aabb;
+        shape->getCollisionShape()->computeAABB(aabb, mTransform * shape->mLocalToBodyTransform);
+
+        // Add the proxy shape to the collision detection
+        mWorld.mCollisionDetection.addProxyCollisionShape(shape, aabb);
+    }
+}
+
+// Set whether or not the proxy shapes of the body are a single compound in the broad-phase
+/// In compound mode, the body is a single node in the broad-phase tree of the world and
+/// its proxy shapes are stored in a local tree in the local-space of the body. When the
+/// body moves, only its node in the world tree is updated. This is faster for bodies with
+/// many proxy shapes but the overlapping pairs of such a body are computed again each time
+/// it moves.
+/**
+ * @param isEnabled True if you want to enable the compound broad-phase mode for this body
+ */
+void CollisionBody::setIsCompoundBroadPhaseEnabled(bool isEnabled) {
+
+    assert(!mWorld.isInReadOnlyQueryMode());
+
+    // If the mode does not change
+    if (mIsCompoundBroadPhaseEnabled == isEnabled) return;
+
+    // If the body is not active, its proxy shapes are not in the broad-phase
+    if (!mIsActive) {
+        mIsCompoundBroadPhaseEnabled = isEnabled;
+        return;
+    }
+
+    // Remove the proxy shapes from the collision detection
+    for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
+        if (shape->mBroadPhaseID != -1) {
+            mWorld.mCollisionDetection.removeProxyCollisionShape(shape);
+        }
+    }
+
+    mIsCompoundBroadPhaseEnabled = isEnabled;
+
+    // Add the proxy shapes again with the new mode
+    for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
+
+        AABB aabb;
+        shape->getCollisionShape()->computeAABB(aabb, mTransform * shape->mLocalToBodyTransform);
+        mWorld.mCollisionDetection.addProxyCollisionShape(shape, aabb);
+    }
+}
+
 // Ask the broad-phase to test again the collision shapes of the body for collision
 // (as if the body has moved).
 void CollisionBody::askForBroadPhaseCollisionCheck() const {
@@ -256,6 +361,8 @@ void CollisionBody::askForBroadPhaseCollisionCheck() const {
     // For all the proxy collision shapes of the body
     for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
 
+        if (shape->mBroadPhaseID == -1) continue;
+
         mWorld.mCollisionDetection.askForBroadPhaseCollisionCheck(shape);  
     }
 }
@@ -85,6 +85,15 @@ class CollisionBody : public Body {
         /// Reference to the world the body belongs to
         CollisionWorld& mWorld;
 
+        /// True if the proxy shapes of the body are a single compound in the broad-phase
+        bool mIsCompoundBroadPhaseEnabled;
+
+        /// Broad-phase ID of the compound of the body (-1 if the body is not in compound mode)
+        int mCompoundBroadPhaseID;
+
+        /// True if the collision shapes of the body are being edited (see beginCollisionShapesEdit())
+        bool mIsEditingCollisionShapes;
+
         // -------------------- Methods -------------------- //
 
         /// Private copy-constructor
@@ -144,6 +153,18 @@ class CollisionBody : public Body {
         /// Remove a collision shape from the body
         virtual void removeCollisionShape(const ProxyShape* proxyShape);
 
+        /// Start editing the collision shapes of the body
+        void beginCollisionShapesEdit();
+
+        /// Finish editing the collision shapes of the body
+        virtual void endCollisionShapesEdit();
+
+        /// Return true if the proxy shapes of the body are a single compound in the broad-phase
+        bool isCompoundBroadPhaseEnabled() const;
+
+        /// Set whether or not the proxy shapes of the body are a single compound in the broad-phase
+        void setIsCompoundBroadPhaseEnabled(bool isEnabled);
+
         /// Return the first element of the linked list of contact manifolds involving this body
         const ContactManifoldListElement* getContactManifoldsList() const;
 
@@ -215,6 +236,14 @@ inline void CollisionBody::setType(BodyType type) {
     }
 }
 
+// Return true if the proxy shapes of the body are a single compound in the broad-phase
+/**
+ * @return True if the compound broad-phase mode is enabled for this body
+ */
+inline bool CollisionBody::isCompoundBroadPhaseEnabled() const {
+    return mIsCompoundBroadPhaseEnabled;
+}
+
 // Return the current position and orientation
 /**
  * @return The current transformation of the body that transforms the local-space
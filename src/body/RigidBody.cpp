@@ -213,6 +213,8 @@ ProxyShape* RigidBody::addCollisionShape(CollisionShape* collisionShape,
                                          const Transform& transform,
                                          decimal mass) {
 
+    assert(!mWorld.isInReadOnlyQueryMode());
+
     assert(mass > decimal(0.0));
 
     // Create a new proxy collision shape to attach the collision shape to the body
@@ -229,6 +231,12 @@ ProxyShape* RigidBody::addCollisionShape(CollisionShape* collisionShape,
         mProxyCollisionShapes = proxyShape;
     }
 
+    mNbCollisionShapes++;
+
+    // If the collision shapes are being edited, the broad-phase and the mass properties
+    // are updated at the end of the edit
+    if (mIsEditingCollisionShapes) return proxyShape;
+
     // Compute the world-space AABB of the new collision shape
     AABB aabb;
     collisionShape->computeAABB(aabb, mTransform * transform);
@@ -236,8 +244,6 @@ ProxyShape* RigidBody::addCollisionShape(CollisionShape* collisionShape,
     // Notify the collision detection about this new collision shape
     mWorld.mCollisionDetection.addProxyCollisionShape(proxyShape, aabb);
 
-    mNbCollisionShapes++;
-
     // Recompute the center of mass, total mass and inertia tensor of the body with the new
     // collision shape
     recomputeMassInformation();
@@ -258,6 +264,18 @@ void RigidBody::removeCollisionShape(const ProxyShape* proxyShape) {
     // Remove the collision shape
     CollisionBody::removeCollisionShape(proxyShape);
 
+    // Recompute the total mass, center of mass and inertia tensor
+    if (!mIsEditingCollisionShapes) recomputeMassInformation();
+}
+
+// Finish editing the collision shapes of the body
+/// The collision shapes added since the call to beginCollisionShapesEdit() are
+/// inserted into the broad-phase and the mass properties of the body are recomputed
+/// once with all its collision shapes.
+void RigidBody::endCollisionShapesEdit() {
+
+    CollisionBody::endCollisionShapesEdit();
+
     // Recompute the total mass, center of mass and inertia tensor
     recomputeMassInformation();
 }
@@ -395,14 +413,25 @@ void RigidBody::recomputeMassInformation() {
 // Update the broad-phase state for this body (because it has moved for instance)
 void RigidBody::updateBroadPhaseState() const {
 
+    assert(!mWorld.isInReadOnlyQueryMode());
+
     PROFILE("RigidBody::updateBroadPhaseState()");
 
     DynamicsWorld& world = static_cast<DynamicsWorld&>(mWorld);
  	 const Vector3 displacement = world.mTimeStep * mLinearVelocity;
 
+    // If the body is in compound mode, only the compound is updated in the broad-phase
+    if (mCompoundBroadPhaseID != -1) {
+        mWorld.mCollisionDetection.updateCompoundBody(this, displacement);
+        return;
+    }
+
     // For all the proxy collision shapes of the body
     for (ProxyShape* shape = mProxyCollisionShapes; shape != NULL; shape = shape->mNext) {
 
+        // If the proxy shape has not been added to the broad-phase yet
+        if (shape->mBroadPhaseID == -1) continue;
+
         // Recompute the world-space AABB of the collision shape
         AABB aabb;
         shape->getCollisionShape()->computeAABB(aabb, mTransform *shape->getLocalToBodyTransform());
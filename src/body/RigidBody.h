@@ -217,6 +217,9 @@ class RigidBody : public CollisionBody {
         /// Remove a collision shape from the body
         virtual void removeCollisionShape(const ProxyShape* proxyShape);
 
+        /// Finish editing the collision shapes of the body
+        virtual void endCollisionShapesEdit();
+
         /// Recompute the center of mass, total mass and inertia tensor of the body using all
         /// the collision shapes attached to the body.
         void recomputeMassInformation();
@@ -28,6 +28,8 @@
 #include "engine/CollisionWorld.h"
 #include "body/Body.h"
 #include "collision/shapes/BoxShape.h"
+#include "collision/shapes/TriangleShape.h"
+#include "collision/shapes/CompoundShape.h"
 #include "body/RigidBody.h"
 #include "configuration.h"
 #include <cassert>
@@ -35,6 +37,7 @@
 #include <set>
 #include <utility>
 #include <utility>
+#include <algorithm>
 
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
@@ -162,12 +165,21 @@ void CollisionDetection::computeBroadPhase() {
 }
 
 // Compute the narrow-phase collision detection
+/// The overlapping pairs to test are first grouped by types of collision shapes (with a
+/// counting sort). Then, each group is tested with a single call to the narrow-phase
+/// algorithm for those types of shapes. This way, the same algorithm runs on consecutive
+/// pairs and an algorithm can process several pairs at the same time.
 void CollisionDetection::computeNarrowPhase() {
 
     PROFILE("CollisionDetection::computeNarrowPhase()");
 
+    const int nbShapeTypesPairs = NB_COLLISION_SHAPE_TYPES * NB_COLLISION_SHAPE_TYPES;
+
     // Clear the set of overlapping pairs in narrow-phase contact
     mContactOverlappingPairs.clear();
+
+    mNarrowPhasePairs.clear();
+    uint nbPairsPerShapeTypes[nbShapeTypesPairs] = {0};
     
     // For each possible collision pair of bodies
     map<overlappingpairid, OverlappingPair*>::iterator it;
@@ -217,27 +229,51 @@ void CollisionDetection::computeNarrowPhase() {
         bodyindexpair bodiesIndex = OverlappingPair::computeBodiesIndexPair(body1, body2);
         if (mNoCollisionPairs.count(bodiesIndex) > 0) continue;
         
-        // Select the narrow phase algorithm to use according to the two collision shapes
+        // If there is no collision algorithm between those two kinds of shapes
         const CollisionShapeType shape1Type = shape1->getCollisionShape()->getType();
         const CollisionShapeType shape2Type = shape2->getCollisionShape()->getType();
-        NarrowPhaseAlgorithm* narrowPhaseAlgorithm = mCollisionMatrix[shape1Type][shape2Type];
+        if (mCollisionMatrix[shape1Type][shape2Type] == NULL) continue;
 
-        // If there is no collision algorithm between those two kinds of shapes
-        if (narrowPhaseAlgorithm == NULL) continue;
-        
-        // Notify the narrow-phase algorithm about the overlapping pair we are going to test
-        narrowPhaseAlgorithm->setCurrentOverlappingPair(pair);
+        // Add the pair to the pairs to test
+        nbPairsPerShapeTypes[shape1Type * NB_COLLISION_SHAPE_TYPES + shape2Type]++;
+        mNarrowPhasePairs.push_back(pair);
+    }
+
+    // Compute the index of the first pair of each group of shape types
+    uint firstPairIndex[nbShapeTypesPairs];
+    uint nextPairIndex[nbShapeTypesPairs];
+    uint nbPairs = 0;
+    for (int i=0; i<nbShapeTypesPairs; i++) {
+        firstPairIndex[i] = nbPairs;
+        nextPairIndex[i] = nbPairs;
+        nbPairs += nbPairsPerShapeTypes[i];
+    }
+    assert(nbPairs == mNarrowPhasePairs.size());
+
+    // Group the pairs by types of collision shapes
+    mNarrowPhaseBatchPairs.resize(nbPairs);
+    for (uint i=0; i<nbPairs; i++) {
+        OverlappingPair* pair = mNarrowPhasePairs[i];
+        const int shape1Type = pair->getShape1()->getCollisionShape()->getType();
+        const int shape2Type = pair->getShape2()->getCollisionShape()->getType();
+        mNarrowPhaseBatchPairs[nextPairIndex[shape1Type * NB_COLLISION_SHAPE_TYPES + shape2Type]++] = pair;
+    }
+
+    // For each group of pairs with the same types of collision shapes
+    for (int i=0; i<nbShapeTypesPairs; i++) {
+
+        if (nbPairsPerShapeTypes[i] == 0) continue;
+
+        // Select the narrow phase algorithm to use according to the two collision shapes
+        NarrowPhaseAlgorithm* narrowPhaseAlgorithm = mCollisionMatrix[i / NB_COLLISION_SHAPE_TYPES]
+                                                                     [i % NB_COLLISION_SHAPE_TYPES];
+        assert(narrowPhaseAlgorithm != NULL);
 
-        // Create the CollisionShapeInfo objects
-        CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), shape1->getLocalToWorldTransform(),
-                                      pair, shape1->getCachedCollisionData());
-        CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), shape2->getLocalToWorldTransform(),
-                                      pair, shape2->getCachedCollisionData());
-        
         // Use the narrow-phase collision detection algorithm to check
-        // if there really is a collision. If a collision occurs, the
+        // if there really are collisions. If a collision occurs, the
         // notifyContact() callback method will be called.
-        narrowPhaseAlgorithm->testCollision(shape1Info, shape2Info, this);
+        narrowPhaseAlgorithm->testCollisionBatch(&(mNarrowPhaseBatchPairs[firstPairIndex[i]]),
+                                                 nbPairsPerShapeTypes[i], this);
     }
 
     // Add all the contact manifolds (between colliding bodies) to the bodies
@@ -347,6 +383,695 @@ void CollisionDetection::computeNarrowPhaseBetweenShapes(CollisionCallback* call
     addAllContactManifoldsToBodies();
 }
 
+// Report the contacts between a proxy shape and the other ones without modifying the world
+/// The candidate shapes are found with the broad-phase tree and the narrow-phase is computed
+/// with temporary overlapping pairs. Therefore, the overlapping pairs, the contact manifolds
+/// and the collision data caches of the world are left untouched. However, the narrow-phase
+/// algorithms of the world are used, so this query cannot run concurrently with another one.
+void CollisionDetection::testCollisionQuery(const ProxyShape* shape, CollisionCallback* callback) const {
+
+    PROFILE("CollisionDetection::testCollisionQuery()");
+
+    // If the body of the shape is not active, it is not in the broad-phase
+    if (!shape->getBody()->isActive()) return;
+
+    // Get the candidate proxy shapes from the broad-phase
+    std::vector<int> candidates;
+    BroadPhaseCandidatesCallback candidatesCallback(candidates);
+    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(
+                mBroadPhaseAlgorithm.getFatAABB(shape), candidatesCallback);
+
+    for (uint i=0; i<candidates.size(); i++) {
+
+        if (candidates[i] == shape->mBroadPhaseID) continue;
+
+        computeQueryContacts(const_cast<ProxyShape*>(shape),
+                             mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(candidates[i]), callback);
+    }
+}
+
+// Report the contacts between two proxy shapes without modifying the world
+void CollisionDetection::testCollisionQuery(const ProxyShape* shape1, const ProxyShape* shape2,
+                                            CollisionCallback* callback) const {
+
+    PROFILE("CollisionDetection::testCollisionQuery()");
+
+    if (!testAABBOverlap(shape1, shape2)) return;
+
+    computeQueryContacts(const_cast<ProxyShape*>(shape1), const_cast<ProxyShape*>(shape2), callback);
+}
+
+// Compute the contacts between two proxy shapes without modifying the world
+/// The same collision filtering as in the broad-phase is used (shapes of the same body,
+/// collision masks and pairs of bodies that cannot collide). The type and the sleeping
+/// state of the bodies are ignored because this is a geometric query.
+void CollisionDetection::computeQueryContacts(ProxyShape* shape1, ProxyShape* shape2,
+                                              CollisionCallback* callback) const {
+
+    CollisionBody* const body1 = shape1->getBody();
+    CollisionBody* const body2 = shape2->getBody();
+
+    // If the two proxy collision shapes are from the same body, skip it
+    if (body1->getID() == body2->getID()) return;
+
+    // Check if the collision filtering allows collision between the two shapes
+    if ((shape1->getCollideWithMaskBits() & shape2->getCollisionCategoryBits()) == 0 ||
+        (shape1->getCollisionCategoryBits() & shape2->getCollideWithMaskBits()) == 0) return;
+
+    // Check if the two bodies are allowed to collide
+    if (mNoCollisionPairs.count(OverlappingPair::computeBodiesIndexPair(body1, body2)) > 0) return;
+
+    // Select the narrow phase algorithm to use according to the two collision shapes
+    const CollisionShapeType shape1Type = shape1->getCollisionShape()->getType();
+    const CollisionShapeType shape2Type = shape2->getCollisionShape()->getType();
+    NarrowPhaseAlgorithm* narrowPhaseAlgorithm = mCollisionMatrix[shape1Type][shape2Type];
+
+    // If there is no collision algorithm between those two kinds of shapes
+    if (narrowPhaseAlgorithm == NULL) return;
+
+    // Create a temporary overlapping pair for the query
+    int nbMaxManifolds = CollisionShape::computeNbMaxContactManifolds(shape1Type, shape2Type);
+    OverlappingPair queryPair(shape1, shape2, nbMaxManifolds, mMemoryAllocator);
+
+    // If the pair also exists in the world, we start from its cached separating axis
+    std::map<overlappingpairid, OverlappingPair*>::const_iterator itPair =
+            mOverlappingPairs.find(OverlappingPair::computeID(shape1, shape2));
+    if (itPair != mOverlappingPairs.end() && itPair->second->getShape1() == shape1) {
+        queryPair.setCachedSeparatingAxis(itPair->second->getCachedSeparatingAxis());
+    }
+
+    // Notify the narrow-phase algorithm about the overlapping pair we are going to test
+    narrowPhaseAlgorithm->setCurrentOverlappingPair(&queryPair);
+
+    // Create the CollisionShapeInfo objects (with collision data caches of the query)
+    void* shape1CachedCollisionData = NULL;
+    void* shape2CachedCollisionData = NULL;
+    CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), shape1->getLocalToWorldTransform(),
+                                  &queryPair, &shape1CachedCollisionData);
+    CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), shape2->getLocalToWorldTransform(),
+                                  &queryPair, &shape2CachedCollisionData);
+
+    TestCollisionBetweenShapesCallback narrowPhaseCallback(callback);
+
+    // Use the narrow-phase collision detection algorithm to check
+    // if there really is a collision
+    narrowPhaseAlgorithm->testCollision(shape1Info, shape2Info, &narrowPhaseCallback);
+
+    free(shape1CachedCollisionData);
+    free(shape2CachedCollisionData);
+}
+
+// Report the proxy shapes overlapping with a world-space AABB
+/// The fat AABBs of the broad-phase tree are used for culling and the overlap is
+/// confirmed with the exact AABB of each proxy shape. At most maxNbOverlappingShapes
+/// proxy shapes are written in the output array and no memory is allocated.
+uint CollisionDetection::testAABBOverlap(const AABB& aabb, ProxyShape** overlappingShapes,
+                                         uint maxNbOverlappingShapes,
+                                         unsigned short categoryMaskBits) const {
+
+    PROFILE("CollisionDetection::testAABBOverlap()");
+
+    OverlapQueryCallback callback(mBroadPhaseAlgorithm, mNarrowPhaseGJKAlgorithm, aabb, NULL,
+                                  Transform::identity(), categoryMaskBits, overlappingShapes,
+                                  maxNbOverlappingShapes);
+    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(aabb, callback);
+
+    return callback.getNbOverlappingShapes();
+}
+
+// Wake up the bodies with a proxy shape overlapping with a world-space AABB
+/// The overlap is tested with the fat AABBs of the broad-phase.
+/**
+ * @param aabb World-space AABB
+ * @param ignoredBody Body that is not woken up (NULL to wake up all the bodies)
+ */
+void CollisionDetection::wakeUpBodiesOverlappingAABB(const AABB& aabb,
+                                                     const CollisionBody* ignoredBody) {
+
+    PROFILE("CollisionDetection::wakeUpBodiesOverlappingAABB()");
+
+    std::vector<int> candidates;
+    BroadPhaseCandidatesCallback candidatesCallback(candidates);
+    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(aabb, candidatesCallback);
+
+    for (uint i=0; i<candidates.size(); i++) {
+
+        CollisionBody* body = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(candidates[i])->getBody();
+        if (body == ignoredBody) continue;
+
+        body->setIsSleeping(false);
+    }
+}
+
+// Report the proxy shapes overlapping with a convex shape
+/// The broad-phase tree is queried with the AABB of the shape and the overlap is
+/// confirmed with the GJK algorithm (against each triangle for a concave proxy shape).
+/// At most maxNbOverlappingShapes proxy shapes are written in the output array.
+uint CollisionDetection::testOverlap(const ConvexShape* shape, const Transform& transform,
+                                     ProxyShape** overlappingShapes, uint maxNbOverlappingShapes,
+                                     unsigned short categoryMaskBits) const {
+
+    PROFILE("CollisionDetection::testOverlap()");
+
+    AABB aabb;
+    shape->computeAABB(aabb, transform);
+
+    OverlapQueryCallback callback(mBroadPhaseAlgorithm, mNarrowPhaseGJKAlgorithm, aabb, shape,
+                                  transform, categoryMaskBits, overlappingShapes,
+                                  maxNbOverlappingShapes);
+    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(aabb, callback);
+
+    return callback.getNbOverlappingShapes();
+}
+
+// Convex cast method
+/// The convex shape is moved from the "from" transform to the "to" transform. The broad-phase
+/// tree is queried with the AABB swept by the shape and the time of impact is computed with
+/// conservative advancement against each candidate proxy shape (or against each candidate
+/// triangle of a concave proxy shape).
+void CollisionDetection::convexCast(const ConvexShape* shape, const Transform& fromTransform,
+                                    const Transform& toTransform, ConvexCastCallback* convexCastCallback,
+                                    unsigned short convexCastWithCategoryMaskBits) const {
+
+    PROFILE("CollisionDetection::convexCast()");
+
+    // Compute the AABB swept by the shape. If the shape rotates, we use its bounding
+    // sphere because its intermediate orientations are not known.
+    AABB fromAABB, toAABB;
+    const bool isRotating = std::abs(fromTransform.getOrientation().dot(toTransform.getOrientation())) <
+                            decimal(1.0) - MACHINE_EPSILON;
+    if (!isRotating) {
+        shape->computeAABB(fromAABB, fromTransform);
+        shape->computeAABB(toAABB, toTransform);
+    }
+    else {
+        Vector3 minBounds, maxBounds;
+        shape->getLocalBounds(minBounds, maxBounds);
+        const decimal radius = std::max(minBounds.length(), maxBounds.length());
+        const Vector3 extent(radius, radius, radius);
+        fromAABB = AABB(fromTransform.getPosition() - extent, fromTransform.getPosition() + extent);
+        toAABB = AABB(toTransform.getPosition() - extent, toTransform.getPosition() + extent);
+    }
+    AABB sweptAABB;
+    sweptAABB.mergeTwoAABBs(fromAABB, toAABB);
+
+    // Get the candidate proxy shapes from the broad-phase
+    std::vector<int> candidates;
+    BroadPhaseCandidatesCallback candidatesCallback(candidates);
+    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(sweptAABB, candidatesCallback);
+
+    decimal maxFraction = decimal(1.0);
+
+    for (uint i=0; i<candidates.size(); i++) {
+
+        ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(candidates[i]);
+
+        // Check if the filtering mask allows convex cast against this shape
+        if ((convexCastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) continue;
+
+        ConvexCastInfo convexCastInfo;
+        if (convexCastAgainstProxyShape(shape, fromTransform, toTransform, proxyShape,
+                                        maxFraction, convexCastInfo)) {
+
+            // Report the hit to the user
+            decimal hitFraction = convexCastCallback->notifyConvexCastHit(convexCastInfo);
+
+            // If the user returned a hitFraction of zero, the query should stop here
+            if (hitFraction == decimal(0.0)) return;
+
+            // If the user returned a positive fraction, we clip the motion
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+        }
+    }
+}
+
+// Compute the time of impact of a cast convex shape against a proxy shape
+/// This method returns true if the cast shape hits the proxy shape before the maximum
+/// fraction of its motion. The collision data caches used here belong to the query (and
+/// not to the proxy shapes) so that the world is not modified.
+bool CollisionDetection::convexCastAgainstProxyShape(const ConvexShape* shape, const Transform& fromTransform,
+                                                     const Transform& toTransform, ProxyShape* proxyShape,
+                                                     decimal maxFraction, ConvexCastInfo& convexCastInfo) const {
+
+    const CollisionShape* proxyCollisionShape = proxyShape->getCollisionShape();
+    const Transform proxyToWorld = proxyShape->getLocalToWorldTransform();
+
+    void* castShapeCachedCollisionData = NULL;
+    void* proxyShapeCachedCollisionData = NULL;
+
+    bool isHit = false;
+
+    // If the proxy shape is convex
+    if (proxyCollisionShape->isConvex()) {
+
+        isHit = mNarrowPhaseGJKAlgorithm.computeTimeOfImpact(shape, fromTransform, toTransform,
+                                    &castShapeCachedCollisionData,
+                                    static_cast<const ConvexShape*>(proxyCollisionShape), proxyToWorld,
+                                    &proxyShapeCachedCollisionData, maxFraction, convexCastInfo.hitFraction,
+                                    convexCastInfo.worldPoint, convexCastInfo.worldNormal);
+    }
+    else {  // If the proxy shape is concave or compound
+
+        // Express the motion of the cast shape in the local-space of the proxy shape
+        const Transform worldToProxy = proxyToWorld.getInverse();
+        const Transform localFromTransform = worldToProxy * fromTransform;
+        const Transform localToTransform = worldToProxy * toTransform;
+
+        // Compute the swept AABB of the cast shape in the local-space of the proxy shape
+        AABB fromAABB, toAABB, sweptAABB;
+        shape->computeAABB(fromAABB, localFromTransform);
+        shape->computeAABB(toAABB, localToTransform);
+        sweptAABB.mergeTwoAABBs(fromAABB, toAABB);
+        if (std::abs(localFromTransform.getOrientation().dot(localToTransform.getOrientation())) <
+            decimal(1.0) - MACHINE_EPSILON) {
+            Vector3 minBounds, maxBounds;
+            shape->getLocalBounds(minBounds, maxBounds);
+            const decimal radius = std::max(minBounds.length(), maxBounds.length());
+            sweptAABB.inflate(radius, radius, radius);
+        }
+
+        decimal hitFraction;
+        Vector3 localPoint, localNormal;
+
+        // If the proxy shape is a compound shape
+        if (proxyCollisionShape->getType() == COMPOUND) {
+
+            const CompoundShape* compoundShape = static_cast<const CompoundShape*>(proxyCollisionShape);
+
+            // Get the child shapes that overlap with the swept AABB
+            std::vector<uint> childIndices;
+            compoundShape->getChildShapesOverlappingAABB(sweptAABB, childIndices);
+
+            // Keep the earliest time of impact among the child shapes
+            for (uint i=0; i<childIndices.size(); i++) {
+
+                // The cached data of a child shape cannot be used for another child shape
+                void* childCachedCollisionData = NULL;
+
+                if (mNarrowPhaseGJKAlgorithm.computeTimeOfImpact(shape, localFromTransform, localToTransform,
+                                            &castShapeCachedCollisionData,
+                                            compoundShape->getChildShape(childIndices[i]),
+                                            compoundShape->getChildTransform(childIndices[i]),
+                                            &childCachedCollisionData, maxFraction, hitFraction,
+                                            localPoint, localNormal)) {
+                    isHit = true;
+                    maxFraction = hitFraction;
+                    convexCastInfo.hitFraction = hitFraction;
+                    convexCastInfo.worldPoint = proxyToWorld * localPoint;
+                    convexCastInfo.worldNormal = proxyToWorld.getOrientation() * localNormal;
+                }
+
+                free(childCachedCollisionData);
+            }
+        }
+        else {
+
+            const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(proxyCollisionShape);
+
+            // Get the triangles of the concave shape that overlap with the swept AABB
+            std::vector<Vector3> trianglesVertices;
+            ConcaveTrianglesCollectorCallback trianglesCallback(trianglesVertices);
+            concaveShape->testAllTriangles(trianglesCallback, sweptAABB);
+
+            // Keep the earliest time of impact among the triangles
+            for (uint i=0; i<trianglesVertices.size(); i += 3) {
+
+                TriangleShape triangleShape(trianglesVertices[i], trianglesVertices[i + 1],
+                                            trianglesVertices[i + 2], concaveShape->getTriangleMargin());
+
+                if (mNarrowPhaseGJKAlgorithm.computeTimeOfImpact(shape, localFromTransform, localToTransform,
+                                            &castShapeCachedCollisionData, &triangleShape, Transform::identity(),
+                                            &proxyShapeCachedCollisionData, maxFraction, hitFraction,
+                                            localPoint, localNormal)) {
+                    isHit = true;
+                    maxFraction = hitFraction;
+                    convexCastInfo.hitFraction = hitFraction;
+                    convexCastInfo.worldPoint = proxyToWorld * localPoint;
+                    convexCastInfo.worldNormal = proxyToWorld.getOrientation() * localNormal;
+                }
+            }
+        }
+    }
+
+    free(castShapeCachedCollisionData);
+    free(proxyShapeCachedCollisionData);
+
+    if (isHit) {
+        convexCastInfo.body = proxyShape->getBody();
+        convexCastInfo.proxyShape = proxyShape;
+    }
+
+    return isHit;
+}
+
+// Compute the distance and the closest points between two proxy shapes
+/// At least one of the two shapes must be convex. If a pair of the world already exists
+/// between two convex shapes, the GJK algorithm is initialized with its cached separating
+/// axis. The distance to a concave shape is the smallest distance to its triangles.
+/**
+ * @return False if the distance cannot be computed (two concave shapes) and true otherwise
+ */
+bool CollisionDetection::computeDistance(const ProxyShape* shape1, const ProxyShape* shape2,
+                                         DistanceInfo& distanceInfo) const {
+
+    PROFILE("CollisionDetection::computeDistance()");
+
+    const CollisionShape* collisionShape1 = shape1->getCollisionShape();
+    const CollisionShape* collisionShape2 = shape2->getCollisionShape();
+
+    if (!collisionShape1->isConvex() && !collisionShape2->isConvex()) return false;
+
+    // The GJK algorithm is run from the convex shape
+    const bool isShape1Convex = collisionShape1->isConvex();
+    const ProxyShape* convexProxyShape = isShape1Convex ? shape1 : shape2;
+    const ProxyShape* otherProxyShape = isShape1Convex ? shape2 : shape1;
+
+    // If the pair already exists in the world, we start from its cached separating axis
+    Vector3 separatingAxis(0, 0, 0);
+    if (collisionShape1->isConvex() && collisionShape2->isConvex()) {
+        std::map<overlappingpairid, OverlappingPair*>::const_iterator itPair =
+                mOverlappingPairs.find(OverlappingPair::computeID(const_cast<ProxyShape*>(shape1),
+                                                                  const_cast<ProxyShape*>(shape2)));
+        if (itPair != mOverlappingPairs.end() && itPair->second->getShape1() == convexProxyShape) {
+            separatingAxis = itPair->second->getCachedSeparatingAxis();
+        }
+    }
+
+    void* shapeCachedCollisionData = NULL;
+    Vector3 convexWorldPoint, otherWorldPoint;
+    decimal distance;
+    bool isDistanceComputed = computeDistanceToProxyShape(
+                static_cast<const ConvexShape*>(convexProxyShape->getCollisionShape()),
+                convexProxyShape->getLocalToWorldTransform(), &shapeCachedCollisionData,
+                otherProxyShape, DECIMAL_LARGEST, separatingAxis, convexWorldPoint,
+                otherWorldPoint, distance);
+    free(shapeCachedCollisionData);
+
+    if (!isDistanceComputed) return false;
+
+    distanceInfo.distance = distance;
+    distanceInfo.worldPoint1 = isShape1Convex ? convexWorldPoint : otherWorldPoint;
+    distanceInfo.worldPoint2 = isShape1Convex ? otherWorldPoint : convexWorldPoint;
+    distanceInfo.proxyShape1 = const_cast<ProxyShape*>(shape1);
+    distanceInfo.proxyShape2 = const_cast<ProxyShape*>(shape2);
+
+    return true;
+}
+
+// Find the nearest proxy shape to a convex shape within a maximum distance
+/// The broad-phase tree is queried with the AABB of the shape enlarged by the maximum
+/// distance. The candidates are then sorted by the distance between their AABB and the
+/// AABB of the shape, which is a lower bound of their exact distance. Therefore, we can
+/// stop computing the exact distances as soon as this bound exceeds the best distance.
+/**
+ * @return True if a proxy shape has been found within the maximum distance
+ */
+bool CollisionDetection::computeNearestProxyShape(const ConvexShape* shape, const Transform& transform,
+                                                  const CollisionBody* ignoredBody, decimal maxDistance,
+                                                  DistanceInfo& distanceInfo,
+                                                  unsigned short categoryMaskBits) const {
+
+    PROFILE("CollisionDetection::computeNearestProxyShape()");
+
+    assert(maxDistance >= decimal(0.0));
+
+    AABB shapeAABB;
+    shape->computeAABB(shapeAABB, transform);
+    AABB queryAABB = shapeAABB;
+    queryAABB.inflate(maxDistance, maxDistance, maxDistance);
+
+    // Get the candidate proxy shapes from the broad-phase
+    std::vector<int> candidates;
+    BroadPhaseCandidatesCallback candidatesCallback(candidates);
+    mBroadPhaseAlgorithm.reportAllShapesOverlappingWithAABB(queryAABB, candidatesCallback);
+
+    // Sort the candidates by the lower bound of their distance
+    std::vector<std::pair<decimal, int> > sortedCandidates;
+    sortedCandidates.reserve(candidates.size());
+    for (uint i=0; i<candidates.size(); i++) {
+
+        ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(candidates[i]);
+
+        // Check if the filtering mask allows this shape and if it is not ignored
+        if ((categoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) continue;
+        if (proxyShape->getBody() == ignoredBody) continue;
+
+        const decimal lowerBound = shapeAABB.computeSquaredDistance(
+                                           mBroadPhaseAlgorithm.getFatAABB(proxyShape));
+        sortedCandidates.push_back(std::make_pair(lowerBound, candidates[i]));
+    }
+    std::sort(sortedCandidates.begin(), sortedCandidates.end());
+
+    void* shapeCachedCollisionData = NULL;
+    decimal bestDistance = maxDistance;
+    bool isFound = false;
+
+    for (uint i=0; i<sortedCandidates.size(); i++) {
+
+        // If the remaining candidates cannot be closer than the best one
+        if (isFound && sortedCandidates[i].first >= bestDistance * bestDistance) break;
+
+        ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(
+                                                                sortedCandidates[i].second);
+
+        Vector3 separatingAxis(0, 0, 0);
+        Vector3 worldPoint1, worldPoint2;
+        decimal distance;
+        if (computeDistanceToProxyShape(shape, transform, &shapeCachedCollisionData, proxyShape,
+                                        bestDistance, separatingAxis, worldPoint1, worldPoint2,
+                                        distance)) {
+            isFound = true;
+            bestDistance = distance;
+            distanceInfo.distance = distance;
+            distanceInfo.worldPoint1 = worldPoint1;
+            distanceInfo.worldPoint2 = worldPoint2;
+            distanceInfo.proxyShape2 = proxyShape;
+
+            // We cannot find a closer shape than an overlapping one
+            if (distance == decimal(0.0)) break;
+        }
+    }
+
+    free(shapeCachedCollisionData);
+
+    return isFound;
+}
+
+// Report the proxy shapes that are inside or intersect the volume bounded by planes
+/// See DynamicAABBTree::reportAllNodesInsidePlanes() for the traversal of the broad-phase tree.
+void CollisionDetection::cullProxyShapes(const Plane* planes, uint nbPlanes,
+                                         CullingCallback* cullingCallback,
+                                         unsigned short categoryMaskBits) const {
+
+    PROFILE("CollisionDetection::cullProxyShapes()");
+
+    CullingQueryCallback cullingQueryCallback(mBroadPhaseAlgorithm, planes, nbPlanes,
+                                              categoryMaskBits, cullingCallback);
+    mBroadPhaseAlgorithm.reportAllShapesInsidePlanes(planes, nbPlanes, cullingQueryCallback);
+}
+
+// Find the nearest proxy shapes to an AABB or to a convex shape within a maximum distance
+/// The broad-phase tree is searched with a branch and bound algorithm (see
+/// DynamicAABBTree::reportNearestNodes()). The distances are the distances between the query
+/// AABB and the AABBs of the proxy shapes unless the exact distances with the convex shape
+/// of the query are required.
+/**
+ * @return The number of proxy shapes written in the output arrays
+ */
+uint CollisionDetection::computeNearestProxyShapes(const AABB& aabb, const ConvexShape* shape,
+                                                   const Transform& transform, bool computeExactDistances,
+                                                   uint maxNbShapes, decimal maxDistance,
+                                                   ProxyShape** nearestShapes, decimal* distances,
+                                                   unsigned short categoryMaskBits) const {
+
+    PROFILE("CollisionDetection::computeNearestProxyShapes()");
+
+    if (maxNbShapes == 0) return 0;
+
+    NearestQueryCallback nearestCallback(*this, aabb, shape, transform, computeExactDistances,
+                                         categoryMaskBits);
+
+    // The second half of the array is used by the broad-phase for the bodies in compound mode
+    std::vector<int32> nearestNodes(2 * maxNbShapes);
+    const uint nbNearestShapes = mBroadPhaseAlgorithm.reportNearestShapes(aabb, maxNbShapes, maxDistance,
+                                                                         nearestCallback, &(nearestNodes[0]),
+                                                                         distances, &(nearestNodes[maxNbShapes]));
+
+    for (uint i=0; i<nbNearestShapes; i++) {
+        nearestShapes[i] = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nearestNodes[i]);
+    }
+
+    return nbNearestShapes;
+}
+
+// Compute the distance between a convex shape and a proxy shape
+/// This method returns true if the distance is smaller than the maximum distance or if
+/// the shapes overlap. In the later case, the distance is zero and the points are the
+/// contact points between the convex shape and the overlapping shape (the proxy shape, a
+/// child shape or a triangle): the point of each shape that is the deepest inside the other
+/// one. The collision data cache of the proxy shape belongs to the query so that the world
+/// is not modified.
+bool CollisionDetection::computeDistanceToProxyShape(const ConvexShape* shape, const Transform& transform,
+                                                     void** shapeCachedCollisionData,
+                                                     const ProxyShape* proxyShape, decimal maxDistance,
+                                                     Vector3& separatingAxis, Vector3& worldPoint1,
+                                                     Vector3& worldPoint2, decimal& distance) const {
+
+    const CollisionShape* proxyCollisionShape = proxyShape->getCollisionShape();
+    const Transform proxyToWorld = proxyShape->getLocalToWorldTransform();
+
+    void* proxyShapeCachedCollisionData = NULL;
+
+    // If the proxy shape is convex
+    if (proxyCollisionShape->isConvex()) {
+
+        Vector3 point1, point2;
+        decimal shapesDistance;
+        const bool isSeparated = mNarrowPhaseGJKAlgorithm.computeClosestPoints(shape, transform,
+                                    shapeCachedCollisionData, static_cast<const ConvexShape*>(proxyCollisionShape),
+                                    proxyToWorld, &proxyShapeCachedCollisionData, separatingAxis,
+                                    point1, point2, shapesDistance, true);
+        free(proxyShapeCachedCollisionData);
+
+        if (!isSeparated) {
+            distance = decimal(0.0);
+            worldPoint1 = point1;
+            worldPoint2 = point2;
+            return true;
+        }
+
+        if (shapesDistance >= maxDistance) return false;
+
+        distance = shapesDistance;
+        worldPoint1 = point1;
+        worldPoint2 = point2;
+
+        return true;
+    }
+
+    // If the proxy shape is a compound shape
+    if (proxyCollisionShape->getType() == COMPOUND) {
+
+        const CompoundShape* compoundShape = static_cast<const CompoundShape*>(proxyCollisionShape);
+
+        // Express the convex shape in the local-space of the compound shape
+        const Transform localTransform = proxyToWorld.getInverse() * transform;
+
+        // Get the child shapes that can be closer than the maximum distance
+        AABB queryAABB;
+        if (maxDistance < DECIMAL_LARGEST) {
+            shape->computeAABB(queryAABB, localTransform);
+            queryAABB.inflate(maxDistance, maxDistance, maxDistance);
+        }
+        else {
+            Vector3 minBounds, maxBounds;
+            compoundShape->getLocalBounds(minBounds, maxBounds);
+            queryAABB = AABB(minBounds, maxBounds);
+        }
+        std::vector<uint> childIndices;
+        compoundShape->getChildShapesOverlappingAABB(queryAABB, childIndices);
+
+        // Keep the smallest distance among the child shapes
+        bool isFound = false;
+        decimal bestDistance = maxDistance;
+        for (uint i=0; i<childIndices.size(); i++) {
+
+            // The cached data of a child shape cannot be used for another child shape
+            void* childCachedCollisionData = NULL;
+
+            Vector3 childSeparatingAxis(0, 0, 0);
+            Vector3 localPoint1, localPoint2;
+            decimal childDistance;
+            const bool isSeparated = mNarrowPhaseGJKAlgorithm.computeClosestPoints(shape, localTransform,
+                                        shapeCachedCollisionData, compoundShape->getChildShape(childIndices[i]),
+                                        compoundShape->getChildTransform(childIndices[i]),
+                                        &childCachedCollisionData, childSeparatingAxis,
+                                        localPoint1, localPoint2, childDistance, true);
+            free(childCachedCollisionData);
+
+            if (!isSeparated) {
+                isFound = true;
+                bestDistance = decimal(0.0);
+                worldPoint1 = proxyToWorld * localPoint1;
+                worldPoint2 = proxyToWorld * localPoint2;
+                break;
+            }
+
+            if (childDistance < bestDistance) {
+                isFound = true;
+                bestDistance = childDistance;
+                worldPoint1 = proxyToWorld * localPoint1;
+                worldPoint2 = proxyToWorld * localPoint2;
+            }
+        }
+
+        if (isFound) distance = bestDistance;
+
+        return isFound;
+    }
+
+    // If the proxy shape is concave
+    const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(proxyCollisionShape);
+
+    // Express the convex shape in the local-space of the concave shape
+    const Transform localTransform = proxyToWorld.getInverse() * transform;
+
+    // Get the triangles of the concave shape that can be closer than the maximum distance
+    AABB queryAABB;
+    if (maxDistance < DECIMAL_LARGEST) {
+        shape->computeAABB(queryAABB, localTransform);
+        queryAABB.inflate(maxDistance, maxDistance, maxDistance);
+    }
+    else {
+        Vector3 minBounds, maxBounds;
+        concaveShape->getLocalBounds(minBounds, maxBounds);
+        queryAABB = AABB(minBounds, maxBounds);
+    }
+    std::vector<Vector3> trianglesVertices;
+    ConcaveTrianglesCollectorCallback trianglesCallback(trianglesVertices);
+    concaveShape->testAllTriangles(trianglesCallback, queryAABB);
+
+    // Keep the smallest distance among the triangles
+    bool isFound = false;
+    decimal bestDistance = maxDistance;
+    for (uint i=0; i<trianglesVertices.size(); i += 3) {
+
+        TriangleShape triangleShape(trianglesVertices[i], trianglesVertices[i + 1],
+                                    trianglesVertices[i + 2], concaveShape->getTriangleMargin());
+
+        Vector3 triangleSeparatingAxis(0, 0, 0);
+        Vector3 localPoint1, localPoint2;
+        decimal triangleDistance;
+        const bool isSeparated = mNarrowPhaseGJKAlgorithm.computeClosestPoints(shape, localTransform,
+                                    shapeCachedCollisionData, &triangleShape, Transform::identity(),
+                                    &proxyShapeCachedCollisionData, triangleSeparatingAxis,
+                                    localPoint1, localPoint2, triangleDistance, true);
+
+        if (!isSeparated) {
+            isFound = true;
+            bestDistance = decimal(0.0);
+            worldPoint1 = proxyToWorld * localPoint1;
+            worldPoint2 = proxyToWorld * localPoint2;
+            break;
+        }
+
+        if (triangleDistance < bestDistance) {
+            isFound = true;
+            bestDistance = triangleDistance;
+            worldPoint1 = proxyToWorld * localPoint1;
+            worldPoint2 = proxyToWorld * localPoint2;
+        }
+    }
+
+    free(proxyShapeCachedCollisionData);
+
+    if (isFound) distance = bestDistance;
+
+    return isFound;
+}
+
 // Allow the broadphase to notify the collision detection about an overlapping pair.
 /// This method is called by the broad-phase collision detection algorithm
 void CollisionDetection::broadPhaseNotifyOverlappingPair(ProxyShape* shape1, ProxyShape* shape2) {
@@ -530,3 +1255,182 @@ void TestCollisionBetweenShapesCallback::notifyContact(OverlappingPair* overlapp
                            const ContactPointInfo& contactInfo) {
     mCollisionCallback->notifyContact(contactInfo);
 }
+
+// Called when a overlapping node has been found during the call to
+// DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+void OverlapQueryCallback::notifyOverlappingNode(int nodeId) {
+
+    // If the output array is full
+    if (mNbOverlappingShapes == mMaxNbOverlappingShapes) return;
+
+    ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nodeId);
+
+    // Check if the filtering mask allows the query against this shape
+    if ((mCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) return;
+
+    // Confirm the overlap with the exact AABB of the proxy shape
+    AABB proxyAABB;
+    proxyShape->getCollisionShape()->computeAABB(proxyAABB, proxyShape->getLocalToWorldTransform());
+    if (!mAABB.testCollision(proxyAABB)) return;
+
+    // Confirm the overlap with the convex shape of the query
+    if (mShape != NULL && !testShapeOverlap(proxyShape)) return;
+
+    mOverlappingShapes[mNbOverlappingShapes] = proxyShape;
+    mNbOverlappingShapes++;
+}
+
+// Called for each leaf node that is not culled
+void CullingQueryCallback::notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside) {
+
+    ProxyShape* proxyShape = mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nodeId);
+
+    // Check if the filtering mask allows the query against this shape
+    if ((mCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) return;
+
+    // If only the fat AABB is known to intersect the planes, we test the exact AABB
+    if (!isFullyInside) {
+
+        AABB proxyAABB;
+        proxyShape->getCollisionShape()->computeAABB(proxyAABB, proxyShape->getLocalToWorldTransform());
+
+        isFullyInside = true;
+        for (uint i=0; i<mNbPlanes; i++) {
+
+            decimal minDistance, maxDistance;
+            proxyAABB.computeSignedDistanceInterval(mPlanes[i], minDistance, maxDistance);
+
+            // If the proxy shape is culled
+            if (minDistance > decimal(0.0)) return;
+
+            if (maxDistance > decimal(0.0)) isFullyInside = false;
+        }
+    }
+
+    mCullingCallback->notifyProxyShape(proxyShape, isFullyInside);
+}
+
+// Compute the distance between the query and the proxy shape of a leaf node
+decimal NearestQueryCallback::computeNodeDistance(int32 nodeId, decimal lowerBoundDistance,
+                                                  decimal maxDistance) {
+
+    const ProxyShape* proxyShape = mCollisionDetection.mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nodeId);
+
+    // Check if the filtering mask allows the query against this shape
+    if ((mCategoryMaskBits & proxyShape->getCollisionCategoryBits()) == 0) return decimal(-1.0);
+
+    // Compute the distance between the query AABB and the exact AABB of the proxy shape
+    AABB proxyAABB;
+    proxyShape->getCollisionShape()->computeAABB(proxyAABB, proxyShape->getLocalToWorldTransform());
+    const decimal aabbDistance = std::sqrt(mAABB.computeSquaredDistance(proxyAABB));
+
+    if (!mIsExactDistance || aabbDistance >= maxDistance) return aabbDistance;
+
+    // Compute the exact distance with the GJK algorithm
+    Vector3 separatingAxis(0, 0, 0);
+    Vector3 worldPoint1, worldPoint2;
+    decimal distance;
+    if (!mCollisionDetection.computeDistanceToProxyShape(mShape, mShapeTransform, &mShapeCachedCollisionData,
+                                                         proxyShape, maxDistance, separatingAxis,
+                                                         worldPoint1, worldPoint2, distance)) {
+        return decimal(-1.0);
+    }
+
+    return distance;
+}
+
+// Return true if the convex shape of the query overlaps with a proxy shape
+/// The collision data caches are owned by the query and the child shapes of a compound
+/// shape are tested as they are found in its tree so that nothing is allocated.
+bool OverlapQueryCallback::testShapeOverlap(ProxyShape* proxyShape) {
+
+    const CollisionShape* proxyCollisionShape = proxyShape->getCollisionShape();
+    const Transform proxyToWorld = proxyShape->getLocalToWorldTransform();
+
+    bool isOverlapping;
+
+    // If the proxy shape is convex
+    if (proxyCollisionShape->isConvex()) {
+
+        Vector3 separatingAxis, point1, point2;
+        decimal distance;
+        mCandidateCache = ConvexMeshSupportCache();
+        void* proxyShapeCachedCollisionData = &mCandidateCache;
+        isOverlapping = !mGJKAlgorithm.computeClosestPoints(mShape, mShapeTransform, &mShapeCachedCollisionData,
+                                        static_cast<const ConvexShape*>(proxyCollisionShape), proxyToWorld,
+                                        &proxyShapeCachedCollisionData, separatingAxis, point1, point2,
+                                        distance);
+    }
+    else if (proxyCollisionShape->getType() == COMPOUND) {  // If the proxy shape is a compound shape
+
+        const CompoundShape* compoundShape = static_cast<const CompoundShape*>(proxyCollisionShape);
+
+        // Test the child shapes overlapping with the AABB of the shape in the local-space
+        // of the compound shape
+        const Transform shapeToCompound = proxyToWorld.getInverse() * mShapeTransform;
+        AABB localAABB;
+        mShape->computeAABB(localAABB, shapeToCompound);
+        OverlapQueryChildShapesCallback childShapesCallback(mGJKAlgorithm, *compoundShape, mShape,
+                                                            shapeToCompound, &mShapeCachedCollisionData,
+                                                            mCandidateCache);
+        compoundShape->reportChildShapesOverlappingAABB(localAABB, childShapesCallback);
+        isOverlapping = childShapesCallback.isOverlapping();
+    }
+    else {  // If the proxy shape is concave
+
+        const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(proxyCollisionShape);
+
+        // Test the triangles overlapping with the AABB of the shape in the local-space
+        // of the concave shape
+        const Transform shapeToConcave = proxyToWorld.getInverse() * mShapeTransform;
+        AABB localAABB;
+        mShape->computeAABB(localAABB, shapeToConcave);
+        OverlapQueryTrianglesCallback trianglesCallback(mGJKAlgorithm, mShape, shapeToConcave,
+                                                        &mShapeCachedCollisionData,
+                                                        concaveShape->getTriangleMargin());
+        concaveShape->testAllTriangles(trianglesCallback, localAABB);
+        isOverlapping = trianglesCallback.isOverlapping();
+    }
+
+    return isOverlapping;
+}
+
+// Test the overlap between the convex shape and a child shape
+void OverlapQueryChildShapesCallback::notifyOverlappingChildShape(uint childIndex) {
+
+    // If an overlapping child shape has already been found
+    if (mIsOverlapping) return;
+
+    // The cached data of a child shape cannot be used for another child shape
+    mChildCache = ConvexMeshSupportCache();
+    void* childCachedCollisionData = &mChildCache;
+
+    Vector3 separatingAxis(0, 0, 0);
+    Vector3 point1, point2;
+    decimal distance;
+    mIsOverlapping = !mGJKAlgorithm.computeClosestPoints(mShape, mShapeToCompoundTransform,
+                                  mShapeCachedCollisionData, mCompoundShape.getChildShape(childIndex),
+                                  mCompoundShape.getChildTransform(childIndex),
+                                  &childCachedCollisionData, separatingAxis, point1, point2,
+                                  distance);
+}
+
+// Test the overlap between the convex shape and a triangle
+void OverlapQueryTrianglesCallback::testTriangle(const Vector3* trianglePoints) {
+
+    // If an overlapping triangle has already been found
+    if (mIsOverlapping) return;
+
+    TriangleShape triangleShape(trianglePoints[0], trianglePoints[1], trianglePoints[2],
+                                mTriangleMargin);
+
+    void* triangleCachedCollisionData = NULL;
+    Vector3 separatingAxis, point1, point2;
+    decimal distance;
+    mIsOverlapping = !mGJKAlgorithm.computeClosestPoints(mShape, mShapeToConcaveTransform,
+                                                         mShapeCachedCollisionData, &triangleShape,
+                                                         Transform::identity(),
+                                                         &triangleCachedCollisionData, separatingAxis,
+                                                         point1, point2, distance);
+}
+
@@ -34,6 +34,11 @@
 #include "narrowphase/DefaultCollisionDispatch.h"
 #include "memory/MemoryAllocator.h"
 #include "constraint/ContactPoint.h"
+#include "collision/ConvexCastInfo.h"
+#include "collision/DistanceInfo.h"
+#include "collision/shapes/CompoundShape.h"
+#include "collision/shapes/ConcaveShape.h"
+#include "collision/shapes/ConvexMeshSupportCache.h"
 #include <vector>
 #include <map>
 #include <set>
@@ -46,6 +51,7 @@ namespace reactphysics3d {
 class BroadPhaseAlgorithm;
 class CollisionWorld;
 class CollisionCallback;
+class CullingCallback;
 
 // Class TestCollisionBetweenShapesCallback
 class TestCollisionBetweenShapesCallback : public NarrowPhaseCallback {
@@ -67,6 +73,302 @@ class TestCollisionBetweenShapesCallback : public NarrowPhaseCallback {
                                    const ContactPointInfo& contactInfo);
 };
 
+// Class ConcaveTrianglesCollectorCallback
+/**
+ * Triangle callback used to gather the vertices of the triangles of a
+ * concave shape that overlap with a query AABB.
+ */
+class ConcaveTrianglesCollectorCallback : public TriangleCallback {
+
+    private:
+
+        std::vector<Vector3>& mTrianglesVertices;
+
+    public:
+
+        // Constructor
+        ConcaveTrianglesCollectorCallback(std::vector<Vector3>& trianglesVertices)
+            : mTrianglesVertices(trianglesVertices) {
+
+        }
+
+        // Report a triangle
+        virtual void testTriangle(const Vector3* trianglePoints) {
+            mTrianglesVertices.push_back(trianglePoints[0]);
+            mTrianglesVertices.push_back(trianglePoints[1]);
+            mTrianglesVertices.push_back(trianglePoints[2]);
+        }
+};
+
+// Class OverlapQueryTrianglesCallback
+/**
+ * Triangle callback used to test if a convex shape overlaps with at least
+ * one of the triangles of a concave shape.
+ */
+class OverlapQueryTrianglesCallback : public TriangleCallback {
+
+    private:
+
+        /// GJK algorithm used to test the overlap
+        const GJKAlgorithm& mGJKAlgorithm;
+
+        /// Convex shape of the query
+        const ConvexShape* mShape;
+
+        /// Transform of the convex shape in the local-space of the concave shape
+        const Transform& mShapeToConcaveTransform;
+
+        /// Collision data cache of the convex shape
+        void** mShapeCachedCollisionData;
+
+        /// Margin of the triangles of the concave shape
+        decimal mTriangleMargin;
+
+        /// True if an overlapping triangle has been found
+        bool mIsOverlapping;
+
+    public:
+
+        // Constructor
+        OverlapQueryTrianglesCallback(const GJKAlgorithm& gjkAlgorithm, const ConvexShape* shape,
+                                      const Transform& shapeToConcaveTransform,
+                                      void** shapeCachedCollisionData, decimal triangleMargin)
+            : mGJKAlgorithm(gjkAlgorithm), mShape(shape), mShapeToConcaveTransform(shapeToConcaveTransform),
+              mShapeCachedCollisionData(shapeCachedCollisionData), mTriangleMargin(triangleMargin),
+              mIsOverlapping(false) {
+
+        }
+
+        // Test the overlap between the convex shape and a triangle
+        virtual void testTriangle(const Vector3* trianglePoints);
+
+        // Return true if an overlapping triangle has been found
+        bool isOverlapping() const {
+            return mIsOverlapping;
+        }
+};
+
+// Class OverlapQueryChildShapesCallback
+/**
+ * Child shape callback used to test if a convex shape overlaps with at least
+ * one of the child shapes of a compound shape.
+ */
+class OverlapQueryChildShapesCallback : public CompoundShapeChildCallback {
+
+    private:
+
+        /// GJK algorithm used to test the overlap
+        const GJKAlgorithm& mGJKAlgorithm;
+
+        /// Compound shape of the child shapes
+        const CompoundShape& mCompoundShape;
+
+        /// Convex shape of the query
+        const ConvexShape* mShape;
+
+        /// Transform of the convex shape in the local-space of the compound shape
+        const Transform& mShapeToCompoundTransform;
+
+        /// Collision data cache of the convex shape
+        void** mShapeCachedCollisionData;
+
+        /// Collision data cache of the child shapes (reset for each child shape)
+        ConvexMeshSupportCache& mChildCache;
+
+        /// True if an overlapping child shape has been found
+        bool mIsOverlapping;
+
+    public:
+
+        // Constructor
+        OverlapQueryChildShapesCallback(const GJKAlgorithm& gjkAlgorithm, const CompoundShape& compoundShape,
+                                        const ConvexShape* shape, const Transform& shapeToCompoundTransform,
+                                        void** shapeCachedCollisionData, ConvexMeshSupportCache& childCache)
+            : mGJKAlgorithm(gjkAlgorithm), mCompoundShape(compoundShape), mShape(shape),
+              mShapeToCompoundTransform(shapeToCompoundTransform),
+              mShapeCachedCollisionData(shapeCachedCollisionData), mChildCache(childCache),
+              mIsOverlapping(false) {
+
+        }
+
+        // Test the overlap between the convex shape and a child shape
+        virtual void notifyOverlappingChildShape(uint childIndex);
+
+        // Return true if an overlapping child shape has been found
+        bool isOverlapping() const {
+            return mIsOverlapping;
+        }
+};
+
+// Class OverlapQueryCallback
+/**
+ * Callback called for each proxy shape whose fat AABB overlaps with the AABB of an
+ * overlap query in the broad-phase tree. The overlap is confirmed with the exact AABB
+ * of the proxy shape (AABB query) or with the GJK algorithm (convex shape query) and
+ * the overlapping proxy shapes are written into the output array of the user.
+ */
+class OverlapQueryCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        /// Reference to the broad-phase algorithm
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        /// GJK algorithm used to confirm the overlaps with a convex shape
+        const GJKAlgorithm& mGJKAlgorithm;
+
+        /// World-space AABB of the query
+        const AABB& mAABB;
+
+        /// Convex shape of the query (NULL for an AABB query)
+        const ConvexShape* mShape;
+
+        /// Local-space to world-space transform of the convex shape of the query
+        Transform mShapeTransform;
+
+        /// Bits mask of the categories of the proxy shapes to report
+        unsigned short mCategoryMaskBits;
+
+        /// Output array of overlapping proxy shapes
+        ProxyShape** mOverlappingShapes;
+
+        /// Size of the output array
+        uint mMaxNbOverlappingShapes;
+
+        /// Number of overlapping proxy shapes written in the output array
+        uint mNbOverlappingShapes;
+
+        /// Collision data cache of the convex shape of the query (reused for all the candidates)
+        ConvexMeshSupportCache mShapeCache;
+
+        /// Pointer to the collision data cache of the convex shape of the query
+        void* mShapeCachedCollisionData;
+
+        /// Collision data cache of the candidate shapes (reset for each candidate)
+        ConvexMeshSupportCache mCandidateCache;
+
+        /// Return true if the convex shape of the query overlaps with a proxy shape
+        bool testShapeOverlap(ProxyShape* proxyShape);
+
+    public:
+
+        // Constructor
+        OverlapQueryCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm,
+                             const GJKAlgorithm& gjkAlgorithm, const AABB& aabb,
+                             const ConvexShape* shape, const Transform& shapeTransform,
+                             unsigned short categoryMaskBits, ProxyShape** overlappingShapes,
+                             uint maxNbOverlappingShapes)
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm), mGJKAlgorithm(gjkAlgorithm), mAABB(aabb),
+              mShape(shape), mShapeTransform(shapeTransform), mCategoryMaskBits(categoryMaskBits),
+              mOverlappingShapes(overlappingShapes), mMaxNbOverlappingShapes(maxNbOverlappingShapes),
+              mNbOverlappingShapes(0), mShapeCachedCollisionData(&mShapeCache) {
+
+        }
+
+        // Called when a overlapping node has been found during the call to
+        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int nodeId);
+
+        // Return the number of overlapping proxy shapes written in the output array
+        uint getNbOverlappingShapes() const {
+            return mNbOverlappingShapes;
+        }
+};
+
+// Class CullingQueryCallback
+/**
+ * Callback called for each proxy shape of the broad-phase tree that is not culled by
+ * the planes of a culling query. If the fat AABB of the proxy shape intersects the
+ * planes, its exact AABB is tested before the proxy shape is reported to the user.
+ */
+class CullingQueryCallback : public DynamicAABBTreeCullingCallback {
+
+    private:
+
+        /// Reference to the broad-phase algorithm
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        /// Planes of the query
+        const Plane* mPlanes;
+
+        /// Number of planes
+        uint mNbPlanes;
+
+        /// Bits mask of the categories of the proxy shapes to report
+        unsigned short mCategoryMaskBits;
+
+        /// User callback
+        CullingCallback* mCullingCallback;
+
+    public:
+
+        // Constructor
+        CullingQueryCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm, const Plane* planes,
+                             uint nbPlanes, unsigned short categoryMaskBits,
+                             CullingCallback* cullingCallback)
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm), mPlanes(planes), mNbPlanes(nbPlanes),
+              mCategoryMaskBits(categoryMaskBits), mCullingCallback(cullingCallback) {
+
+        }
+
+        // Called for each leaf node that is not culled
+        virtual void notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside);
+};
+
+// Class NearestQueryCallback
+/**
+ * Callback used by the nearest proxy shapes query to compute the distance between
+ * the query and a candidate proxy shape of the broad-phase tree. The distance is the
+ * distance between the query AABB and the exact AABB of the proxy shape or, if required,
+ * the exact distance between the convex shape of the query and the proxy shape (GJK).
+ */
+class NearestQueryCallback : public DynamicAABBTreeNearestCallback {
+
+    private:
+
+        /// Reference to the collision detection
+        const CollisionDetection& mCollisionDetection;
+
+        /// World-space AABB of the query
+        const AABB& mAABB;
+
+        /// Convex shape of the query (NULL for an AABB query)
+        const ConvexShape* mShape;
+
+        /// Local-space to world-space transform of the convex shape of the query
+        Transform mShapeTransform;
+
+        /// True if the exact distance with the convex shape of the query is computed
+        bool mIsExactDistance;
+
+        /// Bits mask of the categories of the proxy shapes to report
+        unsigned short mCategoryMaskBits;
+
+        /// Collision data cache of the convex shape of the query
+        void* mShapeCachedCollisionData;
+
+    public:
+
+        // Constructor
+        NearestQueryCallback(const CollisionDetection& collisionDetection, const AABB& aabb,
+                             const ConvexShape* shape, const Transform& shapeTransform,
+                             bool isExactDistance, unsigned short categoryMaskBits)
+            : mCollisionDetection(collisionDetection), mAABB(aabb), mShape(shape),
+              mShapeTransform(shapeTransform), mIsExactDistance(isExactDistance && shape != NULL),
+              mCategoryMaskBits(categoryMaskBits), mShapeCachedCollisionData(NULL) {
+
+        }
+
+        // Destructor
+        virtual ~NearestQueryCallback() {
+            free(mShapeCachedCollisionData);
+        }
+
+        // Compute the distance between the query and the proxy shape of a leaf node
+        virtual decimal computeNodeDistance(int32 nodeId, decimal lowerBoundDistance,
+                                            decimal maxDistance);
+};
+
 // Class CollisionDetection
 /**
  * This class computes the collision detection algorithms. We first
@@ -101,6 +403,14 @@ class CollisionDetection : public NarrowPhaseCallback {
         /// Overlapping pairs in contact (during the current Narrow-phase collision detection)
         std::map<overlappingpairid, OverlappingPair*> mContactOverlappingPairs;
 
+        /// Overlapping pairs to test during the current narrow-phase collision detection
+        /// (this array is reused between two frames)
+        std::vector<OverlappingPair*> mNarrowPhasePairs;
+
+        /// Overlapping pairs of the current narrow-phase grouped by types of collision
+        /// shapes (this array is reused between two frames)
+        std::vector<OverlappingPair*> mNarrowPhaseBatchPairs;
+
         /// Broad-phase algorithm
         BroadPhaseAlgorithm mBroadPhaseAlgorithm;
 
@@ -140,6 +450,22 @@ class CollisionDetection : public NarrowPhaseCallback {
 
         /// Add all the contact manifold of colliding pairs to their bodies
         void addAllContactManifoldsToBodies();
+
+        /// Compute the contacts between two proxy shapes without modifying the world
+        void computeQueryContacts(ProxyShape* shape1, ProxyShape* shape2,
+                                  CollisionCallback* callback) const;
+
+        /// Compute the time of impact of a cast convex shape against a proxy shape
+        bool convexCastAgainstProxyShape(const ConvexShape* shape, const Transform& fromTransform,
+                                         const Transform& toTransform, ProxyShape* proxyShape,
+                                         decimal maxFraction, ConvexCastInfo& convexCastInfo) const;
+
+        /// Compute the distance between a convex shape and a proxy shape
+        bool computeDistanceToProxyShape(const ConvexShape* shape, const Transform& transform,
+                                         void** shapeCachedCollisionData, const ProxyShape* proxyShape,
+                                         decimal maxDistance, Vector3& separatingAxis,
+                                         Vector3& worldPoint1, Vector3& worldPoint2,
+                                         decimal& distance) const;
    
     public :
 
@@ -168,6 +494,9 @@ class CollisionDetection : public NarrowPhaseCallback {
         void updateProxyCollisionShape(ProxyShape* shape, const AABB& aabb,
                                        const Vector3& displacement = Vector3(0, 0, 0), bool forceReinsert = false);
 
+        /// Update the compound of a body in compound mode (that has moved for instance)
+        void updateCompoundBody(const CollisionBody* body, const Vector3& displacement);
+
         /// Add a pair of bodies that cannot collide with each other
         void addNoCollisionPair(CollisionBody* body1, CollisionBody* body2);
 
@@ -194,6 +523,54 @@ class CollisionDetection : public NarrowPhaseCallback {
         void raycast(RaycastCallback* raycastCallback, const Ray& ray,
                      unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Ray casting method for a batch of rays
+        void raycastBatch(const Ray* rays, uint nbRays, RaycastBatchHit* hits,
+                          unsigned short raycastWithCategoryMaskBits) const;
+
+        /// Convex cast method
+        void convexCast(const ConvexShape* shape, const Transform& fromTransform,
+                        const Transform& toTransform, ConvexCastCallback* convexCastCallback,
+                        unsigned short convexCastWithCategoryMaskBits) const;
+
+        /// Report the contacts between a proxy shape and the other ones without modifying the world
+        void testCollisionQuery(const ProxyShape* shape, CollisionCallback* callback) const;
+
+        /// Report the contacts between two proxy shapes without modifying the world
+        void testCollisionQuery(const ProxyShape* shape1, const ProxyShape* shape2,
+                                CollisionCallback* callback) const;
+
+        /// Report the proxy shapes overlapping with a world-space AABB
+        uint testAABBOverlap(const AABB& aabb, ProxyShape** overlappingShapes,
+                             uint maxNbOverlappingShapes, unsigned short categoryMaskBits) const;
+
+        /// Wake up the bodies with a proxy shape overlapping with a world-space AABB
+        void wakeUpBodiesOverlappingAABB(const AABB& aabb, const CollisionBody* ignoredBody);
+
+        /// Report the proxy shapes overlapping with a convex shape
+        uint testOverlap(const ConvexShape* shape, const Transform& transform,
+                         ProxyShape** overlappingShapes, uint maxNbOverlappingShapes,
+                         unsigned short categoryMaskBits) const;
+
+        /// Compute the distance and the closest points between two proxy shapes
+        bool computeDistance(const ProxyShape* shape1, const ProxyShape* shape2,
+                             DistanceInfo& distanceInfo) const;
+
+        /// Find the nearest proxy shape to a convex shape within a maximum distance
+        bool computeNearestProxyShape(const ConvexShape* shape, const Transform& transform,
+                                      const CollisionBody* ignoredBody, decimal maxDistance,
+                                      DistanceInfo& distanceInfo, unsigned short categoryMaskBits) const;
+
+        /// Report the proxy shapes that are inside or intersect the volume bounded by planes
+        void cullProxyShapes(const Plane* planes, uint nbPlanes, CullingCallback* cullingCallback,
+                             unsigned short categoryMaskBits) const;
+
+        /// Find the nearest proxy shapes to an AABB or to a convex shape within a maximum distance
+        uint computeNearestProxyShapes(const AABB& aabb, const ConvexShape* shape,
+                                       const Transform& transform, bool computeExactDistances,
+                                       uint maxNbShapes, decimal maxDistance,
+                                       ProxyShape** nearestShapes, decimal* distances,
+                                       unsigned short categoryMaskBits) const;
+
         /// Test if the AABBs of two bodies overlap
         bool testAABBOverlap(const CollisionBody* body1,
                              const CollisionBody* body2) const;
@@ -229,6 +606,7 @@ class CollisionDetection : public NarrowPhaseCallback {
 
         friend class DynamicsWorld;
         friend class ConvexMeshShape;
+        friend class NearestQueryCallback;
 };
 
 // Return the Narrow-phase collision detection algorithm to use between two types of shapes
@@ -279,7 +657,13 @@ inline void CollisionDetection::askForBroadPhaseCollisionCheck(ProxyShape* shape
 // Update a proxy collision shape (that has moved for instance)
 inline void CollisionDetection::updateProxyCollisionShape(ProxyShape* shape, const AABB& aabb,
                                                           const Vector3& displacement, bool forceReinsert) {
-    mBroadPhaseAlgorithm.updateProxyCollisionShape(shape, aabb, displacement);
+    mBroadPhaseAlgorithm.updateProxyCollisionShape(shape, aabb, displacement, forceReinsert);
+}
+
+// Update the compound of a body in compound mode (that has moved for instance)
+inline void CollisionDetection::updateCompoundBody(const CollisionBody* body,
+                                                   const Vector3& displacement) {
+    mBroadPhaseAlgorithm.updateCompoundBody(body, displacement);
 }
 
 // Ray casting method
@@ -296,6 +680,23 @@ inline void CollisionDetection::raycast(RaycastCallback* raycastCallback,
     mBroadPhaseAlgorithm.raycast(ray, rayCastTest, raycastWithCategoryMaskBits);
 }
 
+// Ray casting method for a batch of rays
+inline void CollisionDetection::raycastBatch(const Ray* rays, uint nbRays, RaycastBatchHit* hits,
+                                             unsigned short raycastWithCategoryMaskBits) const {
+
+    PROFILE("CollisionDetection::raycastBatch()");
+
+    // Reset the hits of the rays
+    for (uint i=0; i<nbRays; i++) {
+        hits[i] = RaycastBatchHit();
+    }
+
+    RaycastBatchTest raycastBatchTest(hits);
+
+    // Ask the broad-phase algorithm to traverse the tree with packets of rays
+    mBroadPhaseAlgorithm.raycastBatch(rays, nbRays, raycastBatchTest, raycastWithCategoryMaskBits);
+}
+
 // Test if the AABBs of two proxy shapes overlap
 inline bool CollisionDetection::testAABBOverlap(const ProxyShape* shape1,
                                                 const ProxyShape* shape2) const {
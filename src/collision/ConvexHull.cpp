@@ -0,0 +1,389 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ConvexHull.h"
+#include <map>
+#include <utility>
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Structure QuickHullFace
+/**
+ * Triangle face of the hull used while the hull is computed by the Quickhull
+ * algorithm.
+ */
+struct QuickHullFace {
+
+    /// Indices of the three vertices (counter clockwise when seen from outside)
+    uint vertices[3];
+
+    /// Outward unit normal of the face
+    Vector3 normal;
+
+    /// Distance of the plane of the face to the origin along its normal
+    decimal distance;
+
+    /// Points that are in front of the face and not assigned to another face
+    std::vector<uint> outsidePoints;
+
+    /// Index of the farthest outside point of the face
+    uint farthestPoint;
+
+    /// Distance of the farthest outside point to the plane of the face
+    decimal farthestDistance;
+
+    /// False if the face has been removed from the hull
+    bool isValid;
+
+    /// Constructor
+    QuickHullFace(const std::vector<Vector3>& points, uint v1, uint v2, uint v3)
+        : farthestPoint(0), farthestDistance(0), isValid(true) {
+        vertices[0] = v1;
+        vertices[1] = v2;
+        vertices[2] = v3;
+        normal = (points[v2] - points[v1]).cross(points[v3] - points[v1]);
+        const decimal length = normal.length();
+        if (length > MACHINE_EPSILON) normal /= length;
+        distance = normal.dot(points[v1]);
+    }
+
+    /// Return the signed distance of a point to the plane of the face
+    decimal computeSignedDistance(const Vector3& point) const {
+        return normal.dot(point) - distance;
+    }
+
+    /// Add a point in front of the face
+    void addOutsidePoint(uint pointIndex, decimal pointDistance) {
+        outsidePoints.push_back(pointIndex);
+        if (pointDistance > farthestDistance) {
+            farthestDistance = pointDistance;
+            farthestPoint = pointIndex;
+        }
+    }
+};
+
+// Map from a directed edge (pair of vertex indices) to the face that contains it
+typedef std::map<std::pair<uint, uint>, uint> QuickHullEdgeMap;
+
+// Constructor
+ConvexHull::ConvexHull() {
+
+}
+
+// Destructor
+ConvexHull::~ConvexHull() {
+
+}
+
+// Compute the convex hull of an array of points
+/// The hull is computed with the Quickhull algorithm. Each new vertex of the hull is the
+/// farthest point in front of a face. The faces that this point can see are removed and
+/// replaced by a fan of triangles between the point and the horizon of the removed faces.
+/// If a maximum number of vertices is given, the farthest point in front of all the faces
+/// is added at each step and the algorithm stops when the hull reaches that number of
+/// vertices. The result is then a simplified hull inside the hull of all the points. The
+/// method returns false (and the hull is empty) if the points are all on a plane.
+/**
+ * @param arrayPoints Array with the coordinates of the points
+ * @param nbPoints Number of points in the array
+ * @param stride Stride (in bytes) between the beginning of two points in the array
+ * @param maxNbVertices Maximum number of vertices of the hull (zero for no maximum)
+ * @return True if the hull has been computed
+ */
+bool ConvexHull::compute(const decimal* arrayPoints, uint nbPoints, int stride,
+                         uint maxNbVertices) {
+
+    assert(stride > 0);
+    assert(maxNbVertices == 0 || maxNbVertices >= 4);
+
+    reset();
+
+    if (nbPoints < 4) return false;
+
+    // Copy the points and compute their bounds
+    std::vector<Vector3> points(nbPoints);
+    const unsigned char* pointPointer = (const unsigned char*) arrayPoints;
+    uint extremePoints[6] = {0, 0, 0, 0, 0, 0};
+    for (uint i=0; i<nbPoints; i++) {
+        const decimal* newPoint = (const decimal*) pointPointer;
+        points[i] = Vector3(newPoint[0], newPoint[1], newPoint[2]);
+        pointPointer += stride;
+
+        for (int axis=0; axis<3; axis++) {
+            if (points[i][axis] < points[extremePoints[2 * axis]][axis]) extremePoints[2 * axis] = i;
+            if (points[i][axis] > points[extremePoints[2 * axis + 1]][axis]) extremePoints[2 * axis + 1] = i;
+        }
+    }
+
+    // Distance under which a point is considered to be on a plane
+    Vector3 extent;
+    for (int axis=0; axis<3; axis++) {
+        extent[axis] = points[extremePoints[2 * axis + 1]][axis] - points[extremePoints[2 * axis]][axis];
+    }
+    const decimal tolerance = CONVEX_HULL_RELATIVE_TOLERANCE * extent.length();
+
+    // ---------- Initial tetrahedron ---------- //
+
+    // The two first vertices are the extreme points along the axis with the largest extent
+    const int largestAxis = extent.getMaxAxis();
+    const uint v0 = extremePoints[2 * largestAxis];
+    const uint v1 = extremePoints[2 * largestAxis + 1];
+    const Vector3 lineDirection = points[v1] - points[v0];
+    if (lineDirection.length() <= tolerance) return false;
+
+    // The third vertex is the farthest point from the line of the two first ones
+    uint v2 = v0;
+    decimal maxDistance = decimal(0.0);
+    for (uint i=0; i<nbPoints; i++) {
+        const decimal distance = (points[i] - points[v0]).cross(lineDirection).length();
+        if (distance > maxDistance) {
+            maxDistance = distance;
+            v2 = i;
+        }
+    }
+    if (maxDistance / lineDirection.length() <= tolerance) return false;
+
+    // The fourth vertex is the farthest point from the plane of the three first ones
+    const QuickHullFace baseFace(points, v0, v1, v2);
+    uint v3 = v0;
+    maxDistance = decimal(0.0);
+    for (uint i=0; i<nbPoints; i++) {
+        const decimal distance = std::abs(baseFace.computeSignedDistance(points[i]));
+        if (distance > maxDistance) {
+            maxDistance = distance;
+            v3 = i;
+        }
+    }
+    if (maxDistance <= tolerance) return false;
+
+    std::vector<QuickHullFace> faces;
+    QuickHullEdgeMap edgeToFace;
+    std::vector<uint> nbVertexFaces(nbPoints, 0);
+    uint nbHullVertices = 4;
+
+    // Create the four faces of the tetrahedron with their normals pointing outward
+    const Vector3 insidePoint = decimal(0.25) * (points[v0] + points[v1] + points[v2] + points[v3]);
+    const uint tetrahedron[4][3] = {{v0, v1, v2}, {v0, v1, v3}, {v0, v2, v3}, {v1, v2, v3}};
+    for (int f=0; f<4; f++) {
+        QuickHullFace face(points, tetrahedron[f][0], tetrahedron[f][1], tetrahedron[f][2]);
+        if (face.computeSignedDistance(insidePoint) > decimal(0.0)) {
+            face = QuickHullFace(points, tetrahedron[f][0], tetrahedron[f][2], tetrahedron[f][1]);
+        }
+        faces.push_back(face);
+    }
+    for (uint f=0; f<4; f++) {
+        for (int k=0; k<3; k++) {
+            edgeToFace[std::make_pair(faces[f].vertices[k], faces[f].vertices[(k + 1) % 3])] = f;
+            nbVertexFaces[faces[f].vertices[k]]++;
+        }
+    }
+
+    // Assign each point to a face that it is in front of
+    for (uint i=0; i<nbPoints; i++) {
+        if (i == v0 || i == v1 || i == v2 || i == v3) continue;
+        for (uint f=0; f<4; f++) {
+            const decimal distance = faces[f].computeSignedDistance(points[i]);
+            if (distance > tolerance) {
+                faces[f].addOutsidePoint(i, distance);
+                break;
+            }
+        }
+    }
+
+    // ---------- Add the points to the hull ---------- //
+
+    // Visibility of each face from the current point (0 : unknown, 1 : visible,
+    // 2 : not visible) and the iteration where it has been computed
+    std::vector<int> faceVisibility;
+    std::vector<uint> faceIteration;
+    std::vector<uint> visibleFaces;
+    std::vector<uint> horizonEdges;
+    std::vector<uint> newFaces;
+    uint firstFaceWithPoints = 0;
+    uint iteration = 0;
+
+    while (maxNbVertices == 0 || nbHullVertices < maxNbVertices) {
+
+        iteration++;
+
+        // Select the face to process
+        int selectedFace = -1;
+        if (maxNbVertices > 0) {
+
+            // Select the face with the farthest outside point
+            decimal farthestDistance = decimal(0.0);
+            for (uint f=0; f<faces.size(); f++) {
+                if (faces[f].isValid && !faces[f].outsidePoints.empty() &&
+                    faces[f].farthestDistance > farthestDistance) {
+                    farthestDistance = faces[f].farthestDistance;
+                    selectedFace = f;
+                }
+            }
+        }
+        else {
+
+            // The new faces are added at the end of the array. Therefore, the faces before
+            // the first one with outside points will never have outside points again
+            while (firstFaceWithPoints < faces.size() &&
+                   (!faces[firstFaceWithPoints].isValid ||
+                    faces[firstFaceWithPoints].outsidePoints.empty())) {
+                firstFaceWithPoints++;
+            }
+            if (firstFaceWithPoints < faces.size()) selectedFace = firstFaceWithPoints;
+        }
+
+        // If there is no point outside of the hull anymore
+        if (selectedFace < 0) break;
+
+        const uint eyePoint = faces[selectedFace].farthestPoint;
+        const Vector3& eye = points[eyePoint];
+
+        faceVisibility.resize(faces.size(), 0);
+        faceIteration.resize(faces.size(), 0);
+
+        // Find the faces visible from the point and the horizon edges with a traversal
+        // of the faces from the selected one
+        visibleFaces.clear();
+        horizonEdges.clear();
+        visibleFaces.push_back(selectedFace);
+        faceVisibility[selectedFace] = 1;
+        faceIteration[selectedFace] = iteration;
+        for (uint i=0; i<visibleFaces.size(); i++) {
+
+            const uint face = visibleFaces[i];
+
+            // For each edge of the visible face
+            for (int k=0; k<3; k++) {
+
+                const uint a = faces[face].vertices[k];
+                const uint b = faces[face].vertices[(k + 1) % 3];
+                QuickHullEdgeMap::const_iterator it = edgeToFace.find(std::make_pair(b, a));
+                assert(it != edgeToFace.end());
+                const uint neighbor = it->second;
+
+                // Compute the visibility of the neighbor face
+                if (faceIteration[neighbor] != iteration) {
+                    faceIteration[neighbor] = iteration;
+                    if (faces[neighbor].computeSignedDistance(eye) > decimal(0.0)) {
+                        faceVisibility[neighbor] = 1;
+                        visibleFaces.push_back(neighbor);
+                    }
+                    else {
+                        faceVisibility[neighbor] = 2;
+                    }
+                }
+
+                // If the neighbor face is not visible, the edge is on the horizon
+                if (faceVisibility[neighbor] == 2) {
+                    horizonEdges.push_back(a);
+                    horizonEdges.push_back(b);
+                }
+            }
+        }
+
+        // Remove the visible faces
+        for (uint i=0; i<visibleFaces.size(); i++) {
+            QuickHullFace& face = faces[visibleFaces[i]];
+            face.isValid = false;
+            for (int k=0; k<3; k++) {
+                edgeToFace.erase(std::make_pair(face.vertices[k], face.vertices[(k + 1) % 3]));
+                nbVertexFaces[face.vertices[k]]--;
+                if (nbVertexFaces[face.vertices[k]] == 0) nbHullVertices--;
+            }
+        }
+
+        // Create the new faces between the horizon edges and the point
+        newFaces.clear();
+        for (uint i=0; i<horizonEdges.size(); i += 2) {
+            const uint newFace = static_cast<uint>(faces.size());
+            faces.push_back(QuickHullFace(points, horizonEdges[i], horizonEdges[i + 1], eyePoint));
+            newFaces.push_back(newFace);
+            for (int k=0; k<3; k++) {
+                const uint vertex = faces[newFace].vertices[k];
+                edgeToFace[std::make_pair(vertex, faces[newFace].vertices[(k + 1) % 3])] = newFace;
+                if (nbVertexFaces[vertex] == 0) nbHullVertices++;
+                nbVertexFaces[vertex]++;
+            }
+        }
+
+        // Assign the outside points of the removed faces to the new faces. The points
+        // that are not in front of a new face are inside the hull.
+        for (uint i=0; i<visibleFaces.size(); i++) {
+            std::vector<uint> outsidePoints;
+            outsidePoints.swap(faces[visibleFaces[i]].outsidePoints);
+            for (uint p=0; p<outsidePoints.size(); p++) {
+                if (outsidePoints[p] == eyePoint) continue;
+                for (uint f=0; f<newFaces.size(); f++) {
+                    const decimal distance = faces[newFaces[f]].computeSignedDistance(points[outsidePoints[p]]);
+                    if (distance > tolerance) {
+                        faces[newFaces[f]].addOutsidePoint(outsidePoints[p], distance);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // ---------- Create the final hull ---------- //
+
+    std::vector<uint> hullVertexIndices(nbPoints, 0);
+    std::vector<uint> hullTriangleIndices(faces.size(), 0);
+    for (uint i=0; i<nbPoints; i++) {
+        if (nbVertexFaces[i] > 0) {
+            hullVertexIndices[i] = static_cast<uint>(mVertices.size());
+            mVertices.push_back(points[i]);
+        }
+    }
+    for (uint f=0; f<faces.size(); f++) {
+        if (!faces[f].isValid) continue;
+        hullTriangleIndices[f] = getNbTriangles();
+        for (int k=0; k<3; k++) {
+            mTriangleIndices.push_back(hullVertexIndices[faces[f].vertices[k]]);
+        }
+    }
+    assert(mVertices.size() == nbHullVertices);
+
+    // Compute the triangle neighbors and the edges of the hull
+    for (uint f=0; f<faces.size(); f++) {
+        if (!faces[f].isValid) continue;
+        for (int k=0; k<3; k++) {
+            const uint a = faces[f].vertices[k];
+            const uint b = faces[f].vertices[(k + 1) % 3];
+            QuickHullEdgeMap::const_iterator it = edgeToFace.find(std::make_pair(b, a));
+            assert(it != edgeToFace.end());
+            mTriangleNeighbors.push_back(hullTriangleIndices[it->second]);
+
+            // Each edge is shared by two triangles and is only added once
+            if (a < b) {
+                mEdgeIndices.push_back(hullVertexIndices[a]);
+                mEdgeIndices.push_back(hullVertexIndices[b]);
+            }
+        }
+    }
+
+    return true;
+}
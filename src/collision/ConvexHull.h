@@ -0,0 +1,166 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONVEX_HULL_H
+#define REACTPHYSICS3D_CONVEX_HULL_H
+
+// Libraries
+#include <vector>
+#include <cassert>
+#include "configuration.h"
+#include "mathematics/Vector3.h"
+
+namespace reactphysics3d {
+
+// Constants
+const decimal CONVEX_HULL_RELATIVE_TOLERANCE = decimal(0.00001);
+
+// Class ConvexHull
+/**
+ * This class computes the convex hull of a cloud of 3D points using the Quickhull
+ * algorithm. The resulting hull only contains the points of the cloud that are
+ * corners of the hull. Its faces are triangles whose vertices are in counter
+ * clockwise order when seen from outside of the hull. The hull also contains its
+ * edges and the adjacent triangle of each triangle edge. The number of vertices of
+ * the hull can be limited to a given budget. A ConvexHull object is used to create
+ * a ConvexMeshShape from a cloud of points for instance.
+ */
+class ConvexHull {
+
+    protected:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Vertices of the hull
+        std::vector<Vector3> mVertices;
+
+        /// Indices of the three vertices of each triangle of the hull
+        std::vector<uint> mTriangleIndices;
+
+        /// Index of the triangle on the other side of each edge of each triangle of the
+        /// hull. The edge k of a triangle goes from its vertex k to its vertex (k+1)%3.
+        std::vector<uint> mTriangleNeighbors;
+
+        /// Indices of the two vertices of each edge of the hull
+        std::vector<uint> mEdgeIndices;
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        ConvexHull(const ConvexHull& convexHull);
+
+        /// Private assignment operator
+        ConvexHull& operator=(const ConvexHull& convexHull);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConvexHull();
+
+        /// Destructor
+        ~ConvexHull();
+
+        /// Compute the convex hull of an array of points
+        bool compute(const decimal* arrayPoints, uint nbPoints, int stride,
+                     uint maxNbVertices = 0);
+
+        /// Clear the hull
+        void reset();
+
+        /// Return the number of vertices of the hull
+        uint getNbVertices() const;
+
+        /// Return a vertex of the hull
+        const Vector3& getVertex(uint vertexIndex) const;
+
+        /// Return the number of triangles of the hull
+        uint getNbTriangles() const;
+
+        /// Return the index of a vertex of a triangle of the hull
+        uint getTriangleVertexIndex(uint triangleIndex, uint k) const;
+
+        /// Return the index of the triangle adjacent to an edge of a triangle of the hull
+        uint getTriangleNeighbor(uint triangleIndex, uint k) const;
+
+        /// Return the number of edges of the hull
+        uint getNbEdges() const;
+
+        /// Return the index of a vertex of an edge of the hull
+        uint getEdgeVertexIndex(uint edgeIndex, uint k) const;
+};
+
+// Clear the hull
+inline void ConvexHull::reset() {
+    mVertices.clear();
+    mTriangleIndices.clear();
+    mTriangleNeighbors.clear();
+    mEdgeIndices.clear();
+}
+
+// Return the number of vertices of the hull
+inline uint ConvexHull::getNbVertices() const {
+    return static_cast<uint>(mVertices.size());
+}
+
+// Return a vertex of the hull
+inline const Vector3& ConvexHull::getVertex(uint vertexIndex) const {
+    assert(vertexIndex < mVertices.size());
+    return mVertices[vertexIndex];
+}
+
+// Return the number of triangles of the hull
+inline uint ConvexHull::getNbTriangles() const {
+    return static_cast<uint>(mTriangleIndices.size() / 3);
+}
+
+// Return the index of a vertex (k = 0, 1 or 2) of a triangle of the hull
+inline uint ConvexHull::getTriangleVertexIndex(uint triangleIndex, uint k) const {
+    assert(k < 3 && triangleIndex * 3 + k < mTriangleIndices.size());
+    return mTriangleIndices[triangleIndex * 3 + k];
+}
+
+// Return the index of the triangle adjacent to the edge k (from vertex k to vertex
+// (k+1)%3) of a triangle of the hull
+inline uint ConvexHull::getTriangleNeighbor(uint triangleIndex, uint k) const {
+    assert(k < 3 && triangleIndex * 3 + k < mTriangleNeighbors.size());
+    return mTriangleNeighbors[triangleIndex * 3 + k];
+}
+
+// Return the number of edges of the hull
+inline uint ConvexHull::getNbEdges() const {
+    return static_cast<uint>(mEdgeIndices.size() / 2);
+}
+
+// Return the index of a vertex (k = 0 or 1) of an edge of the hull
+inline uint ConvexHull::getEdgeVertexIndex(uint edgeIndex, uint k) const {
+    assert(k < 2 && edgeIndex * 2 + k < mEdgeIndices.size());
+    return mEdgeIndices[edgeIndex * 2 + k];
+}
+
+}
+
+#endif
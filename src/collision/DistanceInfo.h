@@ -0,0 +1,91 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DISTANCE_INFO_H
+#define REACTPHYSICS3D_DISTANCE_INFO_H
+
+// Libraries
+#include "mathematics/Vector3.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class ProxyShape;
+
+// Structure DistanceInfo
+/**
+ * This structure contains the result of a distance query between two shapes
+ * (see CollisionWorld::computeDistance() and CollisionWorld::computeNearestProxyShape()).
+ * If the two shapes are overlapping, the distance is zero and the points are the
+ * contact points of the shapes (the deepest point of each shape inside the other one).
+ */
+struct DistanceInfo {
+
+    private:
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy constructor
+        DistanceInfo(const DistanceInfo& distanceInfo);
+
+        /// Private assignment operator
+        DistanceInfo& operator=(const DistanceInfo& distanceInfo);
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Distance between the two shapes
+        decimal distance;
+
+        /// Closest point on the first shape in world-space coordinates
+        Vector3 worldPoint1;
+
+        /// Closest point on the second shape in world-space coordinates
+        Vector3 worldPoint2;
+
+        /// Pointer to the first proxy shape (NULL if the query shape is not a proxy shape)
+        ProxyShape* proxyShape1;
+
+        /// Pointer to the second proxy shape
+        ProxyShape* proxyShape2;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DistanceInfo() : distance(DECIMAL_LARGEST), proxyShape1(NULL), proxyShape2(NULL) {
+
+        }
+
+        /// Destructor
+        ~DistanceInfo() {
+
+        }
+};
+
+}
+
+#endif
@@ -167,6 +167,10 @@ class ProxyShape {
         friend class CollisionBody;
         friend class RigidBody;
         friend class BroadPhaseAlgorithm;
+        friend class CompoundProxyShapesCallback;
+        friend class CompoundCullingCallback;
+        friend class CompoundProxyShapesCullingCallback;
+        friend class CompoundNearestCallback;
         friend class DynamicAABBTree;
         friend class CollisionDetection;
         friend class CollisionWorld;
@@ -47,3 +47,31 @@ decimal RaycastTest::raycastAgainstShape(ProxyShape* shape, const Ray& ray) {
 
     return ray.maxFraction;
 }
+
+// Ray cast test of the ray with a given index against a proxy shape
+/// If the shape is hit closer than the current closest hit of the ray, the hit
+/// is stored and the hit fraction is returned to clip the ray for the next shapes.
+decimal RaycastBatchTest::raycastAgainstShape(ProxyShape* shape, uint rayIndex, const Ray& ray) {
+
+    // Ray casting test against the collision shape
+    RaycastInfo raycastInfo;
+    bool isHit = shape->raycast(ray, raycastInfo);
+
+    // If the ray hit the collision shape closer than the current closest hit
+    RaycastBatchHit& hit = hits[rayIndex];
+    if (isHit && (!hit.hasHit || raycastInfo.hitFraction < hit.hitFraction)) {
+
+        hit.hasHit = true;
+        hit.worldPoint = raycastInfo.worldPoint;
+        hit.worldNormal = raycastInfo.worldNormal;
+        hit.hitFraction = raycastInfo.hitFraction;
+        hit.meshSubpart = raycastInfo.meshSubpart;
+        hit.triangleIndex = raycastInfo.triangleIndex;
+        hit.body = raycastInfo.body;
+        hit.proxyShape = raycastInfo.proxyShape;
+
+        return raycastInfo.hitFraction;
+    }
+
+    return ray.maxFraction;
+}
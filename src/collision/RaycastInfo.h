@@ -93,6 +93,50 @@ struct RaycastInfo {
         }
 };
 
+// Structure RaycastBatchHit
+/**
+ * This structure contains the closest hit of a ray of a batch raycast query
+ * (see CollisionWorld::raycastBatch()).
+ */
+struct RaycastBatchHit {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// True if the ray has hit a proxy shape
+        bool hasHit;
+
+        /// Hit point in world-space coordinates
+        Vector3 worldPoint;
+
+        /// Surface normal at hit point in world-space coordinates
+        Vector3 worldNormal;
+
+        /// Fraction distance of the hit point between point1 and point2 of the ray
+        decimal hitFraction;
+
+        /// Mesh subpart index that has been hit (only used for triangles mesh and -1 otherwise)
+        int meshSubpart;
+
+        /// Hit triangle index (only used for triangles mesh and -1 otherwise)
+        int triangleIndex;
+
+        /// Pointer to the hit collision body
+        CollisionBody* body;
+
+        /// Pointer to the hit proxy collision shape
+        ProxyShape* proxyShape;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        RaycastBatchHit() : hasHit(false), hitFraction(decimal(1.0)), meshSubpart(-1),
+                            triangleIndex(-1), body(NULL), proxyShape(NULL) {
+
+        }
+};
+
 // Class RaycastCallback
 /**
  * This class can be used to register a callback for ray casting queries.
@@ -147,6 +191,23 @@ struct RaycastTest {
         decimal raycastAgainstShape(ProxyShape* shape, const Ray& ray);
 };
 
+/// Structure RaycastBatchTest
+struct RaycastBatchTest {
+
+    public:
+
+        /// Array where the closest hit of each ray is written
+        RaycastBatchHit* hits;
+
+        /// Constructor
+        RaycastBatchTest(RaycastBatchHit* batchHits) {
+            hits = batchHits;
+        }
+
+        /// Ray cast test of the ray with a given index against a proxy shape
+        decimal raycastAgainstShape(ProxyShape* shape, uint rayIndex, const Ray& ray);
+};
+
 }
 
 #endif
@@ -31,11 +31,23 @@
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
 
+// Return the AABB that contains a given AABB transformed by a transform
+static AABB transformAABB(const AABB& aabb, const Transform& transform) {
+
+    const Vector3 center = decimal(0.5) * (aabb.getMin() + aabb.getMax());
+    const Vector3 extent = decimal(0.5) * (aabb.getMax() - aabb.getMin());
+
+    const Vector3 newCenter = transform * center;
+    const Vector3 newExtent = transform.getOrientation().getMatrix().getAbsoluteMatrix() * extent;
+
+    return AABB(newCenter - newExtent, newCenter + newExtent);
+}
+
 // Constructor
 BroadPhaseAlgorithm::BroadPhaseAlgorithm(CollisionDetection& collisionDetection)
                     :mDynamicAABBTree(DYNAMIC_TREE_AABB_GAP), mNbMovedShapes(0), mNbAllocatedMovedShapes(8),
                      mNbNonUsedMovedShapes(0), mNbPotentialPairs(0), mNbAllocatedPotentialPairs(8),
-                     mCollisionDetection(collisionDetection) {
+                     mCollisionDetection(collisionDetection), mNbCompounds(0) {
 
     // Allocate memory for the array of non-static proxy shapes IDs
     mMovedShapes = (int*) malloc(mNbAllocatedMovedShapes * sizeof(int));
@@ -54,12 +66,22 @@ BroadPhaseAlgorithm::~BroadPhaseAlgorithm() {
 
     // Release the memory for the array of potential overlapping pairs
     free(mPotentialPairs);
+
+    // Release the remaining compounds
+    for (uint i=0; i<mCompounds.size(); i++) {
+        delete mCompounds[i];
+    }
 }
 
 // Add a collision shape in the array of shapes that have moved in the last simulation step
 // and that need to be tested again for broad-phase overlapping.
 void BroadPhaseAlgorithm::addMovedCollisionShape(int broadPhaseID) {
 
+    // A proxy shape of a body in compound mode is tested with the leaf of its compound
+    if (broadPhaseID >= COMPOUND_PROXY_SHAPE_ID_OFFSET) {
+        broadPhaseID = mCompoundProxyShapes[broadPhaseID - COMPOUND_PROXY_SHAPE_ID_OFFSET].compound->broadPhaseID;
+    }
+
     // Allocate more elements in the array of shapes that have moved if necessary
     if (mNbAllocatedMovedShapes == mNbMovedShapes) {
         mNbAllocatedMovedShapes *= 2;
@@ -117,6 +139,12 @@ void BroadPhaseAlgorithm::removeMovedCollisionShape(int broadPhaseID) {
 // Add a proxy collision shape into the broad-phase collision detection
 void BroadPhaseAlgorithm::addProxyCollisionShape(ProxyShape* proxyShape, const AABB& aabb) {
 
+    // If the body of the proxy shape is in compound mode
+    if (proxyShape->getBody()->isCompoundBroadPhaseEnabled()) {
+        addCompoundProxyShape(proxyShape);
+        return;
+    }
+
     // Add the collision shape into the dynamic AABB tree and get its broad-phase ID
     int nodeId = mDynamicAABBTree.addObject(aabb, proxyShape);
 
@@ -133,6 +161,12 @@ void BroadPhaseAlgorithm::removeProxyCollisionShape(ProxyShape* proxyShape) {
 
     int broadPhaseID = proxyShape->mBroadPhaseID;
 
+    // If the proxy shape belongs to a body in compound mode
+    if (broadPhaseID >= COMPOUND_PROXY_SHAPE_ID_OFFSET) {
+        removeCompoundProxyShape(proxyShape);
+        return;
+    }
+
     // Remove the collision shape from the dynamic AABB tree
     mDynamicAABBTree.removeObject(broadPhaseID);
 
@@ -149,6 +183,23 @@ void BroadPhaseAlgorithm::updateProxyCollisionShape(ProxyShape* proxyShape, cons
 
     assert(broadPhaseID >= 0);
 
+    // If the proxy shape belongs to a body in compound mode
+    if (broadPhaseID >= COMPOUND_PROXY_SHAPE_ID_OFFSET) {
+
+        BroadPhaseCompoundProxy& compoundProxy = mCompoundProxyShapes[broadPhaseID - COMPOUND_PROXY_SHAPE_ID_OFFSET];
+
+        // If the proxy shape has been modified, its AABB in the local tree is updated
+        if (forceReinsert) {
+            AABB localAABB;
+            proxyShape->getCollisionShape()->computeAABB(localAABB, proxyShape->getLocalToBodyTransform());
+            compoundProxy.compound->localTree.updateObject(compoundProxy.localNodeID, localAABB,
+                                                           Vector3(0, 0, 0), true);
+        }
+
+        updateCompoundNode(compoundProxy.compound, displacement, forceReinsert);
+        return;
+    }
+
     // Update the dynamic AABB tree according to the movement of the collision shape
     bool hasBeenReInserted = mDynamicAABBTree.updateObject(broadPhaseID, aabb, displacement, forceReinsert);
 
@@ -162,6 +213,134 @@ void BroadPhaseAlgorithm::updateProxyCollisionShape(ProxyShape* proxyShape, cons
     }
 }
 
+// Add a proxy shape of a body in compound mode
+/// The proxy shape is inserted into the local tree of the compound of its body (with its
+/// AABB in the local-space of the body) and the leaf of the compound in the broad-phase
+/// tree is created or updated.
+void BroadPhaseAlgorithm::addCompoundProxyShape(ProxyShape* proxyShape) {
+
+    CollisionBody* body = proxyShape->getBody();
+
+    // Create the compound of the body if necessary
+    BroadPhaseCompound* compound;
+    if (body->mCompoundBroadPhaseID == -1) {
+        compound = new BroadPhaseCompound(body);
+    }
+    else {
+        compound = mCompounds[body->mCompoundBroadPhaseID];
+    }
+
+    // Allocate a broad-phase ID for the proxy shape
+    int compoundProxyIndex;
+    if (!mFreeCompoundProxyShapeIDs.empty()) {
+        compoundProxyIndex = mFreeCompoundProxyShapeIDs.back();
+        mFreeCompoundProxyShapeIDs.pop_back();
+    }
+    else {
+        compoundProxyIndex = static_cast<int>(mCompoundProxyShapes.size());
+        mCompoundProxyShapes.push_back(BroadPhaseCompoundProxy());
+    }
+    proxyShape->mBroadPhaseID = COMPOUND_PROXY_SHAPE_ID_OFFSET + compoundProxyIndex;
+
+    // Insert the proxy shape into the local tree of the compound
+    AABB localAABB;
+    proxyShape->getCollisionShape()->computeAABB(localAABB, proxyShape->getLocalToBodyTransform());
+    BroadPhaseCompoundProxy& compoundProxy = mCompoundProxyShapes[compoundProxyIndex];
+    compoundProxy.proxyShape = proxyShape;
+    compoundProxy.compound = compound;
+    compoundProxy.localNodeID = compound->localTree.addObject(localAABB, proxyShape);
+
+    // If the compound is not in the broad-phase tree yet
+    if (compound->broadPhaseID == -1) {
+
+        AABB aabb = transformAABB(compound->localTree.getRootAABB(), body->getTransform());
+        compound->broadPhaseID = mDynamicAABBTree.addObject(aabb, compound);
+        body->mCompoundBroadPhaseID = compound->broadPhaseID;
+
+        if (compound->broadPhaseID >= static_cast<int>(mCompounds.size())) {
+            mCompounds.resize(compound->broadPhaseID + 1, NULL);
+        }
+        mCompounds[compound->broadPhaseID] = compound;
+        mNbCompounds++;
+
+        addMovedCollisionShape(compound->broadPhaseID);
+    }
+    else {
+        updateCompoundNode(compound, Vector3(0, 0, 0), true);
+    }
+}
+
+// Remove a proxy shape of a body in compound mode
+/// The compound of the body is destroyed with its last proxy shape.
+void BroadPhaseAlgorithm::removeCompoundProxyShape(ProxyShape* proxyShape) {
+
+    const int compoundProxyIndex = proxyShape->mBroadPhaseID - COMPOUND_PROXY_SHAPE_ID_OFFSET;
+    BroadPhaseCompoundProxy& compoundProxy = mCompoundProxyShapes[compoundProxyIndex];
+    BroadPhaseCompound* compound = compoundProxy.compound;
+
+    // Remove the proxy shape from the local tree of the compound
+    compound->localTree.removeObject(compoundProxy.localNodeID);
+    compoundProxy.proxyShape = NULL;
+    compoundProxy.compound = NULL;
+    mFreeCompoundProxyShapeIDs.push_back(compoundProxyIndex);
+
+    // If the compound still contains proxy shapes
+    if (compound->localTree.getNbNodes() > 0) {
+        updateCompoundNode(compound, Vector3(0, 0, 0), true);
+        return;
+    }
+
+    // Remove the compound from the broad-phase tree
+    const int broadPhaseID = compound->broadPhaseID;
+    mDynamicAABBTree.removeObject(broadPhaseID);
+    removeMovedCollisionShape(broadPhaseID);
+    mCompounds[broadPhaseID] = NULL;
+    mNbCompounds--;
+    compound->body->mCompoundBroadPhaseID = -1;
+    delete compound;
+}
+
+// Update the leaf of a compound in the broad-phase tree
+/// The pairs of the proxy shapes of a compound are computed with their exact AABB (and not
+/// with the fat AABB of the compound). Therefore, the compound is tested again for
+/// overlapping each time it is updated and not only when its leaf has been reinserted.
+void BroadPhaseAlgorithm::updateCompoundNode(BroadPhaseCompound* compound, const Vector3& displacement,
+                                             bool forceReinsert) {
+
+    const AABB aabb = transformAABB(compound->localTree.getRootAABB(), compound->body->getTransform());
+    mDynamicAABBTree.updateObject(compound->broadPhaseID, aabb, displacement, forceReinsert);
+
+    addMovedCollisionShape(compound->broadPhaseID);
+}
+
+// Update the broad-phase state of all the proxy shapes of a body in compound mode
+/// Only the leaf of the compound is updated in the broad-phase tree. The AABBs of the proxy
+/// shapes in the local-space of the body do not change when the body moves.
+void BroadPhaseAlgorithm::updateCompoundBody(const CollisionBody* body, const Vector3& displacement) {
+
+    assert(body->mCompoundBroadPhaseID >= 0);
+
+    updateCompoundNode(mCompounds[body->mCompoundBroadPhaseID], displacement, false);
+}
+
+// Return the world-space AABB of a proxy shape of a compound
+AABB BroadPhaseAlgorithm::computeCompoundProxyShapeAABB(const BroadPhaseCompoundProxy& compoundProxy) const {
+    return transformAABB(compoundProxy.compound->localTree.getFatAABB(compoundProxy.localNodeID),
+                         compoundProxy.compound->body->getTransform());
+}
+
+// Report the proxy shapes of a compound overlapping with a world-space AABB
+void BroadPhaseAlgorithm::reportCompoundProxyShapesOverlappingWithAABB(const BroadPhaseCompound* compound,
+                                                                       const AABB& aabb,
+                                                                       DynamicAABBTreeOverlapCallback& callback) const {
+
+    // Convert the AABB into the local-space of the body
+    const AABB localAABB = transformAABB(aabb, compound->body->getTransform().getInverse());
+
+    CompoundProxyShapesCallback proxyShapesCallback(compound->localTree, callback);
+    compound->localTree.reportAllShapesOverlappingWithAABB(localAABB, proxyShapesCallback);
+}
+
 // Compute all the overlapping pairs of collision shapes
 void BroadPhaseAlgorithm::computeOverlappingPairs() {
 
@@ -189,6 +368,7 @@ void BroadPhaseAlgorithm::computeOverlappingPairs() {
     // Reset the array of collision shapes that have move (or have been created) during the
     // last simulation step
     mNbMovedShapes = 0;
+    mNbNonUsedMovedShapes = 0;
 
     // Sort the array of potential overlapping pairs in order to remove duplicate pairs
     std::sort(mPotentialPairs, mPotentialPairs + mNbPotentialPairs, BroadPhasePair::smallerThan);
@@ -205,8 +385,8 @@ void BroadPhaseAlgorithm::computeOverlappingPairs() {
         assert(pair->collisionShape1ID != pair->collisionShape2ID);
 
         // Get the two collision shapes of the pair
-        ProxyShape* shape1 = static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(pair->collisionShape1ID));
-        ProxyShape* shape2 = static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(pair->collisionShape2ID));
+        ProxyShape* shape1 = getProxyShapeForBroadPhaseId(pair->collisionShape1ID);
+        ProxyShape* shape2 = getProxyShapeForBroadPhaseId(pair->collisionShape2ID);
 
         // Notify the collision detection about the overlapping pair
         mCollisionDetection.broadPhaseNotifyOverlappingPair(shape1, shape2);
@@ -246,6 +426,52 @@ void BroadPhaseAlgorithm::notifyOverlappingNodes(int node1ID, int node2ID) {
     // If both the nodes are the same, we do not create store the overlapping pair
     if (node1ID == node2ID) return;
 
+    const BroadPhaseCompound* compound1 = getCompound(node1ID);
+    const BroadPhaseCompound* compound2 = getCompound(node2ID);
+
+    // If none of the nodes is the leaf of a compound
+    if (compound1 == NULL && compound2 == NULL) {
+        addPotentialPair(node1ID, node2ID);
+        return;
+    }
+
+    // If only one node is the leaf of a compound, the proxy shapes of the compound that
+    // overlap with the other node are paired with it
+    if (compound1 == NULL || compound2 == NULL) {
+        const BroadPhaseCompound* compound = compound1 != NULL ? compound1 : compound2;
+        const int otherNodeID = compound1 != NULL ? node2ID : node1ID;
+
+        mOverlappingCompoundProxyShapeIDs.clear();
+        BroadPhaseCandidatesCallback candidatesCallback(mOverlappingCompoundProxyShapeIDs);
+        reportCompoundProxyShapesOverlappingWithAABB(compound, mDynamicAABBTree.getFatAABB(otherNodeID),
+                                                     candidatesCallback);
+        for (uint i=0; i<mOverlappingCompoundProxyShapeIDs.size(); i++) {
+            addPotentialPair(mOverlappingCompoundProxyShapeIDs[i], otherNodeID);
+        }
+        return;
+    }
+
+    // If both nodes are the leaves of compounds, each proxy shape of the first compound
+    // that overlaps with the second compound is tested with its proxy shapes
+    const AABB& compound2AABB = mDynamicAABBTree.getFatAABB(node2ID);
+    for (const ProxyShape* shape = compound1->body->getProxyShapesList(); shape != NULL;
+         shape = shape->getNext()) {
+
+        const AABB shapeAABB = getFatAABB(shape);
+        if (!shapeAABB.testCollision(compound2AABB)) continue;
+
+        mOverlappingCompoundProxyShapeIDs.clear();
+        BroadPhaseCandidatesCallback candidatesCallback(mOverlappingCompoundProxyShapeIDs);
+        reportCompoundProxyShapesOverlappingWithAABB(compound2, shapeAABB, candidatesCallback);
+        for (uint i=0; i<mOverlappingCompoundProxyShapeIDs.size(); i++) {
+            addPotentialPair(shape->mBroadPhaseID, mOverlappingCompoundProxyShapeIDs[i]);
+        }
+    }
+}
+
+// Add a potential overlapping pair of proxy shapes
+void BroadPhaseAlgorithm::addPotentialPair(int node1ID, int node2ID) {
+
     // If we need to allocate more memory for the array of potential overlapping pairs
     if (mNbPotentialPairs == mNbAllocatedPotentialPairs) {
 
@@ -271,13 +497,116 @@ void AABBOverlapCallback::notifyOverlappingNode(int nodeId) {
     mBroadPhaseAlgorithm.notifyOverlappingNodes(mReferenceNodeId, nodeId);
 }
 
+// Called when a overlapping node has been found during the call to
+// DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+void CompoundOverlapCallback::notifyOverlappingNode(int nodeId) {
+
+    const BroadPhaseCompound* compound = mBroadPhaseAlgorithm.getCompound(nodeId);
+    if (compound == NULL) {
+        mCallback.notifyOverlappingNode(nodeId);
+        return;
+    }
+
+    mBroadPhaseAlgorithm.reportCompoundProxyShapesOverlappingWithAABB(compound, mAABB, mCallback);
+}
+
+// Called for each leaf node that is not culled
+void CompoundCullingCallback::notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside) {
+
+    const BroadPhaseCompound* compound = mBroadPhaseAlgorithm.getCompound(nodeId);
+    if (compound == NULL) {
+        mCallback.notifyNodeInsidePlanes(nodeId, isFullyInside);
+        return;
+    }
+
+    // If the compound is fully inside the volume, so are its proxy shapes
+    if (isFullyInside) {
+        for (const ProxyShape* shape = compound->body->getProxyShapesList(); shape != NULL;
+             shape = shape->getNext()) {
+            mCallback.notifyNodeInsidePlanes(shape->mBroadPhaseID, true);
+        }
+        return;
+    }
+
+    // Convert the planes into the local-space of the body. A point p of the body space is
+    // on a plane if normal.dot(transform * p) = distance.
+    const Transform& transform = compound->body->getTransform();
+    const Quaternion inverseOrientation = transform.getOrientation().getInverse();
+    for (uint i=0; i<mNbPlanes; i++) {
+        mLocalPlanes[i].normal = inverseOrientation * mPlanes[i].normal;
+        mLocalPlanes[i].distance = mPlanes[i].distance - mPlanes[i].normal.dot(transform.getPosition());
+    }
+
+    // Cull the proxy shapes of the compound with its local tree
+    CompoundProxyShapesCullingCallback proxyShapesCallback(compound->localTree, mCallback);
+    compound->localTree.reportAllNodesInsidePlanes(&mLocalPlanes[0], mNbPlanes, proxyShapesCallback);
+}
+
+// Called to compute the distance to a leaf node
+/// The nearest proxy shape of the node is inserted into the sorted array of the nearest
+/// proxy shapes in the same way as the node is inserted by the tree.
+decimal CompoundNearestCallback::computeNodeDistance(int32 nodeId, decimal lowerBoundDistance,
+                                                     decimal maxDistance) {
+
+    decimal nearestDistance;
+    int32 nearestProxyShapeID = nodeId;
+
+    const BroadPhaseCompound* compound = mBroadPhaseAlgorithm.getCompound(nodeId);
+    if (compound == NULL) {
+        nearestDistance = mCallback.computeNodeDistance(nodeId, lowerBoundDistance, maxDistance);
+    }
+    else {
+
+        // The distance to the compound is the smallest distance to its proxy shapes
+        nearestDistance = decimal(-1.0);
+        for (const ProxyShape* shape = compound->body->getProxyShapesList(); shape != NULL;
+             shape = shape->getNext()) {
+
+            const int32 proxyShapeID = shape->mBroadPhaseID;
+            const decimal distance = mCallback.computeNodeDistance(proxyShapeID, lowerBoundDistance,
+                                                                   maxDistance);
+            if (distance >= decimal(0.0) && (nearestDistance < decimal(0.0) || distance < nearestDistance)) {
+                nearestDistance = distance;
+                nearestProxyShapeID = proxyShapeID;
+            }
+        }
+    }
+
+    // If the node will not be inserted by the tree
+    if (nearestDistance < decimal(0.0) || nearestDistance >= maxDistance) return nearestDistance;
+
+    // Insert the proxy shape into the sorted array of the nearest proxy shapes
+    uint index = mNbNearestProxyShapes < mMaxNbNodes ? mNbNearestProxyShapes : mMaxNbNodes - 1;
+    while (index > 0 && mDistances[index - 1] > nearestDistance) {
+        mNearestProxyShapes[index] = mNearestProxyShapes[index - 1];
+        index--;
+    }
+    mNearestProxyShapes[index] = nearestProxyShapeID;
+    if (mNbNearestProxyShapes < mMaxNbNodes) mNbNearestProxyShapes++;
+
+    return nearestDistance;
+}
+
 // Called for a broad-phase shape that has to be tested for raycast
 decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
 
-    decimal hitFraction = decimal(-1.0);
+    // If the node is the leaf of a compound, the ray is tested against its local tree
+    const BroadPhaseCompound* compound = mBroadPhaseAlgorithm.getCompound(nodeId);
+    if (compound != NULL) {
+        const Transform worldToBody = compound->body->getTransform().getInverse();
+        Ray localRay(worldToBody * ray.point1, worldToBody * ray.point2, ray.maxFraction);
+        CompoundRaycastCallback compoundCallback(compound->localTree, ray, this, NULL, 0);
+        compound->localTree.raycast(localRay, compoundCallback);
+        return compoundCallback.getHitFraction();
+    }
+
+    return raycastProxyShape(mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nodeId), ray);
+}
 
-    // Get the proxy shape from the node
-    ProxyShape* proxyShape = static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(nodeId));
+// Ray cast test against a proxy shape
+decimal BroadPhaseRaycastCallback::raycastProxyShape(ProxyShape* proxyShape, const Ray& ray) {
+
+    decimal hitFraction = decimal(-1.0);
 
     // Check if the raycast filtering mask allows raycast against this shape
     if ((mRaycastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) != 0) {
@@ -290,3 +619,62 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
 
     return hitFraction;
 }
+
+// Called for a broad-phase shape that has to be tested for raycast
+decimal BroadPhaseRaycastPacketCallback::raycastBroadPhaseShape(int32 nodeId, uint rayIndex,
+                                                                const Ray& ray) {
+
+    // If the node is the leaf of a compound, the ray is tested against its local tree
+    const BroadPhaseCompound* compound = mBroadPhaseAlgorithm.getCompound(nodeId);
+    if (compound != NULL) {
+        const Transform worldToBody = compound->body->getTransform().getInverse();
+        Ray localRay(worldToBody * ray.point1, worldToBody * ray.point2, ray.maxFraction);
+        CompoundRaycastCallback compoundCallback(compound->localTree, ray, NULL, this, rayIndex);
+        compound->localTree.raycast(localRay, compoundCallback);
+        return compoundCallback.getHitFraction();
+    }
+
+    return raycastProxyShape(mBroadPhaseAlgorithm.getProxyShapeForBroadPhaseId(nodeId), rayIndex, ray);
+}
+
+// Ray cast test of a ray of the batch against a proxy shape
+decimal BroadPhaseRaycastPacketCallback::raycastProxyShape(ProxyShape* proxyShape, uint rayIndex,
+                                                           const Ray& ray) {
+
+    decimal hitFraction = decimal(-1.0);
+
+    // Check if the raycast filtering mask allows raycast against this shape
+    if ((mRaycastWithCategoryMaskBits & proxyShape->getCollisionCategoryBits()) != 0) {
+
+        // Ask the collision detection to perform a ray cast test against
+        // the proxy shape of this node for the given ray of the batch
+        hitFraction = mRaycastBatchTest.raycastAgainstShape(proxyShape, rayIndex, ray);
+    }
+
+    return hitFraction;
+}
+
+// Called for a proxy shape that has to be tested for raycast
+/// The returned value is also used to compute the value to return to the broad-phase
+/// tree: zero if the ray cast must stop, the smallest positive fraction otherwise and -1
+/// if all the proxy shapes have been ignored.
+decimal CompoundRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+
+    ProxyShape* proxyShape = static_cast<ProxyShape*>(mLocalTree.getNodeDataPointer(nodeId));
+
+    // The proxy shape is tested with the world-space ray clipped as the local ray
+    Ray worldRay(mWorldRay.point1, mWorldRay.point2, ray.maxFraction);
+    decimal hitFraction = mRaycastCallback != NULL ?
+                          mRaycastCallback->raycastProxyShape(proxyShape, worldRay) :
+                          mRaycastPacketCallback->raycastProxyShape(proxyShape, mRayIndex, worldRay);
+
+    if (hitFraction == decimal(0.0)) {
+        mHitFraction = decimal(0.0);
+    }
+    else if (hitFraction > decimal(0.0) && mHitFraction != decimal(0.0) &&
+             (mHitFraction < decimal(0.0) || hitFraction < mHitFraction)) {
+        mHitFraction = hitFraction;
+    }
+
+    return hitFraction;
+}
@@ -40,6 +40,55 @@ namespace reactphysics3d {
 class CollisionDetection;
 class BroadPhaseAlgorithm;
 
+/// Smallest broad-phase ID of the proxy shapes of the bodies in compound mode. Those proxy
+/// shapes are not leaves of the broad-phase tree and their IDs are allocated above this value
+/// so that they never collide with the node IDs of the tree.
+const int COMPOUND_PROXY_SHAPE_ID_OFFSET = 1 << 30;
+
+// Structure BroadPhaseCompound
+/**
+ * This structure represents a body in compound mode in the broad-phase. The body is a
+ * single leaf of the broad-phase tree (with the AABB of all its proxy shapes) and its
+ * proxy shapes are stored in a local Dynamic AABB tree in the local-space of the body.
+ */
+struct BroadPhaseCompound {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Body of the compound
+    CollisionBody* body;
+
+    /// Node ID of the leaf of the compound in the broad-phase tree
+    int broadPhaseID;
+
+    /// Dynamic AABB tree with the AABBs of the proxy shapes in the local-space of the body
+    /// (the data of a leaf node is a pointer to the proxy shape)
+    DynamicAABBTree localTree;
+
+    // -------------------- Methods -------------------- //
+
+    /// Constructor
+    BroadPhaseCompound(CollisionBody* compoundBody) : body(compoundBody), broadPhaseID(-1) {
+
+    }
+};
+
+// Structure BroadPhaseCompoundProxy
+/**
+ * This structure represents a proxy shape of a body in compound mode in the broad-phase.
+ */
+struct BroadPhaseCompoundProxy {
+
+    /// Proxy shape (NULL if the broad-phase ID is not used)
+    ProxyShape* proxyShape;
+
+    /// Compound of the body of the proxy shape
+    BroadPhaseCompound* compound;
+
+    /// Node ID of the proxy shape in the local tree of the compound
+    int localNodeID;
+};
+
 // Structure BroadPhasePair
 /**
  * This structure represent a potential overlapping pair during the
@@ -84,6 +133,216 @@ class AABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
 
 };
 
+// Class BroadPhaseCandidatesCallback
+/**
+ * Callback used to gather the broad-phase IDs of all the proxy shapes whose
+ * AABB overlaps with a query AABB in the broad-phase Dynamic AABB Tree.
+ */
+class BroadPhaseCandidatesCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        std::vector<int>& mBroadPhaseIds;
+
+    public:
+
+        // Constructor
+        BroadPhaseCandidatesCallback(std::vector<int>& broadPhaseIds)
+             : mBroadPhaseIds(broadPhaseIds) {
+
+        }
+
+        // Called when a overlapping node has been found during the call to
+        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int nodeId) {
+            mBroadPhaseIds.push_back(nodeId);
+        }
+};
+
+// Class CompoundOverlapCallback
+/**
+ * Callback used to report the proxy shapes (instead of the leaf nodes) overlapping with
+ * a query AABB in the broad-phase tree. The leaf node of a body in compound mode is
+ * replaced by the proxy shapes of the body that overlap with the query AABB.
+ */
+class CompoundOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        /// Query AABB in world-space
+        const AABB& mAABB;
+
+        /// Callback where the proxy shapes are reported
+        DynamicAABBTreeOverlapCallback& mCallback;
+
+    public:
+
+        // Constructor
+        CompoundOverlapCallback(const BroadPhaseAlgorithm& broadPhaseAlgo, const AABB& aabb,
+                                DynamicAABBTreeOverlapCallback& callback)
+             : mBroadPhaseAlgorithm(broadPhaseAlgo), mAABB(aabb), mCallback(callback) {
+
+        }
+
+        // Called when a overlapping node has been found during the call to
+        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int nodeId);
+};
+
+// Class CompoundProxyShapesCallback
+/**
+ * Callback used to report the broad-phase IDs of the proxy shapes of the leaf nodes
+ * found in the local tree of a body in compound mode.
+ */
+class CompoundProxyShapesCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        /// Local tree of the compound
+        const DynamicAABBTree& mLocalTree;
+
+        /// Callback where the broad-phase IDs of the proxy shapes are reported
+        DynamicAABBTreeOverlapCallback& mCallback;
+
+    public:
+
+        // Constructor
+        CompoundProxyShapesCallback(const DynamicAABBTree& localTree,
+                                    DynamicAABBTreeOverlapCallback& callback)
+             : mLocalTree(localTree), mCallback(callback) {
+
+        }
+
+        // Called when a overlapping node has been found during the call to
+        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int nodeId) {
+            const ProxyShape* proxyShape = static_cast<const ProxyShape*>(mLocalTree.getNodeDataPointer(nodeId));
+            mCallback.notifyOverlappingNode(proxyShape->mBroadPhaseID);
+        }
+};
+
+// Class CompoundProxyShapesCullingCallback
+/**
+ * Culling callback used to report the broad-phase IDs of the proxy shapes of the leaf
+ * nodes found in the local tree of a body in compound mode.
+ */
+class CompoundProxyShapesCullingCallback : public DynamicAABBTreeCullingCallback {
+
+    private:
+
+        /// Local tree of the compound
+        const DynamicAABBTree& mLocalTree;
+
+        /// Callback where the broad-phase IDs of the proxy shapes are reported
+        DynamicAABBTreeCullingCallback& mCallback;
+
+    public:
+
+        // Constructor
+        CompoundProxyShapesCullingCallback(const DynamicAABBTree& localTree,
+                                           DynamicAABBTreeCullingCallback& callback)
+             : mLocalTree(localTree), mCallback(callback) {
+
+        }
+
+        // Called for each leaf node that is not culled
+        virtual void notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside) {
+            const ProxyShape* proxyShape = static_cast<const ProxyShape*>(mLocalTree.getNodeDataPointer(nodeId));
+            mCallback.notifyNodeInsidePlanes(proxyShape->mBroadPhaseID, isFullyInside);
+        }
+};
+
+// Class CompoundCullingCallback
+/**
+ * Culling callback that replaces the leaf node of a body in compound mode by the
+ * proxy shapes of the body that are not culled by the planes.
+ */
+class CompoundCullingCallback : public DynamicAABBTreeCullingCallback {
+
+    private:
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        /// World-space planes bounding the volume
+        const Plane* mPlanes;
+
+        /// Number of planes
+        uint mNbPlanes;
+
+        /// Planes converted into the local-space of the current compound
+        std::vector<Plane> mLocalPlanes;
+
+        /// Callback where the proxy shapes are reported
+        DynamicAABBTreeCullingCallback& mCallback;
+
+    public:
+
+        // Constructor
+        CompoundCullingCallback(const BroadPhaseAlgorithm& broadPhaseAlgo,
+                                const Plane* planes, uint nbPlanes,
+                                DynamicAABBTreeCullingCallback& callback)
+             : mBroadPhaseAlgorithm(broadPhaseAlgo), mPlanes(planes), mNbPlanes(nbPlanes),
+               mLocalPlanes(nbPlanes), mCallback(callback) {
+
+        }
+
+        // Called for each leaf node that is not culled
+        virtual void notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside);
+};
+
+// Class CompoundNearestCallback
+/**
+ * Nearest neighbor callback that computes the distance to the leaf node of a body in
+ * compound mode as the smallest distance to the proxy shapes of the body. The nearest
+ * proxy shape of the body is recorded to replace the leaf node in the results. The
+ * recorded proxy shapes are sorted like the nearest nodes in
+ * DynamicAABBTree::reportNearestNodes() so that they have the same indices.
+ */
+class CompoundNearestCallback : public DynamicAABBTreeNearestCallback {
+
+    private:
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        /// Callback used to compute the distances to the proxy shapes
+        DynamicAABBTreeNearestCallback& mCallback;
+
+        /// Broad-phase IDs of the nearest proxy shapes (one for each nearest node)
+        int32* mNearestProxyShapes;
+
+        /// Distances of the nearest nodes found by the tree
+        const decimal* mDistances;
+
+        /// Maximum number of nearest nodes
+        uint mMaxNbNodes;
+
+        /// Number of nearest proxy shapes
+        uint mNbNearestProxyShapes;
+
+    public:
+
+        // Constructor
+        CompoundNearestCallback(const BroadPhaseAlgorithm& broadPhaseAlgo,
+                                DynamicAABBTreeNearestCallback& callback, int32* nearestProxyShapes,
+                                const decimal* distances, uint maxNbNodes)
+             : mBroadPhaseAlgorithm(broadPhaseAlgo), mCallback(callback),
+               mNearestProxyShapes(nearestProxyShapes), mDistances(distances),
+               mMaxNbNodes(maxNbNodes), mNbNearestProxyShapes(0) {
+
+        }
+
+        // Called to compute the distance to a leaf node
+        virtual decimal computeNodeDistance(int32 nodeId, decimal lowerBoundDistance,
+                                            decimal maxDistance);
+
+        /// Return the broad-phase ID of the proxy shape of a given nearest node
+        int32 getProxyShapeID(uint index) const {
+            return mNearestProxyShapes[index];
+        }
+};
+
 // Class BroadPhaseRaycastCallback
 /**
  * Callback called when the AABB of a leaf node is hit by a ray the
@@ -93,7 +352,7 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
     private :
 
-        const DynamicAABBTree& mDynamicAABBTree;
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
 
         unsigned short mRaycastWithCategoryMaskBits;
 
@@ -102,9 +361,9 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
     public:
 
         // Constructor
-        BroadPhaseRaycastCallback(const DynamicAABBTree& dynamicAABBTree, unsigned short raycastWithCategoryMaskBits,
+        BroadPhaseRaycastCallback(const BroadPhaseAlgorithm& broadPhaseAlgo, unsigned short raycastWithCategoryMaskBits,
                                   RaycastTest& raycastTest)
-            : mDynamicAABBTree(dynamicAABBTree), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
+            : mBroadPhaseAlgorithm(broadPhaseAlgo), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
               mRaycastTest(raycastTest) {
 
         }
@@ -112,6 +371,90 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
         // Called for a broad-phase shape that has to be tested for raycast
         virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray);
 
+        /// Ray cast test against a proxy shape
+        decimal raycastProxyShape(ProxyShape* proxyShape, const Ray& ray);
+};
+
+// Class BroadPhaseRaycastPacketCallback
+/**
+ * Callback called when the AABB of a leaf node is hit by one of the rays
+ * of a ray packet in the broad-phase Dynamic AABB Tree.
+ */
+class BroadPhaseRaycastPacketCallback : public DynamicAABBTreeRaycastPacketCallback {
+
+    private :
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        unsigned short mRaycastWithCategoryMaskBits;
+
+        RaycastBatchTest& mRaycastBatchTest;
+
+    public:
+
+        // Constructor
+        BroadPhaseRaycastPacketCallback(const BroadPhaseAlgorithm& broadPhaseAlgo,
+                                        unsigned short raycastWithCategoryMaskBits,
+                                        RaycastBatchTest& raycastBatchTest)
+            : mBroadPhaseAlgorithm(broadPhaseAlgo), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
+              mRaycastBatchTest(raycastBatchTest) {
+
+        }
+
+        // Called for a broad-phase shape that has to be tested for raycast
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, uint rayIndex, const Ray& ray);
+
+        /// Ray cast test of a ray of the batch against a proxy shape
+        decimal raycastProxyShape(ProxyShape* proxyShape, uint rayIndex, const Ray& ray);
+};
+
+// Class CompoundRaycastCallback
+/**
+ * Callback called when the AABB of a proxy shape is hit by a ray in the local tree
+ * of a body in compound mode. The proxy shape is tested with the ray in world-space
+ * using the broad-phase raycast callback (single ray or ray of a batch).
+ */
+class CompoundRaycastCallback : public DynamicAABBTreeRaycastCallback {
+
+    private :
+
+        /// Local tree of the compound
+        const DynamicAABBTree& mLocalTree;
+
+        /// Ray in world-space
+        const Ray& mWorldRay;
+
+        /// Broad-phase callback for a single ray (NULL for a batch of rays)
+        BroadPhaseRaycastCallback* mRaycastCallback;
+
+        /// Broad-phase callback for a batch of rays (NULL for a single ray)
+        BroadPhaseRaycastPacketCallback* mRaycastPacketCallback;
+
+        /// Index of the ray in the batch
+        uint mRayIndex;
+
+        /// Value to return to the broad-phase tree (-1 if no proxy shape has been hit)
+        decimal mHitFraction;
+
+    public:
+
+        // Constructor
+        CompoundRaycastCallback(const DynamicAABBTree& localTree, const Ray& worldRay,
+                                BroadPhaseRaycastCallback* raycastCallback,
+                                BroadPhaseRaycastPacketCallback* raycastPacketCallback, uint rayIndex)
+            : mLocalTree(localTree), mWorldRay(worldRay), mRaycastCallback(raycastCallback),
+              mRaycastPacketCallback(raycastPacketCallback), mRayIndex(rayIndex),
+              mHitFraction(decimal(-1.0)) {
+
+        }
+
+        // Called for a proxy shape that has to be tested for raycast
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray);
+
+        /// Return the value to return to the broad-phase tree
+        decimal getHitFraction() const {
+            return mHitFraction;
+        }
 };
 
 // Class BroadPhaseAlgorithm
@@ -159,6 +502,24 @@ class BroadPhaseAlgorithm {
 
         /// Reference to the collision detection object
         CollisionDetection& mCollisionDetection;
+
+        /// Compounds of the bodies in compound mode indexed by the node ID of their leaf in
+        /// the broad-phase tree (NULL for the other nodes)
+        std::vector<BroadPhaseCompound*> mCompounds;
+
+        /// Number of bodies in compound mode
+        uint mNbCompounds;
+
+        /// Proxy shapes of the bodies in compound mode indexed by their broad-phase ID
+        /// (minus COMPOUND_PROXY_SHAPE_ID_OFFSET)
+        std::vector<BroadPhaseCompoundProxy> mCompoundProxyShapes;
+
+        /// Broad-phase IDs of the proxy shapes of compounds that can be reused
+        std::vector<int> mFreeCompoundProxyShapeIDs;
+
+        /// Scratch array with the broad-phase IDs of the proxy shapes of a compound that
+        /// overlap with a node (cleared for each pair but its memory is kept)
+        std::vector<int> mOverlappingCompoundProxyShapeIDs;
         
         // -------------------- Methods -------------------- //
 
@@ -168,6 +529,22 @@ class BroadPhaseAlgorithm {
         /// Private assignment operator
         BroadPhaseAlgorithm& operator=(const BroadPhaseAlgorithm& algorithm);
 
+        /// Add a proxy shape of a body in compound mode
+        void addCompoundProxyShape(ProxyShape* proxyShape);
+
+        /// Remove a proxy shape of a body in compound mode
+        void removeCompoundProxyShape(ProxyShape* proxyShape);
+
+        /// Update the leaf of a compound in the broad-phase tree
+        void updateCompoundNode(BroadPhaseCompound* compound, const Vector3& displacement,
+                                bool forceReinsert);
+
+        /// Return the world-space AABB of a proxy shape of a compound
+        AABB computeCompoundProxyShapeAABB(const BroadPhaseCompoundProxy& compoundProxy) const;
+
+        /// Add a potential overlapping pair of proxy shapes
+        void addPotentialPair(int broadPhaseId1, int broadPhaseId2);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -208,6 +585,41 @@ class BroadPhaseAlgorithm {
         /// Ray casting method
         void raycast(const Ray& ray, RaycastTest& raycastTest,
                      unsigned short raycastWithCategoryMaskBits) const;
+
+        /// Ray casting method for a batch of rays
+        void raycastBatch(const Ray* rays, uint nbRays, RaycastBatchTest& raycastBatchTest,
+                          unsigned short raycastWithCategoryMaskBits) const;
+
+        /// Report all the proxy shapes whose fat AABB overlaps with a given AABB
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                                DynamicAABBTreeOverlapCallback& callback) const;
+
+        /// Report the proxy shapes that are inside or intersect the volume bounded by planes
+        void reportAllShapesInsidePlanes(const Plane* planes, uint nbPlanes,
+                                         DynamicAABBTreeCullingCallback& callback) const;
+
+        /// Report the nearest proxy shapes to a given AABB within a maximum distance
+        uint reportNearestShapes(const AABB& aabb, uint maxNbShapes, decimal maxDistance,
+                                 DynamicAABBTreeNearestCallback& callback, int32* nearestNodes,
+                                 decimal* distances, int32* nearestLeafNodes) const;
+
+        /// Return the proxy shape corresponding to a given broad-phase ID
+        ProxyShape* getProxyShapeForBroadPhaseId(int broadPhaseId) const;
+
+        /// Return the fat AABB of a given proxy shape
+        AABB getFatAABB(const ProxyShape* shape) const;
+
+        /// Update the broad-phase state of all the proxy shapes of a body in compound mode
+        void updateCompoundBody(const CollisionBody* body, const Vector3& displacement);
+
+        /// Return the compound of a leaf node of the broad-phase tree (NULL if the node is
+        /// not the leaf of a body in compound mode)
+        const BroadPhaseCompound* getCompound(int nodeID) const;
+
+        /// Report the proxy shapes of a compound overlapping with a world-space AABB
+        void reportCompoundProxyShapesOverlappingWithAABB(const BroadPhaseCompound* compound,
+                                                          const AABB& aabb,
+                                                          DynamicAABBTreeOverlapCallback& callback) const;
 };
 
 // Method used to compare two pairs for sorting algorithm
@@ -224,24 +636,108 @@ inline bool BroadPhasePair::smallerThan(const BroadPhasePair& pair1, const Broad
 inline bool BroadPhaseAlgorithm::testOverlappingShapes(const ProxyShape* shape1,
                                                        const ProxyShape* shape2) const {
     // Get the two AABBs of the collision shapes
-    const AABB& aabb1 = mDynamicAABBTree.getFatAABB(shape1->mBroadPhaseID);
-    const AABB& aabb2 = mDynamicAABBTree.getFatAABB(shape2->mBroadPhaseID);
+    const AABB aabb1 = getFatAABB(shape1);
+    const AABB aabb2 = getFatAABB(shape2);
 
     // Check if the two AABBs are overlapping
     return aabb1.testCollision(aabb2);
 }
 
+// Report all the proxy shapes whose fat AABB overlaps with a given AABB
+/// The leaf of a body in compound mode is replaced by the proxy shapes of the body
+/// that overlap with the AABB.
+inline void BroadPhaseAlgorithm::reportAllShapesOverlappingWithAABB(const AABB& aabb,
+                                               DynamicAABBTreeOverlapCallback& callback) const {
+    if (mNbCompounds == 0) {
+        mDynamicAABBTree.reportAllShapesOverlappingWithAABB(aabb, callback);
+        return;
+    }
+
+    CompoundOverlapCallback compoundCallback(*this, aabb, callback);
+    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(aabb, compoundCallback);
+}
+
+// Report the proxy shapes that are inside or intersect the volume bounded by planes
+/// The leaf of a body in compound mode is replaced by all the proxy shapes of the body.
+inline void BroadPhaseAlgorithm::reportAllShapesInsidePlanes(const Plane* planes, uint nbPlanes,
+                                                             DynamicAABBTreeCullingCallback& callback) const {
+    if (mNbCompounds == 0) {
+        mDynamicAABBTree.reportAllNodesInsidePlanes(planes, nbPlanes, callback);
+        return;
+    }
+
+    CompoundCullingCallback compoundCallback(*this, planes, nbPlanes, callback);
+    mDynamicAABBTree.reportAllNodesInsidePlanes(planes, nbPlanes, compoundCallback);
+}
+
+// Report the nearest proxy shapes to a given AABB within a maximum distance
+/// Only the nearest proxy shape of a body in compound mode can be reported. The array
+/// nearestLeafNodes (maxNbShapes elements) is used to store the nearest leaf nodes of the
+/// tree when there are compounds.
+inline uint BroadPhaseAlgorithm::reportNearestShapes(const AABB& aabb, uint maxNbShapes,
+                                                     decimal maxDistance,
+                                                     DynamicAABBTreeNearestCallback& callback,
+                                                     int32* nearestNodes, decimal* distances,
+                                                     int32* nearestLeafNodes) const {
+    if (mNbCompounds == 0) {
+        return mDynamicAABBTree.reportNearestNodes(aabb, maxNbShapes, maxDistance, callback,
+                                                   nearestNodes, distances);
+    }
+
+    // The proxy shapes are directly written in the output array by the callback
+    CompoundNearestCallback compoundCallback(*this, callback, nearestNodes, distances, maxNbShapes);
+    return mDynamicAABBTree.reportNearestNodes(aabb, maxNbShapes, maxDistance, compoundCallback,
+                                               nearestLeafNodes, distances);
+}
+
+// Return the proxy shape corresponding to a given broad-phase ID
+inline ProxyShape* BroadPhaseAlgorithm::getProxyShapeForBroadPhaseId(int broadPhaseId) const {
+    if (broadPhaseId >= COMPOUND_PROXY_SHAPE_ID_OFFSET) {
+        return mCompoundProxyShapes[broadPhaseId - COMPOUND_PROXY_SHAPE_ID_OFFSET].proxyShape;
+    }
+    return static_cast<ProxyShape*>(mDynamicAABBTree.getNodeDataPointer(broadPhaseId));
+}
+
+// Return the fat AABB of a given proxy shape
+/// The AABB of a proxy shape of a body in compound mode is computed from its AABB in the
+/// local-space of the body.
+inline AABB BroadPhaseAlgorithm::getFatAABB(const ProxyShape* shape) const {
+    if (shape->mBroadPhaseID >= COMPOUND_PROXY_SHAPE_ID_OFFSET) {
+        return computeCompoundProxyShapeAABB(
+                    mCompoundProxyShapes[shape->mBroadPhaseID - COMPOUND_PROXY_SHAPE_ID_OFFSET]);
+    }
+    return mDynamicAABBTree.getFatAABB(shape->mBroadPhaseID);
+}
+
+// Return the compound of a leaf node of the broad-phase tree
+inline const BroadPhaseCompound* BroadPhaseAlgorithm::getCompound(int nodeID) const {
+    return nodeID < static_cast<int>(mCompounds.size()) ? mCompounds[nodeID] : NULL;
+}
+
 // Ray casting method
 inline void BroadPhaseAlgorithm::raycast(const Ray& ray, RaycastTest& raycastTest,
                                          unsigned short raycastWithCategoryMaskBits) const {
 
     PROFILE("BroadPhaseAlgorithm::raycast()");
 
-    BroadPhaseRaycastCallback broadPhaseRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastTest);
+    BroadPhaseRaycastCallback broadPhaseRaycastCallback(*this, raycastWithCategoryMaskBits, raycastTest);
 
     mDynamicAABBTree.raycast(ray, broadPhaseRaycastCallback);
 }
 
+// Ray casting method for a batch of rays
+inline void BroadPhaseAlgorithm::raycastBatch(const Ray* rays, uint nbRays,
+                                              RaycastBatchTest& raycastBatchTest,
+                                              unsigned short raycastWithCategoryMaskBits) const {
+
+    PROFILE("BroadPhaseAlgorithm::raycastBatch()");
+
+    BroadPhaseRaycastPacketCallback broadPhaseRaycastCallback(*this, raycastWithCategoryMaskBits,
+                                                              raycastBatchTest);
+
+    mDynamicAABBTree.raycastBatch(rays, nbRays, broadPhaseRaycastCallback);
+}
+
 }
 
 #endif
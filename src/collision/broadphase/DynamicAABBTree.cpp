@@ -28,12 +28,125 @@
 #include "BroadPhaseAlgorithm.h"
 #include "memory/Stack.h"
 #include "engine/Profiler.h"
+#include <vector>
+#include <algorithm>
+#include <functional>
 
 using namespace reactphysics3d;
 
 // Initialization of static variables
 const int TreeNode::NULL_TREE_NODE = -1;
 
+// Magic number at the beginning of a serialized tree ("RPBV")
+static const uint32 DYNAMIC_AABB_TREE_SERIALIZATION_MAGIC = 0x56425052;
+
+// Structure DynamicAABBTreeSerializationHeader
+/**
+ * Header written at the beginning of a serialized dynamic AABB tree. The
+ * node array of the tree is written just after it.
+ */
+struct DynamicAABBTreeSerializationHeader {
+
+    /// Magic number used to recognize a serialized tree
+    uint32 magic;
+
+    /// Version of the serialization format
+    uint32 version;
+
+    /// Size (in bytes) of a decimal value (float or double precision)
+    uint32 decimalSize;
+
+    /// Size (in bytes) of a tree node
+    uint32 nodeSize;
+
+    /// Number of allocated nodes
+    int32 nbAllocatedNodes;
+
+    /// Number of nodes in the tree
+    int32 nbNodes;
+
+    /// ID of the root node
+    int32 rootNodeID;
+
+    /// ID of the first free node
+    int32 freeNodeID;
+};
+
+// Return true if the nodes of a serialized tree form a valid tree and a valid free list
+/// Each node reachable from the root is visited once. The children and parent IDs and the
+/// heights of the nodes are checked, as well as the data of the leaves (with the callback).
+/// The remaining nodes must all be in the free list.
+static bool isSerializedTreeValid(const TreeNode* nodes, const DynamicAABBTreeSerializationHeader& header,
+                                  const DynamicAABBTreeDeserializeCallback* callback) {
+
+    const int32 nbAllocatedNodes = header.nbAllocatedNodes;
+    std::vector<bool> isNodeVisited(nbAllocatedNodes, false);
+    int32 nbVisitedNodes = 0;
+
+    // Walk the tree from the root
+    if (header.rootNodeID != TreeNode::NULL_TREE_NODE) {
+
+        if (nodes[header.rootNodeID].parentID != TreeNode::NULL_TREE_NODE) return false;
+
+        // A node is pushed only by its parent (checked with the parent ID of the node).
+        // Therefore, each node is pushed at most once.
+        std::vector<int32> stack;
+        stack.push_back(header.rootNodeID);
+        while (!stack.empty()) {
+
+            const int32 nodeID = stack.back();
+            stack.pop_back();
+
+            if (isNodeVisited[nodeID]) return false;
+            isNodeVisited[nodeID] = true;
+            nbVisitedNodes++;
+
+            const TreeNode& node = nodes[nodeID];
+            if (node.height < 0) return false;
+
+            // If the node is a leaf, we check its data
+            if (node.isLeaf()) {
+                if (callback != NULL && !callback->isLeafDataValid(node.dataInt[0], node.dataInt[1])) {
+                    return false;
+                }
+                continue;
+            }
+
+            // Check the children of the internal node
+            int maxChildHeight = -1;
+            for (int i=0; i<2; i++) {
+                const int32 childID = node.children[i];
+                if (childID < 0 || childID >= nbAllocatedNodes ||
+                    nodes[childID].parentID != nodeID) {
+                    return false;
+                }
+                maxChildHeight = std::max(maxChildHeight, int(nodes[childID].height));
+                stack.push_back(childID);
+            }
+            if (node.height != maxChildHeight + 1) return false;
+        }
+    }
+
+    if (nbVisitedNodes != header.nbNodes) return false;
+
+    // Walk the free list
+    int32 freeNodeID = header.freeNodeID;
+    while (freeNodeID != TreeNode::NULL_TREE_NODE) {
+
+        if (freeNodeID < 0 || freeNodeID >= nbAllocatedNodes || isNodeVisited[freeNodeID] ||
+            nodes[freeNodeID].height != -1) {
+            return false;
+        }
+        isNodeVisited[freeNodeID] = true;
+        nbVisitedNodes++;
+
+        freeNodeID = nodes[freeNodeID].nextNodeID;
+    }
+
+    // All the nodes are either in the tree or in the free list
+    return nbVisitedNodes == nbAllocatedNodes;
+}
+
 // Constructor
 DynamicAABBTree::DynamicAABBTree(decimal extraAABBGap) : mExtraAABBGap(extraAABBGap) {
 
@@ -692,6 +805,485 @@ void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback &ca
     }
 }
 
+// Element of the stack used to traverse the tree with a packet of rays
+struct RaycastPacketStackElement {
+
+    /// ID of the node to visit
+    int nodeID;
+
+    /// Bit mask of the rays of the packet that have hit the AABBs of all the ancestors of the node
+    uint32 raysMask;
+};
+
+// Ray casting method for a batch of rays traversed as ray packets
+/// The rays are processed in blocks of RAYCAST_BATCH_BLOCK_SIZE rays. The rays of a block
+/// are grouped by the signs of their direction and split into packets of at most
+/// RAYCAST_PACKET_SIZE rays. Each packet is then traversed as a whole : a node is tested
+/// against all the rays of the packet that have reached it before its children are visited.
+/// For coherent rays, a node is therefore fetched only once per packet instead of once per
+/// ray. As in the raycast() method, the value returned by the callback for a ray is used to
+/// clip (positive value), stop (zero) or ignore the hit (negative value) for this ray only.
+/**
+ * @param rays Array with the rays to cast
+ * @param nbRays Number of rays in the array
+ * @param callback Callback called with the index of the ray when a leaf node is hit
+ */
+void DynamicAABBTree::raycastBatch(const Ray* rays, uint nbRays,
+                                   DynamicAABBTreeRaycastPacketCallback& callback) const {
+
+    PROFILE("DynamicAABBTree::raycastBatch()");
+
+    if (nbRays == 0 || mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    Vector3 inverseDirections[RAYCAST_PACKET_SIZE];
+    decimal maxFractions[RAYCAST_PACKET_SIZE];
+    uint sortedRays[RAYCAST_BATCH_BLOCK_SIZE];
+
+    Stack<RaycastPacketStackElement, 64> stack;
+
+    // For each block of rays
+    for (uint blockStart = 0; blockStart < nbRays; blockStart += RAYCAST_BATCH_BLOCK_SIZE) {
+
+        const uint nbBlockRays = std::min(RAYCAST_BATCH_BLOCK_SIZE, nbRays - blockStart);
+
+        // Sort the rays of the block by the octant of their direction (counting sort) so
+        // that the rays of a packet go in similar directions
+        uint octantsStart[9] = {0};
+        for (uint i=blockStart; i<blockStart + nbBlockRays; i++) {
+            const Vector3 direction = rays[i].point2 - rays[i].point1;
+            const uint octant = (direction.x < 0 ? 1 : 0) | (direction.y < 0 ? 2 : 0) | (direction.z < 0 ? 4 : 0);
+            octantsStart[octant + 1]++;
+        }
+        for (uint o=0; o<8; o++) {
+            octantsStart[o + 1] += octantsStart[o];
+        }
+        for (uint i=blockStart; i<blockStart + nbBlockRays; i++) {
+            const Vector3 direction = rays[i].point2 - rays[i].point1;
+            const uint octant = (direction.x < 0 ? 1 : 0) | (direction.y < 0 ? 2 : 0) | (direction.z < 0 ? 4 : 0);
+            sortedRays[octantsStart[octant]++] = i;
+        }
+
+        // For each packet of rays
+        for (uint packetStart = 0; packetStart < nbBlockRays; packetStart += RAYCAST_PACKET_SIZE) {
+
+            const uint* packetRays = &(sortedRays[packetStart]);
+            const uint nbPacketRays = std::min(RAYCAST_PACKET_SIZE, nbBlockRays - packetStart);
+
+            // Precompute the inverse directions of the rays of the packet
+            uint32 activeRaysMask = 0;
+            for (uint r=0; r<nbPacketRays; r++) {
+                const Ray& ray = rays[packetRays[r]];
+                const Vector3 direction = ray.point2 - ray.point1;
+                for (int i=0; i<3; i++) {
+                    inverseDirections[r][i] = std::abs(direction[i]) > MACHINE_EPSILON ?
+                                              decimal(1.0) / direction[i] :
+                                              (direction[i] < 0 ? DECIMAL_SMALLEST : DECIMAL_LARGEST);
+                }
+                maxFractions[r] = ray.maxFraction;
+                activeRaysMask |= (uint32(1) << r);
+            }
+
+            RaycastPacketStackElement rootElement;
+            rootElement.nodeID = mRootNodeID;
+            rootElement.raysMask = activeRaysMask;
+            stack.push(rootElement);
+
+            // Walk through the tree from the root with the whole packet
+            while (stack.getNbElements() > 0) {
+
+                const RaycastPacketStackElement element = stack.pop();
+
+                // Rays that have been stopped by the callback are not tested anymore
+                const uint32 raysMask = element.raysMask & activeRaysMask;
+                if (raysMask == 0) continue;
+
+                const TreeNode* node = mNodes + element.nodeID;
+
+                // Test the rays of the packet against the node AABB
+                uint32 hitRaysMask = 0;
+                for (uint r=0; r<nbPacketRays; r++) {
+                    const uint32 rayBit = uint32(1) << r;
+                    if ((raysMask & rayBit) != 0 &&
+                        node->aabb.testRayIntersect(rays[packetRays[r]].point1, inverseDirections[r],
+                                                    maxFractions[r])) {
+                        hitRaysMask |= rayBit;
+                    }
+                }
+                if (hitRaysMask == 0) continue;
+
+                // If the node is a leaf of the tree
+                if (node->isLeaf()) {
+
+                    for (uint r=0; r<nbPacketRays; r++) {
+
+                        const uint32 rayBit = uint32(1) << r;
+                        if ((hitRaysMask & rayBit) == 0) continue;
+
+                        const Ray& ray = rays[packetRays[r]];
+                        Ray rayTemp(ray.point1, ray.point2, maxFractions[r]);
+
+                        // Call the callback that will raycast again the broad-phase shape
+                        decimal hitFraction = callback.raycastBroadPhaseShape(element.nodeID,
+                                                                              packetRays[r], rayTemp);
+
+                        // If the user returned a hitFraction of zero, the raycasting
+                        // of this ray should stop here
+                        if (hitFraction == decimal(0.0)) {
+                            activeRaysMask &= ~rayBit;
+                        }
+                        else if (hitFraction > decimal(0.0) && hitFraction < maxFractions[r]) {
+                            maxFractions[r] = hitFraction;
+                        }
+                    }
+                }
+                else {  // If the node has children
+
+                    // Push its children in the stack of nodes to explore with the rays that hit the node
+                    for (int c=0; c<2; c++) {
+                        if (node->children[c] == TreeNode::NULL_TREE_NODE) continue;
+                        RaycastPacketStackElement childElement;
+                        childElement.nodeID = node->children[c];
+                        childElement.raysMask = hitRaysMask;
+                        stack.push(childElement);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Element of the stack used to traverse the tree with a set of culling planes
+struct CullingStackElement {
+
+    /// ID of the node to visit
+    int32 nodeID;
+
+    /// Bit mask of the planes that the AABBs of the ancestors of the node intersect
+    uint32 planesMask;
+};
+
+// Report the leaf nodes that are inside or intersect the volume bounded by planes
+/// The volume is the intersection of the negative half-spaces of the planes (the normals
+/// point outward as for a view frustum). A node that is outside one of the planes is culled
+/// with its whole subtree. When the AABB of a node is inside a plane, this plane does not
+/// need to be tested against its children anymore. When it is inside all the planes, all the
+/// leaves of its subtree are reported as fully inside without any other test.
+/**
+ * @param planes Array of planes (at most 32 planes)
+ * @param nbPlanes Number of planes
+ * @param callback Callback called for each leaf node that is not culled
+ */
+void DynamicAABBTree::reportAllNodesInsidePlanes(const Plane* planes, uint nbPlanes,
+                                                 DynamicAABBTreeCullingCallback& callback) const {
+
+    PROFILE("DynamicAABBTree::reportAllNodesInsidePlanes()");
+
+    assert(nbPlanes <= 32);
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    const uint32 allPlanesMask = nbPlanes == 32 ? 0xFFFFFFFF : (uint32(1) << nbPlanes) - 1;
+
+    Stack<CullingStackElement, 64> stack;
+    CullingStackElement rootElement = {mRootNodeID, allPlanesMask};
+    stack.push(rootElement);
+
+    Stack<int32, 64> insideStack;
+
+    while (stack.getNbElements() > 0) {
+
+        const CullingStackElement element = stack.pop();
+        const TreeNode* node = mNodes + element.nodeID;
+
+        // Test the AABB of the node against the planes that its ancestors intersect
+        uint32 planesMask = element.planesMask;
+        bool isOutside = false;
+        for (uint i=0; i<nbPlanes && !isOutside; i++) {
+
+            if ((planesMask & (uint32(1) << i)) == 0) continue;
+
+            decimal minDistance, maxDistance;
+            node->aabb.computeSignedDistanceInterval(planes[i], minDistance, maxDistance);
+
+            if (minDistance > decimal(0.0)) isOutside = true;
+            else if (maxDistance <= decimal(0.0)) planesMask &= ~(uint32(1) << i);
+        }
+
+        if (isOutside) continue;
+
+        // If the node is fully inside the volume, we report all the leaves of its subtree
+        if (planesMask == 0) {
+
+            insideStack.push(element.nodeID);
+            while (insideStack.getNbElements() > 0) {
+
+                const TreeNode* insideNode = mNodes + insideStack.pop();
+                if (insideNode->isLeaf()) {
+                    callback.notifyNodeInsidePlanes(int32(insideNode - mNodes), true);
+                }
+                else {
+                    insideStack.push(insideNode->children[0]);
+                    insideStack.push(insideNode->children[1]);
+                }
+            }
+        }
+        else if (node->isLeaf()) {
+            callback.notifyNodeInsidePlanes(element.nodeID, false);
+        }
+        else {  // If the node has children
+
+            CullingStackElement child1 = {node->children[0], planesMask};
+            CullingStackElement child2 = {node->children[1], planesMask};
+            stack.push(child1);
+            stack.push(child2);
+        }
+    }
+}
+
+// Report the nearest leaf nodes to an AABB within a maximum distance
+/// This is a best-first branch and bound search. The nodes to visit are kept in a priority
+/// queue ordered by the distance between their fat AABB and the query AABB, which is a lower
+/// bound of the distance to all the leaves below them. The exact distance to a leaf is
+/// computed by the callback. Once "maxNbNodes" leaves have been found, the search radius is
+/// reduced to the distance of the farthest of them and the nodes that are farther than this
+/// radius are pruned. The nearest nodes are written in increasing order of distance.
+/**
+ * @param aabb The query AABB
+ * @param maxNbNodes Maximum number of nodes to report
+ * @param maxDistance Maximum distance between the query and a reported node
+ * @param callback Callback used to compute the distance to a leaf node
+ * @param nearestNodes Output array (of size maxNbNodes) of the nearest nodes
+ * @param distances Output array (of size maxNbNodes) of the distances of the nearest nodes
+ * @return The number of reported nodes
+ */
+uint DynamicAABBTree::reportNearestNodes(const AABB& aabb, uint maxNbNodes, decimal maxDistance,
+                                         DynamicAABBTreeNearestCallback& callback,
+                                         int32* nearestNodes, decimal* distances) const {
+
+    PROFILE("DynamicAABBTree::reportNearestNodes()");
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE || maxNbNodes == 0) return 0;
+
+    uint nbNearestNodes = 0;
+    decimal searchDistance = maxDistance;
+
+    // Priority queue (min-heap on the lower bound distance) of the nodes to visit
+    std::vector<std::pair<decimal, int32> > queue;
+    std::greater<std::pair<decimal, int32> > isFarther;
+    queue.push_back(std::make_pair(std::sqrt(aabb.computeSquaredDistance(mNodes[mRootNodeID].aabb)),
+                                   mRootNodeID));
+
+    while (!queue.empty()) {
+
+        // Get the closest node to visit
+        std::pop_heap(queue.begin(), queue.end(), isFarther);
+        const decimal lowerBoundDistance = queue.back().first;
+        const int32 nodeID = queue.back().second;
+        queue.pop_back();
+
+        // If all the remaining nodes are too far, we stop
+        if (lowerBoundDistance >= searchDistance) break;
+
+        const TreeNode* node = mNodes + nodeID;
+
+        // If the node is a leaf of the tree
+        if (node->isLeaf()) {
+
+            const decimal distance = callback.computeNodeDistance(nodeID, lowerBoundDistance,
+                                                                  searchDistance);
+            if (distance < decimal(0.0) || distance >= searchDistance) continue;
+
+            // Insert the node into the sorted array of the nearest nodes
+            uint index = nbNearestNodes < maxNbNodes ? nbNearestNodes : maxNbNodes - 1;
+            while (index > 0 && distances[index - 1] > distance) {
+                nearestNodes[index] = nearestNodes[index - 1];
+                distances[index] = distances[index - 1];
+                index--;
+            }
+            nearestNodes[index] = nodeID;
+            distances[index] = distance;
+            if (nbNearestNodes < maxNbNodes) nbNearestNodes++;
+
+            // If we have enough nodes, we only look for nodes closer than the farthest one
+            if (nbNearestNodes == maxNbNodes) {
+                searchDistance = distances[maxNbNodes - 1];
+            }
+        }
+        else {  // If the node has children
+
+            for (int i=0; i<2; i++) {
+                const int32 childID = node->children[i];
+                const decimal childDistance = std::sqrt(aabb.computeSquaredDistance(mNodes[childID].aabb));
+                if (childDistance < searchDistance) {
+                    queue.push_back(std::make_pair(childDistance, childID));
+                    std::push_heap(queue.begin(), queue.end(), isFarther);
+                }
+            }
+        }
+    }
+
+    return nbNearestNodes;
+}
+
+// Recompute the AABBs of all the nodes of the tree without changing its structure
+/// The new AABB of each leaf node is given by the callback (and enlarged with the
+/// extra AABB gap of the tree). Then, the AABBs of the internal nodes are recomputed
+/// bottom-up by merging the AABBs of their children. No node is removed or inserted,
+/// therefore the quality of the tree can decrease if the leaves move a lot (see
+/// computeSurfaceAreaCost()).
+/**
+ * @param callback Callback used to compute the new AABB of each leaf node
+ */
+void DynamicAABBTree::refit(DynamicAABBTreeRefitCallback& callback) {
+
+    PROFILE("DynamicAABBTree::refit()");
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    refitNode(mRootNodeID, callback);
+}
+
+// Recompute the AABBs of the nodes of the sub-tree of a given node
+void DynamicAABBTree::refitNode(int nodeID, DynamicAABBTreeRefitCallback& callback) {
+
+    assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
+    TreeNode* node = mNodes + nodeID;
+
+    // If the node is a leaf, we compute its new fat AABB
+    if (node->isLeaf()) {
+        const AABB aabb = callback.computeLeafAABB(nodeID);
+        const Vector3 gap(mExtraAABBGap, mExtraAABBGap, mExtraAABBGap);
+        node->aabb.setMin(aabb.getMin() - gap);
+        node->aabb.setMax(aabb.getMax() + gap);
+        return;
+    }
+
+    // Refit the two children and merge their AABBs
+    refitNode(node->children[0], callback);
+    refitNode(node->children[1], callback);
+    node->aabb.mergeTwoAABBs(mNodes[node->children[0]].aabb, mNodes[node->children[1]].aabb);
+}
+
+// Return the sum of the surface areas of the AABBs of the internal nodes of the tree
+/// This is the cost of the tree used by the surface area heuristic. It is proportional
+/// to the expected number of internal nodes visited by a random ray and can be compared
+/// before and after a refit to know if the tree should be rebuilt.
+decimal DynamicAABBTree::computeSurfaceAreaCost() const {
+
+    decimal cost = decimal(0.0);
+    for (int nodeID=0; nodeID<mNbAllocatedNodes; nodeID++) {
+
+        // Skip the free nodes and the leaf nodes
+        if (mNodes[nodeID].height <= 0) continue;
+
+        const Vector3 extent = mNodes[nodeID].aabb.getExtent();
+        cost += decimal(2.0) * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+    }
+
+    return cost;
+}
+
+// Return the size (in bytes) of the buffer needed to serialize the tree
+size_t DynamicAABBTree::getSerializedSize() const {
+    return sizeof(DynamicAABBTreeSerializationHeader) + mNbAllocatedNodes * sizeof(TreeNode);
+}
+
+// Serialize the tree into a memory buffer. The buffer must have a size of at least
+/// getSerializedSize() bytes. The nodes are written as they are in memory and
+/// therefore the serialized data can only be loaded back with the same
+/// precision (float or double) and on a platform with the same endianness.
+/// This method must only be used with trees whose node data are integers
+/// because the data pointers would not be valid anymore after loading.
+/**
+ * @param buffer Pointer to the memory buffer where to write the tree
+ */
+void DynamicAABBTree::serialize(void* buffer) const {
+
+    assert(buffer != NULL);
+
+    DynamicAABBTreeSerializationHeader header;
+    header.magic = DYNAMIC_AABB_TREE_SERIALIZATION_MAGIC;
+    header.version = DYNAMIC_AABB_TREE_SERIALIZATION_VERSION;
+    header.decimalSize = sizeof(decimal);
+    header.nodeSize = sizeof(TreeNode);
+    header.nbAllocatedNodes = mNbAllocatedNodes;
+    header.nbNodes = mNbNodes;
+    header.rootNodeID = mRootNodeID;
+    header.freeNodeID = mFreeNodeID;
+
+    unsigned char* bytes = static_cast<unsigned char*>(buffer);
+    memcpy(bytes, &header, sizeof(DynamicAABBTreeSerializationHeader));
+    memcpy(bytes + sizeof(DynamicAABBTreeSerializationHeader), mNodes,
+           mNbAllocatedNodes * sizeof(TreeNode));
+}
+
+// Load the tree from a memory buffer written by the serialize() method. The
+/// current nodes of the tree are replaced by the loaded ones. The method
+/// returns false (and leaves the tree unchanged) if the buffer has not been
+/// written with the same version of the format, the same precision or if
+/// its content is not valid. The loaded nodes are checked with a single walk
+/// of the tree and of the free list before they are accepted. The data of the
+/// leaves can also be checked by the caller with a callback.
+/**
+ * @param buffer Pointer to the memory buffer that contains the serialized tree
+ * @param size Size (in bytes) of the memory buffer
+ * @param callback Callback used to check the data of each leaf (can be NULL)
+ * @return True if the tree has been loaded
+ */
+bool DynamicAABBTree::deserialize(const void* buffer, size_t size,
+                                  const DynamicAABBTreeDeserializeCallback* callback) {
+
+    PROFILE("DynamicAABBTree::deserialize()");
+
+    if (buffer == NULL || size < sizeof(DynamicAABBTreeSerializationHeader)) return false;
+
+    DynamicAABBTreeSerializationHeader header;
+    const unsigned char* bytes = static_cast<const unsigned char*>(buffer);
+    memcpy(&header, bytes, sizeof(DynamicAABBTreeSerializationHeader));
+
+    // Check that the data have been written with the same format and precision
+    if (header.magic != DYNAMIC_AABB_TREE_SERIALIZATION_MAGIC ||
+        header.version != DYNAMIC_AABB_TREE_SERIALIZATION_VERSION ||
+        header.decimalSize != sizeof(decimal) || header.nodeSize != sizeof(TreeNode)) {
+        return false;
+    }
+
+    // Check that the header is consistent with the size of the buffer
+    if (header.nbAllocatedNodes <= 0 || header.nbNodes < 0 ||
+        header.nbNodes > header.nbAllocatedNodes ||
+        size != sizeof(DynamicAABBTreeSerializationHeader) +
+                size_t(header.nbAllocatedNodes) * sizeof(TreeNode)) {
+        return false;
+    }
+    if (header.rootNodeID < TreeNode::NULL_TREE_NODE ||
+        header.rootNodeID >= header.nbAllocatedNodes ||
+        header.freeNodeID < TreeNode::NULL_TREE_NODE ||
+        header.freeNodeID >= header.nbAllocatedNodes ||
+        (header.rootNodeID == TreeNode::NULL_TREE_NODE) != (header.nbNodes == 0)) {
+        return false;
+    }
+
+    // Load the nodes and check that they form a valid tree
+    TreeNode* nodes = (TreeNode*) malloc(header.nbAllocatedNodes * sizeof(TreeNode));
+    assert(nodes);
+    memcpy(static_cast<void*>(nodes), bytes + sizeof(DynamicAABBTreeSerializationHeader),
+           header.nbAllocatedNodes * sizeof(TreeNode));
+    if (!isSerializedTreeValid(nodes, header, callback)) {
+        free(nodes);
+        return false;
+    }
+
+    // Replace the nodes of the tree
+    free(mNodes);
+    mNodes = nodes;
+    mNbAllocatedNodes = header.nbAllocatedNodes;
+    mNbNodes = header.nbNodes;
+    mRootNodeID = header.rootNodeID;
+    mFreeNodeID = header.freeNodeID;
+
+    return true;
+}
+
 #ifndef NDEBUG
 
 // Check if the tree structure is valid (for debugging purpose)
@@ -34,6 +34,9 @@
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
 
+// Constants
+const uint32 DYNAMIC_AABB_TREE_SERIALIZATION_VERSION = 1;
+
 // Declarations
 class BroadPhaseAlgorithm;
 class BroadPhaseRaycastTestCallback;
@@ -117,6 +120,80 @@ class DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class DynamicAABBTreeRaycastPacketCallback
+/**
+ * Raycast callback in the Dynamic AABB Tree called when the AABB of a leaf
+ * node is hit by one of the rays of a ray packet.
+ */
+class DynamicAABBTreeRaycastPacketCallback {
+
+    public:
+
+        // Called when the AABB of a leaf node is hit by the ray with index "rayIndex"
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, uint rayIndex, const Ray& ray)=0;
+
+};
+
+// Class DynamicAABBTreeNearestCallback
+/**
+ * Nearest neighbor callback in the Dynamic AABB Tree called to compute the
+ * distance between the query and a leaf node that can be among the nearest ones.
+ */
+class DynamicAABBTreeNearestCallback {
+
+    public:
+
+        // Called to compute the distance to a leaf node. The lower bound is the distance
+        // between the query AABB and the fat AABB of the node. Only the distances smaller
+        // than maxDistance are useful. A negative distance means that the node is ignored.
+        virtual decimal computeNodeDistance(int32 nodeId, decimal lowerBoundDistance,
+                                            decimal maxDistance)=0;
+
+};
+
+// Class DynamicAABBTreeCullingCallback
+/**
+ * Culling callback in the Dynamic AABB Tree called for each leaf node whose
+ * AABB is inside or intersects the volume bounded by a set of planes.
+ */
+class DynamicAABBTreeCullingCallback {
+
+    public:
+
+        // Called for each leaf node that is not culled. The "isFullyInside" parameter
+        // is true if the AABB of the node is fully inside the volume
+        virtual void notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside)=0;
+
+};
+
+// Class DynamicAABBTreeRefitCallback
+/**
+ * Refit callback in the Dynamic AABB Tree called to compute the new AABB
+ * of each leaf node when the tree is refitted.
+ */
+class DynamicAABBTreeRefitCallback {
+
+    public:
+
+        // Called to compute the new AABB (without the extra gap) of a leaf node
+        virtual AABB computeLeafAABB(int32 nodeId)=0;
+
+};
+
+// Class DynamicAABBTreeDeserializeCallback
+/**
+ * Callback used when a tree is loaded from a memory buffer to check the
+ * data of each leaf node of the loaded tree.
+ */
+class DynamicAABBTreeDeserializeCallback {
+
+    public:
+
+        // Return true if the two integers of data of a leaf node are valid
+        virtual bool isLeafDataValid(int32 data1, int32 data2) const=0;
+
+};
+
 // Class DynamicAABBTree
 /**
  * This class implements a dynamic AABB tree that is used for broad-phase
@@ -170,6 +247,9 @@ class DynamicAABBTree {
         /// Compute the height of a given node in the tree
         int computeHeight(int nodeID);
 
+        /// Recompute the AABBs of the nodes of the sub-tree of a given node
+        void refitNode(int nodeID, DynamicAABBTreeRefitCallback& callback);
+
         /// Internally add an object into the tree
         int addObjectInternal(const AABB& aabb);
 
@@ -224,6 +304,38 @@ class DynamicAABBTree {
         /// Ray casting method
         void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
 
+        /// Ray casting method for a batch of rays traversed as ray packets
+        void raycastBatch(const Ray* rays, uint nbRays,
+                          DynamicAABBTreeRaycastPacketCallback& callback) const;
+
+        /// Report the leaf nodes that are inside or intersect the volume bounded by planes
+        void reportAllNodesInsidePlanes(const Plane* planes, uint nbPlanes,
+                                        DynamicAABBTreeCullingCallback& callback) const;
+
+        /// Report the nearest leaf nodes to an AABB within a maximum distance
+        uint reportNearestNodes(const AABB& aabb, uint maxNbNodes, decimal maxDistance,
+                                DynamicAABBTreeNearestCallback& callback, int32* nearestNodes,
+                                decimal* distances) const;
+
+        /// Recompute the AABBs of all the nodes of the tree without changing its structure
+        void refit(DynamicAABBTreeRefitCallback& callback);
+
+        /// Return the sum of the surface areas of the AABBs of the internal nodes of the tree
+        decimal computeSurfaceAreaCost() const;
+
+        /// Return the size (in bytes) of the buffer needed to serialize the tree
+        size_t getSerializedSize() const;
+
+        /// Serialize the tree (where node data are integers) into a memory buffer
+        void serialize(void* buffer) const;
+
+        /// Load the tree (where node data are integers) from a serialized memory buffer
+        bool deserialize(const void* buffer, size_t size,
+                         const DynamicAABBTreeDeserializeCallback* callback = NULL);
+
+        /// Return the number of nodes in the tree
+        int getNbNodes() const;
+
         /// Compute the height of the tree
         int computeHeight();
 
@@ -259,6 +371,11 @@ inline void* DynamicAABBTree::getNodeDataPointer(int nodeID) const {
     return mNodes[nodeID].dataPointer;
 }
 
+// Return the number of nodes in the tree
+inline int DynamicAABBTree::getNbNodes() const {
+    return mNbNodes;
+}
+
 // Return the root AABB of the tree
 inline AABB DynamicAABBTree::getRootAABB() const {
     return getFatAABB(mRootNodeID);
@@ -0,0 +1,245 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "BoxVsTriangleAlgorithm.h"
+#include "collision/shapes/BoxShape.h"
+#include "collision/shapes/TriangleShape.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+BoxVsTriangleAlgorithm::BoxVsTriangleAlgorithm() : NarrowPhaseAlgorithm() {
+
+}
+
+// Destructor
+BoxVsTriangleAlgorithm::~BoxVsTriangleAlgorithm() {
+
+}
+
+// Compute a contact info if the box and the triangle collide
+/// The axis with the smallest penetration depth is used as the contact normal. Since the
+/// edge-edge axes are less stable, an edge axis is only selected if its penetration depth
+/// is clearly smaller than the one of the best face axis.
+void BoxVsTriangleAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
+                                           const CollisionShapeInfo& shape2Info,
+                                           NarrowPhaseCallback* narrowPhaseCallback) {
+
+    assert(shape1Info.collisionShape->getType() == BOX);
+    assert(shape2Info.collisionShape->getType() == TRIANGLE);
+
+    const BoxShape* boxShape = static_cast<const BoxShape*>(shape1Info.collisionShape);
+    const TriangleShape* triangleShape = static_cast<const TriangleShape*>(shape2Info.collisionShape);
+
+    // Tolerances used to prefer face axes over edge-edge axes
+    const decimal edgeRelativeTolerance = decimal(0.95);
+    const decimal edgeAbsoluteTolerance = decimal(0.01);
+
+    // We work in the local-space of the triangle
+    const Transform& triangleToWorld = shape2Info.shapeToWorldTransform;
+    const Transform boxToTriangle = triangleToWorld.getInverse() * shape1Info.shapeToWorldTransform;
+    const Vector3 boxCenter = boxToTriangle.getPosition();
+    const Matrix3x3 boxOrientation = boxToTriangle.getOrientation().getMatrix();
+    const Vector3 boxAxes[3] = {boxOrientation.getColumn(0), boxOrientation.getColumn(1),
+                                boxOrientation.getColumn(2)};
+    const Vector3 boxExtent = boxShape->getExtent();
+
+    const Vector3 triangleVertices[3] = {triangleShape->getVertex(0), triangleShape->getVertex(1),
+                                         triangleShape->getVertex(2)};
+    const Vector3 triangleEdges[3] = {triangleVertices[1] - triangleVertices[0],
+                                      triangleVertices[2] - triangleVertices[1],
+                                      triangleVertices[0] - triangleVertices[2]};
+    const decimal triangleMargin = triangleShape->getMargin();
+
+    Vector3 triangleNormal = triangleEdges[0].cross(triangleVertices[2] - triangleVertices[0]);
+    if (triangleNormal.lengthSquare() < MACHINE_EPSILON) return;
+    triangleNormal.normalize();
+
+    decimal penetrationDepth;
+    Vector3 normal;
+
+    // Test the triangle normal
+    decimal minPenetrationDepth;
+    Vector3 bestNormal;
+    if (!computeAxisPenetration(triangleNormal, boxCenter, boxAxes, boxExtent, triangleVertices,
+                                triangleMargin, minPenetrationDepth, bestNormal)) {
+        return;
+    }
+    int bestBoxAxis = -1;
+    int bestTriangleEdge = -1;
+
+    // Test the three face normals of the box
+    for (int i=0; i<3; i++) {
+        if (!computeAxisPenetration(boxAxes[i], boxCenter, boxAxes, boxExtent, triangleVertices,
+                                    triangleMargin, penetrationDepth, normal)) {
+            return;
+        }
+        if (penetrationDepth < minPenetrationDepth) {
+            minPenetrationDepth = penetrationDepth;
+            bestNormal = normal;
+            bestBoxAxis = i;
+        }
+    }
+
+    // Test the cross products between the box axes and the triangle edges
+    const decimal minFacePenetrationDepth = minPenetrationDepth;
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+
+            Vector3 axis = boxAxes[i].cross(triangleEdges[j]);
+
+            // If the box axis and the triangle edge are parallel, the axis is not valid
+            if (axis.lengthSquare() < MACHINE_EPSILON) continue;
+            axis.normalize();
+
+            if (!computeAxisPenetration(axis, boxCenter, boxAxes, boxExtent, triangleVertices,
+                                        triangleMargin, penetrationDepth, normal)) {
+                return;
+            }
+            if (penetrationDepth < minPenetrationDepth &&
+                penetrationDepth < edgeRelativeTolerance * minFacePenetrationDepth -
+                                   edgeAbsoluteTolerance) {
+                minPenetrationDepth = penetrationDepth;
+                bestNormal = normal;
+                bestBoxAxis = i;
+                bestTriangleEdge = j;
+            }
+        }
+    }
+
+    // Compute the contact points (in the local-space of the triangle)
+    Vector3 pointBox;
+    Vector3 pointTriangle;
+
+    // If the contact normal is an edge-edge axis
+    if (bestTriangleEdge >= 0) {
+
+        // Find the edge of the box parallel to the box axis that is the deepest
+        // in the direction of the normal
+        Vector3 boxEdgeCenter = boxCenter;
+        for (int k=0; k<3; k++) {
+            if (k == bestBoxAxis) continue;
+            const decimal sign = boxAxes[k].dot(bestNormal) >= decimal(0.0) ? decimal(1.0) :
+                                                                              decimal(-1.0);
+            boxEdgeCenter += sign * boxExtent[k] * boxAxes[k];
+        }
+        const Vector3 boxEdgeHalfVector = boxExtent[bestBoxAxis] * boxAxes[bestBoxAxis];
+
+        computeClosestPointsBetweenSegments(boxEdgeCenter - boxEdgeHalfVector,
+                                            boxEdgeCenter + boxEdgeHalfVector,
+                                            triangleVertices[bestTriangleEdge],
+                                            triangleVertices[(bestTriangleEdge + 1) % 3],
+                                            pointBox, pointTriangle);
+        pointTriangle -= triangleMargin * bestNormal;
+    }
+    else if (bestBoxAxis >= 0) {   // If the contact normal is a face normal of the box
+
+        // The deepest triangle vertex in the direction opposite to the normal
+        int deepestVertex = 0;
+        for (int k=1; k<3; k++) {
+            if (triangleVertices[k].dot(bestNormal) < triangleVertices[deepestVertex].dot(bestNormal)) {
+                deepestVertex = k;
+            }
+        }
+        pointTriangle = triangleVertices[deepestVertex] - triangleMargin * bestNormal;
+        pointBox = pointTriangle + minPenetrationDepth * bestNormal;
+    }
+    else {  // If the contact normal is the triangle normal
+
+        // The deepest box vertex in the direction of the normal
+        pointBox = boxCenter;
+        for (int k=0; k<3; k++) {
+            const decimal sign = boxAxes[k].dot(bestNormal) >= decimal(0.0) ? decimal(1.0) :
+                                                                              decimal(-1.0);
+            pointBox += sign * boxExtent[k] * boxAxes[k];
+        }
+        pointTriangle = pointBox - minPenetrationDepth * bestNormal;
+    }
+
+    // Create the contact info object
+    ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                 shape2Info.collisionShape, triangleToWorld.getOrientation() * bestNormal,
+                                 minPenetrationDepth, boxToTriangle.getInverse() * pointBox,
+                                 pointTriangle);
+
+    // Notify about the new contact
+    narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+}
+
+// Project the box and the triangle on an axis and compute the penetration depth
+/// This method returns false if the axis is a separating axis. Otherwise, it computes
+/// the penetration depth along the axis and the contact normal (from the box toward
+/// the triangle) that resolves it.
+/**
+ * @param axis Normalized axis to test (in the local-space of the triangle)
+ * @param boxCenter Center of the box
+ * @param boxAxes The three normalized axes of the box
+ * @param boxExtent Half-extents of the box
+ * @param triangleVertices The three vertices of the triangle
+ * @param triangleMargin Collision margin around the triangle
+ * @param[out] penetrationDepth Penetration depth along the axis
+ * @param[out] normal Contact normal from the box toward the triangle
+ * @return False if the axis separates the box and the triangle and true otherwise
+ */
+bool BoxVsTriangleAlgorithm::computeAxisPenetration(const Vector3& axis, const Vector3& boxCenter,
+                                                    const Vector3* boxAxes, const Vector3& boxExtent,
+                                                    const Vector3* triangleVertices,
+                                                    decimal triangleMargin,
+                                                    decimal& penetrationDepth,
+                                                    Vector3& normal) const {
+
+    // Project the box on the axis
+    const decimal boxProjectedCenter = axis.dot(boxCenter);
+    const decimal boxProjectedRadius = boxExtent.x * std::abs(axis.dot(boxAxes[0])) +
+                                       boxExtent.y * std::abs(axis.dot(boxAxes[1])) +
+                                       boxExtent.z * std::abs(axis.dot(boxAxes[2]));
+
+    // Project the triangle on the axis
+    const decimal projection1 = axis.dot(triangleVertices[0]);
+    const decimal projection2 = axis.dot(triangleVertices[1]);
+    const decimal projection3 = axis.dot(triangleVertices[2]);
+    const decimal triangleMin = min3(projection1, projection2, projection3) - triangleMargin;
+    const decimal triangleMax = max3(projection1, projection2, projection3) + triangleMargin;
+
+    // Penetration depths if we push the box in the negative or positive axis direction
+    const decimal depthNegative = boxProjectedCenter + boxProjectedRadius - triangleMin;
+    const decimal depthPositive = triangleMax - (boxProjectedCenter - boxProjectedRadius);
+
+    // If the axis is a separating axis
+    if (depthNegative < decimal(0.0) || depthPositive < decimal(0.0)) return false;
+
+    if (depthNegative < depthPositive) {
+        penetrationDepth = depthNegative;
+        normal = axis;
+    }
+    else {
+        penetrationDepth = depthPositive;
+        normal = -axis;
+    }
+
+    return true;
+}
@@ -0,0 +1,80 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_BOX_VS_TRIANGLE_ALGORITHM_H
+#define	REACTPHYSICS3D_BOX_VS_TRIANGLE_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class BoxVsTriangleAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between a box and a triangle of a concave shape using the separating
+ * axis theorem (SAT). The 13 potential separating axes are the triangle
+ * normal, the three box face normals and the nine cross products between
+ * the box axes and the triangle edges. The first shape must be the box and
+ * the second shape the triangle.
+ */
+class BoxVsTriangleAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        BoxVsTriangleAlgorithm(const BoxVsTriangleAlgorithm& algorithm);
+
+        /// Private assignment operator
+        BoxVsTriangleAlgorithm& operator=(const BoxVsTriangleAlgorithm& algorithm);
+
+        /// Project the box and the triangle on an axis and compute the penetration depth
+        bool computeAxisPenetration(const Vector3& axis, const Vector3& boxCenter,
+                                    const Vector3* boxAxes, const Vector3& boxExtent,
+                                    const Vector3* triangleVertices, decimal triangleMargin,
+                                    decimal& penetrationDepth, Vector3& normal) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        BoxVsTriangleAlgorithm();
+
+        /// Destructor
+        virtual ~BoxVsTriangleAlgorithm();
+
+        /// Compute a contact info if the two bounding volume collide
+        virtual void testCollision(const CollisionShapeInfo& shape1Info,
+                                   const CollisionShapeInfo& shape2Info,
+                                   NarrowPhaseCallback* narrowPhaseCallback);
+};
+
+}
+
+#endif
@@ -0,0 +1,274 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CapsuleVsCapsuleAlgorithm.h"
+#include "collision/shapes/CapsuleShape.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+CapsuleVsCapsuleAlgorithm::CapsuleVsCapsuleAlgorithm() : NarrowPhaseAlgorithm() {
+
+}
+
+// Destructor
+CapsuleVsCapsuleAlgorithm::~CapsuleVsCapsuleAlgorithm() {
+
+}
+
+// Compute a contact info if the two capsules collide
+/// The collision margin of a capsule is its radius. Therefore, the contact is the same
+/// as the one of the GJK algorithm as long as the inner segments do not intersect.
+void CapsuleVsCapsuleAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
+                                              const CollisionShapeInfo& shape2Info,
+                                              NarrowPhaseCallback* narrowPhaseCallback) {
+
+    assert(shape1Info.collisionShape->getType() == CAPSULE);
+    assert(shape2Info.collisionShape->getType() == CAPSULE);
+
+    const CapsuleShape* capsuleShape1 = static_cast<const CapsuleShape*>(shape1Info.collisionShape);
+    const CapsuleShape* capsuleShape2 = static_cast<const CapsuleShape*>(shape2Info.collisionShape);
+    const Transform& transform1 = shape1Info.shapeToWorldTransform;
+    const Transform& transform2 = shape2Info.shapeToWorldTransform;
+
+    // Compute the inner segments of the capsules in world-space (along the local Y axis)
+    const decimal halfHeight1 = decimal(0.5) * capsuleShape1->getHeight();
+    const decimal halfHeight2 = decimal(0.5) * capsuleShape2->getHeight();
+    const Vector3 segment1Point1 = transform1 * Vector3(0, halfHeight1, 0);
+    const Vector3 segment1Point2 = transform1 * Vector3(0, -halfHeight1, 0);
+    const Vector3 segment2Point1 = transform2 * Vector3(0, halfHeight2, 0);
+    const Vector3 segment2Point2 = transform2 * Vector3(0, -halfHeight2, 0);
+
+    // Compute the closest points between the two segments
+    Vector3 closestPoint1;
+    Vector3 closestPoint2;
+    const decimal distanceSquare = computeClosestPointsBetweenSegments(segment1Point1, segment1Point2,
+                                                                       segment2Point1, segment2Point2,
+                                                                       closestPoint1, closestPoint2);
+
+    const decimal sumRadius = capsuleShape1->getRadius() + capsuleShape2->getRadius();
+
+    // If the capsules touch
+    if (distanceSquare <= sumRadius * sumRadius) {
+        reportContact(shape1Info, shape2Info, closestPoint1, closestPoint2, distanceSquare,
+                      narrowPhaseCallback);
+    }
+}
+
+// Compute the contacts of a batch of capsule vs capsule overlapping pairs
+/// The pairs are processed by packs of four as in SphereVsSphereAlgorithm::testCollisionBatch().
+/// The inner segments of a pack are gathered into separate arrays (one per coordinate) and
+/// the closest points between the segments are computed with the same steps as in
+/// computeClosestPointsBetweenSegments(). The branches of this function are replaced by
+/// selections so that the four pairs can be vectorized by the compiler. The segments of
+/// capsules never degenerate into points because the height of a capsule is positive.
+void CapsuleVsCapsuleAlgorithm::testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                                   NarrowPhaseCallback* narrowPhaseCallback) {
+
+    const uint packSize = 4;
+
+    Transform transforms1[packSize];
+    Transform transforms2[packSize];
+    decimal point1X[packSize], point1Y[packSize], point1Z[packSize];
+    decimal point2X[packSize], point2Y[packSize], point2Z[packSize];
+    decimal direction1X[packSize], direction1Y[packSize], direction1Z[packSize];
+    decimal direction2X[packSize], direction2Y[packSize], direction2Z[packSize];
+    decimal sumRadius[packSize];
+    decimal s[packSize];
+    decimal t[packSize];
+    decimal distanceSquares[packSize];
+    bool isColliding[packSize];
+
+    // For each pack of pairs
+    for (uint firstPair=0; firstPair<nbPairs; firstPair += packSize) {
+
+        const uint nbPairsInPack = std::min(packSize, nbPairs - firstPair);
+
+        // Gather the inner segments of the pairs of the pack
+        for (uint k=0; k<packSize; k++) {
+
+            // The unused lanes of the last pack never collide
+            if (k >= nbPairsInPack) {
+                point1X[k] = point1Y[k] = point1Z[k] = decimal(0.0);
+                point2X[k] = decimal(1.0);
+                point2Y[k] = point2Z[k] = decimal(0.0);
+                direction1X[k] = direction1Z[k] = decimal(0.0);
+                direction2X[k] = direction2Z[k] = decimal(0.0);
+                direction1Y[k] = direction2Y[k] = decimal(1.0);
+                sumRadius[k] = decimal(0.0);
+                continue;
+            }
+
+            const OverlappingPair* pair = overlappingPairs[firstPair + k];
+            const ProxyShape* shape1 = pair->getShape1();
+            const ProxyShape* shape2 = pair->getShape2();
+            const CapsuleShape* capsuleShape1 = static_cast<const CapsuleShape*>(shape1->getCollisionShape());
+            const CapsuleShape* capsuleShape2 = static_cast<const CapsuleShape*>(shape2->getCollisionShape());
+            transforms1[k] = shape1->getLocalToWorldTransform();
+            transforms2[k] = shape2->getLocalToWorldTransform();
+
+            const decimal halfHeight1 = decimal(0.5) * capsuleShape1->getHeight();
+            const decimal halfHeight2 = decimal(0.5) * capsuleShape2->getHeight();
+            const Vector3 segment1Point1 = transforms1[k] * Vector3(0, halfHeight1, 0);
+            const Vector3 segment2Point1 = transforms2[k] * Vector3(0, halfHeight2, 0);
+            const Vector3 direction1 = transforms1[k] * Vector3(0, -halfHeight1, 0) - segment1Point1;
+            const Vector3 direction2 = transforms2[k] * Vector3(0, -halfHeight2, 0) - segment2Point1;
+            point1X[k] = segment1Point1.x;
+            point1Y[k] = segment1Point1.y;
+            point1Z[k] = segment1Point1.z;
+            point2X[k] = segment2Point1.x;
+            point2Y[k] = segment2Point1.y;
+            point2Z[k] = segment2Point1.z;
+            direction1X[k] = direction1.x;
+            direction1Y[k] = direction1.y;
+            direction1Z[k] = direction1.z;
+            direction2X[k] = direction2.x;
+            direction2Y[k] = direction2.y;
+            direction2Z[k] = direction2.z;
+            sumRadius[k] = capsuleShape1->getRadius() + capsuleShape2->getRadius();
+        }
+
+        // Compute the closest points between the segments of the four pairs
+        for (uint k=0; k<packSize; k++) {
+
+            const decimal rX = point1X[k] - point2X[k];
+            const decimal rY = point1Y[k] - point2Y[k];
+            const decimal rZ = point1Z[k] - point2Z[k];
+            const decimal a = direction1X[k] * direction1X[k] + direction1Y[k] * direction1Y[k] +
+                              direction1Z[k] * direction1Z[k];
+            const decimal e = direction2X[k] * direction2X[k] + direction2Y[k] * direction2Y[k] +
+                              direction2Z[k] * direction2Z[k];
+            const decimal b = direction1X[k] * direction2X[k] + direction1Y[k] * direction2Y[k] +
+                              direction1Z[k] * direction2Z[k];
+            const decimal c = direction1X[k] * rX + direction1Y[k] * rY + direction1Z[k] * rZ;
+            const decimal f = direction2X[k] * rX + direction2Y[k] * rY + direction2Z[k] * rZ;
+            const decimal denom = a * e - b * b;
+
+            // Closest point on the first line clamped to the first segment (zero if parallel)
+            const decimal sLine = denom != decimal(0.0) ? (b * f - c * e) / denom : decimal(0.0);
+            const decimal sSegment = std::min(std::max(sLine, decimal(0.0)), decimal(1.0));
+
+            // Closest point on the second segment. If it has to be clamped, the closest
+            // point on the first segment is computed again from the clamped point.
+            const decimal tLine = (b * sSegment + f) / e;
+            t[k] = std::min(std::max(tLine, decimal(0.0)), decimal(1.0));
+            const decimal sClamped = std::min(std::max((b * t[k] - c) / a, decimal(0.0)), decimal(1.0));
+            s[k] = (tLine < decimal(0.0) || tLine > decimal(1.0)) ? sClamped : sSegment;
+
+            const decimal deltaX = rX + direction1X[k] * s[k] - direction2X[k] * t[k];
+            const decimal deltaY = rY + direction1Y[k] * s[k] - direction2Y[k] * t[k];
+            const decimal deltaZ = rZ + direction1Z[k] * s[k] - direction2Z[k] * t[k];
+            distanceSquares[k] = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+            isColliding[k] = distanceSquares[k] <= sumRadius[k] * sumRadius[k];
+        }
+
+        // Report the contacts of the pack
+        for (uint k=0; k<nbPairsInPack; k++) {
+
+            if (!isColliding[k]) continue;
+
+            OverlappingPair* pair = overlappingPairs[firstPair + k];
+            ProxyShape* shape1 = pair->getShape1();
+            ProxyShape* shape2 = pair->getShape2();
+            setCurrentOverlappingPair(pair);
+            CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), transforms1[k],
+                                          pair, shape1->getCachedCollisionData());
+            CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), transforms2[k],
+                                          pair, shape2->getCachedCollisionData());
+            const Vector3 closestPoint1(point1X[k] + direction1X[k] * s[k], point1Y[k] + direction1Y[k] * s[k],
+                                        point1Z[k] + direction1Z[k] * s[k]);
+            const Vector3 closestPoint2(point2X[k] + direction2X[k] * t[k], point2Y[k] + direction2Y[k] * t[k],
+                                        point2Z[k] + direction2Z[k] * t[k]);
+            reportContact(shape1Info, shape2Info, closestPoint1, closestPoint2, distanceSquares[k],
+                          narrowPhaseCallback);
+        }
+    }
+}
+
+// Report the contact between two capsules whose inner segments are close enough
+/**
+ * @param shape1Info Information about the first capsule
+ * @param shape2Info Information about the second capsule
+ * @param closestPoint1 Closest point of the inner segment of the first capsule (world-space)
+ * @param closestPoint2 Closest point of the inner segment of the second capsule (world-space)
+ * @param distanceSquare Square distance between the two closest points
+ * @param narrowPhaseCallback Callback to notify about the new contact
+ */
+void CapsuleVsCapsuleAlgorithm::reportContact(const CollisionShapeInfo& shape1Info,
+                                              const CollisionShapeInfo& shape2Info,
+                                              const Vector3& closestPoint1, const Vector3& closestPoint2,
+                                              decimal distanceSquare,
+                                              NarrowPhaseCallback* narrowPhaseCallback) const {
+
+    const CapsuleShape* capsuleShape1 = static_cast<const CapsuleShape*>(shape1Info.collisionShape);
+    const CapsuleShape* capsuleShape2 = static_cast<const CapsuleShape*>(shape2Info.collisionShape);
+    const Transform& transform1 = shape1Info.shapeToWorldTransform;
+    const Transform& transform2 = shape2Info.shapeToWorldTransform;
+    const decimal radius1 = capsuleShape1->getRadius();
+    const decimal radius2 = capsuleShape2->getRadius();
+
+    // Compute the contact normal (from the first capsule toward the second one)
+    Vector3 normal;
+    decimal distance;
+    if (distanceSquare > MACHINE_EPSILON) {
+        distance = std::sqrt(distanceSquare);
+        normal = (closestPoint2 - closestPoint1) / distance;
+    }
+    else {  // If the two segments intersect
+
+        // Directions of the inner segments (from the top to the bottom point)
+        const Vector3 direction1 = transform1.getOrientation() * Vector3(0, -1, 0);
+        const Vector3 direction2 = transform2.getOrientation() * Vector3(0, -1, 0);
+
+        distance = decimal(0.0);
+        normal = direction1.cross(direction2);
+        if (normal.lengthSquare() > MACHINE_EPSILON) {
+            normal.normalize();
+        }
+        else {  // If the segments are parallel
+            normal = direction1.getOneUnitOrthogonalVector();
+        }
+
+        // Make the normal point from the first capsule toward the second one
+        if (normal.dot(transform2.getPosition() - transform1.getPosition()) < decimal(0.0)) {
+            normal = -normal;
+        }
+    }
+
+    const decimal penetrationDepth = radius1 + radius2 - distance;
+    const Vector3 pointCapsule1 = closestPoint1 + radius1 * normal;
+    const Vector3 pointCapsule2 = closestPoint2 - radius2 * normal;
+
+    // Create the contact info object
+    ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                 shape2Info.collisionShape, normal, penetrationDepth,
+                                 transform1.getInverse() * pointCapsule1,
+                                 transform2.getInverse() * pointCapsule2);
+
+    // Notify about the new contact
+    narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+}
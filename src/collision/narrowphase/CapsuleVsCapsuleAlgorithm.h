@@ -0,0 +1,81 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CAPSULE_VS_CAPSULE_ALGORITHM_H
+#define	REACTPHYSICS3D_CAPSULE_VS_CAPSULE_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class CapsuleVsCapsuleAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between two capsules. The contact is computed directly from the closest
+ * points between the inner segments of the two capsules instead of running
+ * GJK/EPA.
+ */
+class CapsuleVsCapsuleAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        CapsuleVsCapsuleAlgorithm(const CapsuleVsCapsuleAlgorithm& algorithm);
+
+        /// Private assignment operator
+        CapsuleVsCapsuleAlgorithm& operator=(const CapsuleVsCapsuleAlgorithm& algorithm);
+
+        /// Report the contact between two capsules whose inner segments are close enough
+        void reportContact(const CollisionShapeInfo& shape1Info, const CollisionShapeInfo& shape2Info,
+                           const Vector3& closestPoint1, const Vector3& closestPoint2,
+                           decimal distanceSquare, NarrowPhaseCallback* narrowPhaseCallback) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CapsuleVsCapsuleAlgorithm();
+
+        /// Destructor
+        virtual ~CapsuleVsCapsuleAlgorithm();
+
+        /// Compute a contact info if the two bounding volume collide
+        virtual void testCollision(const CollisionShapeInfo& shape1Info,
+                                   const CollisionShapeInfo& shape2Info,
+                                   NarrowPhaseCallback* narrowPhaseCallback);
+
+        /// Compute the contacts of a batch of capsule vs capsule overlapping pairs
+        virtual void testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                        NarrowPhaseCallback* narrowPhaseCallback);
+};
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CapsuleVsTriangleAlgorithm.h"
+#include "collision/shapes/CapsuleShape.h"
+#include "collision/shapes/TriangleShape.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+CapsuleVsTriangleAlgorithm::CapsuleVsTriangleAlgorithm() : NarrowPhaseAlgorithm() {
+
+}
+
+// Destructor
+CapsuleVsTriangleAlgorithm::~CapsuleVsTriangleAlgorithm() {
+
+}
+
+// Compute a contact info if the capsule and the triangle collide
+void CapsuleVsTriangleAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
+                                               const CollisionShapeInfo& shape2Info,
+                                               NarrowPhaseCallback* narrowPhaseCallback) {
+
+    assert(shape1Info.collisionShape->getType() == CAPSULE);
+    assert(shape2Info.collisionShape->getType() == TRIANGLE);
+
+    const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(shape1Info.collisionShape);
+    const TriangleShape* triangleShape = static_cast<const TriangleShape*>(shape2Info.collisionShape);
+
+    // We work in the local-space of the triangle
+    const Transform& triangleToWorld = shape2Info.shapeToWorldTransform;
+    const Transform capsuleToTriangle = triangleToWorld.getInverse() *
+                                        shape1Info.shapeToWorldTransform;
+
+    // Inner segment of the capsule (along the local Y axis of the capsule)
+    const decimal halfHeight = decimal(0.5) * capsuleShape->getHeight();
+    const Vector3 segmentPoint1 = capsuleToTriangle * Vector3(0, halfHeight, 0);
+    const Vector3 segmentPoint2 = capsuleToTriangle * Vector3(0, -halfHeight, 0);
+
+    const Vector3 triangleVertices[3] = {triangleShape->getVertex(0), triangleShape->getVertex(1),
+                                         triangleShape->getVertex(2)};
+
+    // Compute the closest points between the segment and the triangle
+    Vector3 closestPointSegment;
+    Vector3 closestPointTriangle;
+    const decimal distanceSquare = computeClosestPointsSegmentTriangle(segmentPoint1, segmentPoint2,
+                                                                       triangleVertices,
+                                                                       closestPointSegment,
+                                                                       closestPointTriangle);
+
+    const decimal radius = capsuleShape->getRadius();
+    const decimal triangleMargin = triangleShape->getMargin();
+    const decimal sumRadius = radius + triangleMargin;
+
+    // If the capsule does not touch the triangle
+    if (distanceSquare > sumRadius * sumRadius) return;
+
+    Vector3 normal;
+    decimal penetrationDepth;
+    Vector3 pointCapsule;
+    Vector3 pointTriangle;
+
+    // If the segment does not touch the triangle
+    if (distanceSquare > MACHINE_EPSILON) {
+
+        // The contact normal goes from the segment toward the triangle
+        const decimal distance = std::sqrt(distanceSquare);
+        normal = (closestPointTriangle - closestPointSegment) / distance;
+        penetrationDepth = sumRadius - distance;
+        pointCapsule = closestPointSegment + radius * normal;
+        pointTriangle = closestPointTriangle - triangleMargin * normal;
+    }
+    else {  // If the segment intersects the triangle
+
+        Vector3 triangleNormal = (triangleVertices[1] - triangleVertices[0]).cross(
+                                  triangleVertices[2] - triangleVertices[0]);
+        if (triangleNormal.lengthSquare() < MACHINE_EPSILON) return;
+        triangleNormal.normalize();
+
+        // Orient the triangle normal toward the center of the capsule
+        const Vector3 capsuleCenter = capsuleToTriangle.getPosition();
+        if (triangleNormal.dot(capsuleCenter - triangleVertices[0]) < decimal(0.0)) {
+            triangleNormal = -triangleNormal;
+        }
+
+        // The deepest end point of the segment gives the penetration depth
+        const decimal signedDistance1 = triangleNormal.dot(segmentPoint1 - triangleVertices[0]);
+        const decimal signedDistance2 = triangleNormal.dot(segmentPoint2 - triangleVertices[0]);
+        const bool isFirstPointDeeper = signedDistance1 < signedDistance2;
+        const Vector3& deepestPoint = isFirstPointDeeper ? segmentPoint1 : segmentPoint2;
+        const decimal deepestDistance = isFirstPointDeeper ? signedDistance1 : signedDistance2;
+
+        normal = -triangleNormal;
+        penetrationDepth = sumRadius - deepestDistance;
+        pointCapsule = deepestPoint + radius * normal;
+        pointTriangle = deepestPoint - (deepestDistance + triangleMargin) * triangleNormal;
+    }
+
+    // Create the contact info object
+    ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                 shape2Info.collisionShape, triangleToWorld.getOrientation() * normal,
+                                 penetrationDepth, capsuleToTriangle.getInverse() * pointCapsule,
+                                 pointTriangle);
+
+    // Notify about the new contact
+    narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+}
+
+// Compute the closest points between a segment and a triangle and return
+// the square distance between them
+/// The closest points are either an end point of the segment and its closest point on
+/// the triangle or the closest points between the segment and one of the triangle edges.
+/// If the segment crosses the triangle, the distance is zero.
+decimal CapsuleVsTriangleAlgorithm::computeClosestPointsSegmentTriangle(const Vector3& segmentPoint1,
+                                                                       const Vector3& segmentPoint2,
+                                                                       const Vector3* triangleVertices,
+                                                                       Vector3& closestPointSegment,
+                                                                       Vector3& closestPointTriangle) const {
+
+    const Vector3& a = triangleVertices[0];
+    const Vector3& b = triangleVertices[1];
+    const Vector3& c = triangleVertices[2];
+
+    // If the segment crosses the plane of the triangle, test if the intersection
+    // point is inside the triangle
+    const Vector3 triangleNormal = (b - a).cross(c - a);
+    const decimal signedDistance1 = triangleNormal.dot(segmentPoint1 - a);
+    const decimal signedDistance2 = triangleNormal.dot(segmentPoint2 - a);
+    if (!sameSign(signedDistance1, signedDistance2)) {
+        const decimal t = signedDistance1 / (signedDistance1 - signedDistance2);
+        const Vector3 intersectionPoint = segmentPoint1 + t * (segmentPoint2 - segmentPoint1);
+        decimal u, v, w;
+        computeBarycentricCoordinatesInTriangle(a, b, c, intersectionPoint, u, v, w);
+        if (u >= decimal(0.0) && v >= decimal(0.0) && w >= decimal(0.0)) {
+            closestPointSegment = intersectionPoint;
+            closestPointTriangle = intersectionPoint;
+            return decimal(0.0);
+        }
+    }
+
+    // End points of the segment
+    closestPointSegment = segmentPoint1;
+    closestPointTriangle = computeClosestPointOnTriangle(a, b, c, segmentPoint1);
+    decimal minDistanceSquare = (closestPointTriangle - closestPointSegment).lengthSquare();
+
+    Vector3 pointTriangle = computeClosestPointOnTriangle(a, b, c, segmentPoint2);
+    decimal distanceSquare = (pointTriangle - segmentPoint2).lengthSquare();
+    if (distanceSquare < minDistanceSquare) {
+        minDistanceSquare = distanceSquare;
+        closestPointSegment = segmentPoint2;
+        closestPointTriangle = pointTriangle;
+    }
+
+    // Edges of the triangle
+    for (int i=0; i<3; i++) {
+        Vector3 pointSegment;
+        distanceSquare = computeClosestPointsBetweenSegments(segmentPoint1, segmentPoint2,
+                                                             triangleVertices[i],
+                                                             triangleVertices[(i + 1) % 3],
+                                                             pointSegment, pointTriangle);
+        if (distanceSquare < minDistanceSquare) {
+            minDistanceSquare = distanceSquare;
+            closestPointSegment = pointSegment;
+            closestPointTriangle = pointTriangle;
+        }
+    }
+
+    return minDistanceSquare;
+}
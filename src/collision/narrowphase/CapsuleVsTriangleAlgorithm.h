@@ -0,0 +1,81 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CAPSULE_VS_TRIANGLE_ALGORITHM_H
+#define	REACTPHYSICS3D_CAPSULE_VS_TRIANGLE_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class CapsuleVsTriangleAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between a capsule and a triangle of a concave shape. The closest points
+ * between the inner segment of the capsule and the triangle are computed
+ * directly instead of running GJK/EPA. The first shape must be the capsule
+ * and the second shape the triangle.
+ */
+class CapsuleVsTriangleAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        CapsuleVsTriangleAlgorithm(const CapsuleVsTriangleAlgorithm& algorithm);
+
+        /// Private assignment operator
+        CapsuleVsTriangleAlgorithm& operator=(const CapsuleVsTriangleAlgorithm& algorithm);
+
+        /// Compute the closest points between a segment and a triangle and return
+        /// the square distance between them
+        decimal computeClosestPointsSegmentTriangle(const Vector3& segmentPoint1,
+                                                    const Vector3& segmentPoint2,
+                                                    const Vector3* triangleVertices,
+                                                    Vector3& closestPointSegment,
+                                                    Vector3& closestPointTriangle) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CapsuleVsTriangleAlgorithm();
+
+        /// Destructor
+        virtual ~CapsuleVsTriangleAlgorithm();
+
+        /// Compute a contact info if the two bounding volume collide
+        virtual void testCollision(const CollisionShapeInfo& shape1Info,
+                                   const CollisionShapeInfo& shape2Info,
+                                   NarrowPhaseCallback* narrowPhaseCallback);
+};
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CompoundVsConvexAlgorithm.h"
+#include "collision/CollisionDetection.h"
+#include "engine/CollisionWorld.h"
+
+using namespace reactphysics3d;
+
+// Constructor
+CompoundVsConvexAlgorithm::CompoundVsConvexAlgorithm() {
+
+}
+
+// Destructor
+CompoundVsConvexAlgorithm::~CompoundVsConvexAlgorithm() {
+
+}
+
+// Compute a contact info if the two bounding volumes collide
+void CompoundVsConvexAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
+                                              const CollisionShapeInfo& shape2Info,
+                                              NarrowPhaseCallback* narrowPhaseCallback) {
+
+    // Collision shape 1 is the compound shape, collision shape 2 is convex
+    const bool isCompoundShapeFirst = !shape1Info.collisionShape->isConvex();
+    const CollisionShapeInfo& compoundInfo = isCompoundShapeFirst ? shape1Info : shape2Info;
+    const CollisionShapeInfo& convexInfo = isCompoundShapeFirst ? shape2Info : shape1Info;
+
+    assert(compoundInfo.collisionShape->getType() == COMPOUND);
+    assert(convexInfo.collisionShape->isConvex());
+
+    const CompoundShape* compoundShape = static_cast<const CompoundShape*>(compoundInfo.collisionShape);
+    const ConvexShape* convexShape = static_cast<const ConvexShape*>(convexInfo.collisionShape);
+
+    // Compute the convex shape AABB in the local-space of the compound shape
+    AABB aabb;
+    const Transform convexToCompoundTransform = compoundInfo.shapeToWorldTransform.getInverse() *
+                                                convexInfo.shapeToWorldTransform;
+    convexShape->computeAABB(aabb, convexToCompoundTransform);
+
+    // Get the child shapes that overlap the convex shape
+    mOverlappingChildShapes.clear();
+    compoundShape->getChildShapesOverlappingAABB(aabb, mOverlappingChildShapes);
+
+    // For each overlapping child shape
+    for (uint i=0; i<mOverlappingChildShapes.size(); i++) {
+
+        const uint childIndex = mOverlappingChildShapes[i];
+        const ConvexShape* childShape = compoundShape->getChildShape(childIndex);
+        const Transform& childTransform = compoundShape->getChildTransform(childIndex);
+
+        // Select the collision algorithm to use between the child shape and the convex shape
+        NarrowPhaseAlgorithm* algo = isCompoundShapeFirst ?
+                    mCollisionDetection->getCollisionAlgorithm(childShape->getType(),
+                                                               convexShape->getType()) :
+                    mCollisionDetection->getCollisionAlgorithm(convexShape->getType(),
+                                                               childShape->getType());
+
+        // If there is no collision algorithm between those two kinds of shapes
+        if (algo == NULL) continue;
+
+        // Notify the narrow-phase algorithm about the overlapping pair we are going to test
+        algo->setCurrentOverlappingPair(compoundInfo.overlappingPair);
+
+        // The cached collision data of the compound proxy shape cannot be used for the
+        // child shapes because different child shapes would share the same cached data.
+        // Each child shape has its own cached data in the overlapping pair.
+        void** childCachedCollisionData = compoundInfo.overlappingPair->getCachedChildCollisionData(
+                    childIndex, compoundShape->getNbChildShapes());
+
+        CollisionShapeInfo childInfo(compoundInfo.proxyShape, childShape,
+                                     compoundInfo.shapeToWorldTransform * childTransform,
+                                     compoundInfo.overlappingPair, childCachedCollisionData);
+
+        // Convert the contact points of the child shape into the local-space of the compound shape
+        CompoundChildNarrowPhaseCallback childCallback(narrowPhaseCallback, childTransform,
+                                                       isCompoundShapeFirst);
+
+        // Use the collision algorithm to test collision between the child shape and the
+        // convex shape (the order of the shapes of the pair is kept)
+        if (isCompoundShapeFirst) {
+            algo->testCollision(childInfo, convexInfo, &childCallback);
+        }
+        else {
+            algo->testCollision(convexInfo, childInfo, &childCallback);
+        }
+    }
+}
+
+// Called by a narrow-phase collision algorithm when a new contact has been found
+void CompoundChildNarrowPhaseCallback::notifyContact(OverlappingPair* overlappingPair,
+                                                     const ContactPointInfo& contactInfo) {
+
+    ContactPointInfo compoundContactInfo(contactInfo);
+    if (mIsCompoundShapeFirst) {
+        compoundContactInfo.localPoint1 = mChildTransform * contactInfo.localPoint1;
+    }
+    else {
+        compoundContactInfo.localPoint2 = mChildTransform * contactInfo.localPoint2;
+    }
+
+    mNarrowPhaseCallback->notifyContact(overlappingPair, compoundContactInfo);
+}
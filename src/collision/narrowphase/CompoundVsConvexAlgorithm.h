@@ -0,0 +1,117 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_COMPOUND_VS_CONVEX_ALGORITHM_H
+#define	REACTPHYSICS3D_COMPOUND_VS_CONVEX_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+#include "collision/shapes/ConvexShape.h"
+#include "collision/shapes/CompoundShape.h"
+#include <vector>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class CompoundChildNarrowPhaseCallback
+/**
+ * This class is used as a narrow-phase callback to convert the contact points found
+ * between a child shape of a compound shape and a convex shape from the local-space
+ * of the child shape into the local-space of the compound shape before reporting them.
+ */
+class CompoundChildNarrowPhaseCallback : public NarrowPhaseCallback {
+
+    private:
+
+        /// Narrow-phase callback where the converted contacts are reported
+        NarrowPhaseCallback* mNarrowPhaseCallback;
+
+        /// Transform from the local-space of the child shape to the local-space of the
+        /// compound shape
+        Transform mChildTransform;
+
+        /// True if the compound shape is the first shape of the pair
+        bool mIsCompoundShapeFirst;
+
+    public:
+
+        // Constructor
+        CompoundChildNarrowPhaseCallback(NarrowPhaseCallback* narrowPhaseCallback,
+                                         const Transform& childTransform, bool isCompoundShapeFirst)
+          : mNarrowPhaseCallback(narrowPhaseCallback), mChildTransform(childTransform),
+            mIsCompoundShapeFirst(isCompoundShapeFirst) {
+
+        }
+
+        /// Called by a narrow-phase collision algorithm when a new contact has been found
+        virtual void notifyContact(OverlappingPair* overlappingPair,
+                                   const ContactPointInfo& contactInfo);
+};
+
+// Class CompoundVsConvexAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection between a
+ * compound shape and a convex shape. The AABB of the convex shape is used to find
+ * the child shapes of the compound shape that may collide with it using the Dynamic
+ * AABB tree of the compound shape. Then, the collision between the convex shape and
+ * each of those child shapes is computed with the algorithm of the collision dispatch.
+ */
+class CompoundVsConvexAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Indices of the child shapes overlapping the convex shape. This array is
+        /// cleared but never shrunk between two calls to avoid heap allocations.
+        std::vector<uint> mOverlappingChildShapes;
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        CompoundVsConvexAlgorithm(const CompoundVsConvexAlgorithm& algorithm);
+
+        /// Private assignment operator
+        CompoundVsConvexAlgorithm& operator=(const CompoundVsConvexAlgorithm& algorithm);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CompoundVsConvexAlgorithm();
+
+        /// Destructor
+        virtual ~CompoundVsConvexAlgorithm();
+
+        /// Compute a contact info if the two bounding volume collide
+        virtual void testCollision(const CollisionShapeInfo& shape1Info,
+                                   const CollisionShapeInfo& shape2Info,
+                                   NarrowPhaseCallback* narrowPhaseCallback);
+};
+
+}
+
+#endif
@@ -36,6 +36,9 @@ using namespace reactphysics3d;
 // Constructor
 ConcaveVsConvexAlgorithm::ConcaveVsConvexAlgorithm() {
 
+    // Pre-allocate the scratch arrays of the smooth mesh collision algorithm
+    mSmoothMeshContacts.reserve(NB_INITIAL_SMOOTH_MESH_CONTACTS);
+    mProcessedTriangleVertices.reserve(3 * NB_INITIAL_SMOOTH_MESH_CONTACTS);
 }
 
 // Destructor
@@ -43,6 +46,16 @@ ConcaveVsConvexAlgorithm::~ConcaveVsConvexAlgorithm() {
 
 }
 
+// Initalize the algorithm
+void ConcaveVsConvexAlgorithm::init(CollisionDetection* collisionDetection,
+                                    MemoryAllocator* memoryAllocator) {
+    NarrowPhaseAlgorithm::init(collisionDetection, memoryAllocator);
+
+    mSphereVsTriangleAlgorithm.init(collisionDetection, memoryAllocator);
+    mCapsuleVsTriangleAlgorithm.init(collisionDetection, memoryAllocator);
+    mBoxVsTriangleAlgorithm.init(collisionDetection, memoryAllocator);
+}
+
 // Return true and compute a contact info if the two bounding volumes collide
 void ConcaveVsConvexAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
                                              const CollisionShapeInfo& shape2Info,
@@ -74,32 +87,86 @@ void ConcaveVsConvexAlgorithm::testCollision(const CollisionShapeInfo& shape1Inf
     convexVsTriangleCallback.setConcaveShape(concaveShape);
     convexVsTriangleCallback.setProxyShapes(convexProxyShape, concaveProxyShape);
     convexVsTriangleCallback.setOverlappingPair(shape1Info.overlappingPair);
+    convexVsTriangleCallback.setConvexVsTriangleAlgorithm(
+                selectConvexVsTriangleAlgorithm(convexShape->getType()));
 
-    // Compute the convex shape AABB in the local-space of the convex shape
+    // Compute the convex shape AABB in the local-space of the concave shape
     AABB aabb;
-    convexShape->computeAABB(aabb, convexProxyShape->getLocalToWorldTransform());
+    const Transform convexToConcaveTransform = concaveProxyShape->getLocalToWorldTransform().getInverse() *
+                                               convexProxyShape->getLocalToWorldTransform();
+    convexShape->computeAABB(aabb, convexToConcaveTransform);
 
     // If smooth mesh collision is enabled for the concave mesh
     if (concaveShape->getIsSmoothMeshCollisionEnabled()) {
 
-        std::vector<SmoothMeshContactInfo> contactPoints;
+        // Reuse the scratch array of the algorithm to store the contacts
+        mSmoothMeshContacts.clear();
 
-        SmoothCollisionNarrowPhaseCallback smoothNarrowPhaseCallback(contactPoints);
+        SmoothCollisionNarrowPhaseCallback smoothNarrowPhaseCallback(mSmoothMeshContacts);
 
         convexVsTriangleCallback.setNarrowPhaseCallback(&smoothNarrowPhaseCallback);
 
         // Call the convex vs triangle callback for each triangle of the concave shape
-        concaveShape->testAllTriangles(convexVsTriangleCallback, aabb);
+        testOverlappingTriangles(shape1Info.overlappingPair, concaveShape, aabb,
+                                 convexVsTriangleCallback);
 
         // Run the smooth mesh collision algorithm
-        processSmoothMeshCollision(shape1Info.overlappingPair, contactPoints, narrowPhaseCallback);
+        processSmoothMeshCollision(shape1Info.overlappingPair, mSmoothMeshContacts, narrowPhaseCallback);
     }
     else {
 
         convexVsTriangleCallback.setNarrowPhaseCallback(narrowPhaseCallback);
 
         // Call the convex vs triangle callback for each triangle of the concave shape
-        concaveShape->testAllTriangles(convexVsTriangleCallback, aabb);
+        testOverlappingTriangles(shape1Info.overlappingPair, concaveShape, aabb,
+                                 convexVsTriangleCallback);
+    }
+}
+
+// Call a triangle callback for each triangle of the concave shape overlapping an AABB
+/// The triangles of the concave shape that overlap an inflated version of the AABB are
+/// cached in the overlapping pair. As long as the AABB stays inside the inflated AABB
+/// (and the concave shape has not been modified), the cached triangles are used instead
+/// of querying the concave shape (BVH or height field grid) again.
+/**
+ * @param overlappingPair The convex vs concave overlapping pair
+ * @param concaveShape The concave shape of the pair
+ * @param localAABB AABB of the convex shape in the local-space of the concave shape
+ * @param callback Callback to call for each overlapping triangle
+ */
+void ConcaveVsConvexAlgorithm::testOverlappingTriangles(OverlappingPair* overlappingPair,
+                                                        const ConcaveShape* concaveShape,
+                                                        const AABB& localAABB,
+                                                        TriangleCallback& callback) {
+
+    const uint geometryVersion = concaveShape->getGeometryVersion();
+
+    // If the cached triangles cannot be used anymore
+    if (!overlappingPair->isTrianglesCacheValid(localAABB, geometryVersion)) {
+
+        // Query the triangles overlapping the inflated AABB and cache them
+        AABB inflatedAABB = localAABB;
+        inflatedAABB.inflate(CONCAVE_TRIANGLES_CACHE_AABB_GAP, CONCAVE_TRIANGLES_CACHE_AABB_GAP,
+                             CONCAVE_TRIANGLES_CACHE_AABB_GAP);
+        overlappingPair->resetTrianglesCache(inflatedAABB, geometryVersion);
+        TrianglesCacheCallback trianglesCacheCallback(overlappingPair);
+        concaveShape->testAllTriangles(trianglesCacheCallback, inflatedAABB);
+    }
+
+    const decimal triangleMargin = concaveShape->getTriangleMargin();
+
+    // For each cached triangle
+    const uint nbTriangles = overlappingPair->getNbCachedTriangles();
+    for (uint i=0; i<nbTriangles; i++) {
+
+        const Vector3* trianglePoints = overlappingPair->getCachedTriangle(i);
+
+        // If the triangle overlaps the AABB
+        AABB triangleAABB = AABB::createAABBForTriangle(trianglePoints);
+        triangleAABB.inflate(triangleMargin, triangleMargin, triangleMargin);
+        if (triangleAABB.testCollision(localAABB)) {
+            callback.testTriangle(trianglePoints);
+        }
     }
 }
 
@@ -110,9 +177,13 @@ void ConvexVsTriangleCallback::testTriangle(const Vector3* trianglePoints) {
     decimal margin = mConcaveShape->getTriangleMargin();
     TriangleShape triangleShape(trianglePoints[0], trianglePoints[1], trianglePoints[2], margin);
 
-    // Select the collision algorithm to use between the triangle and the convex shape
-    NarrowPhaseAlgorithm* algo = mCollisionDetection->getCollisionAlgorithm(triangleShape.getType(),
-                                                                            mConvexShape->getType());
+    // Select the collision algorithm to use between the triangle and the convex shape. If
+    // there is no specialized algorithm for the convex shape, we use the collision dispatch
+    NarrowPhaseAlgorithm* algo = mConvexVsTriangleAlgorithm;
+    if (algo == NULL) {
+        algo = mCollisionDetection->getCollisionAlgorithm(triangleShape.getType(),
+                                                          mConvexShape->getType());
+    }
 
     // If there is no collision algorithm between those two kinds of shapes
     if (algo == NULL) return;
@@ -135,11 +206,11 @@ void ConvexVsTriangleCallback::testTriangle(const Vector3* trianglePoints) {
 // by Pierre Terdiman (http://www.codercorner.com/MeshContacts.pdf). This is used to avoid the collision
 // issue with some internal edges.
 void ConcaveVsConvexAlgorithm::processSmoothMeshCollision(OverlappingPair* overlappingPair,
-                                                          std::vector<SmoothMeshContactInfo> contactPoints,
+                                                          std::vector<SmoothMeshContactInfo>& contactPoints,
                                                           NarrowPhaseCallback* narrowPhaseCallback) {
 
     // Set with the triangle vertices already processed to void further contacts with same triangle
-    std::unordered_multimap<int, Vector3> processTriangleVertices;
+    mProcessedTriangleVertices.clear();
 
     // Sort the list of narrow-phase contacts according to their penetration depth
     std::sort(contactPoints.begin(), contactPoints.end(), ContactsDepthCompare());
@@ -148,7 +219,7 @@ void ConcaveVsConvexAlgorithm::processSmoothMeshCollision(OverlappingPair* overl
     std::vector<SmoothMeshContactInfo>::const_iterator it;
     for (it = contactPoints.begin(); it != contactPoints.end(); ++it) {
 
-        const SmoothMeshContactInfo info = *it;
+        const SmoothMeshContactInfo& info = *it;
         const Vector3& contactPoint = info.isFirstShapeTriangle ? info.contactInfo.localPoint1 : info.contactInfo.localPoint2;
 
         // Compute the barycentric coordinates of the point in the triangle
@@ -171,7 +242,7 @@ void ConcaveVsConvexAlgorithm::processSmoothMeshCollision(OverlappingPair* overl
             Vector3 contactVertex = !isUZero ? info.triangleVertices[0] : (!isVZero ? info.triangleVertices[1] : info.triangleVertices[2]);
 
             // Check that this triangle vertex has not been processed yet
-            if (!hasVertexBeenProcessed(processTriangleVertices, contactVertex)) {
+            if (!hasVertexBeenProcessed(contactVertex)) {
 
                 // Keep the contact as it is and report it
                 narrowPhaseCallback->notifyContact(overlappingPair, info.contactInfo);
@@ -183,8 +254,8 @@ void ConcaveVsConvexAlgorithm::processSmoothMeshCollision(OverlappingPair* overl
             Vector3 contactVertex2 = isUZero ? info.triangleVertices[2] : (isVZero ? info.triangleVertices[2] : info.triangleVertices[1]);
 
             // Check that this triangle edge has not been processed yet
-            if (!hasVertexBeenProcessed(processTriangleVertices, contactVertex1) &&
-                !hasVertexBeenProcessed(processTriangleVertices, contactVertex2)) {
+            if (!hasVertexBeenProcessed(contactVertex1) &&
+                !hasVertexBeenProcessed(contactVertex2)) {
 
                 // Keep the contact as it is and report it
                 narrowPhaseCallback->notifyContact(overlappingPair, info.contactInfo);
@@ -237,20 +308,20 @@ void ConcaveVsConvexAlgorithm::processSmoothMeshCollision(OverlappingPair* overl
 
         // Add the three vertices of the triangle to the set of processed
         // triangle vertices
-        addProcessedVertex(processTriangleVertices, info.triangleVertices[0]);
-        addProcessedVertex(processTriangleVertices, info.triangleVertices[1]);
-        addProcessedVertex(processTriangleVertices, info.triangleVertices[2]);
+        addProcessedVertex(info.triangleVertices[0]);
+        addProcessedVertex(info.triangleVertices[1]);
+        addProcessedVertex(info.triangleVertices[2]);
     }
 }
 
 // Return true if the vertex is in the set of already processed vertices
-bool ConcaveVsConvexAlgorithm::hasVertexBeenProcessed(const std::unordered_multimap<int, Vector3>& processTriangleVertices, const Vector3& vertex) const {
-
-    int key = int(vertex.x * vertex.y * vertex.z);
+/// The number of processed vertices is small (three per triangle in contact) so a linear
+/// search in the contiguous array is faster than a hash table and does not allocate.
+bool ConcaveVsConvexAlgorithm::hasVertexBeenProcessed(const Vector3& vertex) const {
 
-    auto range = processTriangleVertices.equal_range(key);
-    for (auto it = range.first; it != range.second; ++it) {
-        if (vertex.x == it->second.x && vertex.y == it->second.y && vertex.z == it->second.z) return true;
+    std::vector<Vector3>::const_iterator it;
+    for (it = mProcessedTriangleVertices.begin(); it != mProcessedTriangleVertices.end(); ++it) {
+        if (vertex.x == it->x && vertex.y == it->y && vertex.z == it->z) return true;
     }
 
     return false;
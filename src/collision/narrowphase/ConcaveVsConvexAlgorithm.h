@@ -28,9 +28,12 @@
 
 // Libraries
 #include "NarrowPhaseAlgorithm.h"
+#include "SphereVsTriangleAlgorithm.h"
+#include "CapsuleVsTriangleAlgorithm.h"
+#include "BoxVsTriangleAlgorithm.h"
 #include "collision/shapes/ConvexShape.h"
 #include "collision/shapes/ConcaveShape.h"
-#include <unordered_map>
+#include <vector>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -66,12 +69,20 @@ class ConvexVsTriangleCallback : public TriangleCallback {
         /// Broadphase overlapping pair
         OverlappingPair* mOverlappingPair;
 
+        /// Specialized convex vs triangle algorithm (NULL to use the collision dispatch)
+        NarrowPhaseAlgorithm* mConvexVsTriangleAlgorithm;
+
         /// Used to sort ContactPointInfos according to their penetration depth
         static bool contactsDepthCompare(const ContactPointInfo& contact1,
                                          const ContactPointInfo& contact2);
 
     public:
 
+        /// Constructor
+        ConvexVsTriangleCallback() : mConvexVsTriangleAlgorithm(NULL) {
+
+        }
+
         /// Set the collision detection pointer
         void setCollisionDetection(CollisionDetection* collisionDetection) {
             mCollisionDetection = collisionDetection;
@@ -103,6 +114,11 @@ class ConvexVsTriangleCallback : public TriangleCallback {
             mConcaveProxyShape = concaveProxyShape;
         }
 
+        /// Set the specialized algorithm to use between the convex shape and a triangle
+        void setConvexVsTriangleAlgorithm(NarrowPhaseAlgorithm* algorithm) {
+            mConvexVsTriangleAlgorithm = algorithm;
+        }
+
         /// Test collision between a triangle and the convex mesh shape
         virtual void testTriangle(const Vector3* trianglePoints);
 };
@@ -173,18 +189,62 @@ class SmoothCollisionNarrowPhaseCallback : public NarrowPhaseCallback {
 
 };
 
+// Class TrianglesCacheCallback
+/**
+ * This class is used as a triangle callback to store the triangles of a concave
+ * shape that overlap a given AABB into the triangles cache of an overlapping pair.
+ */
+class TrianglesCacheCallback : public TriangleCallback {
+
+    private:
+
+        /// Overlapping pair where to cache the triangles
+        OverlappingPair* mOverlappingPair;
+
+    public:
+
+        // Constructor
+        TrianglesCacheCallback(OverlappingPair* overlappingPair)
+          : mOverlappingPair(overlappingPair) {
+
+        }
+
+        /// Add the triangle into the triangles cache of the overlapping pair
+        virtual void testTriangle(const Vector3* trianglePoints) {
+            mOverlappingPair->addCachedTriangle(trianglePoints);
+        }
+};
+
 // Class ConcaveVsConvexAlgorithm
 /**
  * This class is used to compute the narrow-phase collision detection
  * between a concave collision shape and a convex collision shape. The idea is
  * to use the GJK collision detection algorithm to compute the collision between
- * the convex shape and each of the triangles in the concave shape.
+ * the convex shape and each of the triangles in the concave shape. For spheres,
+ * capsules and boxes, a specialized convex vs triangle algorithm is used instead.
  */
 class ConcaveVsConvexAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
-        // -------------------- Attributes -------------------- //        
+        // -------------------- Attributes -------------------- //
+
+        /// Sphere vs triangle collision algorithm
+        SphereVsTriangleAlgorithm mSphereVsTriangleAlgorithm;
+
+        /// Capsule vs triangle collision algorithm
+        CapsuleVsTriangleAlgorithm mCapsuleVsTriangleAlgorithm;
+
+        /// Box vs triangle collision algorithm
+        BoxVsTriangleAlgorithm mBoxVsTriangleAlgorithm;
+
+        /// Narrow-phase contacts collected for the smooth mesh collision algorithm. This
+        /// array is cleared but never shrunk between two calls to avoid heap allocations.
+        std::vector<SmoothMeshContactInfo> mSmoothMeshContacts;
+
+        /// Triangle vertices already processed by the smooth mesh collision algorithm.
+        /// This array is cleared but never shrunk between two calls.
+        std::vector<Vector3> mProcessedTriangleVertices;
 
         // -------------------- Methods -------------------- //
 
@@ -194,18 +254,24 @@ class ConcaveVsConvexAlgorithm : public NarrowPhaseAlgorithm {
         /// Private assignment operator
         ConcaveVsConvexAlgorithm& operator=(const ConcaveVsConvexAlgorithm& algorithm);
 
+        /// Return the specialized algorithm to use between a convex shape and a triangle
+        NarrowPhaseAlgorithm* selectConvexVsTriangleAlgorithm(CollisionShapeType convexShapeType);
+
+        /// Call a triangle callback for each triangle of the concave shape overlapping an AABB
+        void testOverlappingTriangles(OverlappingPair* overlappingPair,
+                                      const ConcaveShape* concaveShape,
+                                      const AABB& localAABB, TriangleCallback& callback);
+
         /// Process the concave triangle mesh collision using the smooth mesh collision algorithm
         void processSmoothMeshCollision(OverlappingPair* overlappingPair,
-                                        std::vector<SmoothMeshContactInfo> contactPoints,
+                                        std::vector<SmoothMeshContactInfo>& contactPoints,
                                         NarrowPhaseCallback* narrowPhaseCallback);
 
         /// Add a triangle vertex into the set of processed triangles
-        void addProcessedVertex(std::unordered_multimap<int, Vector3>& processTriangleVertices,
-                                const Vector3& vertex);
+        void addProcessedVertex(const Vector3& vertex);
 
         /// Return true if the vertex is in the set of already processed vertices
-        bool hasVertexBeenProcessed(const std::unordered_multimap<int, Vector3>& processTriangleVertices,
-                                    const Vector3& vertex) const;
+        bool hasVertexBeenProcessed(const Vector3& vertex) const;
 
     public :
 
@@ -217,15 +283,33 @@ class ConcaveVsConvexAlgorithm : public NarrowPhaseAlgorithm {
         /// Destructor
         virtual ~ConcaveVsConvexAlgorithm();
 
+        /// Initalize the algorithm
+        virtual void init(CollisionDetection* collisionDetection, MemoryAllocator* memoryAllocator);
+
         /// Compute a contact info if the two bounding volume collide
         virtual void testCollision(const CollisionShapeInfo& shape1Info,
                                    const CollisionShapeInfo& shape2Info,
                                    NarrowPhaseCallback* narrowPhaseCallback);
 };
 
+// Return the specialized algorithm to use between a convex shape and a triangle
+/// This method returns NULL if there is no specialized algorithm for this type of
+/// convex shape. In this case, the collision dispatch algorithm is used.
+inline NarrowPhaseAlgorithm* ConcaveVsConvexAlgorithm::selectConvexVsTriangleAlgorithm(
+                                                                CollisionShapeType convexShapeType) {
+    switch (convexShapeType) {
+        case SPHERE: return &mSphereVsTriangleAlgorithm;
+        case CAPSULE: return &mCapsuleVsTriangleAlgorithm;
+        case BOX: return &mBoxVsTriangleAlgorithm;
+        default: return NULL;
+    }
+}
+
 // Add a triangle vertex into the set of processed triangles
-inline void ConcaveVsConvexAlgorithm::addProcessedVertex(std::unordered_multimap<int, Vector3>& processTriangleVertices, const Vector3& vertex) {
-    processTriangleVertices.insert(std::make_pair(int(vertex.x * vertex.y * vertex.z), vertex));
+inline void ConcaveVsConvexAlgorithm::addProcessedVertex(const Vector3& vertex) {
+    if (!hasVertexBeenProcessed(vertex)) {
+        mProcessedTriangleVertices.push_back(vertex);
+    }
 }
 
 }
@@ -45,8 +45,11 @@ void DefaultCollisionDispatch::init(CollisionDetection* collisionDetection,
 
     // Initialize the collision algorithms
     mSphereVsSphereAlgorithm.init(collisionDetection, memoryAllocator);
+    mSphereVsBoxAlgorithm.init(collisionDetection, memoryAllocator);
+    mCapsuleVsCapsuleAlgorithm.init(collisionDetection, memoryAllocator);
     mGJKAlgorithm.init(collisionDetection, memoryAllocator);
     mConcaveVsConvexAlgorithm.init(collisionDetection, memoryAllocator);
+    mCompoundVsConvexAlgorithm.init(collisionDetection, memoryAllocator);
 }
 
 // Select and return the narrow-phase collision detection algorithm to
@@ -60,6 +63,20 @@ NarrowPhaseAlgorithm* DefaultCollisionDispatch::selectAlgorithm(int type1, int t
     if (shape1Type == SPHERE && shape2Type == SPHERE) {
         return &mSphereVsSphereAlgorithm;
     }
+    // Sphere vs Box algorithm
+    else if ((shape1Type == SPHERE && shape2Type == BOX) ||
+             (shape1Type == BOX && shape2Type == SPHERE)) {
+        return &mSphereVsBoxAlgorithm;
+    }
+    // Capsule vs Capsule algorithm
+    else if (shape1Type == CAPSULE && shape2Type == CAPSULE) {
+        return &mCapsuleVsCapsuleAlgorithm;
+    }
+    // Compound vs Convex algorithm
+    else if ((shape1Type == COMPOUND && CollisionShape::isConvex(shape2Type)) ||
+             (shape2Type == COMPOUND && CollisionShape::isConvex(shape1Type))) {
+        return &mCompoundVsConvexAlgorithm;
+    }
     // Concave vs Convex algorithm
     else if ((!CollisionShape::isConvex(shape1Type) && CollisionShape::isConvex(shape2Type)) ||
              (!CollisionShape::isConvex(shape2Type) && CollisionShape::isConvex(shape1Type))) {
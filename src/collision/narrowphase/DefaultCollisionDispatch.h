@@ -29,7 +29,10 @@
 // Libraries
 #include "CollisionDispatch.h"
 #include "ConcaveVsConvexAlgorithm.h"
+#include "CompoundVsConvexAlgorithm.h"
 #include "SphereVsSphereAlgorithm.h"
+#include "SphereVsBoxAlgorithm.h"
+#include "CapsuleVsCapsuleAlgorithm.h"
 #include "GJK/GJKAlgorithm.h"
 
 namespace reactphysics3d {
@@ -47,9 +50,18 @@ class DefaultCollisionDispatch : public CollisionDispatch {
         /// Sphere vs Sphere collision algorithm
         SphereVsSphereAlgorithm mSphereVsSphereAlgorithm;
 
+        /// Sphere vs Box collision algorithm
+        SphereVsBoxAlgorithm mSphereVsBoxAlgorithm;
+
+        /// Capsule vs Capsule collision algorithm
+        CapsuleVsCapsuleAlgorithm mCapsuleVsCapsuleAlgorithm;
+
         /// Concave vs Convex collision algorithm
         ConcaveVsConvexAlgorithm mConcaveVsConvexAlgorithm;
 
+        /// Compound vs Convex collision algorithm
+        CompoundVsConvexAlgorithm mCompoundVsConvexAlgorithm;
+
         /// GJK Algorithm
         GJKAlgorithm mGJKAlgorithm;
 
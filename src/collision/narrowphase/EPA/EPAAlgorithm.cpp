@@ -88,7 +88,7 @@ void EPAAlgorithm::computePenetrationDepthAndContactPoints(const Simplex& simple
                                                            CollisionShapeInfo shape2Info,
                                                            const Transform& transform2,
                                                            Vector3& v,
-                                                           NarrowPhaseCallback* narrowPhaseCallback) {
+                                                           NarrowPhaseCallback* narrowPhaseCallback) const {
 
     PROFILE("EPAAlgorithm::computePenetrationDepthAndContactPoints()");
 
@@ -103,7 +103,7 @@ class EPAAlgorithm {
 
         /// Add a triangle face in the candidate triangle heap
         void addFaceCandidate(TriangleEPA* triangle, TriangleEPA** heap, uint& nbTriangles,
-                              decimal upperBoundSquarePenDepth);
+                              decimal upperBoundSquarePenDepth) const;
 
         /// Decide if the origin is in the tetrahedron.
         int isOriginInTetrahedron(const Vector3& p1, const Vector3& p2,
@@ -129,12 +129,12 @@ class EPAAlgorithm {
                                                      CollisionShapeInfo shape2Info,
                                                      const Transform& transform2,
                                                      Vector3& v,
-                                                    NarrowPhaseCallback* narrowPhaseCallback);
+                                                     NarrowPhaseCallback* narrowPhaseCallback) const;
 };
 
 // Add a triangle face in the candidate triangle heap in the EPA algorithm
 inline void EPAAlgorithm::addFaceCandidate(TriangleEPA* triangle, TriangleEPA** heap,
-                                           uint& nbTriangles, decimal upperBoundSquarePenDepth) {
+                                           uint& nbTriangles, decimal upperBoundSquarePenDepth) const {
     
     // If the closest point of the affine hull of triangle
     // points is internal to the triangle and if the distance
@@ -26,6 +26,7 @@
 // Libraries
 #include "GJKAlgorithm.h"
 #include "Simplex.h"
+#include "collision/shapes/ConvexMeshSupportCache.h"
 #include "constraint/ContactPoint.h"
 #include "configuration.h"
 #include "engine/Profiler.h"
@@ -280,7 +281,7 @@ void GJKAlgorithm::computePenetrationDepthForEnlargedObjects(const CollisionShap
                                                              const CollisionShapeInfo& shape2Info,
                                                              const Transform& transform2,
                                                              NarrowPhaseCallback* narrowPhaseCallback,
-                                                             Vector3& v) {
+                                                             Vector3& v) const {
     PROFILE("GJKAlgorithm::computePenetrationDepthForEnlargedObjects()");
 
     Simplex simplex;
@@ -356,17 +357,34 @@ void GJKAlgorithm::computePenetrationDepthForEnlargedObjects(const CollisionShap
 }
 
 // Use the GJK Algorithm to find if a point is inside a convex collision shape
+/// The query uses its own collision data cache on the stack (and not the one of the proxy shape)
+/// so that several threads can perform queries on the same shape at the same time.
 bool GJKAlgorithm::testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) {
 
-    Vector3 suppA;             // Support point of object A
-    Vector3 w;                 // Support point of Minkowski difference A-B
-    decimal prevDistSquare;
-
     assert(proxyShape->getCollisionShape()->isConvex());
 
-    const ConvexShape* shape = static_cast<const ConvexShape*>(proxyShape->getCollisionShape());
+    return testPointInside(localPoint, static_cast<const ConvexShape*>(proxyShape->getCollisionShape()));
+}
+
+// Use the GJK Algorithm to find if a point is inside a given convex shape of a proxy shape
+/// The shape can be different from the collision shape of the proxy shape (child shape of
+/// a compound shape for instance). The point is expressed in the local-space of the shape.
+bool GJKAlgorithm::testPointInside(const Vector3& localPoint, const ConvexShape* shape) {
+
+    // Only the convex mesh shape uses a collision data cache
+    ConvexMeshSupportCache queryCache;
+    void* queryCachedCollisionData = &queryCache;
 
-    void** shapeCachedCollisionData = proxyShape->getCachedCollisionData();
+    return testPointInside(localPoint, shape, &queryCachedCollisionData);
+}
+
+// Use the GJK Algorithm to find if a point is inside a convex collision shape
+bool GJKAlgorithm::testPointInside(const Vector3& localPoint, const ConvexShape* shape,
+                                   void** shapeCachedCollisionData) {
+
+    Vector3 suppA;             // Support point of object A
+    Vector3 w;                 // Support point of Minkowski difference A-B
+    decimal prevDistSquare;
 
     // Support point of object B (object B is a single point)
     const Vector3 suppB(localPoint);
@@ -424,13 +442,32 @@ bool GJKAlgorithm::testPointInside(const Vector3& localPoint, ProxyShape* proxyS
 // Ray casting algorithm agains a convex collision shape using the GJK Algorithm
 /// This method implements the GJK ray casting algorithm described by Gino Van Den Bergen in
 /// "Ray Casting against General Convex Objects with Application to Continuous Collision Detection".
+/// The query uses its own collision data cache on the stack (and not the one of the proxy shape)
+/// so that several threads can perform queries on the same shape at the same time.
 bool GJKAlgorithm::raycast(const Ray& ray, ProxyShape* proxyShape, RaycastInfo& raycastInfo) {
 
     assert(proxyShape->getCollisionShape()->isConvex());
 
-    const ConvexShape* shape = static_cast<const ConvexShape*>(proxyShape->getCollisionShape());
+    return raycast(ray, static_cast<const ConvexShape*>(proxyShape->getCollisionShape()),
+                   proxyShape, raycastInfo);
+}
+
+// Ray casting algorithm agains a given convex shape of a proxy shape using the GJK Algorithm
+/// The shape can be different from the collision shape of the proxy shape (child shape of
+/// a compound shape for instance). The ray is expressed in the local-space of the shape.
+bool GJKAlgorithm::raycast(const Ray& ray, const ConvexShape* shape, ProxyShape* proxyShape,
+                           RaycastInfo& raycastInfo) {
 
-    void** shapeCachedCollisionData = proxyShape->getCachedCollisionData();
+    // Only the convex mesh shape uses a collision data cache
+    ConvexMeshSupportCache queryCache;
+    void* queryCachedCollisionData = &queryCache;
+
+    return raycast(ray, shape, proxyShape, raycastInfo, &queryCachedCollisionData);
+}
+
+// Ray casting algorithm agains a convex collision shape using the GJK Algorithm
+bool GJKAlgorithm::raycast(const Ray& ray, const ConvexShape* shape, ProxyShape* proxyShape,
+                           RaycastInfo& raycastInfo, void** shapeCachedCollisionData) {
 
     Vector3 suppA;      // Current lower bound point on the ray (starting at ray's origin)
     Vector3 suppB;      // Support point on the collision shape
@@ -526,3 +563,255 @@ bool GJKAlgorithm::raycast(const Ray& ray, ProxyShape* proxyShape, RaycastInfo&
 
     return true;
 }
+
+// Compute the closest points between two separated convex shapes (with margins)
+/// The GJK algorithm is run on the shapes without margins and the closest points are
+/// then projected onto the margins. The separating axis (in local-space of the first
+/// shape) is used to initialize the algorithm and is updated with the new one to
+/// exploit temporal coherence between consecutive queries. If the shapes overlap and
+/// the penetration points are requested, the two points are the contact points of the
+/// shapes (as for a contact between them): the point of each shape that is the deepest
+/// inside the other shape. They are computed as in testCollision() with the GJK algorithm
+/// if only the margins overlap and with the EPA algorithm otherwise.
+/**
+ * @param shape1 First convex shape
+ * @param transform1 Local-space to world-space transform of the first shape
+ * @param shape1CachedCollisionData Collision data cache of the first shape
+ * @param shape2 Second convex shape
+ * @param transform2 Local-space to world-space transform of the second shape
+ * @param shape2CachedCollisionData Collision data cache of the second shape
+ * @param separatingAxis Initial and final separating axis (local-space of the first shape)
+ * @param worldPoint1 Closest point on the first shape (in world-space)
+ * @param worldPoint2 Closest point on the second shape (in world-space)
+ * @param distance Distance between the two shapes
+ * @param computePenetrationPoints True if the world points have to be computed when the
+ *                                 shapes are overlapping
+ * @return False if the shapes (with margins) are overlapping and true otherwise
+ */
+bool GJKAlgorithm::computeClosestPoints(const ConvexShape* shape1, const Transform& transform1,
+                                        void** shape1CachedCollisionData,
+                                        const ConvexShape* shape2, const Transform& transform2,
+                                        void** shape2CachedCollisionData,
+                                        Vector3& separatingAxis, Vector3& worldPoint1,
+                                        Vector3& worldPoint2, decimal& distance,
+                                        bool computePenetrationPoints) const {
+
+    Vector3 suppA;             // Support point of object A
+    Vector3 suppB;             // Support point of object B
+    Vector3 w;                 // Support point of Minkowski difference A-B
+    Vector3 pA;                // Closest point of object A
+    Vector3 pB;                // Closest point of object B
+    decimal vDotw;
+    decimal prevDistSquare;
+
+    // Transform a point from local space of body 2 to local
+    // space of body 1 (the GJK algorithm is done in local space of body 1)
+    Transform body2Tobody1 = transform1.getInverse() * transform2;
+
+    // Matrix that transform a direction from local
+    // space of body 1 into local space of body 2
+    Matrix3x3 rotateToBody2 = transform2.getOrientation().getMatrix().getTranspose() *
+                              transform1.getOrientation().getMatrix();
+
+    // Create a simplex set
+    Simplex simplex;
+
+    Vector3 v = separatingAxis;
+    if (v.lengthSquare() < MACHINE_EPSILON) {
+        v.setAllValues(decimal(0.0), decimal(1.0), decimal(0.0));
+    }
+
+    // Initialize the upper bound for the square distance
+    decimal distSquare = DECIMAL_LARGEST;
+
+    do {
+
+        // Compute the support points for original objects (without margins) A and B
+        suppA = shape1->getLocalSupportPointWithoutMargin(-v, shape1CachedCollisionData);
+        suppB = body2Tobody1 *
+                shape2->getLocalSupportPointWithoutMargin(rotateToBody2 * v, shape2CachedCollisionData);
+
+        // Compute the support point for the Minkowski difference A-B
+        w = suppA - suppB;
+
+        vDotw = v.dot(w);
+
+        // If the closest point cannot be improved anymore
+        if (simplex.isPointInSimplex(w) || distSquare - vDotw <= distSquare * REL_ERROR_SQUARE) {
+            break;
+        }
+
+        // Add the new support point to the simplex
+        simplex.addPoint(w, suppA, suppB);
+
+        // If the simplex is affinely dependent
+        if (simplex.isAffinelyDependent()) break;
+
+        // Compute the point of the simplex closest to the origin
+        if (!simplex.computeClosestPoint(v)) break;
+
+        // Store and update the squared distance of the closest point
+        prevDistSquare = distSquare;
+        distSquare = v.lengthSquare();
+
+        // If the distance to the closest point doesn't improve a lot
+        if (prevDistSquare - distSquare <= MACHINE_EPSILON * prevDistSquare) {
+            simplex.backupClosestPointInSimplex(v);
+            distSquare = v.lengthSquare();
+            break;
+        }
+
+    } while(!simplex.isFull() && distSquare > MACHINE_EPSILON *
+                                 simplex.getMaxLengthSquareOfAPoint());
+
+    // If the objects without margins are overlapping
+    if (simplex.isEmpty() || simplex.isFull() ||
+        distSquare <= MACHINE_EPSILON * simplex.getMaxLengthSquareOfAPoint()) {
+
+        if (computePenetrationPoints) {
+
+            // Use the EPA algorithm on the enlarged objects. If it fails, the closest
+            // points of the objects without margins are used (they are in both objects).
+            if (!simplex.isEmpty()) {
+                simplex.computeClosestPointsOfAandB(pA, pB);
+                worldPoint1 = transform1 * pA;
+                worldPoint2 = transform1 * pB;
+            }
+            else {
+                worldPoint1 = transform1.getPosition();
+                worldPoint2 = transform2.getPosition();
+            }
+
+            PenetrationPointsCallback penetrationPointsCallback;
+            const CollisionShapeInfo shape1Info(NULL, shape1, transform1, NULL, shape1CachedCollisionData);
+            const CollisionShapeInfo shape2Info(NULL, shape2, transform2, NULL, shape2CachedCollisionData);
+            computePenetrationDepthForEnlargedObjects(shape1Info, transform1, shape2Info, transform2,
+                                                      &penetrationPointsCallback, v);
+            if (penetrationPointsCallback.isContactFound) {
+                worldPoint1 = transform1 * penetrationPointsCallback.localPoint1;
+                worldPoint2 = transform2 * penetrationPointsCallback.localPoint2;
+            }
+        }
+
+        return false;
+    }
+
+    separatingAxis = v;
+
+    // Compute the closest points of both objects (without the margins)
+    simplex.computeClosestPointsOfAandB(pA, pB);
+
+    // Remove the margins from the distance between the objects
+    const decimal dist = std::sqrt(distSquare);
+    distance = dist - shape1->getMargin() - shape2->getMargin();
+    if (distance <= decimal(0.0) && !computePenetrationPoints) return false;
+
+    // Project the two points on the margins to have the closest points of both
+    // objects with the margins
+    pA = pA - (shape1->getMargin() / dist) * v;
+    pB = pB + (shape2->getMargin() / dist) * v;
+
+    worldPoint1 = transform1 * pA;
+    worldPoint2 = transform1 * pB;
+
+    return distance > decimal(0.0);
+}
+
+// Compute the time of impact of a moving convex shape against a static convex shape
+/// This method uses the conservative advancement algorithm described by Brian Mirtich
+/// in "Impulse-based Dynamic Simulation of Rigid Body Systems". The first shape moves
+/// from the "from" transform to the "to" transform (the position and the orientation
+/// are interpolated). At each step, the distance between the shapes is computed with
+/// GJK and the shape is advanced by the largest fraction of its motion that cannot make
+/// it penetrate the other shape. As for ray casting, if the shapes are overlapping at
+/// the beginning of the motion, no hit is reported.
+/**
+ * @param shape1 Moving convex shape
+ * @param fromTransform1 Local-space to world-space transform of the moving shape at the
+ *                       beginning of the motion
+ * @param toTransform1 Local-space to world-space transform of the moving shape at the
+ *                     end of the motion
+ * @param shape1CachedCollisionData Collision data cache of the moving shape
+ * @param shape2 Static convex shape
+ * @param transform2 Local-space to world-space transform of the static shape
+ * @param shape2CachedCollisionData Collision data cache of the static shape
+ * @param maxFraction Maximum fraction of the motion to consider
+ * @param hitFraction Fraction of the motion at the time of impact
+ * @param worldPoint Contact point on the static shape (in world-space)
+ * @param worldNormal Surface normal of the static shape at the contact point (in world-space)
+ * @return True if the moving shape hits the static shape before the maximum fraction
+ */
+bool GJKAlgorithm::computeTimeOfImpact(const ConvexShape* shape1, const Transform& fromTransform1,
+                                       const Transform& toTransform1, void** shape1CachedCollisionData,
+                                       const ConvexShape* shape2, const Transform& transform2,
+                                       void** shape2CachedCollisionData, decimal maxFraction,
+                                       decimal& hitFraction, Vector3& worldPoint,
+                                       Vector3& worldNormal) const {
+
+    PROFILE("GJKAlgorithm::computeTimeOfImpact()");
+
+    const Vector3 translation = toTransform1.getPosition() - fromTransform1.getPosition();
+
+    // Compute the rotation angle between the two orientations of the moving shape
+    const decimal cosHalfAngle = std::min(std::abs(fromTransform1.getOrientation().dot(
+                                                   toTransform1.getOrientation())), decimal(1.0));
+    const decimal rotationAngle = decimal(2.0) * std::acos(cosHalfAngle);
+
+    // Compute the largest distance between the origin of the moving shape and its surface
+    Vector3 minBounds, maxBounds;
+    shape1->getLocalBounds(minBounds, maxBounds);
+    const Vector3 farthestCorner(std::max(std::abs(minBounds.x), std::abs(maxBounds.x)),
+                                 std::max(std::abs(minBounds.y), std::abs(maxBounds.y)),
+                                 std::max(std::abs(minBounds.z), std::abs(maxBounds.z)));
+    const decimal angularBound = rotationAngle * farthestCorner.length();
+
+    Vector3 separatingAxis = -translation;
+    Vector3 point1, point2;
+    decimal distance;
+    decimal fraction = decimal(0.0);
+
+    for (int i=0; i < MAX_ITERATIONS_CONSERVATIVE_ADVANCEMENT; i++) {
+
+        const Transform transform1 = Transform::interpolateTransforms(fromTransform1,
+                                                                      toTransform1, fraction);
+
+        // Compute the distance and the closest points between the shapes
+        if (!computeClosestPoints(shape1, transform1, shape1CachedCollisionData, shape2, transform2,
+                                  shape2CachedCollisionData, separatingAxis, point1, point2,
+                                  distance)) {
+
+            // If the shapes are overlapping at the beginning of the motion, there is no hit
+            if (i == 0) return false;
+
+            // The shapes can only overlap after an advancement because of numerical errors.
+            // We report a hit with the contact point and normal of the previous iteration.
+            hitFraction = fraction;
+            return true;
+        }
+
+        const Vector3 normal = (point2 - point1) / distance;
+        worldPoint = point2;
+        worldNormal = -normal;
+
+        // If the shapes are close enough, we have found the time of impact
+        if (distance < CONSERVATIVE_ADVANCEMENT_TOLERANCE) {
+            hitFraction = fraction;
+            return true;
+        }
+
+        // Compute an upper bound of the approach speed of any point of the moving
+        // shape along the normal (per unit of fraction of the motion)
+        const decimal approachSpeedBound = translation.dot(normal) + angularBound;
+
+        // If the moving shape cannot get closer to the static shape
+        if (approachSpeedBound <= MACHINE_EPSILON) return false;
+
+        // Advance the moving shape such that it cannot penetrate the static shape
+        fraction += (distance - decimal(0.5) * CONSERVATIVE_ADVANCEMENT_TOLERANCE) / approachSpeedBound;
+
+        if (fraction > maxFraction) return false;
+    }
+
+    return false;
+}
+
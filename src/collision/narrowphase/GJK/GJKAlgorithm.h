@@ -40,6 +40,40 @@ namespace reactphysics3d {
 const decimal REL_ERROR = decimal(1.0e-3);
 const decimal REL_ERROR_SQUARE = REL_ERROR * REL_ERROR;
 const int MAX_ITERATIONS_GJK_RAYCAST = 32;
+const int MAX_ITERATIONS_CONSERVATIVE_ADVANCEMENT = 64;
+const decimal CONSERVATIVE_ADVANCEMENT_TOLERANCE = decimal(0.001);
+
+// Class PenetrationPointsCallback
+/**
+ * Narrow-phase callback used to record the contact points computed by the EPA
+ * algorithm when the penetration points of two shapes are queried.
+ */
+class PenetrationPointsCallback : public NarrowPhaseCallback {
+
+    public:
+
+        /// True if a contact has been reported
+        bool isContactFound;
+
+        /// Contact point on the first shape (in local-space of the first shape)
+        Vector3 localPoint1;
+
+        /// Contact point on the second shape (in local-space of the second shape)
+        Vector3 localPoint2;
+
+        // Constructor
+        PenetrationPointsCallback() : isContactFound(false) {
+
+        }
+
+        // Called by the EPA algorithm when the contact has been computed
+        virtual void notifyContact(OverlappingPair* overlappingPair,
+                                   const ContactPointInfo& contactInfo) {
+            isContactFound = true;
+            localPoint1 = contactInfo.localPoint1;
+            localPoint2 = contactInfo.localPoint2;
+        }
+};
 
 // Class GJKAlgorithm
 /**
@@ -80,7 +114,15 @@ class GJKAlgorithm : public NarrowPhaseAlgorithm {
                                                        const CollisionShapeInfo& shape2Info,
                                                        const Transform& transform2,
                                                        NarrowPhaseCallback* narrowPhaseCallback,
-                                                       Vector3& v);
+                                                       Vector3& v) const;
+
+        /// Use the GJK Algorithm to find if a point is inside a convex collision shape
+        bool testPointInside(const Vector3& localPoint, const ConvexShape* shape,
+                             void** shapeCachedCollisionData);
+
+        /// Ray casting algorithm agains a convex collision shape using the GJK Algorithm
+        bool raycast(const Ray& ray, const ConvexShape* shape, ProxyShape* proxyShape,
+                     RaycastInfo& raycastInfo, void** shapeCachedCollisionData);
 
     public :
 
@@ -104,8 +146,33 @@ class GJKAlgorithm : public NarrowPhaseAlgorithm {
         /// Use the GJK Algorithm to find if a point is inside a convex collision shape
         bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape);
 
+        /// Use the GJK Algorithm to find if a point is inside a given convex shape of a proxy shape
+        bool testPointInside(const Vector3& localPoint, const ConvexShape* shape);
+
         /// Ray casting algorithm agains a convex collision shape using the GJK Algorithm
         bool raycast(const Ray& ray, ProxyShape* proxyShape, RaycastInfo& raycastInfo);
+
+        /// Ray casting algorithm agains a given convex shape of a proxy shape using the GJK Algorithm
+        bool raycast(const Ray& ray, const ConvexShape* shape, ProxyShape* proxyShape,
+                     RaycastInfo& raycastInfo);
+
+        /// Compute the closest points between two separated convex shapes (with margins)
+        bool computeClosestPoints(const ConvexShape* shape1, const Transform& transform1,
+                                  void** shape1CachedCollisionData,
+                                  const ConvexShape* shape2, const Transform& transform2,
+                                  void** shape2CachedCollisionData,
+                                  Vector3& separatingAxis, Vector3& worldPoint1,
+                                  Vector3& worldPoint2, decimal& distance,
+                                  bool computePenetrationPoints = false) const;
+
+        /// Compute the time of impact of a moving convex shape against a static
+        /// convex shape using conservative advancement
+        bool computeTimeOfImpact(const ConvexShape* shape1, const Transform& fromTransform1,
+                                 const Transform& toTransform1, void** shape1CachedCollisionData,
+                                 const ConvexShape* shape2, const Transform& transform2,
+                                 void** shape2CachedCollisionData, decimal maxFraction,
+                                 decimal& hitFraction, Vector3& worldPoint,
+                                 Vector3& worldNormal) const;
 };
 
 // Initalize the algorithm
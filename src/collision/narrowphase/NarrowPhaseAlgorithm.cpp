@@ -45,3 +45,38 @@ void NarrowPhaseAlgorithm::init(CollisionDetection* collisionDetection, MemoryAl
     mCollisionDetection = collisionDetection;
     mMemoryAllocator = memoryAllocator;
 }
+
+// Compute the contacts of a batch of overlapping pairs with the same shape types
+/// The collision detection groups the overlapping pairs by types of collision shapes
+/// and calls this method once per group. By default, the pairs are tested one by one
+/// with the testCollision() method. An algorithm can override this method to process
+/// several pairs at the same time.
+/**
+ * @param overlappingPairs Array of overlapping pairs to test
+ * @param nbPairs Number of overlapping pairs in the array
+ * @param narrowPhaseCallback Callback to notify about the new contacts
+ */
+void NarrowPhaseAlgorithm::testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                              NarrowPhaseCallback* narrowPhaseCallback) {
+
+    // For each overlapping pair of the batch
+    for (uint i=0; i<nbPairs; i++) {
+
+        OverlappingPair* pair = overlappingPairs[i];
+        ProxyShape* shape1 = pair->getShape1();
+        ProxyShape* shape2 = pair->getShape2();
+
+        // Notify the narrow-phase algorithm about the overlapping pair we are going to test
+        setCurrentOverlappingPair(pair);
+
+        // Create the CollisionShapeInfo objects
+        CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), shape1->getLocalToWorldTransform(),
+                                      pair, shape1->getCachedCollisionData());
+        CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), shape2->getLocalToWorldTransform(),
+                                      pair, shape2->getCachedCollisionData());
+
+        // Use the narrow-phase collision detection algorithm to check
+        // if there really is a collision
+        testCollision(shape1Info, shape2Info, narrowPhaseCallback);
+    }
+}
@@ -102,6 +102,10 @@ class NarrowPhaseAlgorithm {
         virtual void testCollision(const CollisionShapeInfo& shape1Info,
                                    const CollisionShapeInfo& shape2Info,
                                    NarrowPhaseCallback* narrowPhaseCallback)=0;
+
+        /// Compute the contacts of a batch of overlapping pairs with the same shape types
+        virtual void testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                        NarrowPhaseCallback* narrowPhaseCallback);
 };
 
 // Set the current overlapping pair of bodies
@@ -0,0 +1,255 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "SphereVsBoxAlgorithm.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/BoxShape.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+SphereVsBoxAlgorithm::SphereVsBoxAlgorithm() : NarrowPhaseAlgorithm() {
+
+}
+
+// Destructor
+SphereVsBoxAlgorithm::~SphereVsBoxAlgorithm() {
+
+}
+
+// Compute a contact info if the sphere and the box collide
+/// The box rounded by its collision margin intersects the sphere if the box without
+/// its margin intersects the sphere with a radius increased by the margin.
+void SphereVsBoxAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
+                                         const CollisionShapeInfo& shape2Info,
+                                         NarrowPhaseCallback* narrowPhaseCallback) {
+
+    // Find which shape is the sphere
+    const bool isSphereShape1 = shape1Info.collisionShape->getType() == SPHERE;
+    const CollisionShapeInfo& sphereInfo = isSphereShape1 ? shape1Info : shape2Info;
+    const CollisionShapeInfo& boxInfo = isSphereShape1 ? shape2Info : shape1Info;
+    assert(sphereInfo.collisionShape->getType() == SPHERE);
+    assert(boxInfo.collisionShape->getType() == BOX);
+
+    const SphereShape* sphereShape = static_cast<const SphereShape*>(sphereInfo.collisionShape);
+    const BoxShape* boxShape = static_cast<const BoxShape*>(boxInfo.collisionShape);
+    const decimal margin = boxShape->getMargin();
+
+    // Compute the sphere center in the local-space of the box
+    const Vector3 center = boxInfo.shapeToWorldTransform.getInverse() *
+                           sphereInfo.shapeToWorldTransform.getPosition();
+    const Vector3 boxExtent = boxShape->getExtent() - Vector3(margin, margin, margin);
+    const decimal radius = sphereShape->getRadius() + margin;
+
+    // Compute the point of the box without margin that is closest to the sphere center
+    const Vector3 closestPoint(clamp(center.x, -boxExtent.x, boxExtent.x),
+                               clamp(center.y, -boxExtent.y, boxExtent.y),
+                               clamp(center.z, -boxExtent.z, boxExtent.z));
+    const decimal distanceSquare = (center - closestPoint).lengthSquare();
+
+    // If the sphere touches the box
+    if (distanceSquare <= radius * radius) {
+        reportContact(shape1Info, shape2Info, center, closestPoint, distanceSquare, narrowPhaseCallback);
+    }
+}
+
+// Compute the contacts of a batch of sphere vs box overlapping pairs
+/// The pairs are processed by packs of four as in SphereVsSphereAlgorithm::testCollisionBatch().
+/// The sphere centers in the local-space of the boxes and the extents of the boxes are
+/// gathered into separate arrays (one per coordinate) so that the closest points and the
+/// overlap tests of the four pairs can be vectorized by the compiler.
+void SphereVsBoxAlgorithm::testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                              NarrowPhaseCallback* narrowPhaseCallback) {
+
+    const uint packSize = 4;
+
+    Transform transforms1[packSize];
+    Transform transforms2[packSize];
+    decimal centerX[packSize];
+    decimal centerY[packSize];
+    decimal centerZ[packSize];
+    decimal extentX[packSize];
+    decimal extentY[packSize];
+    decimal extentZ[packSize];
+    decimal radius[packSize];
+    decimal closestX[packSize];
+    decimal closestY[packSize];
+    decimal closestZ[packSize];
+    decimal distanceSquares[packSize];
+    bool isColliding[packSize];
+
+    // For each pack of pairs
+    for (uint firstPair=0; firstPair<nbPairs; firstPair += packSize) {
+
+        const uint nbPairsInPack = std::min(packSize, nbPairs - firstPair);
+
+        // Gather the data of the pairs of the pack
+        for (uint k=0; k<packSize; k++) {
+
+            // The unused lanes of the last pack never collide
+            if (k >= nbPairsInPack) {
+                centerX[k] = centerY[k] = centerZ[k] = decimal(1.0);
+                extentX[k] = extentY[k] = extentZ[k] = decimal(0.0);
+                radius[k] = decimal(0.0);
+                continue;
+            }
+
+            const OverlappingPair* pair = overlappingPairs[firstPair + k];
+            const ProxyShape* shape1 = pair->getShape1();
+            const ProxyShape* shape2 = pair->getShape2();
+            transforms1[k] = shape1->getLocalToWorldTransform();
+            transforms2[k] = shape2->getLocalToWorldTransform();
+
+            const bool isSphereShape1 = shape1->getCollisionShape()->getType() == SPHERE;
+            const ProxyShape* sphereShape = isSphereShape1 ? shape1 : shape2;
+            const ProxyShape* boxShape = isSphereShape1 ? shape2 : shape1;
+            const Transform& sphereToWorld = isSphereShape1 ? transforms1[k] : transforms2[k];
+            const Transform& boxToWorld = isSphereShape1 ? transforms2[k] : transforms1[k];
+            const BoxShape* box = static_cast<const BoxShape*>(boxShape->getCollisionShape());
+            const decimal margin = box->getMargin();
+
+            const Vector3 center = boxToWorld.getInverse() * sphereToWorld.getPosition();
+            const Vector3 extent = box->getExtent() - Vector3(margin, margin, margin);
+            centerX[k] = center.x;
+            centerY[k] = center.y;
+            centerZ[k] = center.z;
+            extentX[k] = extent.x;
+            extentY[k] = extent.y;
+            extentZ[k] = extent.z;
+            radius[k] = static_cast<const SphereShape*>(sphereShape->getCollisionShape())->getRadius() +
+                        margin;
+        }
+
+        // Test the overlap of the four pairs
+        for (uint k=0; k<packSize; k++) {
+            closestX[k] = std::min(std::max(centerX[k], -extentX[k]), extentX[k]);
+            closestY[k] = std::min(std::max(centerY[k], -extentY[k]), extentY[k]);
+            closestZ[k] = std::min(std::max(centerZ[k], -extentZ[k]), extentZ[k]);
+            const decimal deltaX = centerX[k] - closestX[k];
+            const decimal deltaY = centerY[k] - closestY[k];
+            const decimal deltaZ = centerZ[k] - closestZ[k];
+            distanceSquares[k] = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+            isColliding[k] = distanceSquares[k] <= radius[k] * radius[k];
+        }
+
+        // Report the contacts of the pack
+        for (uint k=0; k<nbPairsInPack; k++) {
+
+            if (!isColliding[k]) continue;
+
+            OverlappingPair* pair = overlappingPairs[firstPair + k];
+            ProxyShape* shape1 = pair->getShape1();
+            ProxyShape* shape2 = pair->getShape2();
+            setCurrentOverlappingPair(pair);
+            CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), transforms1[k],
+                                          pair, shape1->getCachedCollisionData());
+            CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), transforms2[k],
+                                          pair, shape2->getCachedCollisionData());
+            reportContact(shape1Info, shape2Info, Vector3(centerX[k], centerY[k], centerZ[k]),
+                          Vector3(closestX[k], closestY[k], closestZ[k]), distanceSquares[k],
+                          narrowPhaseCallback);
+        }
+    }
+}
+
+// Report the contact between a sphere and a box that intersect
+/**
+ * @param shape1Info Information about the first shape
+ * @param shape2Info Information about the second shape
+ * @param center Center of the sphere in the local-space of the box
+ * @param closestPoint Point of the box without margin that is closest to the sphere center
+ * @param distanceSquare Square distance between the sphere center and the closest point
+ * @param narrowPhaseCallback Callback to notify about the new contact
+ */
+void SphereVsBoxAlgorithm::reportContact(const CollisionShapeInfo& shape1Info,
+                                         const CollisionShapeInfo& shape2Info,
+                                         const Vector3& center, const Vector3& closestPoint,
+                                         decimal distanceSquare,
+                                         NarrowPhaseCallback* narrowPhaseCallback) const {
+
+    const bool isSphereShape1 = shape1Info.collisionShape->getType() == SPHERE;
+    const CollisionShapeInfo& sphereInfo = isSphereShape1 ? shape1Info : shape2Info;
+    const CollisionShapeInfo& boxInfo = isSphereShape1 ? shape2Info : shape1Info;
+
+    const SphereShape* sphereShape = static_cast<const SphereShape*>(sphereInfo.collisionShape);
+    const BoxShape* boxShape = static_cast<const BoxShape*>(boxInfo.collisionShape);
+    const Transform& sphereToWorld = sphereInfo.shapeToWorldTransform;
+    const Transform& boxToWorld = boxInfo.shapeToWorldTransform;
+    const decimal margin = boxShape->getMargin();
+    const Vector3 boxExtent = boxShape->getExtent();
+    const decimal radius = sphereShape->getRadius();
+
+    // Contact normal (from the sphere toward the box) in the local-space of the box
+    Vector3 normal;
+    decimal penetrationDepth;
+    Vector3 pointBox;
+
+    // If the sphere center is outside the box without margin
+    if (distanceSquare > MACHINE_EPSILON) {
+        const decimal distance = std::sqrt(distanceSquare);
+        normal = (closestPoint - center) / distance;
+        penetrationDepth = radius + margin - distance;
+        pointBox = closestPoint - margin * normal;
+    }
+    else {  // If the sphere center is inside the box without margin
+
+        // Find the face of the box that is the closest to the sphere center
+        int closestFaceAxis = 0;
+        decimal minDistanceToFace = boxExtent.x - std::abs(center.x);
+        for (int i=1; i<3; i++) {
+            const decimal distanceToFace = boxExtent[i] - std::abs(center[i]);
+            if (distanceToFace < minDistanceToFace) {
+                minDistanceToFace = distanceToFace;
+                closestFaceAxis = i;
+            }
+        }
+
+        const decimal sign = center[closestFaceAxis] >= decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+        normal.setToZero();
+        normal[closestFaceAxis] = -sign;
+        penetrationDepth = radius + minDistanceToFace;
+        pointBox = center;
+        pointBox[closestFaceAxis] = sign * boxExtent[closestFaceAxis];
+    }
+
+    const Vector3 worldNormal = boxToWorld.getOrientation() * normal;
+    const Vector3 pointSphere = radius * (sphereToWorld.getOrientation().getInverse() * worldNormal);
+
+    // Create the contact info object (the normal goes from the first to the second shape)
+    if (isSphereShape1) {
+        ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                     shape2Info.collisionShape, worldNormal, penetrationDepth,
+                                     pointSphere, pointBox);
+        narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+    }
+    else {
+        ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                     shape2Info.collisionShape, -worldNormal, penetrationDepth,
+                                     pointBox, pointSphere);
+        narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+    }
+}
@@ -0,0 +1,82 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SPHERE_VS_BOX_ALGORITHM_H
+#define	REACTPHYSICS3D_SPHERE_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include "NarrowPhaseAlgorithm.h"
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Class SphereVsBoxAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between a sphere and a box. The contact is computed directly from the
+ * point of the box that is closest to the sphere center instead of running
+ * GJK/EPA. As with GJK, the box is rounded by its collision margin. The
+ * sphere can either be the first or the second shape.
+ */
+class SphereVsBoxAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        SphereVsBoxAlgorithm(const SphereVsBoxAlgorithm& algorithm);
+
+        /// Private assignment operator
+        SphereVsBoxAlgorithm& operator=(const SphereVsBoxAlgorithm& algorithm);
+
+        /// Report the contact between a sphere and a box that intersect
+        void reportContact(const CollisionShapeInfo& shape1Info, const CollisionShapeInfo& shape2Info,
+                           const Vector3& center, const Vector3& closestPoint, decimal distanceSquare,
+                           NarrowPhaseCallback* narrowPhaseCallback) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SphereVsBoxAlgorithm();
+
+        /// Destructor
+        virtual ~SphereVsBoxAlgorithm();
+
+        /// Compute a contact info if the two bounding volume collide
+        virtual void testCollision(const CollisionShapeInfo& shape1Info,
+                                   const CollisionShapeInfo& shape2Info,
+                                   NarrowPhaseCallback* narrowPhaseCallback);
+
+        /// Compute the contacts of a batch of sphere vs box overlapping pairs
+        virtual void testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                        NarrowPhaseCallback* narrowPhaseCallback);
+};
+
+}
+
+#endif
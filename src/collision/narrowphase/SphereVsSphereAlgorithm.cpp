@@ -40,6 +40,7 @@ SphereVsSphereAlgorithm::~SphereVsSphereAlgorithm() {
     
 }   
 
+// Compute a contact info if the two spheres collide
 void SphereVsSphereAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
                                             const CollisionShapeInfo& shape2Info,
                                             NarrowPhaseCallback* narrowPhaseCallback) {
@@ -61,20 +62,109 @@ void SphereVsSphereAlgorithm::testCollision(const CollisionShapeInfo& shape1Info
     
     // If the sphere collision shapes intersect
     if (squaredDistanceBetweenCenters <= sumRadius * sumRadius) {
-        Vector3 centerSphere2InBody1LocalSpace = transform1.getInverse() * transform2.getPosition();
-        Vector3 centerSphere1InBody2LocalSpace = transform2.getInverse() * transform1.getPosition();
-        Vector3 intersectionOnBody1 = sphereShape1->getRadius() *
-                                      centerSphere2InBody1LocalSpace.getUnit();
-        Vector3 intersectionOnBody2 = sphereShape2->getRadius() *
-                                      centerSphere1InBody2LocalSpace.getUnit();
-        decimal penetrationDepth = sumRadius - std::sqrt(squaredDistanceBetweenCenters);
-        
-        // Create the contact info object
-        ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
-                                     shape2Info.collisionShape, vectorBetweenCenters.getUnit(), penetrationDepth,
-                                     intersectionOnBody1, intersectionOnBody2);
-
-        // Notify about the new contact
-        narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+        reportContact(shape1Info, shape2Info, squaredDistanceBetweenCenters, narrowPhaseCallback);
     }
 }
+
+// Compute the contacts of a batch of sphere vs sphere overlapping pairs
+/// The pairs are processed by packs of four. The centers and radii of a pack are first
+/// gathered into separate arrays (one per coordinate) so that the overlap test of the
+/// four pairs has no dependency between the pairs and can be vectorized by the compiler.
+/// The contacts of the pack are reported afterwards.
+void SphereVsSphereAlgorithm::testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                                 NarrowPhaseCallback* narrowPhaseCallback) {
+
+    const uint packSize = 4;
+
+    Transform transforms1[packSize];
+    Transform transforms2[packSize];
+    decimal deltaX[packSize];
+    decimal deltaY[packSize];
+    decimal deltaZ[packSize];
+    decimal sumRadius[packSize];
+    decimal squaredDistances[packSize];
+    bool isColliding[packSize];
+
+    // For each pack of pairs
+    for (uint firstPair=0; firstPair<nbPairs; firstPair += packSize) {
+
+        const uint nbPairsInPack = std::min(packSize, nbPairs - firstPair);
+
+        // Gather the data of the pairs of the pack
+        for (uint k=0; k<packSize; k++) {
+
+            // The unused lanes of the last pack never collide
+            if (k >= nbPairsInPack) {
+                deltaX[k] = deltaY[k] = deltaZ[k] = decimal(1.0);
+                sumRadius[k] = decimal(0.0);
+                continue;
+            }
+
+            const OverlappingPair* pair = overlappingPairs[firstPair + k];
+            const ProxyShape* shape1 = pair->getShape1();
+            const ProxyShape* shape2 = pair->getShape2();
+            transforms1[k] = shape1->getLocalToWorldTransform();
+            transforms2[k] = shape2->getLocalToWorldTransform();
+            const Vector3 vectorBetweenCenters = transforms2[k].getPosition() -
+                                                 transforms1[k].getPosition();
+            deltaX[k] = vectorBetweenCenters.x;
+            deltaY[k] = vectorBetweenCenters.y;
+            deltaZ[k] = vectorBetweenCenters.z;
+            sumRadius[k] = static_cast<const SphereShape*>(shape1->getCollisionShape())->getRadius() +
+                           static_cast<const SphereShape*>(shape2->getCollisionShape())->getRadius();
+        }
+
+        // Test the overlap of the four pairs
+        for (uint k=0; k<packSize; k++) {
+            squaredDistances[k] = deltaX[k] * deltaX[k] + deltaY[k] * deltaY[k] +
+                                  deltaZ[k] * deltaZ[k];
+            isColliding[k] = squaredDistances[k] <= sumRadius[k] * sumRadius[k];
+        }
+
+        // Report the contacts of the pack
+        for (uint k=0; k<nbPairsInPack; k++) {
+
+            if (!isColliding[k]) continue;
+
+            OverlappingPair* pair = overlappingPairs[firstPair + k];
+            ProxyShape* shape1 = pair->getShape1();
+            ProxyShape* shape2 = pair->getShape2();
+            setCurrentOverlappingPair(pair);
+            CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), transforms1[k],
+                                          pair, shape1->getCachedCollisionData());
+            CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), transforms2[k],
+                                          pair, shape2->getCachedCollisionData());
+            reportContact(shape1Info, shape2Info, squaredDistances[k], narrowPhaseCallback);
+        }
+    }
+}
+
+// Report the contact between two intersecting spheres
+void SphereVsSphereAlgorithm::reportContact(const CollisionShapeInfo& shape1Info,
+                                            const CollisionShapeInfo& shape2Info,
+                                            decimal squaredDistanceBetweenCenters,
+                                            NarrowPhaseCallback* narrowPhaseCallback) const {
+
+    const SphereShape* sphereShape1 = static_cast<const SphereShape*>(shape1Info.collisionShape);
+    const SphereShape* sphereShape2 = static_cast<const SphereShape*>(shape2Info.collisionShape);
+    const Transform& transform1 = shape1Info.shapeToWorldTransform;
+    const Transform& transform2 = shape2Info.shapeToWorldTransform;
+    const Vector3 vectorBetweenCenters = transform2.getPosition() - transform1.getPosition();
+    const decimal sumRadius = sphereShape1->getRadius() + sphereShape2->getRadius();
+
+    Vector3 centerSphere2InBody1LocalSpace = transform1.getInverse() * transform2.getPosition();
+    Vector3 centerSphere1InBody2LocalSpace = transform2.getInverse() * transform1.getPosition();
+    Vector3 intersectionOnBody1 = sphereShape1->getRadius() *
+                                  centerSphere2InBody1LocalSpace.getUnit();
+    Vector3 intersectionOnBody2 = sphereShape2->getRadius() *
+                                  centerSphere1InBody2LocalSpace.getUnit();
+    decimal penetrationDepth = sumRadius - std::sqrt(squaredDistanceBetweenCenters);
+
+    // Create the contact info object
+    ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                 shape2Info.collisionShape, vectorBetweenCenters.getUnit(), penetrationDepth,
+                                 intersectionOnBody1, intersectionOnBody2);
+
+    // Notify about the new contact
+    narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+}
@@ -51,7 +51,12 @@ class SphereVsSphereAlgorithm : public NarrowPhaseAlgorithm {
 
         /// Private assignment operator
         SphereVsSphereAlgorithm& operator=(const SphereVsSphereAlgorithm& algorithm);
-        
+
+        /// Report the contact between two intersecting spheres
+        void reportContact(const CollisionShapeInfo& shape1Info, const CollisionShapeInfo& shape2Info,
+                           decimal squaredDistanceBetweenCenters,
+                           NarrowPhaseCallback* narrowPhaseCallback) const;
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -66,6 +71,10 @@ class SphereVsSphereAlgorithm : public NarrowPhaseAlgorithm {
         virtual void testCollision(const CollisionShapeInfo& shape1Info,
                                    const CollisionShapeInfo& shape2Info,
                                    NarrowPhaseCallback* narrowPhaseCallback);
+
+        /// Compute the contacts of a batch of sphere vs sphere overlapping pairs
+        virtual void testCollisionBatch(OverlappingPair** overlappingPairs, uint nbPairs,
+                                        NarrowPhaseCallback* narrowPhaseCallback);
 };
 
 }
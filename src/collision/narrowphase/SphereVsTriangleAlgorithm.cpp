@@ -0,0 +1,105 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "SphereVsTriangleAlgorithm.h"
+#include "collision/shapes/SphereShape.h"
+#include "collision/shapes/TriangleShape.h"
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+SphereVsTriangleAlgorithm::SphereVsTriangleAlgorithm() : NarrowPhaseAlgorithm() {
+
+}
+
+// Destructor
+SphereVsTriangleAlgorithm::~SphereVsTriangleAlgorithm() {
+
+}
+
+// Compute a contact info if the sphere and the triangle collide
+void SphereVsTriangleAlgorithm::testCollision(const CollisionShapeInfo& shape1Info,
+                                              const CollisionShapeInfo& shape2Info,
+                                              NarrowPhaseCallback* narrowPhaseCallback) {
+
+    assert(shape1Info.collisionShape->getType() == SPHERE);
+    assert(shape2Info.collisionShape->getType() == TRIANGLE);
+
+    const SphereShape* sphereShape = static_cast<const SphereShape*>(shape1Info.collisionShape);
+    const TriangleShape* triangleShape = static_cast<const TriangleShape*>(shape2Info.collisionShape);
+
+    // We work in the local-space of the triangle
+    const Transform& triangleToWorld = shape2Info.shapeToWorldTransform;
+    const Transform sphereToTriangle = triangleToWorld.getInverse() *
+                                       shape1Info.shapeToWorldTransform;
+    const Vector3 center = sphereToTriangle.getPosition();
+
+    const Vector3& a = triangleShape->getVertex(0);
+    const Vector3& b = triangleShape->getVertex(1);
+    const Vector3& c = triangleShape->getVertex(2);
+
+    // Compute the point of the triangle that is closest to the sphere center
+    const Vector3 closestPoint = computeClosestPointOnTriangle(a, b, c, center);
+
+    const decimal radius = sphereShape->getRadius();
+    const decimal triangleMargin = triangleShape->getMargin();
+    const decimal sumRadius = radius + triangleMargin;
+    const Vector3 closestPointToCenter = center - closestPoint;
+    const decimal distanceSquare = closestPointToCenter.lengthSquare();
+
+    // If the sphere does not touch the triangle
+    if (distanceSquare > sumRadius * sumRadius) return;
+
+    // Compute the contact normal (from the sphere toward the triangle)
+    Vector3 normal;
+    decimal distance;
+    if (distanceSquare > MACHINE_EPSILON) {
+        distance = std::sqrt(distanceSquare);
+        normal = -closestPointToCenter / distance;
+    }
+    else {  // If the sphere center is on the triangle, we use the triangle normal
+
+        Vector3 triangleNormal = (b - a).cross(c - a);
+        if (triangleNormal.lengthSquare() < MACHINE_EPSILON) return;
+        distance = decimal(0.0);
+        normal = -triangleNormal.getUnit();
+    }
+
+    const decimal penetrationDepth = sumRadius - distance;
+
+    // Contact points in the local-spaces of the sphere and of the triangle
+    const Vector3 localPoint1 = radius * (sphereToTriangle.getOrientation().getInverse() * normal);
+    const Vector3 localPoint2 = closestPoint - triangleMargin * normal;
+
+    // Create the contact info object
+    ContactPointInfo contactInfo(shape1Info.proxyShape, shape2Info.proxyShape, shape1Info.collisionShape,
+                                 shape2Info.collisionShape, triangleToWorld.getOrientation() * normal,
+                                 penetrationDepth, localPoint1, localPoint2);
+
+    // Notify about the new contact
+    narrowPhaseCallback->notifyContact(shape1Info.overlappingPair, contactInfo);
+}
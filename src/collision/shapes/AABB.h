@@ -94,6 +94,13 @@ class AABB {
         /// Return the volume of the AABB
         decimal getVolume() const;
 
+        /// Return the squared distance between the current AABB and the AABB in argument
+        decimal computeSquaredDistance(const AABB& aabb) const;
+
+        /// Compute the interval of the signed distances of the points of the AABB to a plane
+        void computeSignedDistanceInterval(const Plane& plane, decimal& minDistance,
+                                           decimal& maxDistance) const;
+
         /// Merge the AABB in parameter with the current one
         void mergeWithAABB(const AABB& aabb);
 
@@ -112,6 +119,11 @@ class AABB {
         /// Return true if the ray intersects the AABB
         bool testRayIntersect(const Ray& ray) const;
 
+        /// Return true if the ray segment between the fractions 0 and maxFraction
+        /// intersects the AABB (slab test with a precomputed inverse direction)
+        bool testRayIntersect(const Vector3& origin, const Vector3& inverseDirection,
+                              decimal maxFraction) const;
+
         /// Create and return an AABB for a triangle
         static AABB createAABBForTriangle(const Vector3* trianglePoints);
 
@@ -171,6 +183,31 @@ inline bool AABB::testCollision(const AABB& aabb) const {
     return true;
 }
 
+// Return the squared distance between the current AABB and the AABB in argument
+/// The distance is zero if the two AABBs are overlapping
+inline decimal AABB::computeSquaredDistance(const AABB& aabb) const {
+    decimal distanceSquare = decimal(0.0);
+    for (int i=0; i<3; i++) {
+        const decimal gap = std::max(aabb.mMinCoordinates[i] - mMaxCoordinates[i],
+                                     mMinCoordinates[i] - aabb.mMaxCoordinates[i]);
+        if (gap > decimal(0.0)) distanceSquare += gap * gap;
+    }
+    return distanceSquare;
+}
+
+// Compute the interval of the signed distances of the points of the AABB to a plane
+/// The AABB is outside the plane if minDistance > 0 and inside if maxDistance <= 0
+inline void AABB::computeSignedDistanceInterval(const Plane& plane, decimal& minDistance,
+                                                decimal& maxDistance) const {
+    const Vector3 halfExtent = decimal(0.5) * (mMaxCoordinates - mMinCoordinates);
+    const decimal centerDistance = plane.computeSignedDistance(getCenter());
+    const decimal radius = std::abs(plane.normal.x) * halfExtent.x +
+                           std::abs(plane.normal.y) * halfExtent.y +
+                           std::abs(plane.normal.z) * halfExtent.z;
+    minDistance = centerDistance - radius;
+    maxDistance = centerDistance + radius;
+}
+
 // Return the volume of the AABB
 inline decimal AABB::getVolume() const {
     const Vector3 diff = mMaxCoordinates - mMinCoordinates;
@@ -199,6 +236,32 @@ inline bool AABB::contains(const Vector3& point) const {
             point.z >= mMinCoordinates.z - MACHINE_EPSILON && point.z <= mMaxCoordinates.z + MACHINE_EPSILON);
 }
 
+// Return true if the ray segment between the fractions 0 and maxFraction intersects the AABB
+/// The inverse direction of a ray parallel to an axis must contain a very large
+/// finite value (and not infinity) for this axis so that no NaN can be produced.
+/**
+ * @param origin Origin of the ray
+ * @param inverseDirection Component-wise inverse of the (point2 - point1) vector of the ray
+ * @param maxFraction Maximum fraction of the ray to test
+ * @return True if the ray segment intersects the AABB
+ */
+inline bool AABB::testRayIntersect(const Vector3& origin, const Vector3& inverseDirection,
+                                   decimal maxFraction) const {
+
+    decimal tMin = decimal(0.0);
+    decimal tMax = maxFraction;
+
+    for (int i=0; i<3; i++) {
+        decimal t1 = (mMinCoordinates[i] - origin[i]) * inverseDirection[i];
+        decimal t2 = (mMaxCoordinates[i] - origin[i]) * inverseDirection[i];
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+    }
+
+    return tMin <= tMax;
+}
+
 // Assignment operator
 inline AABB& AABB::operator=(const AABB& aabb) {
     if (this != &aabb) {
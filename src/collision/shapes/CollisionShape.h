@@ -41,8 +41,8 @@ namespace reactphysics3d {
     
 /// Type of the collision shape
 enum CollisionShapeType {TRIANGLE, BOX, SPHERE, CONE, CYLINDER,
-                         CAPSULE, CONVEX_MESH, CONCAVE_MESH, HEIGHTFIELD};
-const int NB_COLLISION_SHAPE_TYPES = 9;
+                         CAPSULE, CONVEX_MESH, CONCAVE_MESH, HEIGHTFIELD, COMPOUND};
+const int NB_COLLISION_SHAPE_TYPES = 10;
 
 // Declarations
 class ProxyShape;
@@ -124,6 +124,8 @@ class CollisionShape {
 
         friend class ProxyShape;
         friend class CollisionWorld;
+        friend class CompoundShape;
+        friend class CompoundShapeRaycastCallback;
 };
 
 // Return the type of the collision shape
@@ -136,7 +138,7 @@ inline CollisionShapeType CollisionShape::getType() const {
 
 // Return true if the collision shape type is a convex shape
 inline bool CollisionShape::isConvex(CollisionShapeType shapeType) {
-    return shapeType != CONCAVE_MESH && shapeType != HEIGHTFIELD;
+    return shapeType != CONCAVE_MESH && shapeType != HEIGHTFIELD && shapeType != COMPOUND;
 }
 
 // Return the scaling vector of the collision shape
@@ -0,0 +1,178 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CompoundShape.h"
+
+using namespace reactphysics3d;
+
+// Constructor
+CompoundShape::CompoundShape() : CollisionShape(COMPOUND) {
+
+}
+
+// Destructor
+CompoundShape::~CompoundShape() {
+
+}
+
+// Add a convex child shape with a transform into the compound shape
+/// The child shape is not copied and must not be destroyed while the compound shape is
+/// used. The same child shape can be added several times with different transforms.
+/// The compound shape must not be modified once it has been added to a body.
+/**
+ * @param shape Pointer to the convex child shape
+ * @param transform Transform from the local-space of the child shape to the local-space
+ *                  of the compound shape
+ * @return Index of the new child shape in the compound shape
+ */
+uint CompoundShape::addChildShape(const ConvexShape* shape, const Transform& transform) {
+
+    assert(shape != NULL);
+
+    uint childIndex = static_cast<uint>(mChildShapes.size());
+    mChildShapes.push_back(shape);
+    mChildTransforms.push_back(transform);
+
+    // Compute the AABB of the child shape in the local-space of the compound shape
+    AABB aabb;
+    shape->computeAABB(aabb, transform);
+
+    // Insert the child shape into the Dynamic AABB tree
+    mDynamicAABBTree.addObject(aabb, static_cast<int32>(childIndex), 0);
+
+    return childIndex;
+}
+
+// Add the indices of the child shapes whose AABB overlaps a given local-space AABB
+/**
+ * @param localAABB AABB in the local-space of the compound shape
+ * @param[out] childIndices Array where the indices of the overlapping child shapes are added
+ */
+void CompoundShape::getChildShapesOverlappingAABB(const AABB& localAABB,
+                                                  std::vector<uint>& childIndices) const {
+
+    CompoundShapeOverlapCallback overlapCallback(mDynamicAABBTree, childIndices);
+    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(localAABB, overlapCallback);
+}
+
+// Report the child shapes whose AABB overlaps a given local-space AABB to a callback
+/// Nothing is allocated, which lets the queries of the world test the child shapes
+/// as they are found.
+/**
+ * @param localAABB AABB in the local-space of the compound shape
+ * @param callback Callback called with the index of each overlapping child shape
+ */
+void CompoundShape::reportChildShapesOverlappingAABB(const AABB& localAABB,
+                                                     CompoundShapeChildCallback& callback) const {
+
+    CompoundShapeChildOverlapCallback overlapCallback(mDynamicAABBTree, callback);
+    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(localAABB, overlapCallback);
+}
+
+// Return the local bounds of the shape in x, y and z directions
+/**
+ * @param min The minimum bounds of the shape in local-space coordinates
+ * @param max The maximum bounds of the shape in local-space coordinates
+ */
+void CompoundShape::getLocalBounds(Vector3& min, Vector3& max) const {
+
+    if (mChildShapes.empty()) {
+        min.setToZero();
+        max.setToZero();
+        return;
+    }
+
+    AABB treeAABB = mDynamicAABBTree.getRootAABB();
+    min = treeAABB.getMin();
+    max = treeAABB.getMax();
+}
+
+// Return true if a point is inside the collision shape
+bool CompoundShape::testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const {
+
+    // Get the child shapes whose AABB contains the point
+    std::vector<uint> childIndices;
+    getChildShapesOverlappingAABB(AABB(localPoint, localPoint), childIndices);
+
+    for (uint i=0; i<childIndices.size(); i++) {
+
+        const Transform& childTransform = mChildTransforms[childIndices[i]];
+        const Vector3 childPoint = childTransform.getInverse() * localPoint;
+
+        if (mChildShapes[childIndices[i]]->testPointInside(childPoint, proxyShape)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Raycast method with feedback information
+/// The ray is tested against the child shapes whose AABB is hit by the ray in the Dynamic
+/// AABB tree of the compound shape. The closest hit is reported.
+bool CompoundShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape) const {
+
+    PROFILE("CompoundShape::raycast()");
+
+    CompoundShapeRaycastCallback raycastCallback(*this, proxyShape, raycastInfo);
+    mDynamicAABBTree.raycast(ray, raycastCallback);
+
+    return raycastCallback.getIsHit();
+}
+
+// Raycast the child shape of a leaf node hit by the ray
+/// The ray is clipped to the closest hit found so far
+decimal CompoundShapeRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+
+    uint childIndex = static_cast<uint>(mCompoundShape.mDynamicAABBTree.getNodeDataInt(nodeId)[0]);
+    const ConvexShape* childShape = mCompoundShape.mChildShapes[childIndex];
+    const Transform& childTransform = mCompoundShape.mChildTransforms[childIndex];
+
+    // Convert the ray into the local-space of the child shape
+    const Transform inverseChildTransform = childTransform.getInverse();
+    Ray childRay(inverseChildTransform * ray.point1, inverseChildTransform * ray.point2,
+                 ray.maxFraction);
+
+    RaycastInfo childRaycastInfo;
+    if (childShape->raycast(childRay, childRaycastInfo, mProxyShape) &&
+        childRaycastInfo.hitFraction <= ray.maxFraction) {
+
+        mIsHit = true;
+
+        // Convert the hit point and normal into the local-space of the compound shape
+        mRaycastInfo.body = childRaycastInfo.body;
+        mRaycastInfo.proxyShape = childRaycastInfo.proxyShape;
+        mRaycastInfo.hitFraction = childRaycastInfo.hitFraction;
+        mRaycastInfo.worldPoint = childTransform * childRaycastInfo.worldPoint;
+        mRaycastInfo.worldNormal = childTransform.getOrientation() * childRaycastInfo.worldNormal;
+        mRaycastInfo.meshSubpart = -1;
+        mRaycastInfo.triangleIndex = -1;
+
+        return childRaycastInfo.hitFraction;
+    }
+
+    return ray.maxFraction;
+}
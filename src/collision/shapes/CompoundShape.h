@@ -0,0 +1,308 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_COMPOUND_SHAPE_H
+#define REACTPHYSICS3D_COMPOUND_SHAPE_H
+
+// Libraries
+#include "CollisionShape.h"
+#include "ConvexShape.h"
+#include "collision/broadphase/DynamicAABBTree.h"
+#include "engine/Profiler.h"
+#include <vector>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+class CompoundShape;
+
+// Class CompoundShapeOverlapCallback
+/**
+ * This class is used to collect the child shapes of a compound shape whose
+ * AABB overlaps a given AABB in the Dynamic AABB tree of the compound shape.
+ */
+class CompoundShapeOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        /// Reference to the Dynamic AABB tree of the compound shape
+        const DynamicAABBTree& mDynamicAABBTree;
+
+        /// Array where the indices of the overlapping child shapes are added
+        std::vector<uint>& mChildIndices;
+
+    public:
+
+        // Constructor
+        CompoundShapeOverlapCallback(const DynamicAABBTree& dynamicAABBTree,
+                                     std::vector<uint>& childIndices)
+          : mDynamicAABBTree(dynamicAABBTree), mChildIndices(childIndices) {
+
+        }
+
+        // Called when a overlapping node has been found during the call to
+        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int nodeId) {
+            mChildIndices.push_back(mDynamicAABBTree.getNodeDataInt(nodeId)[0]);
+        }
+};
+
+// Class CompoundShapeChildCallback
+/**
+ * Callback called for each child shape of a compound shape whose AABB overlaps
+ * a given AABB in the local-space of the compound shape.
+ */
+class CompoundShapeChildCallback {
+
+    public:
+
+        // Called for each child shape whose AABB overlaps the AABB of the query
+        virtual void notifyOverlappingChildShape(uint childIndex)=0;
+};
+
+// Class CompoundShapeChildOverlapCallback
+/**
+ * This class is used to report the child shapes of a compound shape whose AABB
+ * overlaps a given AABB in the Dynamic AABB tree of the compound shape to a
+ * CompoundShapeChildCallback.
+ */
+class CompoundShapeChildOverlapCallback : public DynamicAABBTreeOverlapCallback {
+
+    private:
+
+        /// Reference to the Dynamic AABB tree of the compound shape
+        const DynamicAABBTree& mDynamicAABBTree;
+
+        /// Callback called for each overlapping child shape
+        CompoundShapeChildCallback& mChildCallback;
+
+    public:
+
+        // Constructor
+        CompoundShapeChildOverlapCallback(const DynamicAABBTree& dynamicAABBTree,
+                                          CompoundShapeChildCallback& childCallback)
+          : mDynamicAABBTree(dynamicAABBTree), mChildCallback(childCallback) {
+
+        }
+
+        // Called when a overlapping node has been found during the call to
+        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int nodeId) {
+            mChildCallback.notifyOverlappingChildShape(mDynamicAABBTree.getNodeDataInt(nodeId)[0]);
+        }
+};
+
+// Class CompoundShapeRaycastCallback
+/**
+ * This class is used to raycast the child shapes of a compound shape whose AABB
+ * is hit by the ray in the Dynamic AABB tree of the compound shape.
+ */
+class CompoundShapeRaycastCallback : public DynamicAABBTreeRaycastCallback {
+
+    private :
+
+        /// Reference to the compound shape
+        const CompoundShape& mCompoundShape;
+
+        /// Proxy shape of the compound shape
+        ProxyShape* mProxyShape;
+
+        /// Raycast info of the closest hit
+        RaycastInfo& mRaycastInfo;
+
+        /// True if a child shape has been hit
+        bool mIsHit;
+
+    public:
+
+        // Constructor
+        CompoundShapeRaycastCallback(const CompoundShape& compoundShape, ProxyShape* proxyShape,
+                                     RaycastInfo& raycastInfo)
+            : mCompoundShape(compoundShape), mProxyShape(proxyShape), mRaycastInfo(raycastInfo),
+              mIsHit(false) {
+
+        }
+
+        /// Raycast the child shape of a leaf node hit by the ray
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray);
+
+        /// Return true if a raycast hit has been found
+        bool getIsHit() const {
+            return mIsHit;
+        }
+};
+
+// Class CompoundShape
+/**
+ * This class represents a static collision shape made of many convex child shapes
+ * (boxes, convex meshes, ...) placed with their own transform in the local-space of
+ * the compound shape. It is used to bake many small static shapes of a level into a
+ * single proxy shape. The broad-phase only contains a single leaf for the whole
+ * compound shape and its child shapes are stored in an internal Dynamic AABB tree
+ * that is queried on demand by the narrow-phase. The child shapes are not copied and
+ * must not be destroyed while the compound shape is used. Since the compound shape
+ * is meant for static bodies, its mass properties are only approximated and it
+ * cannot be scaled.
+ */
+class CompoundShape : public CollisionShape {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Child shapes
+        std::vector<const ConvexShape*> mChildShapes;
+
+        /// Transforms from the local-space of the child shapes to the local-space of
+        /// the compound shape
+        std::vector<Transform> mChildTransforms;
+
+        /// Dynamic AABB tree with the AABBs of the child shapes (the data of a leaf
+        /// node is the index of its child shape)
+        DynamicAABBTree mDynamicAABBTree;
+
+        // -------------------- Methods -------------------- //
+
+        /// Private copy-constructor
+        CompoundShape(const CompoundShape& shape);
+
+        /// Private assignment operator
+        CompoundShape& operator=(const CompoundShape& shape);
+
+        /// Return true if a point is inside the collision shape
+        virtual bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const;
+
+        /// Raycast method with feedback information
+        virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape) const;
+
+        /// Return the number of bytes used by the collision shape
+        virtual size_t getSizeInBytes() const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CompoundShape();
+
+        /// Destructor
+        virtual ~CompoundShape();
+
+        /// Add a convex child shape with a transform into the compound shape
+        uint addChildShape(const ConvexShape* shape, const Transform& transform);
+
+        /// Return the number of child shapes
+        uint getNbChildShapes() const;
+
+        /// Return a child shape
+        const ConvexShape* getChildShape(uint childIndex) const;
+
+        /// Return the transform of a child shape
+        const Transform& getChildTransform(uint childIndex) const;
+
+        /// Add the indices of the child shapes whose AABB overlaps a given local-space AABB
+        void getChildShapesOverlappingAABB(const AABB& localAABB,
+                                           std::vector<uint>& childIndices) const;
+
+        /// Report the child shapes whose AABB overlaps a given local-space AABB to a callback
+        void reportChildShapesOverlappingAABB(const AABB& localAABB,
+                                              CompoundShapeChildCallback& callback) const;
+
+        /// Return true if the collision shape is convex, false if it is concave
+        virtual bool isConvex() const;
+
+        /// Return the local bounds of the shape in x, y and z directions
+        virtual void getLocalBounds(Vector3& min, Vector3& max) const;
+
+        /// Set the local scaling vector of the collision shape
+        virtual void setLocalScaling(const Vector3& scaling);
+
+        /// Return the local inertia tensor of the collision shape
+        virtual void computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const;
+
+        // ---------- Friendship ----------- //
+
+        friend class CompoundShapeRaycastCallback;
+};
+
+// Return the number of bytes used by the collision shape
+inline size_t CompoundShape::getSizeInBytes() const {
+    return sizeof(CompoundShape);
+}
+
+// Return the number of child shapes
+inline uint CompoundShape::getNbChildShapes() const {
+    return static_cast<uint>(mChildShapes.size());
+}
+
+// Return a child shape
+inline const ConvexShape* CompoundShape::getChildShape(uint childIndex) const {
+    assert(childIndex < mChildShapes.size());
+    return mChildShapes[childIndex];
+}
+
+// Return the transform from the local-space of a child shape to the local-space of
+// the compound shape
+inline const Transform& CompoundShape::getChildTransform(uint childIndex) const {
+    assert(childIndex < mChildTransforms.size());
+    return mChildTransforms[childIndex];
+}
+
+// Return true if the collision shape is convex, false if it is concave
+inline bool CompoundShape::isConvex() const {
+    return false;
+}
+
+// Set the local scaling vector of the collision shape
+/// A compound shape cannot be scaled. The child shapes can be scaled before being
+/// added into the compound shape instead.
+inline void CompoundShape::setLocalScaling(const Vector3& scaling) {
+    assert(scaling == Vector3(1, 1, 1));
+}
+
+// Return the local inertia tensor of the collision shape
+/// The local inertia tensor of the compound shape is approximated using the inertia
+/// tensor of its bounding box.
+/**
+ * @param[out] tensor The 3x3 inertia tensor matrix of the shape in local-space
+ *                    coordinates
+ * @param mass Mass to use to compute the inertia tensor of the collision shape
+ */
+inline void CompoundShape::computeLocalInertiaTensor(Matrix3x3& tensor, decimal mass) const {
+    Vector3 minBounds, maxBounds;
+    getLocalBounds(minBounds, maxBounds);
+    decimal factor = (decimal(1.0) / decimal(3.0)) * mass;
+    Vector3 realExtent = decimal(0.5) * (maxBounds - minBounds);
+    decimal xSquare = realExtent.x * realExtent.x;
+    decimal ySquare = realExtent.y * realExtent.y;
+    decimal zSquare = realExtent.z * realExtent.z;
+    tensor.setAllValues(factor * (ySquare + zSquare), 0.0, 0.0,
+                        0.0, factor * (xSquare + zSquare), 0.0,
+                        0.0, 0.0, factor * (xSquare + ySquare));
+}
+
+}
+
+#endif
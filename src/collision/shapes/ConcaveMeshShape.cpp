@@ -30,20 +30,90 @@ using namespace reactphysics3d;
 
 // Constructor
 ConcaveMeshShape::ConcaveMeshShape(TriangleMesh* triangleMesh)
-                 : ConcaveShape(CONCAVE_MESH) {
+                 : ConcaveShape(CONCAVE_MESH), mBVHBuildCost(0), mMeshShape(this), mMeshVersion(0) {
     mTriangleMesh = triangleMesh;
     mRaycastTestType = FRONT;
+    mDynamicAABBTree = new DynamicAABBTree();
 
     // Insert all the triangles into the dynamic AABB tree
     initBVHTree();
 }
 
+// Constructor to create an instance of a concave mesh shape with a given scaling
+/// The new shape shares the triangle mesh and the Dynamic AABB tree of the given shape
+/// instead of building its own tree. Since the tree is built without scaling, only the
+/// scaling (applied at query time) is specific to the instance. Therefore, many instances
+/// of a mesh can be created at different scales with a constant memory cost per instance.
+/// The shape that owns the tree must not be destroyed while its instances are used.
+/**
+ * @param meshShape Concave mesh shape whose triangle mesh and tree are shared with the new shape
+ * @param scaling Scaling factor of the new shape in the three local x, y and z directions
+ */
+ConcaveMeshShape::ConcaveMeshShape(ConcaveMeshShape* meshShape, const Vector3& scaling)
+                 : ConcaveShape(CONCAVE_MESH), mTriangleMesh(meshShape->mTriangleMesh),
+                   mDynamicAABBTree(meshShape->mDynamicAABBTree), mBVHBuildCost(0),
+                   mMeshShape(meshShape->mMeshShape), mMeshVersion(0) {
+
+    assert(scaling.x > decimal(0.0) && scaling.y > decimal(0.0) && scaling.z > decimal(0.0));
+
+    mScaling = scaling;
+    mTriangleMargin = meshShape->mTriangleMargin;
+    mRaycastTestType = meshShape->mRaycastTestType;
+}
+
+// Constructor with a Dynamic AABB tree loaded from data written by saveBVH()
+/// Loading the tree is a single copy of the saved nodes which is much faster than
+/// inserting all the triangles of the mesh into a new tree. The data must have been
+/// saved from a shape with the same triangle mesh. If the data cannot be loaded (other
+/// version of the format, other precision, corrupted tree, other number of triangles or
+/// leaves that refer to triangles that are not in the mesh), the tree is built from the
+/// triangles of the mesh as with the other constructor.
+/**
+ * @param triangleMesh Pointer to the triangle mesh of the shape
+ * @param bvhData Pointer to the memory buffer that contains the saved tree
+ * @param bvhDataSize Size (in bytes) of the memory buffer
+ */
+ConcaveMeshShape::ConcaveMeshShape(TriangleMesh* triangleMesh, const void* bvhData,
+                                   size_t bvhDataSize)
+                 : ConcaveShape(CONCAVE_MESH), mBVHBuildCost(0), mMeshShape(this), mMeshVersion(0) {
+    mTriangleMesh = triangleMesh;
+    mRaycastTestType = FRONT;
+    mDynamicAABBTree = new DynamicAABBTree();
+
+    // Compute the number of triangles of the mesh
+    int nbTriangles = 0;
+    for (uint subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
+        nbTriangles += mTriangleMesh->getSubpart(subPart)->getNbTriangles();
+    }
+
+    // Load the tree and check that it has one leaf per triangle of the mesh
+    ConcaveMeshDeserializeCallback deserializeCallback(*mTriangleMesh);
+    bool isLoaded = mDynamicAABBTree->deserialize(bvhData, bvhDataSize, &deserializeCallback) &&
+                    (mDynamicAABBTree->getNbNodes() + 1) / 2 == nbTriangles;
+
+    if (isLoaded) {
+        mBVHBuildCost = mDynamicAABBTree->computeSurfaceAreaCost();
+    }
+    else {
+
+        // Insert all the triangles into a new dynamic AABB tree
+        mDynamicAABBTree->reset();
+        initBVHTree();
+    }
+}
+
 // Destructor
 ConcaveMeshShape::~ConcaveMeshShape() {
 
+    // Only the shape that has built the tree destroys it
+    if (mMeshShape == this) {
+        delete mDynamicAABBTree;
+    }
 }
 
 // Insert all the triangles into the dynamic AABB tree
+/// The AABBs of the triangles are inserted without scaling and without the triangle
+/// margin so that the tree can be shared by shapes with different scalings.
 void ConcaveMeshShape::initBVHTree() {
 
     // TODO : Try to randomly add the triangles into the tree to obtain a better tree
@@ -54,60 +124,61 @@ void ConcaveMeshShape::initBVHTree() {
         // Get the triangle vertex array of the current sub-part
         TriangleVertexArray* triangleVertexArray = mTriangleMesh->getSubpart(subPart);
 
-        TriangleVertexArray::VertexDataType vertexType = triangleVertexArray->getVertexDataType();
-        TriangleVertexArray::IndexDataType indexType = triangleVertexArray->getIndexDataType();
-        unsigned char* verticesStart = triangleVertexArray->getVerticesStart();
-        unsigned char* indicesStart = triangleVertexArray->getIndicesStart();
-        int vertexStride = triangleVertexArray->getVerticesStride();
-        int indexStride = triangleVertexArray->getIndicesStride();
-
         // For each triangle of the concave mesh
         for (uint triangleIndex=0; triangleIndex<triangleVertexArray->getNbTriangles(); triangleIndex++) {
 
-            void* vertexIndexPointer = (indicesStart + triangleIndex * 3 * indexStride);
             Vector3 trianglePoints[3];
-
-            // For each vertex of the triangle
-            for (int k=0; k < 3; k++) {
-
-                // Get the index of the current vertex in the triangle
-                int vertexIndex = 0;
-                if (indexType == TriangleVertexArray::INDEX_INTEGER_TYPE) {
-                    vertexIndex = ((uint*)vertexIndexPointer)[k];
-                }
-                else if (indexType == TriangleVertexArray::INDEX_SHORT_TYPE) {
-                    vertexIndex = ((unsigned short*)vertexIndexPointer)[k];
-                }
-                else {
-                    assert(false);
-                }
-
-                // Get the vertices components of the triangle
-                if (vertexType == TriangleVertexArray::VERTEX_FLOAT_TYPE) {
-                    const float* vertices = (float*)(verticesStart + vertexIndex * vertexStride);
-                    trianglePoints[k][0] = decimal(vertices[0]) * mScaling.x;
-                    trianglePoints[k][1] = decimal(vertices[1]) * mScaling.y;
-                    trianglePoints[k][2] = decimal(vertices[2]) * mScaling.z;
-                }
-                else if (vertexType == TriangleVertexArray::VERTEX_DOUBLE_TYPE) {
-                    const double* vertices = (double*)(verticesStart + vertexIndex * vertexStride);
-                    trianglePoints[k][0] = decimal(vertices[0]) * mScaling.x;
-                    trianglePoints[k][1] = decimal(vertices[1]) * mScaling.y;
-                    trianglePoints[k][2] = decimal(vertices[2]) * mScaling.z;
-                }
-                else {
-                    assert(false);
-                }
-            }
+            getUnscaledTriangleVertices(subPart, triangleIndex, trianglePoints);
 
             // Create the AABB for the triangle
             AABB aabb = AABB::createAABBForTriangle(trianglePoints);
-            aabb.inflate(mTriangleMargin, mTriangleMargin, mTriangleMargin);
 
             // Add the AABB with the index of the triangle into the dynamic AABB tree
-            mDynamicAABBTree.addObject(aabb, subPart, triangleIndex);
+            mDynamicAABBTree->addObject(aabb, subPart, triangleIndex);
         }
     }
+
+    // Keep the cost of the new tree to know later if it has to be rebuilt after refits
+    mMeshShape->mBVHBuildCost = mDynamicAABBTree->computeSurfaceAreaCost();
+}
+
+// Update the Dynamic AABB tree after the vertices of the triangle mesh have been modified
+/// The AABBs of the triangles are recomputed with the current vertices of the triangle
+/// mesh and the AABBs of the nodes of the tree are updated bottom-up without removing or
+/// inserting any triangle. This is much faster than rebuilding the tree but the tree
+/// quality decreases when the triangles move a lot relative to each other. If the surface
+/// area cost of the refitted tree becomes larger than rebuildCostRatio times its cost when
+/// it was built, the tree is rebuilt. The triangles and the number of vertices of the mesh
+/// must not change. Note that the broad-phase AABBs of the proxy shapes that use this shape
+/// are not updated (see CollisionWorld::refitConcaveMeshShape()). If the tree is shared with
+/// other instances of the mesh, it is refitted for all of them and the version of the mesh,
+/// stored in the shape that owns the tree, is incremented so that the cached triangles of
+/// all the instances are discarded.
+/**
+ * @param rebuildCostRatio Maximum ratio between the cost of the refitted tree and the
+ *                         cost of the tree when it was built (never rebuilt by default)
+ * @return True if the tree has been rebuilt
+ */
+bool ConcaveMeshShape::refit(decimal rebuildCostRatio) {
+
+    PROFILE("ConcaveMeshShape::refit()");
+
+    // Recompute the AABBs of the tree nodes with the new vertices
+    ConcaveMeshRefitCallback refitCallback(*this, *mDynamicAABBTree);
+    mDynamicAABBTree->refit(refitCallback);
+
+    // If the quality of the tree has decreased too much, we rebuild it
+    bool isRebuilt = false;
+    if (mDynamicAABBTree->computeSurfaceAreaCost() > rebuildCostRatio * mMeshShape->mBVHBuildCost) {
+        mDynamicAABBTree->reset();
+        initBVHTree();
+        isRebuilt = true;
+    }
+
+    // The triangles of the mesh (and of all its instances) have changed
+    mMeshShape->mMeshVersion++;
+
+    return isRebuilt;
 }
 
 // Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
@@ -115,6 +186,18 @@ void ConcaveMeshShape::initBVHTree() {
 void ConcaveMeshShape::getTriangleVerticesWithIndexPointer(int32 subPart, int32 triangleIndex,
                                                            Vector3* outTriangleVertices) const {
 
+    getUnscaledTriangleVertices(subPart, triangleIndex, outTriangleVertices);
+
+    // Apply the scaling of the shape
+    outTriangleVertices[0] = outTriangleVertices[0] * mScaling;
+    outTriangleVertices[1] = outTriangleVertices[1] * mScaling;
+    outTriangleVertices[2] = outTriangleVertices[2] * mScaling;
+}
+
+// Return the three vertices coordinates (without scaling) of a triangle of the mesh
+void ConcaveMeshShape::getUnscaledTriangleVertices(int32 subPart, int32 triangleIndex,
+                                                   Vector3* outTriangleVertices) const {
+
     // Get the triangle vertex array of the current sub-part
     TriangleVertexArray* triangleVertexArray = mTriangleMesh->getSubpart(subPart);
 
@@ -145,15 +228,15 @@ void ConcaveMeshShape::getTriangleVerticesWithIndexPointer(int32 subPart, int32
         // Get the vertices components of the triangle
         if (vertexType == TriangleVertexArray::VERTEX_FLOAT_TYPE) {
             const float* vertices = (float*)(verticesStart + vertexIndex * vertexStride);
-            outTriangleVertices[k][0] = decimal(vertices[0]) * mScaling.x;
-            outTriangleVertices[k][1] = decimal(vertices[1]) * mScaling.y;
-            outTriangleVertices[k][2] = decimal(vertices[2]) * mScaling.z;
+            outTriangleVertices[k][0] = decimal(vertices[0]);
+            outTriangleVertices[k][1] = decimal(vertices[1]);
+            outTriangleVertices[k][2] = decimal(vertices[2]);
         }
         else if (vertexType == TriangleVertexArray::VERTEX_DOUBLE_TYPE) {
             const double* vertices = (double*)(verticesStart + vertexIndex * vertexStride);
-            outTriangleVertices[k][0] = decimal(vertices[0]) * mScaling.x;
-            outTriangleVertices[k][1] = decimal(vertices[1]) * mScaling.y;
-            outTriangleVertices[k][2] = decimal(vertices[2]) * mScaling.z;
+            outTriangleVertices[k][0] = decimal(vertices[0]);
+            outTriangleVertices[k][1] = decimal(vertices[1]);
+            outTriangleVertices[k][2] = decimal(vertices[2]);
         }
         else {
             assert(false);
@@ -164,27 +247,37 @@ void ConcaveMeshShape::getTriangleVerticesWithIndexPointer(int32 subPart, int32
 // Use a callback method on all triangles of the concave shape inside a given AABB
 void ConcaveMeshShape::testAllTriangles(TriangleCallback& callback, const AABB& localAABB) const {
 
-    ConvexTriangleAABBOverlapCallback overlapCallback(callback, *this, mDynamicAABBTree);
+    ConvexTriangleAABBOverlapCallback overlapCallback(callback, *this, *mDynamicAABBTree);
+
+    // Compute the AABB in the unscaled local-space of the tree (the triangles of the
+    // tree are enlarged by their margin)
+    const Vector3 inverseScaling(decimal(1.0) / mScaling.x, decimal(1.0) / mScaling.y,
+                                 decimal(1.0) / mScaling.z);
+    const Vector3 margin = mTriangleMargin * inverseScaling;
+    const AABB aabb(localAABB.getMin() * inverseScaling - margin,
+                    localAABB.getMax() * inverseScaling + margin);
 
     // Ask the Dynamic AABB Tree to report all the triangles that are overlapping
     // with the AABB of the convex shape.
-    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(localAABB, overlapCallback);
+    mDynamicAABBTree->reportAllShapesOverlappingWithAABB(aabb, overlapCallback);
 }
 
 // Raycast method with feedback information
 /// Note that only the first triangle hit by the ray in the mesh will be returned, even if
-/// the ray hits many triangles.
+/// the ray hits many triangles. The tree is traversed with the ray in the unscaled
+/// local-space where the fractions along the ray are the same.
 bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape) const {
 
     PROFILE("ConcaveMeshShape::raycast()");
 
     // Create the callback object that will compute ray casting against triangles
-    ConcaveMeshRaycastCallback raycastCallback(mDynamicAABBTree, *this, proxyShape, raycastInfo, ray);
+    ConcaveMeshRaycastCallback raycastCallback(*mDynamicAABBTree, *this, proxyShape, raycastInfo, ray);
 
     // Ask the Dynamic AABB Tree to report all AABB nodes that are hit by the ray.
     // The raycastCallback object will then compute ray casting against the triangles
     // in the hit AABBs.
-    mDynamicAABBTree.raycast(ray, raycastCallback);
+    const Ray unscaledRay(ray.point1 / mScaling, ray.point2 / mScaling, ray.maxFraction);
+    mDynamicAABBTree->raycast(unscaledRay, raycastCallback);
 
     raycastCallback.raycastTriangles();
 
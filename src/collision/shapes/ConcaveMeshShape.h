@@ -100,11 +100,67 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
         }
 };
 
+// Class ConcaveMeshRefitCallback
+/**
+ * This class is used to compute the new AABBs of the triangles of a concave
+ * mesh shape when its Dynamic AABB tree is refitted.
+ */
+class ConcaveMeshRefitCallback : public DynamicAABBTreeRefitCallback {
+
+    private:
+
+        // Reference to the concave mesh shape
+        const ConcaveMeshShape& mConcaveMeshShape;
+
+        // Reference to the Dynamic AABB tree
+        const DynamicAABBTree& mDynamicAABBTree;
+
+    public:
+
+        // Constructor
+        ConcaveMeshRefitCallback(const ConcaveMeshShape& concaveShape,
+                                 const DynamicAABBTree& dynamicAABBTree)
+          : mConcaveMeshShape(concaveShape), mDynamicAABBTree(dynamicAABBTree) {
+
+        }
+
+        // Compute the new AABB of the triangle of a leaf node of the tree
+        virtual AABB computeLeafAABB(int32 nodeId);
+};
+
+// Class ConcaveMeshDeserializeCallback
+/**
+ * This class is used to check that each leaf of a Dynamic AABB tree loaded
+ * from a memory buffer refers to an existing triangle of the mesh.
+ */
+class ConcaveMeshDeserializeCallback : public DynamicAABBTreeDeserializeCallback {
+
+    private:
+
+        // Reference to the triangle mesh
+        const TriangleMesh& mTriangleMesh;
+
+    public:
+
+        // Constructor
+        ConcaveMeshDeserializeCallback(const TriangleMesh& triangleMesh)
+          : mTriangleMesh(triangleMesh) {
+
+        }
+
+        // Return true if the mesh subpart and the triangle index of a leaf exist in the mesh
+        virtual bool isLeafDataValid(int32 subPart, int32 triangleIndex) const;
+};
+
 // Class ConcaveMeshShape
 /**
  * This class represents a static concave mesh shape. Note that collision detection
  * with a concave mesh shape can be very expensive. You should use only use
- * this shape for a static mesh.
+ * this shape for a static mesh. The vertices of the triangle mesh are not copied
+ * into the shape. If they are modified (animated platform, deforming bridge, ...),
+ * the refit() method must be called to update the shape. The Dynamic AABB tree of the
+ * shape is built without scaling. Therefore, an instance of the shape with a different
+ * scaling can be created without copying the mesh or building a new tree.
  */
 class ConcaveMeshShape : public ConcaveShape {
 
@@ -115,8 +171,19 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Triangle mesh
         TriangleMesh* mTriangleMesh;
 
-        /// Dynamic AABB tree to accelerate collision with the triangles
-        DynamicAABBTree mDynamicAABBTree;
+        /// Dynamic AABB tree (without scaling) to accelerate collision with the triangles
+        DynamicAABBTree* mDynamicAABBTree;
+
+        /// Surface area cost of the Dynamic AABB tree when it was built
+        decimal mBVHBuildCost;
+
+        /// Concave mesh shape that owns the Dynamic AABB tree used by this shape. This
+        /// is the shape itself unless it is an instance of another concave mesh shape.
+        ConcaveMeshShape* mMeshShape;
+
+        /// Version number of the triangle mesh. It is only incremented in the shape that
+        /// owns the tree so that all the instances of the mesh see the modifications.
+        uint mMeshVersion;
 
         // -------------------- Methods -------------------- //
 
@@ -140,11 +207,21 @@ class ConcaveMeshShape : public ConcaveShape {
         void getTriangleVerticesWithIndexPointer(int32 subPart, int32 triangleIndex,
                                                  Vector3* outTriangleVertices) const;
 
+        /// Return the three vertices coordinates (without scaling) of a triangle of the mesh
+        void getUnscaledTriangleVertices(int32 subPart, int32 triangleIndex,
+                                         Vector3* outTriangleVertices) const;
+
     public:
 
         /// Constructor
         ConcaveMeshShape(TriangleMesh* triangleMesh);
 
+        /// Constructor to create an instance of a concave mesh shape with a given scaling
+        ConcaveMeshShape(ConcaveMeshShape* meshShape, const Vector3& scaling);
+
+        /// Constructor with a Dynamic AABB tree loaded from data written by saveBVH()
+        ConcaveMeshShape(TriangleMesh* triangleMesh, const void* bvhData, size_t bvhDataSize);
+
         /// Destructor
         ~ConcaveMeshShape();
 
@@ -160,10 +237,23 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Use a callback method on all triangles of the concave shape inside a given AABB
         virtual void testAllTriangles(TriangleCallback& callback, const AABB& localAABB) const;
 
+        /// Update the Dynamic AABB tree after the vertices of the triangle mesh have been modified
+        bool refit(decimal rebuildCostRatio = DECIMAL_LARGEST);
+
+        /// Return the version number of the triangles geometry
+        virtual uint getGeometryVersion() const;
+
+        /// Return the size (in bytes) of the buffer needed to save the Dynamic AABB tree
+        size_t getBVHDataSize() const;
+
+        /// Save the Dynamic AABB tree of the shape into a memory buffer
+        void saveBVH(void* buffer) const;
+
         // ---------- Friendship ----------- //
 
         friend class ConvexTriangleAABBOverlapCallback;
         friend class ConcaveMeshRaycastCallback;
+        friend class ConcaveMeshRefitCallback;
 };
 
 // Return the number of bytes used by the collision shape
@@ -171,6 +261,22 @@ inline size_t ConcaveMeshShape::getSizeInBytes() const {
     return sizeof(ConcaveMeshShape);
 }
 
+// Return the size (in bytes) of the buffer needed to save the Dynamic AABB tree
+inline size_t ConcaveMeshShape::getBVHDataSize() const {
+    return mDynamicAABBTree->getSerializedSize();
+}
+
+// Save the Dynamic AABB tree of the shape into a memory buffer
+/// The buffer must have a size of at least getBVHDataSize() bytes. The saved data
+/// can be given to the constructor of a new shape with the same triangle mesh to
+/// avoid building the tree again (see DynamicAABBTree::serialize()).
+/**
+ * @param buffer Pointer to the memory buffer where to write the tree
+ */
+inline void ConcaveMeshShape::saveBVH(void* buffer) const {
+    mDynamicAABBTree->serialize(buffer);
+}
+
 // Return the local bounds of the shape in x, y and z directions.
 // This method is used to compute the AABB of the box
 /**
@@ -180,22 +286,28 @@ inline size_t ConcaveMeshShape::getSizeInBytes() const {
 inline void ConcaveMeshShape::getLocalBounds(Vector3& min, Vector3& max) const {
 
     // Get the AABB of the whole tree
-    AABB treeAABB = mDynamicAABBTree.getRootAABB();
+    AABB treeAABB = mDynamicAABBTree->getRootAABB();
+
+    // Apply the scaling and the triangle margin
+    const Vector3 margin(mTriangleMargin, mTriangleMargin, mTriangleMargin);
+    min = treeAABB.getMin() * mScaling - margin;
+    max = treeAABB.getMax() * mScaling + margin;
+}
 
-    min = treeAABB.getMin();
-    max = treeAABB.getMax();
+// Return the version number of the triangles geometry
+/// The version changes when the scaling of this shape changes or when the shared triangle
+/// mesh is refitted (from this shape or from any other instance of the mesh).
+inline uint ConcaveMeshShape::getGeometryVersion() const {
+    return mGeometryVersion + mMeshShape->mMeshVersion;
 }
 
 // Set the local scaling vector of the collision shape
+/// The scaling is applied at query time and therefore, the tree does not need to be rebuilt.
 inline void ConcaveMeshShape::setLocalScaling(const Vector3& scaling) {
 
     CollisionShape::setLocalScaling(scaling);
 
-    // Reset the Dynamic AABB Tree
-    mDynamicAABBTree.reset();
-
-    // Rebuild Dynamic AABB Tree here
-    initBVHTree();
+    notifyGeometryChanged();
 }
 
 // Return the local inertia tensor of the shape
@@ -230,6 +342,28 @@ inline void ConvexTriangleAABBOverlapCallback::notifyOverlappingNode(int nodeId)
     mTriangleTestCallback.testTriangle(trianglePoints);
 }
 
+// Compute the new AABB of the triangle of a leaf node of the tree
+inline AABB ConcaveMeshRefitCallback::computeLeafAABB(int32 nodeId) {
+
+    // Get the node data (triangle index and mesh subpart index)
+    int32* data = mDynamicAABBTree.getNodeDataInt(nodeId);
+
+    // Get the current triangle vertices (without scaling) for this node from the concave mesh shape
+    Vector3 trianglePoints[3];
+    mConcaveMeshShape.getUnscaledTriangleVertices(data[0], data[1], trianglePoints);
+
+    return AABB::createAABBForTriangle(trianglePoints);
+}
+
+// Return true if the mesh subpart and the triangle index of a leaf exist in the mesh
+inline bool ConcaveMeshDeserializeCallback::isLeafDataValid(int32 subPart, int32 triangleIndex) const {
+
+    if (subPart < 0 || uint(subPart) >= mTriangleMesh.getNbSubparts()) return false;
+
+    return triangleIndex >= 0 &&
+           uint(triangleIndex) < mTriangleMesh.getSubpart(subPart)->getNbTriangles();
+}
+
 }
 #endif
 
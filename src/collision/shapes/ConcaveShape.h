@@ -68,6 +68,10 @@ class ConcaveShape : public CollisionShape {
         /// Raycast test type for the triangle (front, back, front-back)
         TriangleRaycastSide mRaycastTestType;
 
+        /// Version number of the triangles geometry. It is incremented each time the
+        /// triangles of the shape are modified so that cached triangles can be discarded.
+        uint mGeometryVersion;
+
         // -------------------- Methods -------------------- //
 
         /// Private copy-constructor
@@ -79,6 +83,9 @@ class ConcaveShape : public CollisionShape {
         /// Return true if a point is inside the collision shape
         virtual bool testPointInside(const Vector3& localPoint, ProxyShape* proxyShape) const;
 
+        /// Notify that the triangles of the shape have been modified
+        void notifyGeometryChanged();
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -109,6 +116,9 @@ class ConcaveShape : public CollisionShape {
 
         /// Enable/disable the smooth mesh collision algorithm
         void setIsSmoothMeshCollisionEnabled(bool isEnabled);
+
+        /// Return the version number of the triangles geometry
+        virtual uint getGeometryVersion() const;
 };
 
 // Return the triangle margin
@@ -139,6 +149,16 @@ inline void ConcaveShape::setIsSmoothMeshCollisionEnabled(bool isEnabled) {
     mIsSmoothMeshCollisionEnabled = isEnabled;
 }
 
+// Return the version number of the triangles geometry
+inline uint ConcaveShape::getGeometryVersion() const {
+    return mGeometryVersion;
+}
+
+// Notify that the triangles of the shape have been modified
+inline void ConcaveShape::notifyGeometryChanged() {
+    mGeometryVersion++;
+}
+
 // Return the raycast test type (front, back, front-back)
 inline TriangleRaycastSide ConcaveShape::getRaycastTestType() const {
     return mRaycastTestType;
@@ -25,6 +25,7 @@
 
 // Libraries
 #include <complex>
+#include <algorithm>
 #include "configuration.h"
 #include "ConvexMeshShape.h"
 
@@ -40,7 +41,8 @@ using namespace reactphysics3d;
  */
 ConvexMeshShape::ConvexMeshShape(const decimal* arrayVertices, uint nbVertices, int stride, decimal margin)
                 : ConvexShape(CONVEX_MESH, margin), mNbVertices(nbVertices), mMinBounds(0, 0, 0),
-                  mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(false) {
+                  mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(false),
+                  mEdgesAdjacencyOffsets(1, 0), mMeshShape(this) {
     assert(nbVertices > 0);
     assert(stride > 0);
 
@@ -52,13 +54,16 @@ ConvexMeshShape::ConvexMeshShape(const decimal* arrayVertices, uint nbVertices,
         mVertices.push_back(Vector3(newPoint[0], newPoint[1], newPoint[2]));
         vertexPointer += stride;
     }
+    reserveAdjacencyOffsets(mNbVertices - 1);
 
     // Recalculate the bounds of the mesh
     recalculateBounds();
 }
 
 // Constructor to initialize with a triangle mesh
-/// This method creates an internal copy of the input vertices.
+/// This method creates an internal copy of the input vertices. The edges of the triangles
+/// are collected first and the adjacency arrays are then built in two passes with
+/// buildEdgesAdjacency() because each call to addEdge() shifts the adjacency arrays.
 /**
  * @param triangleVertexArray Array with the vertices and indices of the vertices and triangles of the mesh
  * @param isEdgesInformationUsed True if you want to use edges information for collision detection (faster but requires more memory)
@@ -66,7 +71,8 @@ ConvexMeshShape::ConvexMeshShape(const decimal* arrayVertices, uint nbVertices,
  */
 ConvexMeshShape::ConvexMeshShape(TriangleVertexArray* triangleVertexArray, bool isEdgesInformationUsed, decimal margin)
                 : ConvexShape(CONVEX_MESH, margin), mMinBounds(0, 0, 0),
-                  mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(isEdgesInformationUsed) {
+                  mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(isEdgesInformationUsed),
+                  mEdgesAdjacencyOffsets(1, 0), mMeshShape(this) {
 
     TriangleVertexArray::VertexDataType vertexType = triangleVertexArray->getVertexDataType();
     TriangleVertexArray::IndexDataType indexType = triangleVertexArray->getIndexDataType();
@@ -82,52 +88,79 @@ ConvexMeshShape::ConvexMeshShape(TriangleVertexArray* triangleVertexArray, bool
         if (vertexType == TriangleVertexArray::VERTEX_FLOAT_TYPE) {
             const float* vertices = (float*)(verticesStart + v * vertexStride);
 
-            Vector3 vertex(vertices[0], vertices[1], vertices[2] );
-            vertex = vertex * mScaling;
-            mVertices.push_back(vertex);
+            mVertices.push_back(Vector3(vertices[0], vertices[1], vertices[2]));
         }
         else if (vertexType == TriangleVertexArray::VERTEX_DOUBLE_TYPE) {
             const double* vertices = (double*)(verticesStart + v * vertexStride);
 
-            Vector3 vertex(vertices[0], vertices[1], vertices[2] );
-            vertex = vertex * mScaling;
-            mVertices.push_back(vertex);
+            mVertices.push_back(Vector3(vertices[0], vertices[1], vertices[2]));
         }
     }
 
-    // If we need to use the edges information of the mesh
-    if (mIsEdgesInformationUsed) {
+    mNbVertices = mVertices.size();
+    if (mNbVertices > 0) reserveAdjacencyOffsets(mNbVertices - 1);
+
+    // Compute a point inside the mesh (used to orient the face planes) and the size of
+    // the mesh (used for the tolerance of the face planes)
+    Vector3 centroid(0, 0, 0);
+    Vector3 minVertex(DECIMAL_LARGEST, DECIMAL_LARGEST, DECIMAL_LARGEST);
+    Vector3 maxVertex(DECIMAL_SMALLEST, DECIMAL_SMALLEST, DECIMAL_SMALLEST);
+    for (uint i=0; i<mNbVertices; i++) {
+        centroid += mVertices[i];
+        minVertex = Vector3::min(minVertex, mVertices[i]);
+        maxVertex = Vector3::max(maxVertex, mVertices[i]);
+    }
+    if (mNbVertices > 0) centroid /= decimal(mNbVertices);
+    const decimal tolerance = mNbVertices > 0 ? FACE_PLANE_RELATIVE_TOLERANCE *
+                                                (maxVertex - minVertex).length() : decimal(0.0);
 
-        // For each triangle of the mesh
-        for (uint triangleIndex=0; triangleIndex<triangleVertexArray->getNbTriangles(); triangleIndex++) {
+    // Vertex indices of the edges of the triangles (the edges shared by two triangles
+    // appear twice)
+    std::vector<uint> edgesVertices;
+    if (mIsEdgesInformationUsed) edgesVertices.reserve(6 * triangleVertexArray->getNbTriangles());
 
-            void* vertexIndexPointer = (indicesStart + triangleIndex * 3 * indexStride);
+    // For each triangle of the mesh
+    for (uint triangleIndex=0; triangleIndex<triangleVertexArray->getNbTriangles(); triangleIndex++) {
 
-            uint vertexIndex[3] = {0, 0, 0};
+        void* vertexIndexPointer = (indicesStart + triangleIndex * 3 * indexStride);
 
-            // For each vertex of the triangle
-            for (int k=0; k < 3; k++) {
+        uint vertexIndex[3] = {0, 0, 0};
 
-                // Get the index of the current vertex in the triangle
-                if (indexType == TriangleVertexArray::INDEX_INTEGER_TYPE) {
-                    vertexIndex[k] = ((uint*)vertexIndexPointer)[k];
-                }
-                else if (indexType == TriangleVertexArray::INDEX_SHORT_TYPE) {
-                    vertexIndex[k] = ((unsigned short*)vertexIndexPointer)[k];
-                }
-                else {
-                    assert(false);
-                }
+        // For each vertex of the triangle
+        for (int k=0; k < 3; k++) {
+
+            // Get the index of the current vertex in the triangle
+            if (indexType == TriangleVertexArray::INDEX_INTEGER_TYPE) {
+                vertexIndex[k] = ((uint*)vertexIndexPointer)[k];
             }
+            else if (indexType == TriangleVertexArray::INDEX_SHORT_TYPE) {
+                vertexIndex[k] = ((unsigned short*)vertexIndexPointer)[k];
+            }
+            else {
+                assert(false);
+            }
+        }
+
+        // If we need to use the edges information of the mesh
+        if (mIsEdgesInformationUsed) {
 
             // Add information about the edges
-            addEdge(vertexIndex[0], vertexIndex[1]);
-            addEdge(vertexIndex[0], vertexIndex[2]);
-            addEdge(vertexIndex[1], vertexIndex[2]);
+            edgesVertices.push_back(vertexIndex[0]); edgesVertices.push_back(vertexIndex[1]);
+            edgesVertices.push_back(vertexIndex[0]); edgesVertices.push_back(vertexIndex[2]);
+            edgesVertices.push_back(vertexIndex[1]); edgesVertices.push_back(vertexIndex[2]);
         }
+
+        // Add the plane of the triangle
+        addFacePlane(mVertices[vertexIndex[0]], mVertices[vertexIndex[1]],
+                     mVertices[vertexIndex[2]], centroid, tolerance);
     }
 
-    mNbVertices = mVertices.size();
+    // Build the adjacency arrays of the vertices from all the edges at once
+    if (mIsEdgesInformationUsed) buildEdgesAdjacency(edgesVertices);
+
+    // Only keep the face planes if they describe a closed convex mesh
+    validateFacePlanes(tolerance);
+
     recalculateBounds();
 }
 
@@ -136,10 +169,79 @@ ConvexMeshShape::ConvexMeshShape(TriangleVertexArray* triangleVertexArray, bool
 /// the addVertex() method.
 ConvexMeshShape::ConvexMeshShape(decimal margin)
                 : ConvexShape(CONVEX_MESH, margin), mNbVertices(0), mMinBounds(0, 0, 0),
-                  mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(false) {
+                  mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(false),
+                  mEdgesAdjacencyOffsets(1, 0), mMeshShape(this) {
 
 }
 
+// Constructor to initialize with the vertices, edges and faces of a convex hull
+/// This method creates an internal copy of the vertices of the hull. The edges of the
+/// hull are used to speed up the collision detection and the planes of its faces are
+/// used for raycasting and point inside tests.
+/**
+ * @param convexHull Convex hull (see ConvexHull::compute()) with at least four vertices
+ * @param margin Collision margin (in meters) around the collision shape
+ */
+ConvexMeshShape::ConvexMeshShape(const ConvexHull& convexHull, decimal margin)
+                : ConvexShape(CONVEX_MESH, margin), mNbVertices(convexHull.getNbVertices()),
+                  mMinBounds(0, 0, 0), mMaxBounds(0, 0, 0), mIsEdgesInformationUsed(true),
+                  mEdgesAdjacencyOffsets(convexHull.getNbVertices() + 1, 0), mMeshShape(this) {
+    assert(mNbVertices >= 4);
+
+    // Copy the vertices of the hull
+    Vector3 centroid(0, 0, 0);
+    Vector3 minVertex(DECIMAL_LARGEST, DECIMAL_LARGEST, DECIMAL_LARGEST);
+    Vector3 maxVertex(DECIMAL_SMALLEST, DECIMAL_SMALLEST, DECIMAL_SMALLEST);
+    for (uint i=0; i<mNbVertices; i++) {
+        mVertices.push_back(convexHull.getVertex(i));
+        centroid += mVertices[i];
+        minVertex = Vector3::min(minVertex, mVertices[i]);
+        maxVertex = Vector3::max(maxVertex, mVertices[i]);
+    }
+    centroid /= decimal(mNbVertices);
+    const decimal tolerance = FACE_PLANE_RELATIVE_TOLERANCE * (maxVertex - minVertex).length();
+
+    // Build the adjacency arrays of the vertices from the edges of the hull
+    std::vector<uint> edgesVertices(2 * convexHull.getNbEdges());
+    for (uint e=0; e<convexHull.getNbEdges(); e++) {
+        edgesVertices[2 * e] = convexHull.getEdgeVertexIndex(e, 0);
+        edgesVertices[2 * e + 1] = convexHull.getEdgeVertexIndex(e, 1);
+    }
+    buildEdgesAdjacency(edgesVertices);
+
+    // Add the planes of the faces of the hull (coplanar triangles share the same plane)
+    for (uint t=0; t<convexHull.getNbTriangles(); t++) {
+        addFacePlane(mVertices[convexHull.getTriangleVertexIndex(t, 0)],
+                     mVertices[convexHull.getTriangleVertexIndex(t, 1)],
+                     mVertices[convexHull.getTriangleVertexIndex(t, 2)], centroid, tolerance);
+    }
+    validateFacePlanes(tolerance);
+
+    recalculateBounds();
+}
+
+// Constructor to create an instance of a convex mesh shape with a given scaling
+/// The new shape does not copy the vertices, edges and face planes of the mesh but shares
+/// them with the given shape. Only the scaling (applied at query time) and the bounds are
+/// specific to the instance. Therefore, many instances of a mesh can be created at
+/// different scales with a constant memory cost per instance. The shape that stores
+/// the mesh data must not be modified or destroyed while its instances are used.
+/**
+ * @param meshShape Convex mesh shape whose mesh data are shared with the new shape
+ * @param scaling Scaling factor of the new shape in the three local x, y and z directions
+ */
+ConvexMeshShape::ConvexMeshShape(const ConvexMeshShape* meshShape, const Vector3& scaling)
+                : ConvexShape(CONVEX_MESH, meshShape->mMargin), mNbVertices(meshShape->mNbVertices),
+                  mMinBounds(0, 0, 0), mMaxBounds(0, 0, 0),
+                  mIsEdgesInformationUsed(meshShape->mIsEdgesInformationUsed),
+                  mMeshShape(meshShape->mMeshShape) {
+
+    assert(scaling.x > decimal(0.0) && scaling.y > decimal(0.0) && scaling.z > decimal(0.0));
+
+    mScaling = scaling;
+    recalculateBounds();
+}
+
 // Destructor
 ConvexMeshShape::~ConvexMeshShape() {
 
@@ -152,81 +254,250 @@ ConvexMeshShape::~ConvexMeshShape() {
 /// However, if the edges information is used, we can cache the previous support vertex and use
 /// it as a start in a hill-climbing (local search) process to find the new support vertex which
 /// will be in most of the cases very close to the previous one. Using hill-climbing, this method
-/// runs in almost constant time.
+/// runs in almost constant time. In both cases, the last support direction is cached as well so
+/// that a query with the same direction directly returns the cached vertex.
 Vector3 ConvexMeshShape::getLocalSupportPointWithoutMargin(const Vector3& direction,
                                                            void** cachedCollisionData) const {
 
-    assert(mNbVertices == mVertices.size());
+    const std::vector<Vector3>& vertices = mMeshShape->mVertices;
+    assert(mNbVertices == vertices.size());
     assert(cachedCollisionData != NULL);
 
     // Allocate memory for the cached collision data if not allocated yet
     if ((*cachedCollisionData) == NULL) {
-        *cachedCollisionData = (int*) malloc(sizeof(int));
-        *((int*)(*cachedCollisionData)) = 0;
+        ConvexMeshSupportCache* newCache = (ConvexMeshSupportCache*)
+                                           malloc(sizeof(ConvexMeshSupportCache));
+        newCache->direction[0] = decimal(0.0);
+        newCache->direction[1] = decimal(0.0);
+        newCache->direction[2] = decimal(0.0);
+        newCache->vertexIndex = 0;
+        *cachedCollisionData = newCache;
     }
+    ConvexMeshSupportCache* cache = (ConvexMeshSupportCache*)(*cachedCollisionData);
+
+    // The cached vertex might come from a previous version of the mesh
+    uint supportVertex = cache->vertexIndex < mNbVertices ? cache->vertexIndex : 0;
+
+    // If the support direction has not changed since the last query
+    if (direction.x == cache->direction[0] && direction.y == cache->direction[1] &&
+        direction.z == cache->direction[2] && cache->vertexIndex < mNbVertices) {
+        return vertices[supportVertex] * mScaling;
+    }
+
+    // Since the vertices are scaled afterwards, we have dot(d, S * v) = dot(S * d, v)
+    const Vector3 unscaledDirection = direction * mScaling;
 
     // If the edges information is used to speed up the collision detection
     if (mIsEdgesInformationUsed) {
+        supportVertex = computeSupportVertexHillClimbing(unscaledDirection, supportVertex);
+    }
+    else {  // If the edges information is not used
+        supportVertex = computeSupportVertexBruteForce(unscaledDirection);
+    }
+
+    // Cache the support direction and support vertex
+    cache->direction[0] = direction.x;
+    cache->direction[1] = direction.y;
+    cache->direction[2] = direction.z;
+    cache->vertexIndex = supportVertex;
+
+    // Return the support vertex
+    return vertices[supportVertex] * mScaling;
+}
 
-        assert(mEdgesAdjacencyList.size() == mNbVertices);
+// Return the index of the support vertex using hill-climbing over the edges
+/// The neighbors of each vertex are stored contiguously in the mEdgesAdjacentVertices
+/// array so that each step of the local search only reads a small contiguous range.
+/**
+ * @param direction Support direction (in the unscaled local-space of the mesh)
+ * @param startVertex Index of the vertex where to start the local search
+ * @return The index of the support vertex
+ */
+uint ConvexMeshShape::computeSupportVertexHillClimbing(const Vector3& direction,
+                                                       uint startVertex) const {
 
-        uint maxVertex = *((int*)(*cachedCollisionData));
-        decimal maxDotProduct = direction.dot(mVertices[maxVertex]);
-        bool isOptimal;
+    const std::vector<Vector3>& vertices = mMeshShape->mVertices;
+    const std::vector<uint>& adjacencyOffsets = mMeshShape->mEdgesAdjacencyOffsets;
+    const std::vector<uint>& adjacentVertices = mMeshShape->mEdgesAdjacentVertices;
+    assert(adjacencyOffsets.size() == mNbVertices + 1);
 
-        // Perform hill-climbing (local search)
-        do {
-            isOptimal = true;
+    uint maxVertex = startVertex;
+    decimal maxDotProduct = direction.dot(vertices[maxVertex]);
+    bool isOptimal;
 
-            assert(mEdgesAdjacencyList.at(maxVertex).size() > 0);
+    // Perform hill-climbing (local search)
+    do {
+        isOptimal = true;
 
-            // For all neighbors of the current vertex
-            std::set<uint>::const_iterator it;
-            std::set<uint>::const_iterator itBegin = mEdgesAdjacencyList.at(maxVertex).begin();
-            std::set<uint>::const_iterator itEnd = mEdgesAdjacencyList.at(maxVertex).end();
-            for (it = itBegin; it != itEnd; ++it) {
+        const uint firstNeighbor = adjacencyOffsets[maxVertex];
+        const uint lastNeighbor = adjacencyOffsets[maxVertex + 1];
+        assert(lastNeighbor > firstNeighbor);
 
-                // Compute the dot product
-                decimal dotProduct = direction.dot(mVertices[*it]);
+        // For all neighbors of the current vertex
+        for (uint i=firstNeighbor; i<lastNeighbor; i++) {
 
-                // If the current vertex is a better vertex (larger dot product)
-                if (dotProduct > maxDotProduct) {
-                    maxVertex = *it;
-                    maxDotProduct = dotProduct;
-                    isOptimal = false;
-                }
+            const uint neighbor = adjacentVertices[i];
+
+            // Compute the dot product
+            decimal dotProduct = direction.dot(vertices[neighbor]);
+
+            // If the current vertex is a better vertex (larger dot product)
+            if (dotProduct > maxDotProduct) {
+                maxVertex = neighbor;
+                maxDotProduct = dotProduct;
+                isOptimal = false;
             }
+        }
 
-        } while(!isOptimal);
+    } while(!isOptimal);
 
-        // Cache the support vertex
-        *((int*)(*cachedCollisionData)) = maxVertex;
+    return maxVertex;
+}
 
-        // Return the support vertex
-        return mVertices[maxVertex] * mScaling;
+// Return the index of the support vertex by testing all the vertices
+/// The vertices are processed four at a time with four independent running maxima.
+/// Since there is no dependency between the four lanes and the selection is branch-free,
+/// the compiler is able to vectorize the loop for small meshes.
+/**
+ * @param direction Support direction (in the unscaled local-space of the mesh)
+ * @return The index of the support vertex
+ */
+uint ConvexMeshShape::computeSupportVertexBruteForce(const Vector3& direction) const {
+
+    decimal maxDotProducts[4] = {DECIMAL_SMALLEST, DECIMAL_SMALLEST,
+                                 DECIMAL_SMALLEST, DECIMAL_SMALLEST};
+    uint maxIndices[4] = {0, 0, 0, 0};
+
+    const std::vector<Vector3>& vertices = mMeshShape->mVertices;
+    const uint nbVerticesInPacks = mNbVertices & ~uint(3);
+
+    // For each pack of four vertices
+    for (uint i=0; i<nbVerticesInPacks; i += 4) {
+        for (uint k=0; k<4; k++) {
+            const Vector3& vertex = vertices[i + k];
+            const decimal dotProduct = direction.x * vertex.x + direction.y * vertex.y +
+                                       direction.z * vertex.z;
+            const bool isLarger = dotProduct > maxDotProducts[k];
+            maxDotProducts[k] = isLarger ? dotProduct : maxDotProducts[k];
+            maxIndices[k] = isLarger ? i + k : maxIndices[k];
+        }
+    }
+
+    // Remaining vertices
+    for (uint i=nbVerticesInPacks; i<mNbVertices; i++) {
+        const decimal dotProduct = direction.dot(vertices[i]);
+        if (dotProduct > maxDotProducts[0]) {
+            maxDotProducts[0] = dotProduct;
+            maxIndices[0] = i;
+        }
+    }
+
+    // Reduce the four lanes (the smallest index wins in case of equality)
+    uint indexMaxDotProduct = maxIndices[0];
+    decimal maxDotProduct = maxDotProducts[0];
+    for (uint k=1; k<4; k++) {
+        if (maxDotProducts[k] > maxDotProduct ||
+            (maxDotProducts[k] == maxDotProduct && maxIndices[k] < indexMaxDotProduct)) {
+            maxDotProduct = maxDotProducts[k];
+            indexMaxDotProduct = maxIndices[k];
+        }
     }
-    else {  // If the edges information is not used
 
-        double maxDotProduct = DECIMAL_SMALLEST;
-        uint indexMaxDotProduct = 0;
+    assert(maxDotProduct >= decimal(0.0));
 
-        // For each vertex of the mesh
-        for (uint i=0; i<mNbVertices; i++) {
+    return indexMaxDotProduct;
+}
 
-            // Compute the dot product of the current vertex
-            double dotProduct = direction.dot(mVertices[i]);
+// Add an edge into the convex mesh by specifying the two vertex indices of the edge.
+/// The vertex indices follow the order of the vertices of the constructor or of addVertex().
+/**
+* @param v1 Index of the first vertex of the edge to add
+* @param v2 Index of the second vertex of the edge to add
+*/
+void ConvexMeshShape::addEdge(uint v1, uint v2) {
 
-            // If the current dot product is larger than the maximum one
-            if (dotProduct > maxDotProduct) {
-                indexMaxDotProduct = i;
-                maxDotProduct = dotProduct;
-            }
+    assert(mMeshShape == this);
+
+    reserveAdjacencyOffsets(std::max(v1, v2));
+
+    // Add the edge in the adjacency arrays
+    addAdjacentVertex(v1, v2);
+    addAdjacentVertex(v2, v1);
+}
+
+// Build the adjacency arrays of the vertices from a list of edges
+/// The arrays are built in two passes (number of neighbors of each vertex and then
+/// neighbors) and the duplicated edges are removed afterwards. This runs in
+/// O(E log(d)) time with "d" the maximum number of neighbors of a vertex whereas adding
+/// the edges one by one with addEdge() shifts the adjacency arrays for each edge.
+/**
+ * @param edgesVertices Array with the two vertex indices of each edge
+ */
+void ConvexMeshShape::buildEdgesAdjacency(const std::vector<uint>& edgesVertices) {
+
+    assert(mMeshShape == this);
+    assert(edgesVertices.size() % 2 == 0);
+
+    // Count the number of neighbors of each vertex (with the duplicated edges)
+    mEdgesAdjacencyOffsets.assign(mNbVertices + 1, 0);
+    for (uint i=0; i<edgesVertices.size(); i++) {
+        assert(edgesVertices[i] < mNbVertices);
+        mEdgesAdjacencyOffsets[edgesVertices[i] + 1]++;
+    }
+    for (uint i=0; i<mNbVertices; i++) {
+        mEdgesAdjacencyOffsets[i + 1] += mEdgesAdjacencyOffsets[i];
+    }
+
+    // Fill the neighbors of each vertex
+    std::vector<uint> nextNeighbor(mEdgesAdjacencyOffsets.begin(), mEdgesAdjacencyOffsets.end() - 1);
+    mEdgesAdjacentVertices.resize(mEdgesAdjacencyOffsets[mNbVertices]);
+    for (uint i=0; i<edgesVertices.size(); i += 2) {
+        const uint v1 = edgesVertices[i];
+        const uint v2 = edgesVertices[i + 1];
+        mEdgesAdjacentVertices[nextNeighbor[v1]++] = v2;
+        mEdgesAdjacentVertices[nextNeighbor[v2]++] = v1;
+    }
+
+    // Remove the duplicated neighbors of each vertex and compact the arrays
+    uint nbNeighbors = 0;
+    for (uint v=0; v<mNbVertices; v++) {
+        std::vector<uint>::iterator first = mEdgesAdjacentVertices.begin() + mEdgesAdjacencyOffsets[v];
+        std::vector<uint>::iterator last = mEdgesAdjacentVertices.begin() + mEdgesAdjacencyOffsets[v + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+
+        mEdgesAdjacencyOffsets[v] = nbNeighbors;
+        for (std::vector<uint>::iterator it = first; it != last; ++it) {
+            mEdgesAdjacentVertices[nbNeighbors++] = *it;
         }
+    }
+    mEdgesAdjacencyOffsets[mNbVertices] = nbNeighbors;
+    mEdgesAdjacentVertices.resize(nbNeighbors);
+}
 
-        assert(maxDotProduct >= decimal(0.0));
+// Make sure the adjacency offsets array has an entry for a given vertex
+void ConvexMeshShape::reserveAdjacencyOffsets(uint vertexIndex) {
+    while (mEdgesAdjacencyOffsets.size() < vertexIndex + 2) {
+        mEdgesAdjacencyOffsets.push_back(mEdgesAdjacencyOffsets.back());
+    }
+}
+
+// Add a directed edge in the adjacency arrays if it does not exist yet
+void ConvexMeshShape::addAdjacentVertex(uint vertex, uint neighbor) {
 
-        // Return the vertex with the largest dot product in the support direction
-        return mVertices[indexMaxDotProduct] * mScaling;
+    const uint firstNeighbor = mEdgesAdjacencyOffsets[vertex];
+    const uint lastNeighbor = mEdgesAdjacencyOffsets[vertex + 1];
+
+    // If the neighbor is already in the adjacency range of the vertex
+    for (uint i=firstNeighbor; i<lastNeighbor; i++) {
+        if (mEdgesAdjacentVertices[i] == neighbor) return;
+    }
+
+    // Insert the neighbor at the end of the range of the vertex and shift the
+    // ranges of the following vertices
+    mEdgesAdjacentVertices.insert(mEdgesAdjacentVertices.begin() + lastNeighbor, neighbor);
+    for (uint i=vertex + 1; i<mEdgesAdjacencyOffsets.size(); i++) {
+        mEdgesAdjacencyOffsets[i]++;
     }
 }
 
@@ -239,17 +510,19 @@ void ConvexMeshShape::recalculateBounds() {
     mMinBounds.setToZero();
     mMaxBounds.setToZero();
 
+    const std::vector<Vector3>& vertices = mMeshShape->mVertices;
+
     // For each vertex of the mesh
     for (uint i=0; i<mNbVertices; i++) {
 
-        if (mVertices[i].x > mMaxBounds.x) mMaxBounds.x = mVertices[i].x;
-        if (mVertices[i].x < mMinBounds.x) mMinBounds.x = mVertices[i].x;
+        if (vertices[i].x > mMaxBounds.x) mMaxBounds.x = vertices[i].x;
+        if (vertices[i].x < mMinBounds.x) mMinBounds.x = vertices[i].x;
 
-        if (mVertices[i].y > mMaxBounds.y) mMaxBounds.y = mVertices[i].y;
-        if (mVertices[i].y < mMinBounds.y) mMinBounds.y = mVertices[i].y;
+        if (vertices[i].y > mMaxBounds.y) mMaxBounds.y = vertices[i].y;
+        if (vertices[i].y < mMinBounds.y) mMinBounds.y = vertices[i].y;
 
-        if (mVertices[i].z > mMaxBounds.z) mMaxBounds.z = mVertices[i].z;
-        if (mVertices[i].z < mMinBounds.z) mMinBounds.z = mVertices[i].z;
+        if (vertices[i].z > mMaxBounds.z) mMaxBounds.z = vertices[i].z;
+        if (vertices[i].z < mMinBounds.z) mMinBounds.z = vertices[i].z;
     }
 
     // Apply the local scaling factor
@@ -261,8 +534,149 @@ void ConvexMeshShape::recalculateBounds() {
     mMinBounds -= Vector3(mMargin, mMargin, mMargin);
 }
 
+// Add the plane of a triangle face if no coplanar face has been added yet
+/// The normal of the plane is oriented so that it points away from a given point
+/// inside the mesh. Therefore, the winding order of the triangles does not matter.
+/**
+ * @param v1 First vertex of the triangle (in the unscaled local-space)
+ * @param v2 Second vertex of the triangle (in the unscaled local-space)
+ * @param v3 Third vertex of the triangle (in the unscaled local-space)
+ * @param insidePoint Point inside the mesh
+ * @param tolerance Distance under which two parallel planes are considered equal
+ */
+void ConvexMeshShape::addFacePlane(const Vector3& v1, const Vector3& v2, const Vector3& v3,
+                                   const Vector3& insidePoint, decimal tolerance) {
+
+    Vector3 normal = (v2 - v1).cross(v3 - v1);
+
+    // Ignore the degenerate triangles
+    const decimal normalLength = normal.length();
+    if (normalLength < MACHINE_EPSILON) return;
+    normal /= normalLength;
+
+    // Make the normal point outward
+    if (normal.dot(v1 - insidePoint) < decimal(0.0)) normal = -normal;
+
+    const Plane plane(normal, v1);
+
+    // If the face is coplanar with a face that has already been added
+    for (uint i=0; i<mFacePlanes.size(); i++) {
+        if (mFacePlanes[i].normal.dot(normal) > decimal(1.0) - FACE_PLANE_RELATIVE_TOLERANCE &&
+            std::abs(mFacePlanes[i].distance - plane.distance) < tolerance) {
+            return;
+        }
+    }
+
+    mFacePlanes.push_back(plane);
+}
+
+// Discard the face planes if they do not describe a closed convex mesh
+/// All the vertices must be behind every face plane (convex mesh) and each vertex must
+/// lie on at least three face planes (closed mesh). Otherwise, the face planes would not
+/// bound the shape and the GJK algorithm is used instead.
+/**
+ * @param tolerance Maximum distance of a vertex in front of a face plane
+ */
+void ConvexMeshShape::validateFacePlanes(decimal tolerance) {
+
+    // A closed mesh has at least four faces
+    if (mFacePlanes.size() < 4) {
+        mFacePlanes.clear();
+        return;
+    }
+
+    // For each vertex of the mesh
+    for (uint v=0; v<mNbVertices; v++) {
+
+        uint nbIncidentPlanes = 0;
+
+        // For each face plane
+        for (uint i=0; i<mFacePlanes.size(); i++) {
+
+            const decimal distance = mFacePlanes[i].computeSignedDistance(mVertices[v]);
+
+            // If the vertex is in front of the plane, the mesh is not convex
+            if (distance > tolerance) {
+                mFacePlanes.clear();
+                return;
+            }
+
+            if (distance > -tolerance) nbIncidentPlanes++;
+        }
+
+        // If the vertex is not a corner of the mesh, some faces are missing
+        if (nbIncidentPlanes < 3) {
+            mFacePlanes.clear();
+            return;
+        }
+    }
+}
+
 // Raycast method with feedback information
+/// If the face planes are known, the ray is clipped against all of them. The entry
+/// point of the ray is the last entering intersection as long as it comes before the
+/// first exiting one. This computation is done in the unscaled local-space of the mesh
+/// where the hit fraction is the same. Otherwise, the GJK algorithm is used.
 bool ConvexMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape) const {
-    return proxyShape->mBody->mWorld.mCollisionDetection.mNarrowPhaseGJKAlgorithm.raycast(
-                                     ray, proxyShape, raycastInfo);
+
+    const std::vector<Plane>& facePlanes = mMeshShape->mFacePlanes;
+
+    if (facePlanes.empty()) {
+        return proxyShape->mBody->mWorld.mCollisionDetection.mNarrowPhaseGJKAlgorithm.raycast(
+                                         ray, this, proxyShape, raycastInfo);
+    }
+
+    // Convert the ray into the unscaled local-space of the mesh
+    const Vector3 point1 = ray.point1 / mScaling;
+    const Vector3 rayDirection = ray.point2 / mScaling - point1;
+
+    decimal tMin = DECIMAL_SMALLEST;
+    decimal tMax = ray.maxFraction;
+    int hitPlaneIndex = -1;
+
+    // For each face plane
+    for (uint i=0; i<facePlanes.size(); i++) {
+
+        const Plane& plane = facePlanes[i];
+        const decimal nDotD = plane.normal.dot(rayDirection);
+        const decimal distance = -plane.computeSignedDistance(point1);
+
+        // If the ray is parallel to the plane
+        if (std::abs(nDotD) < MACHINE_EPSILON) {
+
+            // If the ray's origin is in front of the plane, there is no hit
+            if (distance < decimal(0.0)) return false;
+        }
+        else {
+
+            const decimal t = distance / nDotD;
+
+            // If the ray enters the half-space of the plane
+            if (nDotD < decimal(0.0)) {
+                if (t > tMin) {
+                    tMin = t;
+                    hitPlaneIndex = i;
+                }
+            }
+            else {  // If the ray exits the half-space of the plane
+                tMax = std::min(tMax, t);
+            }
+
+            // If the intersection interval is empty, there is no hit
+            if (tMin > tMax) return false;
+        }
+    }
+
+    // If the ray's origin is inside the mesh, we return no hit
+    if (hitPlaneIndex < 0 || tMin < decimal(0.0)) return false;
+
+    raycastInfo.body = proxyShape->getBody();
+    raycastInfo.proxyShape = proxyShape;
+    raycastInfo.hitFraction = tMin;
+    raycastInfo.worldPoint = ray.point1 + tMin * (ray.point2 - ray.point1);
+
+    // The normals are transformed by the inverse of the scaling
+    raycastInfo.worldNormal = facePlanes[hitPlaneIndex].normal / mScaling;
+
+    return true;
 }
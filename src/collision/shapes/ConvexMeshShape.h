@@ -31,10 +31,10 @@
 #include "engine/CollisionWorld.h"
 #include "mathematics/mathematics.h"
 #include "collision/TriangleMesh.h"
+#include "collision/ConvexHull.h"
+#include "ConvexMeshSupportCache.h"
 #include "collision/narrowphase/GJK/GJKAlgorithm.h"
 #include <vector>
-#include <set>
-#include <map>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -42,6 +42,9 @@ namespace reactphysics3d {
 // Declaration
 class CollisionWorld;
 
+// Constants
+const decimal FACE_PLANE_RELATIVE_TOLERANCE = decimal(0.0001);
+
 // Class ConvexMeshShape
 /**
  * This class represents a convex mesh shape. In order to create a convex mesh shape, you
@@ -56,7 +59,14 @@ class CollisionWorld;
  * of the collision detection that uses the edges is almost O(1) constant time at the cost
  * of additional memory used to store the vertices. You can indicate edges information
  * with the addEdge() method. Then, you must use the setIsEdgesInformationUsed(true) method
- * in order to use the edges information for collision detection.
+ * in order to use the edges information for collision detection. If the shape is created
+ * with a closed triangle vertex array, the planes of its faces are also computed and used
+ * for an analytic raycast and point inside test instead of the GJK algorithm. The vertices
+ * of the mesh are stored without scaling and the scaling is applied at query time. An
+ * instance of a convex mesh shape with a different scaling can be created without copying
+ * the mesh data. A convex mesh shape can also be created from a ConvexHull computed
+ * from any cloud of points. In this case, the edges and the face planes of the hull
+ * are used.
  */
 class ConvexMeshShape : public ConvexShape {
 
@@ -80,8 +90,22 @@ class ConvexMeshShape : public ConvexShape {
         /// make the collision detection faster
         bool mIsEdgesInformationUsed;
 
-        /// Adjacency list representing the edges of the mesh
-        std::map<uint, std::set<uint> > mEdgesAdjacencyList;
+        /// Offsets of the neighbors of each vertex in the mEdgesAdjacentVertices array
+        /// (compressed sparse row layout). The neighbors of vertex i are stored in the
+        /// range [mEdgesAdjacencyOffsets[i], mEdgesAdjacencyOffsets[i+1]).
+        std::vector<uint> mEdgesAdjacencyOffsets;
+
+        /// Flat array with the neighbor vertex indices of all the vertices of the mesh
+        std::vector<uint> mEdgesAdjacentVertices;
+
+        /// Outward planes of the faces of the mesh (in the unscaled local-space). This
+        /// array is empty if the faces of the mesh are not known.
+        std::vector<Plane> mFacePlanes;
+
+        /// Convex mesh shape that stores the mesh data (vertices, edges and face planes)
+        /// used by this shape. This is the shape itself unless it is an instance of
+        /// another convex mesh shape.
+        const ConvexMeshShape* mMeshShape;
 
         // -------------------- Methods -------------------- //
 
@@ -94,6 +118,28 @@ class ConvexMeshShape : public ConvexShape {
         /// Recompute the bounds of the mesh
         void recalculateBounds();
 
+        /// Make sure the adjacency offsets array has an entry for a given vertex
+        void reserveAdjacencyOffsets(uint vertexIndex);
+
+        /// Add a directed edge in the adjacency arrays if it does not exist yet
+        void addAdjacentVertex(uint vertex, uint neighbor);
+
+        /// Build the adjacency arrays of the vertices from a list of edges
+        void buildEdgesAdjacency(const std::vector<uint>& edgesVertices);
+
+        /// Return the index of the support vertex using hill-climbing over the edges
+        uint computeSupportVertexHillClimbing(const Vector3& direction, uint startVertex) const;
+
+        /// Return the index of the support vertex by testing all the vertices
+        uint computeSupportVertexBruteForce(const Vector3& direction) const;
+
+        /// Add the plane of a triangle face if no coplanar face has been added yet
+        void addFacePlane(const Vector3& v1, const Vector3& v2, const Vector3& v3,
+                          const Vector3& insidePoint, decimal tolerance);
+
+        /// Discard the face planes if they do not describe a closed convex mesh
+        void validateFacePlanes(decimal tolerance);
+
         /// Set the scaling vector of the collision shape
         virtual void setLocalScaling(const Vector3& scaling);
 
@@ -125,6 +171,12 @@ class ConvexMeshShape : public ConvexShape {
         /// Constructor.
         ConvexMeshShape(decimal margin = OBJECT_MARGIN);
 
+        /// Constructor to initialize with the vertices, edges and faces of a convex hull
+        ConvexMeshShape(const ConvexHull& convexHull, decimal margin = OBJECT_MARGIN);
+
+        /// Constructor to create an instance of a convex mesh shape with a given scaling
+        ConvexMeshShape(const ConvexMeshShape* meshShape, const Vector3& scaling);
+
         /// Destructor
         virtual ~ConvexMeshShape();
 
@@ -146,6 +198,13 @@ class ConvexMeshShape : public ConvexShape {
         /// Set the variable to know if the edges information is used to speed up the
         /// collision detection
         void setIsEdgesInformationUsed(bool isEdgesUsed);
+
+        /// Return true if the face planes of the mesh are used for raycasting and
+        /// point inside tests
+        bool hasFacePlanes() const;
+
+        /// Return the number of face planes of the mesh
+        uint getNbFacePlanes() const;
 };
 
 /// Set the scaling vector of the collision shape
@@ -195,10 +254,19 @@ inline void ConvexMeshShape::computeLocalInertiaTensor(Matrix3x3& tensor, decima
  */
 inline void ConvexMeshShape::addVertex(const Vector3& vertex) {
 
+    // The mesh data of an instance cannot be modified
+    assert(mMeshShape == this);
+
     // Add the vertex in to vertices array
     mVertices.push_back(vertex);
     mNbVertices++;
 
+    // The new vertex has no neighbor yet
+    reserveAdjacencyOffsets(mNbVertices - 1);
+
+    // The face planes do not describe the new mesh anymore
+    mFacePlanes.clear();
+
     // Update the bounds of the mesh
     if (vertex.x * mScaling.x > mMaxBounds.x) mMaxBounds.x = vertex.x * mScaling.x;
     if (vertex.x * mScaling.x < mMinBounds.x) mMinBounds.x = vertex.x * mScaling.x;
@@ -208,31 +276,6 @@ inline void ConvexMeshShape::addVertex(const Vector3& vertex) {
     if (vertex.z * mScaling.z < mMinBounds.z) mMinBounds.z = vertex.z * mScaling.z;
 }
 
-// Add an edge into the convex mesh by specifying the two vertex indices of the edge.
-/// Note that the vertex indices start at zero and need to correspond to the order of
-/// the vertices in the vertices array in the constructor or the order of the calls
-/// of the addVertex() methods that you use to add vertices into the convex mesh.
-/**
-* @param v1 Index of the first vertex of the edge to add
-* @param v2 Index of the second vertex of the edge to add
-*/
-inline void ConvexMeshShape::addEdge(uint v1, uint v2) {
-
-    // If the entry for vertex v1 does not exist in the adjacency list
-    if (mEdgesAdjacencyList.count(v1) == 0) {
-        mEdgesAdjacencyList.insert(std::make_pair(v1, std::set<uint>()));
-    }
-
-    // If the entry for vertex v2 does not exist in the adjacency list
-    if (mEdgesAdjacencyList.count(v2) == 0) {
-        mEdgesAdjacencyList.insert(std::make_pair(v2, std::set<uint>()));
-    }
-
-    // Add the edge in the adjacency list
-    mEdgesAdjacencyList[v1].insert(v2);
-    mEdgesAdjacencyList[v2].insert(v1);
-}
-
 // Return true if the edges information is used to speed up the collision detection
 /**
  * @return True if the edges information is used and false otherwise
@@ -251,13 +294,45 @@ inline void ConvexMeshShape::setIsEdgesInformationUsed(bool isEdgesUsed) {
     mIsEdgesInformationUsed = isEdgesUsed;
 }
 
+// Return true if the face planes of the mesh are used for raycasting and point inside tests
+/**
+ * @return True if the face planes of the mesh are known and false otherwise
+ */
+inline bool ConvexMeshShape::hasFacePlanes() const {
+    return !mMeshShape->mFacePlanes.empty();
+}
+
+// Return the number of face planes of the mesh
+/**
+ * @return The number of face planes (zero if the faces of the mesh are not known)
+ */
+inline uint ConvexMeshShape::getNbFacePlanes() const {
+    return static_cast<uint>(mMeshShape->mFacePlanes.size());
+}
+
 // Return true if a point is inside the collision shape
+/// If the face planes are known, the point is inside if it is behind all of them.
+/// Otherwise, the GJK algorithm is used.
 inline bool ConvexMeshShape::testPointInside(const Vector3& localPoint,
                                              ProxyShape* proxyShape) const {
 
+    const std::vector<Plane>& facePlanes = mMeshShape->mFacePlanes;
+
+    if (!facePlanes.empty()) {
+
+        // The face planes are expressed in the unscaled local-space of the mesh
+        const Vector3 unscaledPoint = localPoint / mScaling;
+
+        for (uint i=0; i<facePlanes.size(); i++) {
+            if (facePlanes[i].computeSignedDistance(unscaledPoint) > decimal(0.0)) return false;
+        }
+
+        return true;
+    }
+
     // Use the GJK algorithm to test if the point is inside the convex mesh
     return proxyShape->mBody->mWorld.mCollisionDetection.
-           mNarrowPhaseGJKAlgorithm.testPointInside(localPoint, proxyShape);
+           mNarrowPhaseGJKAlgorithm.testPointInside(localPoint, this);
 }
 
 }
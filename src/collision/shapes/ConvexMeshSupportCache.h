@@ -0,0 +1,60 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONVEX_MESH_SUPPORT_CACHE_H
+#define REACTPHYSICS3D_CONVEX_MESH_SUPPORT_CACHE_H
+
+// Libraries
+#include "configuration.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Structure ConvexMeshSupportCache
+/**
+ * This structure is stored in the cached collision data of a proxy shape with
+ * a convex mesh. It remembers the last support direction and support vertex so
+ * that the next support query can start from there. A query can also use its own
+ * cache (on the stack for instance) by pointing the cached collision data to it.
+ */
+struct ConvexMeshSupportCache {
+
+    /// Last support direction (in the local-space of the shape)
+    decimal direction[3];
+
+    /// Index of the support vertex for the last support direction
+    uint vertexIndex;
+
+    /// Constructor
+    ConvexMeshSupportCache() : vertexIndex(0) {
+        direction[0] = decimal(0.0);
+        direction[1] = decimal(0.0);
+        direction[2] = decimal(0.0);
+    }
+};
+
+}
+
+#endif
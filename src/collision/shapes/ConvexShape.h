@@ -85,6 +85,7 @@ class ConvexShape : public CollisionShape {
 
         friend class GJKAlgorithm;
         friend class EPAAlgorithm;
+        friend class CompoundShape;
 };
 
 /// Return true if the collision shape is convex, false if it is concave
@@ -25,6 +25,8 @@
 
 // Libraries
 #include "HeightFieldShape.h"
+#include <cstring>
+#include <cstdlib>
 
 using namespace reactphysics3d;
 
@@ -35,17 +37,19 @@ using namespace reactphysics3d;
  * @param minHeight Minimum height value of the height field
  * @param maxHeight Maximum height value of the height field
  * @param heightFieldData Pointer to the first height value data (note that values are shared and not copied)
- * @param dataType Data type for the height values (int, float, double)
+ * @param dataType Data type for the height values (int, float, double, 8 or 16 bits unsigned integer)
  * @param upAxis Integer representing the up axis direction (0 for x, 1 for y and 2 for z)
  * @param integerHeightScale Scaling factor used to scale the height values (only when height values type is integer)
+ * @param integerHeightOffset Offset added to the scaled height values (only when height values type is integer)
  */
 HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal minHeight, decimal maxHeight,
                                    const void* heightFieldData, HeightDataType dataType, int upAxis,
-                                   decimal integerHeightScale)
+                                   decimal integerHeightScale, decimal integerHeightOffset)
                  : ConcaveShape(HEIGHTFIELD), mNbColumns(nbGridColumns), mNbRows(nbGridRows),
                    mWidth(nbGridColumns - 1), mLength(nbGridRows - 1), mMinHeight(minHeight),
                    mMaxHeight(maxHeight), mUpAxis(upAxis), mIntegerHeightScale(integerHeightScale),
-                   mHeightDataType(dataType) {
+                   mIntegerHeightOffset(integerHeightOffset), mHeightDataType(dataType),
+                   mPyramidHeightValues(NULL) {
 
     assert(nbGridColumns >= 2);
     assert(nbGridRows >= 2);
@@ -72,11 +76,16 @@ HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal mi
         mAABB.setMin(Vector3(-mWidth * decimal(0.5), -mLength * decimal(0.5), -halfHeight));
         mAABB.setMax(Vector3(mWidth * decimal(0.5), mLength * decimal(0.5), halfHeight));
     }
+
+    // Compute the height pyramid used to cull the cells of the grid
+    initHeightPyramid();
 }
 
 // Destructor
 HeightFieldShape::~HeightFieldShape() {
 
+    // Release the memory of the height pyramid
+    free(mPyramidHeightValues);
 }
 
 // Return the local bounds of the shape in x, y and z directions.
@@ -133,31 +142,392 @@ void HeightFieldShape::testAllTriangles(TriangleCallback& callback, const AABB&
    assert(jMin >= 0 && jMin < mNbRows);
    assert(jMax >= 0 && jMax < mNbRows);
 
-   // For each sub-grid points (except the last ones one each dimension)
-   for (int i = iMin; i < iMax; i++) {
-       for (int j = jMin; j < jMax; j++) {
+   // Height range of the AABB (the triangles are enlarged by their margin)
+   const decimal heightMargin = mTriangleMargin / mScaling[mUpAxis];
+   const decimal minHeight = aabb.getMin()[mUpAxis] - heightMargin;
+   const decimal maxHeight = aabb.getMax()[mUpAxis] + heightMargin;
+
+   // Test the triangles of the sub-grid (except the last points on each dimension)
+   // starting from the top block of the height pyramid
+   const int level = getNbPyramidLevels() - 1;
+   switch(mHeightDataType) {
+        case HEIGHT_FLOAT_TYPE :
+            testBlockTriangles<float>(callback, level, 0, 0, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+            break;
+        case HEIGHT_DOUBLE_TYPE :
+            testBlockTriangles<double>(callback, level, 0, 0, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+            break;
+        case HEIGHT_INT_TYPE :
+            testBlockTriangles<int>(callback, level, 0, 0, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+            break;
+        case HEIGHT_UINT8_TYPE :
+            testBlockTriangles<uint8>(callback, level, 0, 0, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+            break;
+        case HEIGHT_UINT16_TYPE :
+            testBlockTriangles<uint16>(callback, level, 0, 0, iMin, iMax, jMin, jMax, minHeight, maxHeight);
+            break;
+        default: assert(false);
+   }
+}
 
-           // Compute the four point of the current quad
-           Vector3 p1 = getVertexAt(i, j);
-           Vector3 p2 = getVertexAt(i, j + 1);
-           Vector3 p3 = getVertexAt(i + 1, j);
-           Vector3 p4 = getVertexAt(i + 1, j + 1);
+// Use a callback method on the triangles of a block of the height pyramid that are inside
+// a given range of cells and can overlap a given height range
+/// The blocks that are outside the range of cells or whose height range does not overlap
+/// the given height range are rejected with all their cells. Otherwise, the four children
+/// blocks of the previous level are recursively tested. The method is instantiated for each
+/// type of height values so that there is no test of the data type for each height value.
+/**
+ * @param callback Callback called with each triangle
+ * @param level Level of the block in the height pyramid (0 for a single cell)
+ * @param blockI Column index of the block in its level
+ * @param blockJ Row index of the block in its level
+ * @param iMin Minimum column index of the cells to test
+ * @param iMax Maximum column index (excluded) of the cells to test
+ * @param jMin Minimum row index of the cells to test
+ * @param jMax Maximum row index (excluded) of the cells to test
+ * @param minHeight Minimum height (without scaling) of the triangles to test
+ * @param maxHeight Maximum height (without scaling) of the triangles to test
+ */
+template<typename HeightType>
+void HeightFieldShape::testBlockTriangles(TriangleCallback& callback, int level, int blockI,
+                                          int blockJ, int iMin, int iMax, int jMin, int jMax,
+                                          decimal minHeight, decimal maxHeight) const {
+
+    // If the cells of the block are outside the range of cells to test
+    if ((blockI << level) >= iMax || ((blockI + 1) << level) <= iMin) return;
+    if ((blockJ << level) >= jMax || ((blockJ + 1) << level) <= jMin) return;
+
+    // If the height range of the block does not overlap the height range to test
+    decimal blockMinHeight;
+    decimal blockMaxHeight;
+    computeBlockHeightRange<HeightType>(level, blockI, blockJ, blockMinHeight, blockMaxHeight);
+    if (blockMinHeight > maxHeight || blockMaxHeight < minHeight) return;
+
+    // If the block is a single cell of the grid
+    if (level == 0) {
+        testCellTriangles<HeightType>(blockI, blockJ, callback);
+        return;
+    }
 
-           // Generate the first triangle for the current grid rectangle
-           Vector3 trianglePoints[3] = {p1, p2, p3};
+    // Test the children blocks of the previous level
+    const int lastChildI = std::min(2 * blockI + 1, (mNbColumns - 2) >> (level - 1));
+    const int lastChildJ = std::min(2 * blockJ + 1, (mNbRows - 2) >> (level - 1));
+    for (int childJ = 2 * blockJ; childJ <= lastChildJ; childJ++) {
+        for (int childI = 2 * blockI; childI <= lastChildI; childI++) {
+            testBlockTriangles<HeightType>(callback, level - 1, childI, childJ, iMin, iMax,
+                                           jMin, jMax, minHeight, maxHeight);
+        }
+    }
+}
 
-           // Test collision against the first triangle
-           callback.testTriangle(trianglePoints);
+// Compute the minimum and maximum heights (without scaling) of a block of the pyramid
+/**
+ * @param level Level of the block in the height pyramid (0 for a single cell)
+ * @param blockI Column index of the block in its level
+ * @param blockJ Row index of the block in its level
+ * @param[out] minHeight Minimum height of the block along the up axis
+ * @param[out] maxHeight Maximum height of the block along the up axis
+ */
+void HeightFieldShape::computeBlockHeightRange(int level, int blockI, int blockJ,
+                                               decimal& minHeight, decimal& maxHeight) const {
+
+    switch(mHeightDataType) {
+        case HEIGHT_FLOAT_TYPE :
+            computeBlockHeightRange<float>(level, blockI, blockJ, minHeight, maxHeight);
+            break;
+        case HEIGHT_DOUBLE_TYPE :
+            computeBlockHeightRange<double>(level, blockI, blockJ, minHeight, maxHeight);
+            break;
+        case HEIGHT_INT_TYPE :
+            computeBlockHeightRange<int>(level, blockI, blockJ, minHeight, maxHeight);
+            break;
+        case HEIGHT_UINT8_TYPE :
+            computeBlockHeightRange<uint8>(level, blockI, blockJ, minHeight, maxHeight);
+            break;
+        case HEIGHT_UINT16_TYPE :
+            computeBlockHeightRange<uint16>(level, blockI, blockJ, minHeight, maxHeight);
+            break;
+        default: assert(false);
+    }
+}
 
-           // Generate the second triangle for the current grid rectangle
-           trianglePoints[0] = p3;
-           trianglePoints[1] = p2;
-           trianglePoints[2] = p4;
+// Compute the height range of a block of the pyramid for a given type of height values
+/**
+ * @param level Level of the block in the height pyramid (0 for a single cell)
+ * @param blockI Column index of the block in its level
+ * @param blockJ Row index of the block in its level
+ * @param[out] minHeight Minimum height of the block along the up axis
+ * @param[out] maxHeight Maximum height of the block along the up axis
+ */
+template<typename HeightType>
+void HeightFieldShape::computeBlockHeightRange(int level, int blockI, int blockJ,
+                                               decimal& minHeight, decimal& maxHeight) const {
+
+    // If the block is a single cell, we use the heights of its four vertices
+    if (level == 0) {
+        const decimal height1 = getHeightAt<HeightType>(blockI, blockJ);
+        const decimal height2 = getHeightAt<HeightType>(blockI, blockJ + 1);
+        const decimal height3 = getHeightAt<HeightType>(blockI + 1, blockJ);
+        const decimal height4 = getHeightAt<HeightType>(blockI + 1, blockJ + 1);
+        const decimal heightOrigin = getHeightOrigin();
+        minHeight = heightOrigin + std::min(std::min(height1, height2), std::min(height3, height4));
+        maxHeight = heightOrigin + std::max(std::max(height1, height2), std::max(height3, height4));
+        return;
+    }
 
-           // Test collision against the second triangle
-           callback.testTriangle(trianglePoints);
-       }
-   }
+    // The height values of the block are converted into heights (a negative scale of the
+    // integer height values swaps the minimum and the maximum)
+    HeightType minValue;
+    HeightType maxValue;
+    computeBlockValueRange<HeightType>(level, blockI, blockJ, minValue, maxValue);
+    const decimal height1 = convertHeightValue<HeightType>(minValue);
+    const decimal height2 = convertHeightValue<HeightType>(maxValue);
+    const decimal heightOrigin = getHeightOrigin();
+    minHeight = heightOrigin + std::min(height1, height2);
+    maxHeight = heightOrigin + std::max(height1, height2);
+}
+
+// Compute the minimum and maximum height values of a block of the pyramid
+/**
+ * @param level Level of the block in the height pyramid (0 for a single cell)
+ * @param blockI Column index of the block in its level
+ * @param blockJ Row index of the block in its level
+ * @param[out] minValue Minimum height value (in the height data) of the block
+ * @param[out] maxValue Maximum height value (in the height data) of the block
+ */
+template<typename HeightType>
+void HeightFieldShape::computeBlockValueRange(int level, int blockI, int blockJ,
+                                              HeightType& minValue, HeightType& maxValue) const {
+
+    // If the block is a single cell, we use the height values of its four vertices
+    if (level == 0) {
+        const HeightType* heightValues = static_cast<const HeightType*>(mHeightFieldData);
+        const HeightType value1 = heightValues[blockJ * mNbColumns + blockI];
+        const HeightType value2 = heightValues[(blockJ + 1) * mNbColumns + blockI];
+        const HeightType value3 = heightValues[blockJ * mNbColumns + blockI + 1];
+        const HeightType value4 = heightValues[(blockJ + 1) * mNbColumns + blockI + 1];
+        minValue = std::min(std::min(value1, value2), std::min(value3, value4));
+        maxValue = std::max(std::max(value1, value2), std::max(value3, value4));
+        return;
+    }
+
+    const HeightType* pyramidValues = static_cast<const HeightType*>(mPyramidHeightValues);
+    const int index = getPyramidIndex(level, blockI, blockJ);
+    minValue = pyramidValues[2 * index];
+    maxValue = pyramidValues[2 * index + 1];
+}
+
+// Allocate the height pyramid and compute the height ranges of all its blocks
+/// A new level is added on top of the previous one as long as the previous level
+/// has more than one block along one of the axis of the grid. The height values of
+/// the blocks are stored with the type of the height data. Therefore, the pyramid
+/// uses less memory than the height data (about 2/3 of a height value per cell).
+void HeightFieldShape::initHeightPyramid() {
+
+    const int nbCellsI = mNbColumns - 1;
+    const int nbCellsJ = mNbRows - 1;
+
+    mPyramidLevelOffsets.clear();
+    int nbBlocks = 0;
+    for (int level = 1; ((nbCellsI - 1) >> (level - 1)) > 0 ||
+                        ((nbCellsJ - 1) >> (level - 1)) > 0; level++) {
+        mPyramidLevelOffsets.push_back(nbBlocks);
+        nbBlocks += (((nbCellsI - 1) >> level) + 1) * (((nbCellsJ - 1) >> level) + 1);
+    }
+
+    free(mPyramidHeightValues);
+    mPyramidHeightValues = malloc(2 * nbBlocks * getHeightValueSize());
+
+    updateHeightPyramid(0, 0, nbCellsI - 1, nbCellsJ - 1);
+}
+
+// Recompute the height ranges of the blocks of the pyramid over a range of cells
+/**
+ * @param iMin Minimum column index of the cells
+ * @param jMin Minimum row index of the cells
+ * @param iMax Maximum column index (included) of the cells
+ * @param jMax Maximum row index (included) of the cells
+ */
+void HeightFieldShape::updateHeightPyramid(int iMin, int jMin, int iMax, int jMax) {
+
+    switch(mHeightDataType) {
+        case HEIGHT_FLOAT_TYPE : updateHeightPyramid<float>(iMin, jMin, iMax, jMax); break;
+        case HEIGHT_DOUBLE_TYPE : updateHeightPyramid<double>(iMin, jMin, iMax, jMax); break;
+        case HEIGHT_INT_TYPE : updateHeightPyramid<int>(iMin, jMin, iMax, jMax); break;
+        case HEIGHT_UINT8_TYPE : updateHeightPyramid<uint8>(iMin, jMin, iMax, jMax); break;
+        case HEIGHT_UINT16_TYPE : updateHeightPyramid<uint16>(iMin, jMin, iMax, jMax); break;
+        default: assert(false);
+    }
+}
+
+// Recompute the blocks of the pyramid over a range of cells for a given type of height values
+/// Only the blocks that contain at least one cell of the range are recomputed, level
+/// by level, from the height values of their children blocks.
+/**
+ * @param iMin Minimum column index of the cells
+ * @param jMin Minimum row index of the cells
+ * @param iMax Maximum column index (included) of the cells
+ * @param jMax Maximum row index (included) of the cells
+ */
+template<typename HeightType>
+void HeightFieldShape::updateHeightPyramid(int iMin, int jMin, int iMax, int jMax) {
+
+    assert(iMin >= 0 && iMax < mNbColumns - 1 && iMin <= iMax);
+    assert(jMin >= 0 && jMax < mNbRows - 1 && jMin <= jMax);
+
+    HeightType* pyramidValues = static_cast<HeightType*>(mPyramidHeightValues);
+
+    for (int level=1; level<getNbPyramidLevels(); level++) {
+
+        // Range of the blocks of the current level
+        iMin >>= 1;
+        jMin >>= 1;
+        iMax >>= 1;
+        jMax >>= 1;
+
+        // Number of blocks of the previous level
+        const int lastChildI = (mNbColumns - 2) >> (level - 1);
+        const int lastChildJ = (mNbRows - 2) >> (level - 1);
+
+        for (int blockJ = jMin; blockJ <= jMax; blockJ++) {
+            for (int blockI = iMin; blockI <= iMax; blockI++) {
+
+                // Merge the height values of the children blocks
+                HeightType minValue;
+                HeightType maxValue;
+                computeBlockValueRange<HeightType>(level - 1, 2 * blockI, 2 * blockJ, minValue, maxValue);
+                for (int childJ = 2 * blockJ; childJ <= std::min(2 * blockJ + 1, lastChildJ); childJ++) {
+                    for (int childI = 2 * blockI; childI <= std::min(2 * blockI + 1, lastChildI); childI++) {
+                        HeightType childMinValue;
+                        HeightType childMaxValue;
+                        computeBlockValueRange<HeightType>(level - 1, childI, childJ, childMinValue,
+                                                           childMaxValue);
+                        minValue = std::min(minValue, childMinValue);
+                        maxValue = std::max(maxValue, childMaxValue);
+                    }
+                }
+
+                const int index = getPyramidIndex(level, blockI, blockJ);
+                pyramidValues[2 * index] = minValue;
+                pyramidValues[2 * index + 1] = maxValue;
+            }
+        }
+    }
+}
+
+// Use a callback method on the two triangles of a given cell of the grid
+/**
+ * @param i Column index of the cell (between 0 and mNbColumns - 2)
+ * @param j Row index of the cell (between 0 and mNbRows - 2)
+ * @param callback Callback called with each triangle of the cell
+ */
+template<typename HeightType>
+void HeightFieldShape::testCellTriangles(int i, int j, TriangleCallback& callback) const {
+
+    assert(i >= 0 && i < mNbColumns - 1);
+    assert(j >= 0 && j < mNbRows - 1);
+
+    // Compute the four point of the current quad
+    Vector3 p1 = getVertexAt<HeightType>(i, j);
+    Vector3 p2 = getVertexAt<HeightType>(i, j + 1);
+    Vector3 p3 = getVertexAt<HeightType>(i + 1, j);
+    Vector3 p4 = getVertexAt<HeightType>(i + 1, j + 1);
+
+    // Generate the first triangle for the current grid rectangle
+    Vector3 trianglePoints[3] = {p1, p2, p3};
+
+    // Test collision against the first triangle
+    callback.testTriangle(trianglePoints);
+
+    // Generate the second triangle for the current grid rectangle
+    trianglePoints[0] = p3;
+    trianglePoints[1] = p2;
+    trianglePoints[2] = p4;
+
+    // Test collision against the second triangle
+    callback.testTriangle(trianglePoints);
+}
+
+// Copy new height values into a region of the grid and update the shape accordingly
+/// The height values are written into the shared height data array. Then, the height
+/// pyramid is only recomputed over the cells that use the modified grid points. The
+/// local AABB of the height field keeps the minimum and maximum heights given in the
+/// constructor (so that the height field is not moved) but it is enlarged if the new
+/// height values are out of this range.
+/**
+ * @param firstColumn Column of the first grid point of the region
+ * @param firstRow Row of the first grid point of the region
+ * @param nbRegionColumns Number of columns of the region
+ * @param nbRegionRows Number of rows of the region
+ * @param heights Pointer to the new height values of the region (row after row with the
+ *                same data type as the height field)
+ */
+void HeightFieldShape::updateHeights(int firstColumn, int firstRow, int nbRegionColumns,
+                                     int nbRegionRows, const void* heights) {
+
+    assert(firstColumn >= 0 && nbRegionColumns > 0 && firstColumn + nbRegionColumns <= mNbColumns);
+    assert(firstRow >= 0 && nbRegionRows > 0 && firstRow + nbRegionRows <= mNbRows);
+
+    // Size in bytes of a height value
+    const size_t heightSize = getHeightValueSize();
+
+    // Copy the new height values row after row
+    unsigned char* heightFieldData = (unsigned char*) const_cast<void*>(mHeightFieldData);
+    const unsigned char* newHeights = (const unsigned char*) heights;
+    for (int j=0; j<nbRegionRows; j++) {
+        memcpy(heightFieldData + ((firstRow + j) * mNbColumns + firstColumn) * heightSize,
+               newHeights + j * nbRegionColumns * heightSize, nbRegionColumns * heightSize);
+    }
+
+    // Update the height pyramid over the cells that use the modified grid points
+    updateHeightPyramid(clamp(firstColumn - 1, 0, mNbColumns - 2), clamp(firstRow - 1, 0, mNbRows - 2),
+                        clamp(firstColumn + nbRegionColumns - 1, 0, mNbColumns - 2),
+                        clamp(firstRow + nbRegionRows - 1, 0, mNbRows - 2));
+
+    // Update the height range of the local AABB with the top block of the pyramid
+    decimal minHeight;
+    decimal maxHeight;
+    computeBlockHeightRange(getNbPyramidLevels() - 1, 0, 0, minHeight, maxHeight);
+    const decimal halfHeight = (mMaxHeight - mMinHeight) * decimal(0.5);
+    Vector3 aabbMin = mAABB.getMin();
+    Vector3 aabbMax = mAABB.getMax();
+    aabbMin[mUpAxis] = std::min(-halfHeight, minHeight);
+    aabbMax[mUpAxis] = std::max(halfHeight, maxHeight);
+    mAABB.setMin(aabbMin);
+    mAABB.setMax(aabbMax);
+
+    // The triangles of the height field have changed
+    notifyGeometryChanged();
+}
+
+// Return the local AABB of the triangles that use the grid points of a region
+/**
+ * @param firstColumn Column of the first grid point of the region
+ * @param firstRow Row of the first grid point of the region
+ * @param nbRegionColumns Number of columns of the region
+ * @param nbRegionRows Number of rows of the region
+ * @return The AABB (in local-space with scaling) of the cells around the region
+ */
+AABB HeightFieldShape::computeRegionAABB(int firstColumn, int firstRow, int nbRegionColumns,
+                                         int nbRegionRows) const {
+
+    // Grid points of the cells that use the grid points of the region
+    const int iMin = std::max(firstColumn - 1, 0);
+    const int jMin = std::max(firstRow - 1, 0);
+    const int iMax = std::min(firstColumn + nbRegionColumns, mNbColumns - 1);
+    const int jMax = std::min(firstRow + nbRegionRows, mNbRows - 1);
+
+    Vector3 minPoint(DECIMAL_LARGEST, DECIMAL_LARGEST, DECIMAL_LARGEST);
+    Vector3 maxPoint(DECIMAL_SMALLEST, DECIMAL_SMALLEST, DECIMAL_SMALLEST);
+    for (int j=jMin; j<=jMax; j++) {
+        for (int i=iMin; i<=iMax; i++) {
+            const Vector3 vertex = getVertexAt(i, j);
+            minPoint = Vector3::min(minPoint, vertex);
+            maxPoint = Vector3::max(maxPoint, vertex);
+        }
+    }
+
+    return AABB(minPoint, maxPoint);
 }
 
 // Compute the min/max grid coords corresponding to the intersection of the AABB of the height field and
@@ -192,33 +562,193 @@ void HeightFieldShape::computeMinMaxGridCoordinates(int* minCoords, int* maxCoor
 
 // Raycast method with feedback information
 /// Note that only the first triangle hit by the ray in the mesh will be returned, even if
-/// the ray hits many triangles.
+/// the ray hits many triangles. The ray is first clipped against the AABB of the height
+/// field. Then, the cells of the grid crossed by the ray are visited in order along the ray
+/// (2D digital differential analyzer). The triangles of a cell are only tested if the height
+/// range of the ray inside the cell overlaps the height range of the cell and the walk stops
+/// at the first cell where a triangle is hit. The ray also jumps over the whole blocks of
+/// the height pyramid that it cannot hit. The walk is done in the unscaled local-space
+/// of the height field where the fractions along the ray are the same.
 bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape) const {
 
-    // TODO : Implement raycasting without using an AABB for the ray
-    //        but using a dynamic AABB tree or octree instead
-
     PROFILE("HeightFieldShape::raycast()");
 
+    switch(mHeightDataType) {
+        case HEIGHT_FLOAT_TYPE : return raycastGrid<float>(ray, raycastInfo, proxyShape);
+        case HEIGHT_DOUBLE_TYPE : return raycastGrid<double>(ray, raycastInfo, proxyShape);
+        case HEIGHT_INT_TYPE : return raycastGrid<int>(ray, raycastInfo, proxyShape);
+        case HEIGHT_UINT8_TYPE : return raycastGrid<uint8>(ray, raycastInfo, proxyShape);
+        case HEIGHT_UINT16_TYPE : return raycastGrid<uint16>(ray, raycastInfo, proxyShape);
+        default: assert(false); return false;
+    }
+}
+
+// Raycast method for a given type of height values (see HeightFieldShape::raycast())
+template<typename HeightType>
+bool HeightFieldShape::raycastGrid(const Ray& ray, RaycastInfo& raycastInfo,
+                                   ProxyShape* proxyShape) const {
+
+    const decimal epsilon = decimal(0.0001);
+
     TriangleOverlapCallback triangleCallback(ray, proxyShape, raycastInfo, *this);
 
-    // Compute the AABB for the ray
-    const Vector3 rayEnd = ray.point1 + ray.maxFraction * (ray.point2 - ray.point1);
-    const AABB rayAABB(Vector3::min(ray.point1, rayEnd), Vector3::max(ray.point1, rayEnd));
+    // Convert the ray into the unscaled local-space of the height field
+    const Vector3 point1 = ray.point1 / mScaling;
+    const Vector3 rayDirection = ray.point2 / mScaling - point1;
+
+    // Clip the ray against the AABB of the height field
+    decimal tMin = decimal(0.0);
+    decimal tMax = ray.maxFraction;
+    for (int i=0; i<3; i++) {
+
+        const decimal minCoordinate = mAABB.getMin()[i] - epsilon;
+        const decimal maxCoordinate = mAABB.getMax()[i] + epsilon;
+
+        // If ray is parallel to the slab
+        if (std::abs(rayDirection[i]) < MACHINE_EPSILON) {
+
+            // If the ray's origin is not inside the slab, there is no hit
+            if (point1[i] < minCoordinate || point1[i] > maxCoordinate) return false;
+        }
+        else {
 
-    testAllTriangles(triangleCallback, rayAABB);
+            const decimal oneOverD = decimal(1.0) / rayDirection[i];
+            decimal t1 = (minCoordinate - point1[i]) * oneOverD;
+            decimal t2 = (maxCoordinate - point1[i]) * oneOverD;
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+
+            // If the slabs intersection is empty, there is no hit
+            if (tMin > tMax) return false;
+        }
+    }
+
+    // Axis of the columns and rows of the grid according to the up axis
+    const int columnAxis = mUpAxis == 0 ? 1 : 0;
+    const int rowAxis = mUpAxis == 2 ? 1 : 2;
+
+    // Origin and direction of the ray in grid coordinates (the grid points are at
+    // integer coordinates between 0 and mWidth along the columns axis and between
+    // 0 and mLength along the rows axis)
+    const decimal originU = point1[columnAxis] + mWidth * decimal(0.5);
+    const decimal originV = point1[rowAxis] + mLength * decimal(0.5);
+    const decimal directionU = rayDirection[columnAxis];
+    const decimal directionV = rayDirection[rowAxis];
+
+    // Cell that contains the entry point of the ray
+    int i = clamp(int(std::floor(originU + tMin * directionU)), 0, mNbColumns - 2);
+    int j = clamp(int(std::floor(originV + tMin * directionV)), 0, mNbRows - 2);
+
+    const bool isParallelToColumns = std::abs(directionU) < MACHINE_EPSILON;
+    const bool isParallelToRows = std::abs(directionV) < MACHINE_EPSILON;
+    const int nbLevels = getNbPyramidLevels();
+
+    // Walk through the cells of the grid crossed by the ray
+    decimal tCellStart = tMin;
+    while (true) {
+
+        // Find the coarsest block of the height pyramid that contains the current cell
+        // and that cannot be hit by the ray. In this case, the ray directly jumps to the
+        // exit of the block. Otherwise, the block is the current cell itself.
+        bool isBlockSkipped = false;
+        int blockIMin = i;
+        int blockIMax = i + 1;
+        int blockJMin = j;
+        int blockJMax = j + 1;
+        decimal tExitU = DECIMAL_LARGEST;
+        decimal tExitV = DECIMAL_LARGEST;
+        decimal tBlockEnd = tMax;
+        for (int level = nbLevels - 1; level >= 0; level--) {
+
+            // Range of cells of the block (maximum excluded)
+            blockIMin = (i >> level) << level;
+            blockJMin = (j >> level) << level;
+            blockIMax = std::min(blockIMin + (1 << level), mNbColumns - 1);
+            blockJMax = std::min(blockJMin + (1 << level), mNbRows - 1);
+
+            // Fractions where the ray exits the block through a column or a row boundary
+            tExitU = isParallelToColumns ? DECIMAL_LARGEST :
+                     (decimal(directionU > decimal(0.0) ? blockIMax : blockIMin) - originU) / directionU;
+            tExitV = isParallelToRows ? DECIMAL_LARGEST :
+                     (decimal(directionV > decimal(0.0) ? blockJMax : blockJMin) - originV) / directionV;
+            tBlockEnd = std::min(std::min(tExitU, tExitV), tMax);
+
+            // Height range of the ray inside the block (from the current cell)
+            const decimal rayHeight1 = point1[mUpAxis] + tCellStart * rayDirection[mUpAxis];
+            const decimal rayHeight2 = point1[mUpAxis] + tBlockEnd * rayDirection[mUpAxis];
+
+            // If the ray cannot hit the triangles of the block
+            decimal blockMinHeight;
+            decimal blockMaxHeight;
+            computeBlockHeightRange<HeightType>(level, i >> level, j >> level, blockMinHeight,
+                                                blockMaxHeight);
+            if (std::min(rayHeight1, rayHeight2) > blockMaxHeight + epsilon ||
+                std::max(rayHeight1, rayHeight2) < blockMinHeight - epsilon) {
+                isBlockSkipped = true;
+                break;
+            }
+        }
+
+        // If the ray can hit the triangles of the current cell
+        if (!isBlockSkipped) {
+
+            testCellTriangles<HeightType>(i, j, triangleCallback);
+
+            // The hit in the current cell is the first one along the ray
+            if (triangleCallback.getIsHit()) break;
+        }
+
+        // If we have reached the end of the ray
+        if (tBlockEnd >= tMax) break;
+
+        // Move to the cell where the ray enters after leaving the block
+        if (tExitU <= tExitV) {
+            i = directionU > decimal(0.0) ? blockIMax : blockIMin - 1;
+        }
+        else {
+            const int cellI = int(std::floor(originU + tBlockEnd * directionU));
+            i = clamp(cellI, blockIMin, blockIMax - 1);
+        }
+        if (tExitV <= tExitU) {
+            j = directionV > decimal(0.0) ? blockJMax : blockJMin - 1;
+        }
+        else {
+            const int cellJ = int(std::floor(originV + tBlockEnd * directionV));
+            j = clamp(cellJ, blockJMin, blockJMax - 1);
+        }
+
+        // If the ray leaves the grid
+        if (i < 0 || i > mNbColumns - 2 || j < 0 || j > mNbRows - 2) break;
+
+        tCellStart = std::max(tCellStart, tBlockEnd);
+    }
 
     return triangleCallback.getIsHit();
 }
 
 // Return the vertex (local-coordinates) of the height field at a given (x,y) position
+Vector3 HeightFieldShape::getVertexAt(int x, int y) const {
+
+    switch(mHeightDataType) {
+        case HEIGHT_FLOAT_TYPE : return getVertexAt<float>(x, y);
+        case HEIGHT_DOUBLE_TYPE : return getVertexAt<double>(x, y);
+        case HEIGHT_INT_TYPE : return getVertexAt<int>(x, y);
+        case HEIGHT_UINT8_TYPE : return getVertexAt<uint8>(x, y);
+        case HEIGHT_UINT16_TYPE : return getVertexAt<uint16>(x, y);
+        default: assert(false); return Vector3::zero();
+    }
+}
+
+// Return the vertex (local-coordinates) at a given (x,y) position for a given type of height values
+template<typename HeightType>
 Vector3 HeightFieldShape::getVertexAt(int x, int y) const {
 
     // Get the height value
-    const decimal height = getHeightAt(x, y);
+    const decimal height = getHeightAt<HeightType>(x, y);
 
     // Height values origin
-    const decimal heightOrigin = -(mMaxHeight - mMinHeight) * decimal(0.5) - mMinHeight;
+    const decimal heightOrigin = getHeightOrigin();
 
     Vector3 vertex;
     switch (mUpAxis) {
@@ -30,6 +30,7 @@
 #include "ConcaveShape.h"
 #include "collision/shapes/TriangleShape.h"
 #include "engine/Profiler.h"
+#include <vector>
 
 namespace reactphysics3d {
 
@@ -73,18 +74,25 @@ class TriangleOverlapCallback : public TriangleCallback {
  * This class represents a static height field that can be used to represent
  * a terrain. The height field is made of a grid with rows and columns with a
  * height value at each grid point. Note that the height values are not copied into the shape
- * but are shared instead. The height values can be of type integer, float or double.
+ * but are shared instead. The height values can be of type integer, float or double. To save
+ * memory, they can also be quantized on 8 or 16 bits unsigned integers. In this case, the height
+ * of a grid point is computed with the scale and offset of the height field
+ * (height = value * integerHeightScale + integerHeightOffset).
  * When creating a HeightFieldShape, you need to specify the minimum and maximum height value of
  * your height field. Note that the HeightFieldShape will be re-centered based on its AABB. It means
  * that for instance, if the minimum height value is -200 and the maximum value is 400, the final
  * minimum height of the field in the simulation will be -300 and the maximum height will be 300.
+ * The height values of a region of the grid can be modified at runtime with the
+ * CollisionWorld::updateHeightFieldHeights() method. In this case, the height values
+ * array must be writable.
  */
 class HeightFieldShape : public ConcaveShape {
 
     public:
 
         /// Data type for the height data of the height field
-        enum HeightDataType {HEIGHT_FLOAT_TYPE, HEIGHT_DOUBLE_TYPE, HEIGHT_INT_TYPE};
+        enum HeightDataType {HEIGHT_FLOAT_TYPE, HEIGHT_DOUBLE_TYPE, HEIGHT_INT_TYPE,
+                             HEIGHT_UINT8_TYPE, HEIGHT_UINT16_TYPE};
 
     protected:
 
@@ -114,6 +122,9 @@ class HeightFieldShape : public ConcaveShape {
         /// Height values scale for height field with integer height values
         decimal mIntegerHeightScale;
 
+        /// Height values offset for height field with integer height values
+        decimal mIntegerHeightOffset;
+
         /// Data type of the height values
         HeightDataType mHeightDataType;
 
@@ -123,6 +134,15 @@ class HeightFieldShape : public ConcaveShape {
         /// Local AABB of the height field (without scaling)
         AABB mAABB;
 
+        /// Minimum and maximum height values (pairs stored with the type of the height data)
+        /// of the blocks of cells of the height pyramid. The level k of the pyramid contains
+        /// the blocks of 2^k x 2^k cells of the grid. Only the levels k >= 1 are stored
+        /// because the height range of a single cell is computed from its four vertices.
+        void* mPyramidHeightValues;
+
+        /// Index of the first block of each level (starting at level 1) in the pyramid arrays
+        std::vector<int> mPyramidLevelOffsets;
+
         // -------------------- Methods -------------------- //
 
         /// Private copy-constructor
@@ -145,15 +165,86 @@ class HeightFieldShape : public ConcaveShape {
         void getTriangleVerticesWithIndexPointer(int32 subPart, int32 triangleIndex,
                                                  Vector3* outTriangleVertices) const;
 
+        /// Raycast method for a given type of height values
+        template<typename HeightType>
+        bool raycastGrid(const Ray& ray, RaycastInfo& raycastInfo, ProxyShape* proxyShape) const;
+
         /// Return the vertex (local-coordinates) of the height field at a given (x,y) position
         Vector3 getVertexAt(int x, int y) const;
 
+        /// Return the vertex (local-coordinates) at a given (x,y) position for a given type of height values
+        template<typename HeightType>
+        Vector3 getVertexAt(int x, int y) const;
+
         /// Return the height of a given (x,y) point in the height field
         decimal getHeightAt(int x, int y) const;
 
+        /// Return the height of a given (x,y) point for a given type of height values
+        template<typename HeightType>
+        decimal getHeightAt(int x, int y) const;
+
+        /// Convert a height value of the height data into a height
+        template<typename HeightType>
+        decimal convertHeightValue(HeightType value) const;
+
         /// Return the closest inside integer grid value of a given floating grid value
         int computeIntegerGridValue(decimal value) const;
 
+        /// Use a callback method on the two triangles of a given cell of the grid
+        template<typename HeightType>
+        void testCellTriangles(int i, int j, TriangleCallback& callback) const;
+
+        /// Use a callback method on the triangles of a block of the height pyramid that
+        /// are inside a given range of cells and can overlap a given height range
+        template<typename HeightType>
+        void testBlockTriangles(TriangleCallback& callback, int level, int blockI, int blockJ,
+                                int iMin, int iMax, int jMin, int jMax,
+                                decimal minHeight, decimal maxHeight) const;
+
+        /// Return the height of the local origin in the height values space
+        decimal getHeightOrigin() const;
+
+        /// Return the size in bytes of a height value of the height data
+        size_t getHeightValueSize() const;
+
+        /// Return the number of levels of the height pyramid (including the cells level)
+        int getNbPyramidLevels() const;
+
+        /// Return the index of a block of a level (k >= 1) in the height pyramid
+        int getPyramidIndex(int level, int blockI, int blockJ) const;
+
+        /// Compute the minimum and maximum heights (without scaling) of a block of the pyramid
+        void computeBlockHeightRange(int level, int blockI, int blockJ,
+                                     decimal& minHeight, decimal& maxHeight) const;
+
+        /// Compute the height range of a block of the pyramid for a given type of height values
+        template<typename HeightType>
+        void computeBlockHeightRange(int level, int blockI, int blockJ,
+                                     decimal& minHeight, decimal& maxHeight) const;
+
+        /// Compute the minimum and maximum height values of a block of the pyramid
+        template<typename HeightType>
+        void computeBlockValueRange(int level, int blockI, int blockJ,
+                                    HeightType& minValue, HeightType& maxValue) const;
+
+        /// Allocate the height pyramid and compute the height ranges of all its blocks
+        void initHeightPyramid();
+
+        /// Recompute the height ranges of the blocks of the pyramid over a range of cells
+        void updateHeightPyramid(int iMin, int jMin, int iMax, int jMax);
+
+        /// Recompute the blocks of the pyramid over a range of cells for a given type of height values
+        template<typename HeightType>
+        void updateHeightPyramid(int iMin, int jMin, int iMax, int jMax);
+
+        /// Copy new height values into a region of the grid and update the shape accordingly
+        void updateHeights(int firstColumn, int firstRow, int nbRegionColumns, int nbRegionRows,
+                           const void* heights);
+
+        /// Return the local AABB of the triangles that use the grid points of a region
+        AABB computeRegionAABB(int firstColumn, int firstRow, int nbRegionColumns,
+                               int nbRegionRows) const;
+
         /// Compute the min/max grid coords corresponding to the intersection of the AABB of the height field and the AABB to collide
         void computeMinMaxGridCoordinates(int* minCoords, int* maxCoords, const AABB& aabbToCollide) const;
 
@@ -162,7 +253,8 @@ class HeightFieldShape : public ConcaveShape {
         /// Constructor
         HeightFieldShape(int nbGridColumns, int nbGridRows, decimal minHeight, decimal maxHeight,
                          const void* heightFieldData, HeightDataType dataType,
-                         int upAxis = 1, decimal integerHeightScale = 1.0f);
+                         int upAxis = 1, decimal integerHeightScale = 1.0f,
+                         decimal integerHeightOffset = 0.0f);
 
         /// Destructor
         ~HeightFieldShape();
@@ -192,6 +284,7 @@ class HeightFieldShape : public ConcaveShape {
 
         friend class ConvexTriangleAABBOverlapCallback;
         friend class ConcaveMeshRaycastCallback;
+        friend class CollisionWorld;
 };
 
 // Return the number of rows in the height field
@@ -217,19 +310,78 @@ inline size_t HeightFieldShape::getSizeInBytes() const {
 // Set the local scaling vector of the collision shape
 inline void HeightFieldShape::setLocalScaling(const Vector3& scaling) {
     CollisionShape::setLocalScaling(scaling);
+    notifyGeometryChanged();
+}
+
+// Convert a height value of the height data into a height
+/// The integer height values are converted with the scale and offset of the height field.
+template<typename HeightType>
+inline decimal HeightFieldShape::convertHeightValue(HeightType value) const {
+    return decimal(value) * mIntegerHeightScale + mIntegerHeightOffset;
+}
+
+// Convert a float height value into a height
+template<>
+inline decimal HeightFieldShape::convertHeightValue<float>(float value) const {
+    return value;
+}
+
+// Convert a double height value into a height
+template<>
+inline decimal HeightFieldShape::convertHeightValue<double>(double value) const {
+    return value;
+}
+
+// Return the height of a given (x,y) point for a given type of height values
+template<typename HeightType>
+inline decimal HeightFieldShape::getHeightAt(int x, int y) const {
+    return convertHeightValue<HeightType>(static_cast<const HeightType*>(mHeightFieldData)[y * mNbColumns + x]);
 }
 
 // Return the height of a given (x,y) point in the height field
 inline decimal HeightFieldShape::getHeightAt(int x, int y) const {
 
     switch(mHeightDataType) {
-        case HEIGHT_FLOAT_TYPE : return ((float*)mHeightFieldData)[y * mNbColumns + x];
-        case HEIGHT_DOUBLE_TYPE : return ((double*)mHeightFieldData)[y * mNbColumns + x];
-        case HEIGHT_INT_TYPE : return ((int*)mHeightFieldData)[y * mNbColumns + x] * mIntegerHeightScale;
+        case HEIGHT_FLOAT_TYPE : return getHeightAt<float>(x, y);
+        case HEIGHT_DOUBLE_TYPE : return getHeightAt<double>(x, y);
+        case HEIGHT_INT_TYPE : return getHeightAt<int>(x, y);
+        case HEIGHT_UINT8_TYPE : return getHeightAt<uint8>(x, y);
+        case HEIGHT_UINT16_TYPE : return getHeightAt<uint16>(x, y);
+        default: assert(false); return 0;
+    }
+}
+
+// Return the height of the local origin in the height values space
+inline decimal HeightFieldShape::getHeightOrigin() const {
+    return -(mMaxHeight - mMinHeight) * decimal(0.5) - mMinHeight;
+}
+
+// Return the size in bytes of a height value of the height data
+inline size_t HeightFieldShape::getHeightValueSize() const {
+
+    switch(mHeightDataType) {
+        case HEIGHT_FLOAT_TYPE : return sizeof(float);
+        case HEIGHT_DOUBLE_TYPE : return sizeof(double);
+        case HEIGHT_INT_TYPE : return sizeof(int);
+        case HEIGHT_UINT8_TYPE : return sizeof(uint8);
+        case HEIGHT_UINT16_TYPE : return sizeof(uint16);
         default: assert(false); return 0;
     }
 }
 
+// Return the number of levels of the height pyramid (including the cells level)
+inline int HeightFieldShape::getNbPyramidLevels() const {
+    return static_cast<int>(mPyramidLevelOffsets.size()) + 1;
+}
+
+// Return the index of a block of a level (k >= 1) in the height pyramid
+/// The level k has ((n - 1) >> k) + 1 blocks along a grid axis with n cells.
+inline int HeightFieldShape::getPyramidIndex(int level, int blockI, int blockJ) const {
+    assert(level >= 1 && level < getNbPyramidLevels());
+    const int nbBlocksI = ((mNbColumns - 2) >> level) + 1;
+    return mPyramidLevelOffsets[level - 1] + blockJ * nbBlocksI + blockI;
+}
+
 // Return the closest inside integer grid value of a given floating grid value
 inline int HeightFieldShape::computeIntegerGridValue(decimal value) const {
     return (value < decimal(0.0)) ? value - decimal(0.5) : value + decimal(0.5);
@@ -51,6 +51,7 @@ typedef long unsigned int luint;
 typedef luint bodyindex;
 typedef std::pair<bodyindex, bodyindex> bodyindexpair;
 
+typedef unsigned char uint8;
 typedef signed short int16;
 typedef signed int int32;
 typedef unsigned short uint16;
@@ -144,6 +145,24 @@ const int NB_MAX_CONTACT_MANIFOLDS_CONVEX_SHAPE = 1;
 /// least one concave collision shape.
 const int NB_MAX_CONTACT_MANIFOLDS_CONCAVE_SHAPE = 3;
 
+/// In the narrow-phase collision detection between a convex and a concave shape, the
+/// triangles of the concave shape are queried with the AABB of the convex shape inflated
+/// with this gap. The triangles are cached and the query is only performed again when
+/// the AABB of the convex shape is not inside the inflated AABB anymore.
+const decimal CONCAVE_TRIANGLES_CACHE_AABB_GAP = decimal(0.2);
+
+/// Initial capacity of the scratch arrays used by the smooth mesh collision
+/// algorithm (number of triangle contacts between a convex and a concave shape)
+const uint NB_INITIAL_SMOOTH_MESH_CONTACTS = 64;
+
+/// Maximum number of rays that are traversed together through the dynamic AABB
+/// tree during a batch raycast (must not exceed the number of bits of a uint32)
+const uint RAYCAST_PACKET_SIZE = 32;
+
+/// Maximum number of rays that are sorted together into packets during a batch raycast
+/// (the rays of a batch are processed in blocks of this size without heap allocation)
+const uint RAYCAST_BATCH_BLOCK_SIZE = 8 * RAYCAST_PACKET_SIZE;
+
 }
 
 #endif
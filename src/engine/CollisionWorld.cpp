@@ -25,7 +25,10 @@
 
 // Libraries
 #include "CollisionWorld.h"
+#include "collision/shapes/HeightFieldShape.h"
+#include "collision/shapes/ConcaveMeshShape.h"
 #include <algorithm>
+#include <thread>
 
 // Namespaces
 using namespace reactphysics3d;
@@ -34,7 +37,7 @@ using namespace std;
 // Constructor
 CollisionWorld::CollisionWorld()
                : mCollisionDetection(this, mMemoryAllocator), mCurrentBodyID(0),
-                 mEventListener(NULL) {
+                 mEventListener(NULL), mIsInReadOnlyQueryMode(false) {
 
 }
 
@@ -59,6 +62,8 @@ CollisionWorld::~CollisionWorld() {
  */
 CollisionBody* CollisionWorld::createCollisionBody(const Transform& transform) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Get the next available body ID
     bodyindex bodyID = computeNextAvailableBodyID();
 
@@ -84,6 +89,8 @@ CollisionBody* CollisionWorld::createCollisionBody(const Transform& transform) {
  */
 void CollisionWorld::destroyCollisionBody(CollisionBody* collisionBody) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Remove all the collision shapes of the body
     collisionBody->removeAllCollisionShapes();
 
@@ -100,6 +107,94 @@ void CollisionWorld::destroyCollisionBody(CollisionBody* collisionBody) {
     mMemoryAllocator.release(collisionBody, sizeof(CollisionBody));
 }
 
+// Update the height values of a region of the grid of a height field proxy shape
+/// The new height values are copied into the height data array of the height field
+/// (which must be writable) and the shape only updates the parts of its data that depend
+/// on this region. Then, the AABB of the proxy shape is refitted in the broad-phase and the
+/// bodies overlapping with the modified area (old and new heights) are woken up. The
+/// overlapping pairs and the contacts with the height field are kept. Note that if the
+/// height field shape is shared, the other proxy shapes using it are not refitted.
+/**
+ * @param proxyShape Proxy shape of the height field
+ * @param firstColumn Column of the first grid point of the region
+ * @param firstRow Row of the first grid point of the region
+ * @param nbRegionColumns Number of columns of the region
+ * @param nbRegionRows Number of rows of the region
+ * @param heights Pointer to the new height values of the region (row after row with the
+ *                same data type as the height field)
+ */
+void CollisionWorld::updateHeightFieldHeights(ProxyShape* proxyShape, int firstColumn, int firstRow,
+                                              int nbRegionColumns, int nbRegionRows,
+                                              const void* heights) {
+
+    assert(!mIsInReadOnlyQueryMode);
+    assert(proxyShape->getCollisionShape()->getType() == HEIGHTFIELD);
+
+    HeightFieldShape* heightFieldShape = static_cast<HeightFieldShape*>(proxyShape->mCollisionShape);
+
+    // Compute the local AABB of the modified area with the old and the new heights
+    AABB regionAABB = heightFieldShape->computeRegionAABB(firstColumn, firstRow,
+                                                          nbRegionColumns, nbRegionRows);
+    heightFieldShape->updateHeights(firstColumn, firstRow, nbRegionColumns, nbRegionRows, heights);
+    regionAABB.mergeWithAABB(heightFieldShape->computeRegionAABB(firstColumn, firstRow,
+                                                                 nbRegionColumns, nbRegionRows));
+
+    // If the body is not active, its proxy shapes are not in the broad-phase
+    if (!proxyShape->getBody()->isActive()) return;
+
+    // Refit the AABB of the proxy shape in the broad-phase
+    proxyShape->mBody->updateProxyShapeInBroadPhase(proxyShape, true);
+
+    // Compute the world-space AABB of the modified area
+    const Transform localToWorldTransform = proxyShape->getLocalToWorldTransform();
+    const Matrix3x3 worldAxis = localToWorldTransform.getOrientation().getMatrix().getAbsoluteMatrix();
+    const Vector3 center = localToWorldTransform * regionAABB.getCenter();
+    const Vector3 halfExtent = worldAxis * (decimal(0.5) * regionAABB.getExtent());
+    const AABB worldRegionAABB(center - halfExtent, center + halfExtent);
+
+    // Wake up the bodies in the modified area
+    mCollisionDetection.wakeUpBodiesOverlappingAABB(worldRegionAABB, proxyShape->getBody());
+}
+
+// Update a concave mesh proxy shape after the vertices of its triangle mesh have changed
+/// The Dynamic AABB tree of the concave mesh shape is refitted (see ConcaveMeshShape::refit()).
+/// Then, the AABB of the proxy shape is refitted in the broad-phase and the bodies overlapping
+/// with the old or the new AABB of the proxy shape are woken up. Note that if the concave mesh
+/// shape is shared, the other proxy shapes using it are not refitted.
+/**
+ * @param proxyShape Proxy shape of the concave mesh
+ * @param rebuildCostRatio Maximum ratio between the cost of the refitted tree and the
+ *                         cost of the tree when it was built (never rebuilt by default)
+ * @return True if the tree of the concave mesh shape has been rebuilt
+ */
+bool CollisionWorld::refitConcaveMeshShape(ProxyShape* proxyShape, decimal rebuildCostRatio) {
+
+    assert(!mIsInReadOnlyQueryMode);
+    assert(proxyShape->getCollisionShape()->getType() == CONCAVE_MESH);
+
+    ConcaveMeshShape* concaveMeshShape = static_cast<ConcaveMeshShape*>(proxyShape->mCollisionShape);
+    const Transform localToWorldTransform = proxyShape->getLocalToWorldTransform();
+
+    // Refit the shape and compute the world-space AABB of the old and new triangles
+    AABB worldAABB;
+    concaveMeshShape->computeAABB(worldAABB, localToWorldTransform);
+    const bool isRebuilt = concaveMeshShape->refit(rebuildCostRatio);
+    AABB newWorldAABB;
+    concaveMeshShape->computeAABB(newWorldAABB, localToWorldTransform);
+    worldAABB.mergeWithAABB(newWorldAABB);
+
+    // If the body is not active, its proxy shapes are not in the broad-phase
+    if (!proxyShape->getBody()->isActive()) return isRebuilt;
+
+    // Refit the AABB of the proxy shape in the broad-phase
+    proxyShape->mBody->updateProxyShapeInBroadPhase(proxyShape, true);
+
+    // Wake up the bodies around the mesh
+    mCollisionDetection.wakeUpBodiesOverlappingAABB(worldAABB, proxyShape->getBody());
+
+    return isRebuilt;
+}
+
 // Return the next available body ID
 bodyindex CollisionWorld::computeNextAvailableBodyID() {
 
@@ -148,6 +243,56 @@ bool CollisionWorld::testAABBOverlap(const CollisionBody* body1,
     return body1AABB.testCollision(body2AABB);
 }
 
+// Ray cast a batch of rays using several threads and report the closest hit of each ray
+/// The batch is split into contiguous ranges of rays that are traversed in parallel
+/// (the calling thread processes the first range). Ray casting only reads the world,
+/// so the world must not be modified by another thread during this call.
+/// The library does not own a thread pool. Therefore, each call creates and joins
+/// (nbThreads - 1) threads. This cost (in the order of tens of microseconds per thread)
+/// is only amortized for large batches. For small batches, use raycastBatch() instead.
+/**
+ * @param rays Array with the rays to cast
+ * @param nbRays Number of rays in the array
+ * @param hits Array of (at least) nbRays elements where the closest hit of each ray
+ *             is written (hits[i].hasHit is false if the ray i did not hit anything)
+ * @param nbThreads Number of threads to use (including the calling thread, at least one)
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ */
+void CollisionWorld::raycastBatchParallel(const Ray* rays, uint nbRays, RaycastBatchHit* hits,
+                                          uint nbThreads,
+                                          unsigned short raycastWithCategoryMaskBits) const {
+
+    assert(nbThreads >= 1);
+
+    // Use ranges of whole ray packets so that no packet is split between two threads
+    const uint nbPackets = (nbRays + RAYCAST_PACKET_SIZE - 1) / RAYCAST_PACKET_SIZE;
+    nbThreads = std::min(nbThreads, nbPackets);
+    if (nbThreads <= 1) {
+        mCollisionDetection.raycastBatch(rays, nbRays, hits, raycastWithCategoryMaskBits);
+        return;
+    }
+    const uint nbRaysPerThread = ((nbPackets + nbThreads - 1) / nbThreads) * RAYCAST_PACKET_SIZE;
+
+    // Start the worker threads for all the ranges except the first one
+    std::vector<std::thread> threads;
+    threads.reserve(nbThreads - 1);
+    for (uint start = nbRaysPerThread; start < nbRays; start += nbRaysPerThread) {
+        const uint nbRangeRays = std::min(nbRaysPerThread, nbRays - start);
+        threads.push_back(std::thread(&CollisionDetection::raycastBatch, &mCollisionDetection,
+                                      rays + start, nbRangeRays, hits + start,
+                                      raycastWithCategoryMaskBits));
+    }
+
+    // The calling thread processes the first range
+    mCollisionDetection.raycastBatch(rays, std::min(nbRaysPerThread, nbRays), hits,
+                                     raycastWithCategoryMaskBits);
+
+    for (uint i=0; i<threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
 // Test and report collisions between a given shape and all the others
 // shapes of the world.
 /**
@@ -157,6 +302,8 @@ bool CollisionWorld::testAABBOverlap(const CollisionBody* body1,
 void CollisionWorld::testCollision(const ProxyShape* shape,
                                    CollisionCallback* callback) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Reset all the contact manifolds lists of each body
     resetContactManifoldListsOfBodies();
 
@@ -179,6 +326,8 @@ void CollisionWorld::testCollision(const ProxyShape* shape1,
                                    const ProxyShape* shape2,
                                    CollisionCallback* callback) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Reset all the contact manifolds lists of each body
     resetContactManifoldListsOfBodies();
 
@@ -201,6 +350,8 @@ void CollisionWorld::testCollision(const ProxyShape* shape1,
 void CollisionWorld::testCollision(const CollisionBody* body,
                                    CollisionCallback* callback) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Reset all the contact manifolds lists of each body
     resetContactManifoldListsOfBodies();
 
@@ -229,6 +380,8 @@ void CollisionWorld::testCollision(const CollisionBody* body1,
                                    const CollisionBody* body2,
                                    CollisionCallback* callback) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Reset all the contact manifolds lists of each body
     resetContactManifoldListsOfBodies();
 
@@ -249,12 +402,129 @@ void CollisionWorld::testCollision(const CollisionBody* body1,
     mCollisionDetection.testCollisionBetweenShapes(callback, shapes1, shapes2);
 }
 
+// Compute the distance and the closest points between two bodies
+/// The distance between two bodies is the smallest distance between their proxy shapes.
+/// The pairs of concave proxy shapes are ignored.
+/**
+ * @param body1 Pointer to the first body
+ * @param body2 Pointer to the second body
+ * @param distanceInfo Output information about the closest pair of proxy shapes
+ * @return True if the distance between at least one pair of proxy shapes has been computed
+ */
+bool CollisionWorld::computeDistance(const CollisionBody* body1, const CollisionBody* body2,
+                                     DistanceInfo& distanceInfo) const {
+
+    bool isComputed = false;
+
+    for (const ProxyShape* shape1=body1->getProxyShapesList(); shape1 != NULL;
+         shape1 = shape1->getNext()) {
+        for (const ProxyShape* shape2=body2->getProxyShapesList(); shape2 != NULL;
+             shape2 = shape2->getNext()) {
+
+            DistanceInfo shapesDistanceInfo;
+            if (mCollisionDetection.computeDistance(shape1, shape2, shapesDistanceInfo) &&
+                (!isComputed || shapesDistanceInfo.distance < distanceInfo.distance)) {
+                isComputed = true;
+                distanceInfo.distance = shapesDistanceInfo.distance;
+                distanceInfo.worldPoint1 = shapesDistanceInfo.worldPoint1;
+                distanceInfo.worldPoint2 = shapesDistanceInfo.worldPoint2;
+                distanceInfo.proxyShape1 = shapesDistanceInfo.proxyShape1;
+                distanceInfo.proxyShape2 = shapesDistanceInfo.proxyShape2;
+
+                if (distanceInfo.distance == decimal(0.0)) return true;
+            }
+        }
+    }
+
+    return isComputed;
+}
+
+// Find the nearest proxy shape of another body to a body within a maximum distance
+/// The query is done with each convex proxy shape of the body. The proxy shapes of the
+/// body itself are ignored.
+/**
+ * @param body Pointer to the body of the query
+ * @param maxDistance Maximum distance between the body and the reported proxy shape
+ * @param distanceInfo Output information about the nearest proxy shape (proxyShape2)
+ *                     and the proxy shape of the body closest to it (proxyShape1)
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to consider
+ * @return True if a proxy shape has been found within the maximum distance
+ */
+bool CollisionWorld::computeNearestProxyShape(const CollisionBody* body, decimal maxDistance,
+                                              DistanceInfo& distanceInfo,
+                                              unsigned short categoryMaskBits) const {
+
+    bool isFound = false;
+
+    for (const ProxyShape* shape=body->getProxyShapesList(); shape != NULL;
+         shape = shape->getNext()) {
+
+        if (!shape->getCollisionShape()->isConvex()) continue;
+
+        DistanceInfo shapeDistanceInfo;
+        if (mCollisionDetection.computeNearestProxyShape(
+                    static_cast<const ConvexShape*>(shape->getCollisionShape()),
+                    shape->getLocalToWorldTransform(), body, maxDistance, shapeDistanceInfo,
+                    categoryMaskBits)) {
+
+            // The next proxy shapes of the body only need to find a closer shape
+            isFound = true;
+            maxDistance = shapeDistanceInfo.distance;
+            distanceInfo.distance = shapeDistanceInfo.distance;
+            distanceInfo.worldPoint1 = shapeDistanceInfo.worldPoint1;
+            distanceInfo.worldPoint2 = shapeDistanceInfo.worldPoint2;
+            distanceInfo.proxyShape1 = const_cast<ProxyShape*>(shape);
+            distanceInfo.proxyShape2 = shapeDistanceInfo.proxyShape2;
+
+            if (maxDistance == decimal(0.0)) break;
+        }
+    }
+
+    return isFound;
+}
+
+// Report the contacts between a body and the other bodies without modifying the world
+/// See testCollisionQuery(const ProxyShape*, CollisionCallback*) for details.
+/**
+ * @param body Pointer to the body to test
+ * @param callback Pointer to the object with the callback method
+ */
+void CollisionWorld::testCollisionQuery(const CollisionBody* body,
+                                        CollisionCallback* callback) const {
+
+    for (const ProxyShape* shape=body->getProxyShapesList(); shape != NULL;
+         shape = shape->getNext()) {
+        mCollisionDetection.testCollisionQuery(shape, callback);
+    }
+}
+
+// Report the contacts between two bodies without modifying the world
+/**
+ * @param body1 Pointer to the first body to test
+ * @param body2 Pointer to the second body to test
+ * @param callback Pointer to the object with the callback method
+ */
+void CollisionWorld::testCollisionQuery(const CollisionBody* body1, const CollisionBody* body2,
+                                        CollisionCallback* callback) const {
+
+    for (const ProxyShape* shape1=body1->getProxyShapesList(); shape1 != NULL;
+         shape1 = shape1->getNext()) {
+        for (const ProxyShape* shape2=body2->getProxyShapesList(); shape2 != NULL;
+             shape2 = shape2->getNext()) {
+            mCollisionDetection.testCollisionQuery(shape1, shape2, callback);
+        }
+    }
+}
+
 // Test and report collisions between all shapes of the world
 /**
  * @param callback Pointer to the object with the callback method
  */
 void CollisionWorld::testCollision(CollisionCallback* callback) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Reset all the contact manifolds lists of each body
     resetContactManifoldListsOfBodies();
 
@@ -35,6 +35,7 @@
 #include "Profiler.h"
 #include "body/CollisionBody.h"
 #include "collision/RaycastInfo.h"
+#include "collision/ConvexCastInfo.h"
 #include "OverlappingPair.h"
 #include "collision/CollisionDetection.h"
 #include "constraint/Joint.h"
@@ -47,6 +48,7 @@ namespace reactphysics3d {
 
 // Declarations
 class CollisionCallback;
+class CullingCallback;
 
 // Class CollisionWorld
 /**
@@ -78,6 +80,9 @@ class CollisionWorld {
         /// Pointer to an event listener object
         EventListener* mEventListener;
 
+        /// True if the world is in read-only query mode
+        bool mIsInReadOnlyQueryMode;
+
         // -------------------- Methods -------------------- //
 
         /// Private copy-constructor
@@ -117,10 +122,41 @@ class CollisionWorld {
         /// Set the collision dispatch configuration
         void setCollisionDispatch(CollisionDispatch* collisionDispatch);
 
+        /// Update the height values of a region of the grid of a height field proxy shape
+        void updateHeightFieldHeights(ProxyShape* proxyShape, int firstColumn, int firstRow,
+                                      int nbRegionColumns, int nbRegionRows, const void* heights);
+
+        /// Update a concave mesh proxy shape after the vertices of its triangle mesh have changed
+        bool refitConcaveMeshShape(ProxyShape* proxyShape,
+                                   decimal rebuildCostRatio = DECIMAL_LARGEST);
+
         /// Ray cast method
         void raycast(const Ray& ray, RaycastCallback* raycastCallback,
                      unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
 
+        /// Ray cast a batch of rays and report the closest hit of each ray
+        void raycastBatch(const Ray* rays, uint nbRays, RaycastBatchHit* hits,
+                          unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
+
+        /// Ray cast a batch of rays using several threads and report the closest hit of each ray
+        void raycastBatchParallel(const Ray* rays, uint nbRays, RaycastBatchHit* hits,
+                                  uint nbThreads,
+                                  unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
+
+        /// Cast a convex shape through the world and report the shapes it hits
+        void convexCast(const ConvexShape* shape, const Transform& fromTransform,
+                        const Transform& toTransform, ConvexCastCallback* convexCastCallback,
+                        unsigned short convexCastWithCategoryMaskBits = 0xFFFF) const;
+
+        /// Enter the read-only query mode
+        void beginReadOnlyQueries();
+
+        /// Leave the read-only query mode
+        void endReadOnlyQueries();
+
+        /// Return true if the world is in read-only query mode
+        bool isInReadOnlyQueryMode() const;
+
         /// Test if the AABBs of two bodies overlap
         bool testAABBOverlap(const CollisionBody* body1,
                              const CollisionBody* body2) const;
@@ -129,6 +165,54 @@ class CollisionWorld {
         bool testAABBOverlap(const ProxyShape* shape1,
                              const ProxyShape* shape2) const;
 
+        /// Report the proxy shapes whose AABB overlaps with a given world-space AABB
+        uint testAABBOverlap(const AABB& aabb, ProxyShape** overlappingShapes,
+                             uint maxNbOverlappingShapes,
+                             unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Report the proxy shapes overlapping with a convex shape
+        uint testOverlap(const ConvexShape* shape, const Transform& transform,
+                         ProxyShape** overlappingShapes, uint maxNbOverlappingShapes,
+                         unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Compute the distance and the closest points between two proxy shapes
+        bool computeDistance(const ProxyShape* shape1, const ProxyShape* shape2,
+                             DistanceInfo& distanceInfo) const;
+
+        /// Compute the distance and the closest points between two bodies
+        bool computeDistance(const CollisionBody* body1, const CollisionBody* body2,
+                             DistanceInfo& distanceInfo) const;
+
+        /// Find the nearest proxy shape to a convex shape within a maximum distance
+        bool computeNearestProxyShape(const ConvexShape* shape, const Transform& transform,
+                                      decimal maxDistance, DistanceInfo& distanceInfo,
+                                      unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the nearest proxy shape of another body to a body within a maximum distance
+        bool computeNearestProxyShape(const CollisionBody* body, decimal maxDistance,
+                                      DistanceInfo& distanceInfo,
+                                      unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Report the proxy shapes that are inside or intersect the volume bounded by planes
+        void cullProxyShapes(const Plane* planes, uint nbPlanes, CullingCallback* cullingCallback,
+                             unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the k nearest proxy shapes to a point within a maximum distance
+        uint computeNearestProxyShapes(const Vector3& point, uint maxNbShapes, decimal maxDistance,
+                                       ProxyShape** nearestShapes, decimal* distances,
+                                       unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the k nearest proxy shapes to a convex shape within a maximum distance
+        uint computeNearestProxyShapes(const ConvexShape* shape, const Transform& transform,
+                                       uint maxNbShapes, decimal maxDistance,
+                                       ProxyShape** nearestShapes, decimal* distances,
+                                       bool computeExactDistances = true,
+                                       unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the nearest body to a point within a maximum distance
+        CollisionBody* computeNearestBody(const Vector3& point, decimal maxDistance,
+                                          unsigned short categoryMaskBits = 0xFFFF) const;
+
         /// Test and report collisions between a given shape and all the others
         /// shapes of the world
         virtual void testCollision(const ProxyShape* shape,
@@ -152,6 +236,22 @@ class CollisionWorld {
         /// Test and report collisions between all shapes of the world
         virtual void testCollision(CollisionCallback* callback);
 
+        /// Report the contacts between a shape and the other shapes without
+        /// modifying the world
+        void testCollisionQuery(const ProxyShape* shape, CollisionCallback* callback) const;
+
+        /// Report the contacts between two shapes without modifying the world
+        void testCollisionQuery(const ProxyShape* shape1, const ProxyShape* shape2,
+                                CollisionCallback* callback) const;
+
+        /// Report the contacts between a body and the other bodies without
+        /// modifying the world
+        void testCollisionQuery(const CollisionBody* body, CollisionCallback* callback) const;
+
+        /// Report the contacts between two bodies without modifying the world
+        void testCollisionQuery(const CollisionBody* body1, const CollisionBody* body2,
+                                CollisionCallback* callback) const;
+
         // -------------------- Friendship -------------------- //
 
         friend class CollisionDetection;
@@ -184,6 +284,7 @@ inline std::set<CollisionBody*>::iterator CollisionWorld::getBodiesEndIterator()
  * which collision detection algorithm to use for two given collision shapes
  */
 inline void CollisionWorld::setCollisionDispatch(CollisionDispatch* collisionDispatch) {
+    assert(!mIsInReadOnlyQueryMode);
     mCollisionDetection.setCollisionDispatch(collisionDispatch);
 }
 
@@ -200,6 +301,73 @@ inline void CollisionWorld::raycast(const Ray& ray,
     mCollisionDetection.raycast(raycastCallback, ray, raycastWithCategoryMaskBits);
 }
 
+// Ray cast a batch of rays and report the closest hit of each ray
+/// The rays are traversed through the broad-phase tree as packets. The traversal is
+/// faster when the rays that are close in the array are coherent (close origins and
+/// similar directions).
+/**
+ * @param rays Array with the rays to cast
+ * @param nbRays Number of rays in the array
+ * @param hits Array of (at least) nbRays elements where the closest hit of each ray
+ *             is written (hits[i].hasHit is false if the ray i did not hit anything)
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ */
+inline void CollisionWorld::raycastBatch(const Ray* rays, uint nbRays, RaycastBatchHit* hits,
+                                         unsigned short raycastWithCategoryMaskBits) const {
+    mCollisionDetection.raycastBatch(rays, nbRays, hits, raycastWithCategoryMaskBits);
+}
+
+// Cast a convex shape through the world and report the shapes it hits
+/// The shape moves from the "from" transform to the "to" transform. Its position and
+/// orientation are interpolated during the motion. The callback is called with the time
+/// of impact, the contact point and the normal for each proxy shape that is hit. A proxy
+/// shape that overlaps with the cast shape at the beginning of the motion is not reported.
+/**
+ * @param shape Convex shape to cast
+ * @param fromTransform Local-space to world-space transform of the shape at the
+ *                      beginning of the motion
+ * @param toTransform Local-space to world-space transform of the shape at the end
+ *                    of the motion
+ * @param convexCastCallback Pointer to the class with the callback method
+ * @param convexCastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                       bodies to be tested
+ */
+inline void CollisionWorld::convexCast(const ConvexShape* shape, const Transform& fromTransform,
+                                       const Transform& toTransform,
+                                       ConvexCastCallback* convexCastCallback,
+                                       unsigned short convexCastWithCategoryMaskBits) const {
+    mCollisionDetection.convexCast(shape, fromTransform, toTransform, convexCastCallback,
+                                   convexCastWithCategoryMaskBits);
+}
+
+// Enter the read-only query mode
+/// In this mode, the world cannot be modified (no body creation/destruction, no shape
+/// addition/removal, no body move and no simulation step) and the queries that do not
+/// modify the world (raycasts and AABB overlap tests) can be safely called from several
+/// threads at the same time. The collision tests (testCollision() methods) modify the
+/// overlapping pairs of the world and are therefore not allowed in this mode. The mode
+/// is enforced with assertions in debug mode.
+inline void CollisionWorld::beginReadOnlyQueries() {
+    assert(!mIsInReadOnlyQueryMode);
+    mIsInReadOnlyQueryMode = true;
+}
+
+// Leave the read-only query mode
+/// This method must be called once all the threads have finished their queries.
+inline void CollisionWorld::endReadOnlyQueries() {
+    assert(mIsInReadOnlyQueryMode);
+    mIsInReadOnlyQueryMode = false;
+}
+
+// Return true if the world is in read-only query mode
+/**
+ * @return True if the world is in read-only query mode
+ */
+inline bool CollisionWorld::isInReadOnlyQueryMode() const {
+    return mIsInReadOnlyQueryMode;
+}
+
 // Test if the AABBs of two proxy shapes overlap
 /**
  * @param shape1 Pointer to the first proxy shape to test
@@ -212,6 +380,189 @@ inline bool CollisionWorld::testAABBOverlap(const ProxyShape* shape1,
     return mCollisionDetection.testAABBOverlap(shape1, shape2);
 }
 
+// Report the proxy shapes whose AABB overlaps with a given world-space AABB
+/// No memory is allocated by this query. If there are more overlapping proxy shapes
+/// than the size of the output array, only the first ones that are found are reported.
+/**
+ * @param aabb World-space AABB of the query
+ * @param overlappingShapes Output array where the overlapping proxy shapes are written
+ * @param maxNbOverlappingShapes Size of the output array
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to report
+ * @return Number of proxy shapes written in the output array
+ */
+inline uint CollisionWorld::testAABBOverlap(const AABB& aabb, ProxyShape** overlappingShapes,
+                                            uint maxNbOverlappingShapes,
+                                            unsigned short categoryMaskBits) const {
+    return mCollisionDetection.testAABBOverlap(aabb, overlappingShapes, maxNbOverlappingShapes,
+                                               categoryMaskBits);
+}
+
+// Report the proxy shapes overlapping with a convex shape
+/// The candidates of the broad-phase are confirmed with the GJK algorithm. The output
+/// array is filled in the same way as in the AABB overlap query.
+/**
+ * @param shape Convex shape of the query
+ * @param transform Local-space to world-space transform of the shape
+ * @param overlappingShapes Output array where the overlapping proxy shapes are written
+ * @param maxNbOverlappingShapes Size of the output array
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to report
+ * @return Number of proxy shapes written in the output array
+ */
+inline uint CollisionWorld::testOverlap(const ConvexShape* shape, const Transform& transform,
+                                        ProxyShape** overlappingShapes, uint maxNbOverlappingShapes,
+                                        unsigned short categoryMaskBits) const {
+    return mCollisionDetection.testOverlap(shape, transform, overlappingShapes,
+                                           maxNbOverlappingShapes, categoryMaskBits);
+}
+
+// Compute the distance and the closest points between two proxy shapes
+/// At least one of the two shapes must be convex. If the shapes are overlapping, the
+/// distance is zero and the closest points are not computed.
+/**
+ * @param shape1 Pointer to the first proxy shape
+ * @param shape2 Pointer to the second proxy shape
+ * @param distanceInfo Output information about the distance between the shapes
+ * @return False if the two shapes are concave and true otherwise
+ */
+inline bool CollisionWorld::computeDistance(const ProxyShape* shape1, const ProxyShape* shape2,
+                                            DistanceInfo& distanceInfo) const {
+    return mCollisionDetection.computeDistance(shape1, shape2, distanceInfo);
+}
+
+// Find the nearest proxy shape to a convex shape within a maximum distance
+/**
+ * @param shape Convex shape of the query
+ * @param transform Local-space to world-space transform of the shape
+ * @param maxDistance Maximum distance between the shape and the reported proxy shape
+ * @param distanceInfo Output information about the nearest proxy shape (proxyShape2)
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to consider
+ * @return True if a proxy shape has been found within the maximum distance
+ */
+inline bool CollisionWorld::computeNearestProxyShape(const ConvexShape* shape, const Transform& transform,
+                                                     decimal maxDistance, DistanceInfo& distanceInfo,
+                                                     unsigned short categoryMaskBits) const {
+    return mCollisionDetection.computeNearestProxyShape(shape, transform, NULL, maxDistance,
+                                                        distanceInfo, categoryMaskBits);
+}
+
+// Report the proxy shapes that are inside or intersect the volume bounded by planes
+/// The volume is the intersection of the half-spaces behind the planes (their normals point
+/// outward, see the Plane structure). For instance, the six planes of a view frustum can be
+/// used to find the proxy shapes to render. The test is done with the AABBs of the proxy
+/// shapes and the subtrees of the broad-phase tree that are fully inside the volume are
+/// reported without further tests.
+/**
+ * @param planes Array of planes (at most 32 planes)
+ * @param nbPlanes Number of planes
+ * @param cullingCallback Pointer to the class with the callback method
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to report
+ */
+inline void CollisionWorld::cullProxyShapes(const Plane* planes, uint nbPlanes,
+                                            CullingCallback* cullingCallback,
+                                            unsigned short categoryMaskBits) const {
+    mCollisionDetection.cullProxyShapes(planes, nbPlanes, cullingCallback, categoryMaskBits);
+}
+
+// Find the k nearest proxy shapes to a point within a maximum distance
+/// The distance to a proxy shape is the distance between the point and the AABB of the
+/// proxy shape. This is fast but approximate (it is a lower bound of the exact distance).
+/// The proxy shapes are written in increasing order of distance.
+/**
+ * @param point Point of the query (in world-space)
+ * @param maxNbShapes Maximum number of proxy shapes to report (size of the output arrays)
+ * @param maxDistance Maximum distance between the point and a reported proxy shape
+ * @param nearestShapes Output array of the nearest proxy shapes
+ * @param distances Output array of the distances of the nearest proxy shapes
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to consider
+ * @return Number of proxy shapes written in the output arrays
+ */
+inline uint CollisionWorld::computeNearestProxyShapes(const Vector3& point, uint maxNbShapes,
+                                                      decimal maxDistance, ProxyShape** nearestShapes,
+                                                      decimal* distances,
+                                                      unsigned short categoryMaskBits) const {
+    return mCollisionDetection.computeNearestProxyShapes(AABB(point, point), NULL, Transform::identity(),
+                                                         false, maxNbShapes, maxDistance, nearestShapes,
+                                                         distances, categoryMaskBits);
+}
+
+// Find the k nearest proxy shapes to a convex shape within a maximum distance
+/// The candidates are found with the AABB distances and, if required, their exact
+/// distances to the shape are computed with the GJK algorithm. The proxy shapes are
+/// written in increasing order of distance.
+/**
+ * @param shape Convex shape of the query
+ * @param transform Local-space to world-space transform of the shape
+ * @param maxNbShapes Maximum number of proxy shapes to report (size of the output arrays)
+ * @param maxDistance Maximum distance between the shape and a reported proxy shape
+ * @param nearestShapes Output array of the nearest proxy shapes
+ * @param distances Output array of the distances of the nearest proxy shapes
+ * @param computeExactDistances True if the exact distances are computed and false if the
+ *                              distances between the AABBs are used
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to consider
+ * @return Number of proxy shapes written in the output arrays
+ */
+inline uint CollisionWorld::computeNearestProxyShapes(const ConvexShape* shape, const Transform& transform,
+                                                      uint maxNbShapes, decimal maxDistance,
+                                                      ProxyShape** nearestShapes, decimal* distances,
+                                                      bool computeExactDistances,
+                                                      unsigned short categoryMaskBits) const {
+    AABB aabb;
+    shape->computeAABB(aabb, transform);
+    return mCollisionDetection.computeNearestProxyShapes(aabb, shape, transform, computeExactDistances,
+                                                         maxNbShapes, maxDistance, nearestShapes,
+                                                         distances, categoryMaskBits);
+}
+
+// Find the nearest body to a point within a maximum distance
+/// The distance to a body is the distance between the point and the AABBs of its proxy shapes.
+/**
+ * @param point Point of the query (in world-space)
+ * @param maxDistance Maximum distance between the point and the reported body
+ * @param categoryMaskBits Bits mask corresponding to the category of the proxy
+ *                         shapes to consider
+ * @return Pointer to the nearest body or NULL if there is no body within the maximum distance
+ */
+inline CollisionBody* CollisionWorld::computeNearestBody(const Vector3& point, decimal maxDistance,
+                                                         unsigned short categoryMaskBits) const {
+    ProxyShape* nearestShape;
+    decimal distance;
+    if (computeNearestProxyShapes(point, 1, maxDistance, &nearestShape, &distance, categoryMaskBits) == 0) {
+        return NULL;
+    }
+    return nearestShape->getBody();
+}
+
+// Report the contacts between a shape and the other shapes without modifying the world
+/// Contrary to the testCollision() methods, the overlapping pairs, the contact manifolds
+/// of the bodies and the collision data caches of the proxy shapes are not modified.
+/// The bodies are not required to be dynamic or awake. This query uses the narrow-phase
+/// algorithms of the world and therefore must not be called from several threads.
+/**
+ * @param shape Pointer to the proxy shape to test
+ * @param callback Pointer to the object with the callback method
+ */
+inline void CollisionWorld::testCollisionQuery(const ProxyShape* shape,
+                                               CollisionCallback* callback) const {
+    mCollisionDetection.testCollisionQuery(shape, callback);
+}
+
+// Report the contacts between two shapes without modifying the world
+/**
+ * @param shape1 Pointer to the first proxy shape to test
+ * @param shape2 Pointer to the second proxy shape to test
+ * @param callback Pointer to the object with the callback method
+ */
+inline void CollisionWorld::testCollisionQuery(const ProxyShape* shape1, const ProxyShape* shape2,
+                                               CollisionCallback* callback) const {
+    mCollisionDetection.testCollisionQuery(shape1, shape2, callback);
+}
+
 // Class CollisionCallback
 /**
  * This class can be used to register a callback for collision test queries.
@@ -232,6 +583,27 @@ class CollisionCallback {
         virtual void notifyContact(const ContactPointInfo& contactPointInfo)=0;
 };
 
+// Class CullingCallback
+/**
+ * This class can be used to register a callback for culling queries
+ * (see CollisionWorld::cullProxyShapes()). You should implement your own class
+ * inherited from this one and implement the notifyProxyShape() method.
+ */
+class CullingCallback {
+
+    public:
+
+        /// Destructor
+        virtual ~CullingCallback() {
+
+        }
+
+        /// This method will be called for each proxy shape that is not culled. The
+        /// "isFullyInside" parameter is true if the AABB of the proxy shape is fully
+        /// inside the volume bounded by the planes.
+        virtual void notifyProxyShape(ProxyShape* proxyShape, bool isFullyInside)=0;
+};
+
 }
 
  #endif
@@ -118,6 +118,8 @@ DynamicsWorld::~DynamicsWorld() {
  */
 void DynamicsWorld::update(decimal timeStep) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
 #ifdef IS_PROFILING_ACTIVE
     // Increment the frame counter of the profiler
     Profiler::incrementFrameCounter();
@@ -439,6 +441,8 @@ void DynamicsWorld::solvePositionCorrection() {
  */
 RigidBody* DynamicsWorld::createRigidBody(const Transform& transform) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Compute the body ID
     bodyindex bodyID = computeNextAvailableBodyID();
 
@@ -464,6 +468,8 @@ RigidBody* DynamicsWorld::createRigidBody(const Transform& transform) {
  */
 void DynamicsWorld::destroyRigidBody(RigidBody* rigidBody) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     // Remove all the collision shapes of the body
     rigidBody->removeAllCollisionShapes();
 
@@ -497,6 +503,8 @@ void DynamicsWorld::destroyRigidBody(RigidBody* rigidBody) {
  */
 Joint* DynamicsWorld::createJoint(const JointInfo& jointInfo) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     Joint* newJoint = NULL;
 
     // Allocate memory to create the new joint
@@ -569,6 +577,8 @@ Joint* DynamicsWorld::createJoint(const JointInfo& jointInfo) {
  */
 void DynamicsWorld::destroyJoint(Joint* joint) {
 
+    assert(!mIsInReadOnlyQueryMode);
+
     assert(joint != NULL);
 
     // If the collision between the two bodies of the constraint was disabled
@@ -25,6 +25,7 @@
 
 // Libraries
 #include "OverlappingPair.h"
+#include <cstdlib>
 
 using namespace reactphysics3d;
 
@@ -33,11 +34,15 @@ using namespace reactphysics3d;
 OverlappingPair::OverlappingPair(ProxyShape* shape1, ProxyShape* shape2,
                                  int nbMaxContactManifolds, MemoryAllocator& memoryAllocator)
                 : mContactManifoldSet(shape1, shape2, memoryAllocator, nbMaxContactManifolds),
-                  mCachedSeparatingAxis(1.0, 1.0, 1.0) {
+                  mCachedSeparatingAxis(1.0, 1.0, 1.0), mCachedTrianglesGeometryVersion(0) {
     
 }
 
 // Destructor
 OverlappingPair::~OverlappingPair() {
-    
+
+    // Release the collision data caches of the child shapes
+    for (uint i=0; i<mCachedChildCollisionData.size(); i++) {
+        free(mCachedChildCollisionData[i]);
+    }
 }                                  
@@ -30,6 +30,8 @@
 #include "collision/ContactManifoldSet.h"
 #include "collision/ProxyShape.h"
 #include "collision/shapes/CollisionShape.h"
+#include "collision/shapes/AABB.h"
+#include <vector>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -56,7 +58,23 @@ class OverlappingPair {
 
         /// Cached previous separating axis
         Vector3 mCachedSeparatingAxis;
-        
+
+        /// Vertices (in the local-space of the concave shape) of the cached triangles of a
+        /// convex vs concave pair (three consecutive vertices per triangle)
+        std::vector<Vector3> mCachedTriangleVertices;
+
+        /// Inflated AABB (in the local-space of the concave shape) that has been used
+        /// to query the cached triangles
+        AABB mCachedTrianglesAABB;
+
+        /// Geometry version of the concave shape when the triangles have been cached
+        /// (zero if there are no cached triangles)
+        uint mCachedTrianglesGeometryVersion;
+
+        /// Collision data caches of the child shapes of a compound shape (indexed by the
+        /// index of the child shape) of a compound vs convex pair
+        std::vector<void*> mCachedChildCollisionData;
+
         // -------------------- Methods -------------------- //
 
         /// Private copy-constructor
@@ -94,6 +112,24 @@ class OverlappingPair {
         /// Set the cached separating axis
         void setCachedSeparatingAxis(const Vector3& axis);
 
+        /// Return true if the cached triangles can be used for a given query AABB
+        bool isTrianglesCacheValid(const AABB& localAABB, uint geometryVersion) const;
+
+        /// Clear the cached triangles and set the AABB used to query the new ones
+        void resetTrianglesCache(const AABB& localInflatedAABB, uint geometryVersion);
+
+        /// Add a triangle into the cached triangles
+        void addCachedTriangle(const Vector3* trianglePoints);
+
+        /// Return the number of cached triangles
+        uint getNbCachedTriangles() const;
+
+        /// Return the three vertices of a cached triangle
+        const Vector3* getCachedTriangle(uint triangleIndex) const;
+
+        /// Return a pointer to the collision data cache of a child shape of a compound shape
+        void** getCachedChildCollisionData(uint childIndex, uint nbChildShapes);
+
         /// Return the number of contacts in the cache
         uint getNbContactPoints() const;
 
@@ -144,6 +180,58 @@ inline void OverlappingPair::setCachedSeparatingAxis(const Vector3& axis) {
     mCachedSeparatingAxis = axis;
 }
 
+// Return true if the cached triangles can be used for a given query AABB
+/**
+ * @param localAABB AABB of the convex shape in the local-space of the concave shape
+ * @param geometryVersion Current geometry version of the concave shape
+ * @return True if the cached triangles contain all the triangles overlapping the AABB
+ */
+inline bool OverlappingPair::isTrianglesCacheValid(const AABB& localAABB,
+                                                   uint geometryVersion) const {
+    return mCachedTrianglesGeometryVersion == geometryVersion &&
+           mCachedTrianglesAABB.contains(localAABB);
+}
+
+// Clear the cached triangles and set the AABB used to query the new ones
+inline void OverlappingPair::resetTrianglesCache(const AABB& localInflatedAABB,
+                                                 uint geometryVersion) {
+    mCachedTriangleVertices.clear();
+    mCachedTrianglesAABB = localInflatedAABB;
+    mCachedTrianglesGeometryVersion = geometryVersion;
+}
+
+// Add a triangle into the cached triangles
+inline void OverlappingPair::addCachedTriangle(const Vector3* trianglePoints) {
+    mCachedTriangleVertices.push_back(trianglePoints[0]);
+    mCachedTriangleVertices.push_back(trianglePoints[1]);
+    mCachedTriangleVertices.push_back(trianglePoints[2]);
+}
+
+// Return the number of cached triangles
+inline uint OverlappingPair::getNbCachedTriangles() const {
+    return mCachedTriangleVertices.size() / 3;
+}
+
+// Return the three vertices of a cached triangle
+inline const Vector3* OverlappingPair::getCachedTriangle(uint triangleIndex) const {
+    assert(triangleIndex < getNbCachedTriangles());
+    return &(mCachedTriangleVertices[3 * triangleIndex]);
+}
+
+// Return a pointer to the collision data cache of a child shape of a compound shape
+/// The array of caches is only enlarged when child shapes have been added to the compound
+/// shape. The caches are released when the pair is destroyed.
+/**
+ * @param childIndex Index of the child shape in the compound shape
+ * @param nbChildShapes Number of child shapes of the compound shape
+ */
+inline void** OverlappingPair::getCachedChildCollisionData(uint childIndex, uint nbChildShapes) {
+    assert(childIndex < nbChildShapes);
+    if (mCachedChildCollisionData.size() < nbChildShapes) {
+        mCachedChildCollisionData.resize(nbChildShapes, NULL);
+    }
+    return &mCachedChildCollisionData[childIndex];
+}
 
 // Return the number of contact points in the contact manifold
 inline uint OverlappingPair::getNbContactPoints() const {
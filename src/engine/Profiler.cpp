@@ -35,6 +35,7 @@ ProfileNode Profiler::mRootNode("Root", NULL);
 ProfileNode* Profiler::mCurrentNode = &Profiler::mRootNode;
 long double Profiler::mProfilingStartTime = Timer::getCurrentSystemTime() * 1000.0;
 uint Profiler::mFrameCounter = 0;
+std::thread::id Profiler::mProfilingThreadID = std::this_thread::get_id();
 
 // Constructor
 ProfileNode::ProfileNode(const char* name, ProfileNode* parentNode)
@@ -160,6 +161,9 @@ void ProfileNodeIterator::enterParent() {
 // Method called when we want to start profiling a block of code.
 void Profiler::startProfilingBlock(const char* name) {
 
+    // Only the profiled thread can modify the profiler tree
+    if (std::this_thread::get_id() != mProfilingThreadID) return;
+
     // Look for the node in the tree that corresponds to the block of
     // code to profile
     if (name != mCurrentNode->getName()) {
@@ -174,6 +178,9 @@ void Profiler::startProfilingBlock(const char* name) {
 // startProfilingBlock() method has been called.
 void Profiler::stopProfilingBlock() {
 
+    // Only the profiled thread can modify the profiler tree
+    if (std::this_thread::get_id() != mProfilingThreadID) return;
+
     // Go to the parent node unless if the current block
     // of code is recursing
     if (mCurrentNode->exitBlockOfCode()) {
@@ -182,7 +189,9 @@ void Profiler::stopProfilingBlock() {
 }
 
 // Reset the timing data of the profiler (but not the profiler tree structure)
+/// The thread that resets the profiler becomes the profiled thread.
 void Profiler::reset() {
+    mProfilingThreadID = std::this_thread::get_id();
     mRootNode.reset();
     mRootNode.enterBlockOfCode();
     mFrameCounter = 0;
@@ -31,6 +31,7 @@
 // Libraries
 #include "configuration.h"
 #include "Timer.h"
+#include <thread>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -196,6 +197,11 @@ class Profiler {
         /// Starting profiling time
         static long double mProfilingStartTime;
 
+        /// ID of the thread that is profiled. The blocks of code executed by the other
+        /// threads (concurrent read-only queries for instance) are not profiled because
+        /// the profiler tree is not thread-safe.
+        static std::thread::id mProfilingThreadID;
+
         /// Recursively print the report of a given node of the profiler tree
         static void printRecursiveNodeReport(ProfileNodeIterator* iterator,
                                              int spacing,
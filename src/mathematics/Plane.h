@@ -0,0 +1,86 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_PLANE_H
+#define REACTPHYSICS3D_PLANE_H
+
+// Libraries
+#include "Vector3.h"
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Structure Plane
+/**
+ * This structure represents a plane made of the points p such that
+ * normal.dot(p) = distance. The normal (unit length) points toward the
+ * outside of the half-space bounded by the plane. For instance, the planes
+ * of a view frustum or of the faces of a convex polyhedron point outward.
+ */
+struct Plane {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Unit normal of the plane (pointing outward)
+        Vector3 normal;
+
+        /// Signed distance of the plane from the origin along the normal
+        decimal distance;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        Plane() : normal(0, 0, 0), distance(0) {
+
+        }
+
+        /// Constructor with a normal and a signed distance from the origin
+        Plane(const Vector3& planeNormal, decimal planeDistance)
+             : normal(planeNormal), distance(planeDistance) {
+
+        }
+
+        /// Constructor with a normal and a point on the plane
+        Plane(const Vector3& planeNormal, const Vector3& point)
+             : normal(planeNormal), distance(planeNormal.dot(point)) {
+
+        }
+
+        /// Destructor
+        ~Plane() {
+
+        }
+
+        /// Return the signed distance of a point to the plane (positive outside)
+        decimal computeSignedDistance(const Vector3& point) const {
+            return normal.dot(point) - distance;
+        }
+};
+
+}
+
+#endif
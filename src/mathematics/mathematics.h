@@ -34,6 +34,7 @@
 #include "Vector2.h"
 #include "Transform.h"
 #include "Ray.h"
+#include "Plane.h"
 #include "configuration.h"
 #include "mathematics_functions.h"
 #include <vector>
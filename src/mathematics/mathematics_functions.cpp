@@ -50,6 +50,119 @@ void reactphysics3d::computeBarycentricCoordinatesInTriangle(const Vector3& a, c
     u = decimal(1.0) - v - w;
 }
 
+/// Compute the point of the triangle (a, b, c) that is closest to a point p
+/// This method uses the technique described in the book Real-Time collision detection by
+/// Christer Ericson. The Voronoi regions of the vertices and edges are tested first and
+/// the point is projected onto the face of the triangle otherwise.
+Vector3 reactphysics3d::computeClosestPointOnTriangle(const Vector3& a, const Vector3& b,
+                                                      const Vector3& c, const Vector3& p) {
+    const Vector3 ab = b - a;
+    const Vector3 ac = c - a;
+
+    // Vertex region of a
+    const Vector3 ap = p - a;
+    decimal d1 = ab.dot(ap);
+    decimal d2 = ac.dot(ap);
+    if (d1 <= decimal(0.0) && d2 <= decimal(0.0)) return a;
+
+    // Vertex region of b
+    const Vector3 bp = p - b;
+    decimal d3 = ab.dot(bp);
+    decimal d4 = ac.dot(bp);
+    if (d3 >= decimal(0.0) && d4 <= d3) return b;
+
+    // Edge region of ab
+    decimal vc = d1 * d4 - d3 * d2;
+    if (vc <= decimal(0.0) && d1 >= decimal(0.0) && d3 <= decimal(0.0)) {
+        decimal v = d1 / (d1 - d3);
+        return a + v * ab;
+    }
+
+    // Vertex region of c
+    const Vector3 cp = p - c;
+    decimal d5 = ab.dot(cp);
+    decimal d6 = ac.dot(cp);
+    if (d6 >= decimal(0.0) && d5 <= d6) return c;
+
+    // Edge region of ac
+    decimal vb = d5 * d2 - d1 * d6;
+    if (vb <= decimal(0.0) && d2 >= decimal(0.0) && d6 <= decimal(0.0)) {
+        decimal w = d2 / (d2 - d6);
+        return a + w * ac;
+    }
+
+    // Edge region of bc
+    decimal va = d3 * d6 - d5 * d4;
+    if (va <= decimal(0.0) && (d4 - d3) >= decimal(0.0) && (d5 - d6) >= decimal(0.0)) {
+        decimal w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return b + w * (c - b);
+    }
+
+    // Face region
+    decimal denom = decimal(1.0) / (va + vb + vc);
+    decimal v = vb * denom;
+    decimal w = vc * denom;
+    return a + ab * v + ac * w;
+}
+
+/// Compute the closest points between the segments (p1, q1) and (p2, q2) and return
+/// the square distance between them. This method uses the technique described in the
+/// book Real-Time collision detection by Christer Ericson.
+decimal reactphysics3d::computeClosestPointsBetweenSegments(const Vector3& p1, const Vector3& q1,
+                                                            const Vector3& p2, const Vector3& q2,
+                                                            Vector3& closestPoint1,
+                                                            Vector3& closestPoint2) {
+    const Vector3 d1 = q1 - p1;
+    const Vector3 d2 = q2 - p2;
+    const Vector3 r = p1 - p2;
+    decimal a = d1.lengthSquare();
+    decimal e = d2.lengthSquare();
+    decimal f = d2.dot(r);
+    decimal s, t;
+
+    // If both segments degenerate into points
+    if (a <= MACHINE_EPSILON && e <= MACHINE_EPSILON) {
+        s = t = decimal(0.0);
+    }
+    else if (a <= MACHINE_EPSILON) {    // If the first segment degenerates into a point
+        s = decimal(0.0);
+        t = clamp(f / e, decimal(0.0), decimal(1.0));
+    }
+    else {
+        decimal c = d1.dot(r);
+
+        // If the second segment degenerates into a point
+        if (e <= MACHINE_EPSILON) {
+            t = decimal(0.0);
+            s = clamp(-c / a, decimal(0.0), decimal(1.0));
+        }
+        else {
+            decimal b = d1.dot(d2);
+            decimal denom = a * e - b * b;
+
+            // If the segments are not parallel, compute the closest point on the first
+            // line and clamp it to the first segment
+            s = (denom != decimal(0.0)) ? clamp((b * f - c * e) / denom, decimal(0.0), decimal(1.0)) :
+                                          decimal(0.0);
+
+            // Compute the closest point on the second segment and clamp it
+            t = (b * s + f) / e;
+            if (t < decimal(0.0)) {
+                t = decimal(0.0);
+                s = clamp(-c / a, decimal(0.0), decimal(1.0));
+            }
+            else if (t > decimal(1.0)) {
+                t = decimal(1.0);
+                s = clamp((b - c) / a, decimal(0.0), decimal(1.0));
+            }
+        }
+    }
+
+    closestPoint1 = p1 + d1 * s;
+    closestPoint2 = p2 + d2 * t;
+    return (closestPoint1 - closestPoint2).lengthSquare();
+}
+
 // Clamp a vector such that it is no longer than a given maximum length
 Vector3 reactphysics3d::clamp(const Vector3& vector, decimal maxLength) {
     if (vector.lengthSquare() > maxLength * maxLength) {
@@ -82,6 +82,16 @@ Vector3 clamp(const Vector3& vector, decimal maxLength);
 void computeBarycentricCoordinatesInTriangle(const Vector3& a, const Vector3& b, const Vector3& c,
                                              const Vector3& p, decimal& u, decimal& v, decimal& w);
 
+/// Compute the point of the triangle (a, b, c) that is closest to a point p
+Vector3 computeClosestPointOnTriangle(const Vector3& a, const Vector3& b, const Vector3& c,
+                                      const Vector3& p);
+
+/// Compute the closest points between the segments (p1, q1) and (p2, q2) and return
+/// the square distance between them
+decimal computeClosestPointsBetweenSegments(const Vector3& p1, const Vector3& q1,
+                                            const Vector3& p2, const Vector3& q2,
+                                            Vector3& closestPoint1, Vector3& closestPoint2);
+
 }
 
 #endif
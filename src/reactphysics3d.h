@@ -52,11 +52,13 @@
 #include "collision/shapes/ConvexMeshShape.h"
 #include "collision/shapes/ConcaveMeshShape.h"
 #include "collision/shapes/HeightFieldShape.h"
+#include "collision/shapes/CompoundShape.h"
 #include "collision/shapes/AABB.h"
 #include "collision/ProxyShape.h"
 #include "collision/RaycastInfo.h"
 #include "collision/TriangleMesh.h"
 #include "collision/TriangleVertexArray.h"
+#include "collision/ConvexHull.h"
 #include "constraint/BallAndSocketJoint.h"
 #include "constraint/SliderJoint.h"
 #include "constraint/HingeJoint.h"
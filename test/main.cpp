@@ -37,6 +37,8 @@
 #include "tests/collision/TestCollisionWorld.h"
 #include "tests/collision/TestAABB.h"
 #include "tests/collision/TestDynamicAABBTree.h"
+#include "tests/collision/TestConvexHull.h"
+#include "tests/collision/TestNarrowPhaseAlgorithms.h"
 
 using namespace reactphysics3d;
 
@@ -61,6 +63,8 @@ int main() {
     testSuite.addTest(new TestRaycast("Raycasting"));
     testSuite.addTest(new TestCollisionWorld("CollisionWorld"));
     testSuite.addTest(new TestDynamicAABBTree("DynamicAABBTree"));
+    testSuite.addTest(new TestConvexHull("ConvexHull"));
+    testSuite.addTest(new TestNarrowPhaseAlgorithms("NarrowPhaseAlgorithms"));
 
     // Run the tests
     testSuite.run();
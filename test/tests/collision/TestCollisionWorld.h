@@ -39,8 +39,6 @@ enum CollisionCategory {
     CATEGORY_3 = 0x0004
 };
 
-// TODO : Add test for concave shape collision here
-
 // Class
 class WorldCollisionCallback : public CollisionCallback
 {
@@ -95,6 +93,93 @@ class WorldCollisionCallback : public CollisionCallback
         }
 };
 
+// Class ConcaveCollisionCallback
+class ConcaveCollisionCallback : public CollisionCallback
+{
+    public:
+
+        int nbContacts;
+        decimal maxPenetrationDepth;
+
+        /// Normal of the deepest contact (from the convex body toward the concave body)
+        Vector3 normal;
+
+        CollisionBody* convexBody;
+
+        ConcaveCollisionCallback() : convexBody(NULL)
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            nbContacts = 0;
+            maxPenetrationDepth = 0;
+            normal.setToZero();
+        }
+
+        // This method will be called for contact
+        virtual void notifyContact(const ContactPointInfo& contactPointInfo) {
+
+            nbContacts++;
+            if (contactPointInfo.penetrationDepth > maxPenetrationDepth) {
+                maxPenetrationDepth = contactPointInfo.penetrationDepth;
+                bool isConvexFirst = contactPointInfo.shape1->getBody()->getID() == convexBody->getID();
+                normal = isConvexFirst ? contactPointInfo.normal : -contactPointInfo.normal;
+            }
+        }
+};
+
+// Class ClosestConvexCastCallback
+class ClosestConvexCastCallback : public ConvexCastCallback {
+
+    public:
+
+        bool isHit;
+        decimal hitFraction;
+        Vector3 worldPoint;
+        Vector3 worldNormal;
+        CollisionBody* body;
+
+        ClosestConvexCastCallback() {
+            reset();
+        }
+
+        void reset() {
+            isHit = false;
+            hitFraction = decimal(1.0);
+            worldPoint.setToZero();
+            worldNormal.setToZero();
+            body = NULL;
+        }
+
+        virtual decimal notifyConvexCastHit(const ConvexCastInfo& info) {
+
+            if (!isHit || info.hitFraction < hitFraction) {
+                isHit = true;
+                hitFraction = info.hitFraction;
+                worldPoint = info.worldPoint;
+                worldNormal = info.worldNormal;
+                body = info.body;
+            }
+
+            // Clip the motion to the closest hit
+            return info.hitFraction;
+        }
+};
+
+// Class WorldCullingCallback
+class WorldCullingCallback : public CullingCallback {
+
+    public:
+
+        std::map<ProxyShape*, bool> reportedShapes;
+
+        virtual void notifyProxyShape(ProxyShape* proxyShape, bool isFullyInside) {
+            reportedShapes[proxyShape] = isFullyInside;
+        }
+};
+
 // Class TestCollisionWorld
 /**
  * Unit test for the CollisionWorld class.
@@ -128,6 +213,23 @@ class TestCollisionWorld : public Test {
         // Collision callback class
         WorldCollisionCallback mCollisionCallback;
 
+        // Concave mesh floor
+        std::vector<Vector3> mFloorVertices;
+        std::vector<uint> mFloorIndices;
+        TriangleVertexArray* mFloorVertexArray;
+        TriangleMesh mFloorTriangleMesh;
+        ConcaveMeshShape* mFloorShape;
+        CollisionBody* mFloorBody;
+
+        // Convex bodies resting on the concave mesh floor
+        CapsuleShape* mCapsuleShape;
+        CollisionBody* mFloorSphereBody;
+        CollisionBody* mFloorCapsuleBody;
+        CollisionBody* mFloorBoxBody;
+
+        // Collision callback class for the concave collisions
+        ConcaveCollisionCallback mConcaveCollisionCallback;
+
     public :
 
         // ---------- Methods ---------- //
@@ -168,6 +270,37 @@ class TestCollisionWorld : public Test {
             mCollisionCallback.sphere1Body = mSphere1Body;
             mCollisionCallback.sphere2Body = mSphere2Body;
             mCollisionCallback.cylinderBody = mCylinderBody;
+
+            // Create a concave mesh floor (far from the other bodies)
+            mFloorVertices.push_back(Vector3(-10, 0, -10));
+            mFloorVertices.push_back(Vector3(10, 0, -10));
+            mFloorVertices.push_back(Vector3(10, 0, 10));
+            mFloorVertices.push_back(Vector3(-10, 0, 10));
+            mFloorIndices.push_back(0); mFloorIndices.push_back(2); mFloorIndices.push_back(1);
+            mFloorIndices.push_back(0); mFloorIndices.push_back(3); mFloorIndices.push_back(2);
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VERTEX_DOUBLE_TYPE;
+            mFloorVertexArray = new TriangleVertexArray(4, &(mFloorVertices[0]), sizeof(Vector3),
+                                                        2, &(mFloorIndices[0]), sizeof(uint),
+                                                        vertexType, TriangleVertexArray::INDEX_INTEGER_TYPE);
+            mFloorTriangleMesh.addSubpart(mFloorVertexArray);
+            mFloorShape = new ConcaveMeshShape(&mFloorTriangleMesh);
+            mFloorBody = mWorld->createCollisionBody(Transform(Vector3(100, 0, 0), Quaternion::identity()));
+            mFloorBody->addCollisionShape(mFloorShape, Transform::identity());
+
+            // Create convex bodies slightly penetrating the floor
+            mFloorSphereBody = mWorld->createCollisionBody(Transform(Vector3(95, 2.9, 0),
+                                                                     Quaternion::identity()));
+            mFloorSphereBody->addCollisionShape(mSphereShape, Transform::identity());
+
+            mCapsuleShape = new CapsuleShape(1, 4);
+            mFloorCapsuleBody = mWorld->createCollisionBody(Transform(Vector3(100, 0.8, 0),
+                                                                      Quaternion(0, 0, PI / decimal(2.0))));
+            mFloorCapsuleBody->addCollisionShape(mCapsuleShape, Transform::identity());
+
+            mFloorBoxBody = mWorld->createCollisionBody(Transform(Vector3(105, 2.8, 0),
+                                                                  Quaternion::identity()));
+            mFloorBoxBody->addCollisionShape(mBoxShape, Transform::identity());
         }
 
         /// Destructor
@@ -175,12 +308,29 @@ class TestCollisionWorld : public Test {
             delete mBoxShape;
             delete mSphereShape;
             delete mCylinderShape;
+            delete mCapsuleShape;
+            delete mFloorShape;
+            delete mFloorVertexArray;
         }
 
         /// Run the tests
         void run() {
 
             testCollisions();
+            testConcaveCollisions();
+            testConvexCast();
+            testOverlapQueries();
+            testCollisionQueries();
+            testDistanceQueries();
+            testNearestQueries();
+            testCulling();
+            testHeightFieldUpdate();
+            testConcaveMeshRefit();
+            testConcaveMeshInstanceRefit();
+            testCompoundShape();
+            testCompoundBroadPhase();
+            testCompoundCulling();
+            testCollisionShapesEdit();
         }
 
         void testCollisions() {
@@ -336,6 +486,912 @@ class TestCollisionWorld : public Test {
             mSphere2ProxyShape->setCollideWithMaskBits(0xFFFF);
             mCylinderProxyShape->setCollideWithMaskBits(0xFFFF);
         }
+
+        void testConcaveCollisions() {
+
+            // Sphere vs concave mesh
+            mConcaveCollisionCallback.reset();
+            mConcaveCollisionCallback.convexBody = mFloorSphereBody;
+            mWorld->testCollision(mFloorSphereBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts > 0);
+            test(approxEqual(mConcaveCollisionCallback.maxPenetrationDepth, decimal(0.1), decimal(0.001)));
+            test(approxEqual(mConcaveCollisionCallback.normal.y, decimal(-1.0), decimal(0.001)));
+
+            // Move the sphere a little bit (the cached triangles of the pair are used)
+            mFloorSphereBody->setTransform(Transform(Vector3(95.05, 2.85, 0), Quaternion::identity()));
+            mConcaveCollisionCallback.reset();
+            mWorld->testCollision(mFloorSphereBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts > 0);
+            test(approxEqual(mConcaveCollisionCallback.maxPenetrationDepth, decimal(0.15), decimal(0.001)));
+            mFloorSphereBody->setTransform(Transform(Vector3(95, 2.9, 0), Quaternion::identity()));
+
+            // Capsule (lying on the floor) vs concave mesh
+            mConcaveCollisionCallback.reset();
+            mConcaveCollisionCallback.convexBody = mFloorCapsuleBody;
+            mWorld->testCollision(mFloorCapsuleBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts > 0);
+            test(approxEqual(mConcaveCollisionCallback.maxPenetrationDepth, decimal(0.2), decimal(0.001)));
+            test(approxEqual(mConcaveCollisionCallback.normal.y, decimal(-1.0), decimal(0.001)));
+
+            // Box vs concave mesh
+            mConcaveCollisionCallback.reset();
+            mConcaveCollisionCallback.convexBody = mFloorBoxBody;
+            mWorld->testCollision(mFloorBoxBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts > 0);
+            test(approxEqual(mConcaveCollisionCallback.maxPenetrationDepth, decimal(0.2), decimal(0.001)));
+            test(approxEqual(mConcaveCollisionCallback.normal.y, decimal(-1.0), decimal(0.001)));
+
+            // Move the box above the floor
+            mFloorBoxBody->setTransform(Transform(Vector3(105, 3.5, 0), Quaternion::identity()));
+            mConcaveCollisionCallback.reset();
+            mWorld->testCollision(mFloorBoxBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts == 0);
+            mFloorBoxBody->setTransform(Transform(Vector3(105, 2.8, 0), Quaternion::identity()));
+
+            // Sphere vs concave mesh with smooth mesh collision (the sphere touches
+            // the shared edge of the two floor triangles)
+            mFloorShape->setIsSmoothMeshCollisionEnabled(true);
+            mFloorSphereBody->setTransform(Transform(Vector3(100, 2.9, 0), Quaternion::identity()));
+            mConcaveCollisionCallback.reset();
+            mConcaveCollisionCallback.convexBody = mFloorSphereBody;
+            mWorld->testCollision(mFloorSphereBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts == 1);
+            test(approxEqual(mConcaveCollisionCallback.maxPenetrationDepth, decimal(0.1), decimal(0.001)));
+            test(approxEqual(mConcaveCollisionCallback.normal.y, decimal(-1.0), decimal(0.001)));
+            mFloorShape->setIsSmoothMeshCollisionEnabled(false);
+            mFloorSphereBody->setTransform(Transform(Vector3(95, 2.9, 0), Quaternion::identity()));
+        }
+
+        void testConvexCast() {
+
+            SphereShape castSphere(1);
+            ClosestConvexCastCallback callback;
+
+            // Sphere swept against the box
+            mWorld->convexCast(&castSphere, Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                               Transform(Vector3(20, 0, 0), Quaternion::identity()), &callback);
+            test(callback.isHit);
+            test(callback.body == mBoxBody);
+            test(approxEqual(callback.hitFraction, decimal(0.3), decimal(0.001)));
+            test(approxEqual(callback.worldPoint.x, decimal(7.0), decimal(0.01)));
+            test(approxEqual(callback.worldNormal.x, decimal(-1.0), decimal(0.01)));
+
+            // With a category mask that excludes the box
+            callback.reset();
+            mWorld->convexCast(&castSphere, Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                               Transform(Vector3(20, 0, 0), Quaternion::identity()), &callback,
+                               CATEGORY_2);
+            test(!callback.isHit);
+
+            // Motion that does not reach the box
+            callback.reset();
+            mWorld->convexCast(&castSphere, Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                               Transform(Vector3(5, 0, 0), Quaternion::identity()), &callback);
+            test(!callback.isHit);
+
+            // Shape overlapping the box at the beginning of the motion
+            callback.reset();
+            mWorld->convexCast(&castSphere, Transform(Vector3(10, 0, 0), Quaternion::identity()),
+                               Transform(Vector3(20, 0, 0), Quaternion::identity()), &callback,
+                               CATEGORY_1);
+            test(!callback.isHit);
+
+            // Rotating box swept against the box
+            BoxShape castBox(Vector3(1, 1, 1));
+            callback.reset();
+            mWorld->convexCast(&castBox, Transform(Vector3(0, 0, 0), Quaternion::identity()),
+                               Transform(Vector3(20, 0, 0), Quaternion(0, PI / decimal(4.0), 0)), &callback);
+            test(callback.isHit);
+            test(callback.body == mBoxBody);
+            test(callback.hitFraction > decimal(0.25) && callback.hitFraction < decimal(0.3));
+
+            // Sphere swept against the concave mesh floor
+            callback.reset();
+            mWorld->convexCast(&castSphere, Transform(Vector3(102, 5, 7), Quaternion::identity()),
+                               Transform(Vector3(102, -5, 7), Quaternion::identity()), &callback);
+            test(callback.isHit);
+            test(callback.body == mFloorBody);
+            test(approxEqual(callback.hitFraction, decimal(0.4), decimal(0.001)));
+            test(approxEqual(callback.worldPoint.y, decimal(0.0), decimal(0.01)));
+            test(approxEqual(callback.worldNormal.y, decimal(1.0), decimal(0.01)));
+        }
+
+        void testOverlapQueries() {
+
+            ProxyShape* shapes[10];
+
+            // AABB around the box
+            uint nbShapes = mWorld->testAABBOverlap(AABB(Vector3(8, -1, -1), Vector3(12, 1, 1)), shapes, 10);
+            test(nbShapes == 1);
+            test(shapes[0] == mBoxProxyShape);
+            test(mWorld->testAABBOverlap(AABB(Vector3(8, -1, -1), Vector3(12, 1, 1)), shapes, 10,
+                                         CATEGORY_2) == 0);
+
+            // Large AABB with a small output array
+            test(mWorld->testAABBOverlap(AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50)), shapes, 2) == 2);
+
+            // Sphere overlapping the box and the first sphere
+            SphereShape sphereShape(1);
+            nbShapes = mWorld->testOverlap(&sphereShape, Transform(Vector3(10, 3.5, 0), Quaternion::identity()),
+                                           shapes, 10);
+            test(nbShapes == 2);
+            test((shapes[0] == mBoxProxyShape && shapes[1] == mSphere1ProxyShape) ||
+                 (shapes[1] == mBoxProxyShape && shapes[0] == mSphere1ProxyShape));
+            nbShapes = mWorld->testOverlap(&sphereShape, Transform(Vector3(10, 3.5, 0), Quaternion::identity()),
+                                           shapes, 10, CATEGORY_1 | CATEGORY_3);
+            test(nbShapes == 2);
+
+            // Sphere near a corner of the box (the AABBs overlap but not the shapes)
+            const Transform nearCornerTransform(Vector3(13.8, -3.8, 0), Quaternion::identity());
+            AABB nearCornerAABB;
+            sphereShape.computeAABB(nearCornerAABB, nearCornerTransform);
+            test(mWorld->testAABBOverlap(nearCornerAABB, shapes, 10) == 1);
+            test(mWorld->testOverlap(&sphereShape, nearCornerTransform, shapes, 10) == 0);
+
+            // Sphere vs concave mesh floor
+            nbShapes = mWorld->testOverlap(&sphereShape, Transform(Vector3(102, 0.5, 7), Quaternion::identity()),
+                                           shapes, 10);
+            test(nbShapes == 1);
+            test(shapes[0]->getBody() == mFloorBody);
+            test(mWorld->testOverlap(&sphereShape, Transform(Vector3(102, 1.5, 7), Quaternion::identity()),
+                                     shapes, 10) == 0);
+        }
+
+        void testCollisionQueries() {
+
+            const ContactManifoldListElement* boxManifolds = mBoxBody->getContactManifoldsList();
+
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mBoxBody, &mCollisionCallback);
+            test(mCollisionCallback.boxCollideWithSphere1);
+            test(mCollisionCallback.boxCollideWithCylinder);
+            test(!mCollisionCallback.sphere1CollideWithCylinder);
+            test(!mCollisionCallback.sphere1CollideWithSphere2);
+
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mSphere1Body, mBoxBody, &mCollisionCallback);
+            test(mCollisionCallback.boxCollideWithSphere1);
+            test(!mCollisionCallback.boxCollideWithCylinder);
+
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mCylinderProxyShape, &mCollisionCallback);
+            test(!mCollisionCallback.boxCollideWithSphere1);
+            test(mCollisionCallback.boxCollideWithCylinder);
+
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mSphere1ProxyShape, mCylinderProxyShape, &mCollisionCallback);
+            test(!mCollisionCallback.sphere1CollideWithCylinder);
+
+            // The contact manifolds of the bodies are not modified by the queries
+            test(mBoxBody->getContactManifoldsList() == boxManifolds);
+
+            // Running the same query again gives the same results
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mBoxBody, &mCollisionCallback);
+            test(mCollisionCallback.boxCollideWithSphere1);
+            test(mCollisionCallback.boxCollideWithCylinder);
+            test(!mCollisionCallback.sphere1CollideWithCylinder);
+            test(!mCollisionCallback.sphere1CollideWithSphere2);
+
+            // Static bodies are not tested by testCollision() but they are by the queries
+            mBoxBody->setType(STATIC);
+            mSphere1Body->setType(STATIC);
+
+            mCollisionCallback.reset();
+            mWorld->testCollision(mBoxBody, mSphere1Body, &mCollisionCallback);
+            test(!mCollisionCallback.boxCollideWithSphere1);
+
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mBoxBody, mSphere1Body, &mCollisionCallback);
+            test(mCollisionCallback.boxCollideWithSphere1);
+
+            mBoxBody->setType(DYNAMIC);
+            mSphere1Body->setType(DYNAMIC);
+
+            // Collision filtering
+            mBoxProxyShape->setCollideWithMaskBits(CATEGORY_3);
+            mCollisionCallback.reset();
+            mWorld->testCollisionQuery(mBoxBody, &mCollisionCallback);
+            test(!mCollisionCallback.boxCollideWithSphere1);
+            test(mCollisionCallback.boxCollideWithCylinder);
+            mBoxProxyShape->setCollideWithMaskBits(0xFFFF);
+
+            // Convex body resting on the concave mesh floor
+            mConcaveCollisionCallback.reset();
+            mConcaveCollisionCallback.convexBody = mFloorBoxBody;
+            mWorld->testCollisionQuery(mFloorBoxBody, mFloorBody, &mConcaveCollisionCallback);
+            test(mConcaveCollisionCallback.nbContacts > 0);
+            test(approxEqual(mConcaveCollisionCallback.maxPenetrationDepth, decimal(0.2), decimal(0.001)));
+            test(approxEqual(mConcaveCollisionCallback.normal.y, decimal(-1.0), decimal(0.001)));
+        }
+
+        void testDistanceQueries() {
+
+            // Box vs second sphere
+            DistanceInfo distanceInfo;
+            test(mWorld->computeDistance(mBoxProxyShape, mSphere2ProxyShape, distanceInfo));
+            test(approxEqual(distanceInfo.distance, std::sqrt(decimal(387)) - decimal(3), decimal(0.05)));
+            test((distanceInfo.worldPoint1 - Vector3(13, 3, 3)).length() < decimal(0.05));
+            test(approxEqual((distanceInfo.worldPoint2 - distanceInfo.worldPoint1).length(),
+                             distanceInfo.distance, decimal(0.05)));
+            test(distanceInfo.proxyShape1 == mBoxProxyShape);
+            test(distanceInfo.proxyShape2 == mSphere2ProxyShape);
+
+            // Overlapping bodies
+            DistanceInfo overlapDistanceInfo;
+            test(mWorld->computeDistance(mBoxBody, mSphere1Body, overlapDistanceInfo));
+            test(overlapDistanceInfo.distance == decimal(0.0));
+
+            // The points of overlapping shapes are the deepest points of each shape inside the other one
+            test((overlapDistanceInfo.worldPoint1 - Vector3(10, 3, 0)).length() < decimal(0.05));
+            test((overlapDistanceInfo.worldPoint2 - Vector3(10, 2, 0)).length() < decimal(0.05));
+            test(mSphere1ProxyShape->testPointInside(overlapDistanceInfo.worldPoint1));
+            test(mBoxProxyShape->testPointInside(overlapDistanceInfo.worldPoint2));
+
+            // Sphere overlapping with the concave mesh floor
+            DistanceInfo floorOverlapDistanceInfo;
+            test(mWorld->computeDistance(mFloorBody->getProxyShapesList(),
+                                         mFloorSphereBody->getProxyShapesList(), floorOverlapDistanceInfo));
+            test(floorOverlapDistanceInfo.distance == decimal(0.0));
+            test((floorOverlapDistanceInfo.worldPoint1 - Vector3(95, 0, 0)).length() < decimal(0.05));
+            test((floorOverlapDistanceInfo.worldPoint2 - Vector3(95, decimal(-0.1), 0)).length() < decimal(0.05));
+
+            // Second sphere vs concave mesh floor (the floor is the first shape)
+            DistanceInfo floorDistanceInfo;
+            test(mWorld->computeDistance(mFloorBody->getProxyShapesList(), mSphere2ProxyShape,
+                                         floorDistanceInfo));
+            test(approxEqual(floorDistanceInfo.distance, std::sqrt(decimal(3700)) - decimal(3), decimal(0.1)));
+            test((floorDistanceInfo.worldPoint1 - Vector3(90, 0, 10)).length() < decimal(0.1));
+
+            // Nearest proxy shape to a small sphere close to the box
+            SphereShape sphereShape(1);
+            DistanceInfo nearestInfo;
+            test(mWorld->computeNearestProxyShape(&sphereShape, Transform(Vector3(10, 0, 5), Quaternion::identity()),
+                                                  10, nearestInfo));
+            test(nearestInfo.proxyShape2 == mBoxProxyShape);
+            test(approxEqual(nearestInfo.distance, decimal(1.0), decimal(0.05)));
+            test((nearestInfo.worldPoint2 - Vector3(10, 0, 3)).length() < decimal(0.05));
+
+            DistanceInfo filteredNearestInfo;
+            test(mWorld->computeNearestProxyShape(&sphereShape, Transform(Vector3(10, 0, 5), Quaternion::identity()),
+                                                  10, filteredNearestInfo, CATEGORY_2 | CATEGORY_3));
+            test(filteredNearestInfo.proxyShape2 == mCylinderProxyShape);
+            test(approxEqual(filteredNearestInfo.distance, std::sqrt(decimal(15.25)) - decimal(1), decimal(0.05)));
+
+            DistanceInfo farNearestInfo;
+            test(!mWorld->computeNearestProxyShape(&sphereShape, Transform(Vector3(10, 0, 5), Quaternion::identity()),
+                                                   decimal(0.5), farNearestInfo));
+
+            // Nearest proxy shape to a small sphere above the concave mesh floor
+            DistanceInfo floorNearestInfo;
+            test(mWorld->computeNearestProxyShape(&sphereShape, Transform(Vector3(100, 4, 8), Quaternion::identity()),
+                                                  10, floorNearestInfo));
+            test(floorNearestInfo.proxyShape2->getBody() == mFloorBody);
+            test(approxEqual(floorNearestInfo.distance, decimal(3.0), decimal(0.05)));
+            test((floorNearestInfo.worldPoint2 - Vector3(100, 0, 8)).length() < decimal(0.05));
+
+            // Nearest proxy shape to a body (its own proxy shapes are ignored)
+            DistanceInfo bodyNearestInfo;
+            test(mWorld->computeNearestProxyShape(mSphere2Body, 100, bodyNearestInfo));
+            test(bodyNearestInfo.proxyShape1 == mSphere2ProxyShape);
+            test(bodyNearestInfo.proxyShape2 == mBoxProxyShape);
+            test(approxEqual(bodyNearestInfo.distance, distanceInfo.distance, decimal(0.05)));
+        }
+
+        void testNearestQueries() {
+
+            ProxyShape* shapes[10];
+            decimal distances[10];
+
+            // Nearest proxy shapes to a point (distances to the AABBs)
+            uint nbShapes = mWorld->computeNearestProxyShapes(Vector3(10, 0, 8), 3, 100, shapes, distances);
+            test(nbShapes == 3);
+            test(shapes[0] == mBoxProxyShape);
+            test(shapes[1] == mSphere1ProxyShape);
+            test(shapes[2] == mCylinderProxyShape);
+            test(approxEqual(distances[0], decimal(5.0), decimal(0.001)));
+            test(approxEqual(distances[1], std::sqrt(decimal(29.0)), decimal(0.001)));
+            AABB cylinderAABB;
+            mCylinderShape->computeAABB(cylinderAABB, mCylinderBody->getTransform());
+            test(approxEqual(distances[2], std::sqrt(cylinderAABB.computeSquaredDistance(
+                                                AABB(Vector3(10, 0, 8), Vector3(10, 0, 8)))), decimal(0.001)));
+
+            nbShapes = mWorld->computeNearestProxyShapes(Vector3(10, 0, 8), 3, 100, shapes, distances, CATEGORY_2);
+            test(nbShapes == 1);
+            test(shapes[0] == mSphere2ProxyShape);
+
+            test(mWorld->computeNearestProxyShapes(Vector3(10, 0, 8), 3, 4, shapes, distances) == 0);
+
+            // Nearest body to a point
+            test(mWorld->computeNearestBody(Vector3(10, 0, 8), 100) == mBoxBody);
+            test(mWorld->computeNearestBody(Vector3(10, 0, 8), 100, CATEGORY_3) == mCylinderBody);
+            test(mWorld->computeNearestBody(Vector3(10, 0, 8), 1) == NULL);
+
+            // Nearest proxy shapes to a convex shape with the AABB distances
+            SphereShape sphereShape(1);
+            const Transform sphereTransform(Vector3(10, 0, 5), Quaternion::identity());
+            nbShapes = mWorld->computeNearestProxyShapes(&sphereShape, sphereTransform, 2, 100,
+                                                         shapes, distances, false);
+            test(nbShapes == 2);
+            test(shapes[0] == mBoxProxyShape);
+            test(shapes[1] == mSphere1ProxyShape);
+
+            // Nearest proxy shapes to a convex shape with the exact distances
+            nbShapes = mWorld->computeNearestProxyShapes(&sphereShape, sphereTransform, 2, 100,
+                                                         shapes, distances);
+            test(nbShapes == 2);
+            test(shapes[0] == mBoxProxyShape);
+            test(shapes[1] == mCylinderProxyShape);
+            test(approxEqual(distances[0], decimal(1.0), decimal(0.05)));
+            test(approxEqual(distances[1], std::sqrt(decimal(15.25)) - decimal(1), decimal(0.05)));
+        }
+
+        void testCulling() {
+
+            // Volume that contains the first sphere, intersects the box and excludes the others
+            Plane planes[6];
+            planes[0] = Plane(Vector3(1, 0, 0), decimal(20));
+            planes[1] = Plane(Vector3(-1, 0, 0), decimal(0));
+            planes[2] = Plane(Vector3(0, 1, 0), decimal(20));
+            planes[3] = Plane(Vector3(0, -1, 0), decimal(1));
+            planes[4] = Plane(Vector3(0, 0, 1), decimal(20));
+            planes[5] = Plane(Vector3(0, 0, -1), decimal(20));
+
+            WorldCullingCallback callback;
+            mWorld->cullProxyShapes(planes, 6, &callback);
+            test(callback.reportedShapes.size() == 2);
+            test(callback.reportedShapes.count(mSphere1ProxyShape) == 1);
+            test(callback.reportedShapes[mSphere1ProxyShape]);
+            test(callback.reportedShapes.count(mBoxProxyShape) == 1);
+            test(!callback.reportedShapes[mBoxProxyShape]);
+
+            WorldCullingCallback filteredCallback;
+            mWorld->cullProxyShapes(planes, 6, &filteredCallback, CATEGORY_2 | CATEGORY_3);
+            test(filteredCallback.reportedShapes.empty());
+
+            // The fat AABB of the cylinder intersects this volume but not its exact AABB
+            AABB cylinderAABB;
+            mCylinderShape->computeAABB(cylinderAABB, mCylinderBody->getTransform());
+            planes[3] = Plane(Vector3(0, -1, 0), -cylinderAABB.getMax().y - decimal(0.01));
+            WorldCullingCallback cylinderCallback;
+            mWorld->cullProxyShapes(planes, 6, &cylinderCallback, CATEGORY_3);
+            test(cylinderCallback.reportedShapes.empty());
+        }
+
+        void testHeightFieldUpdate() {
+
+            // Flat height field at height 0
+            float heightData[10 * 10];
+            for (int i=0; i<100; i++) heightData[i] = 0;
+            HeightFieldShape heightFieldShape(10, 10, -2, 2, heightData,
+                                              HeightFieldShape::HEIGHT_FLOAT_TYPE);
+            SphereShape sphereShape(decimal(0.5));
+
+            CollisionWorld world;
+            CollisionBody* heightFieldBody = world.createCollisionBody(Transform::identity());
+            ProxyShape* heightFieldProxyShape = heightFieldBody->addCollisionShape(&heightFieldShape,
+                                                                                   Transform::identity());
+            CollisionBody* nearBody = world.createCollisionBody(
+                        Transform(Vector3(decimal(0.5), decimal(1.5), decimal(0.5)), Quaternion::identity()));
+            ProxyShape* nearProxyShape = nearBody->addCollisionShape(&sphereShape, Transform::identity());
+            CollisionBody* farBody = world.createCollisionBody(
+                        Transform(Vector3(-4, decimal(1.5), -4), Quaternion::identity()));
+            farBody->addCollisionShape(&sphereShape, Transform::identity());
+            nearBody->setIsSleeping(true);
+            farBody->setIsSleeping(true);
+
+            const Ray ray(Vector3(decimal(0.5), 10, decimal(0.5)), Vector3(decimal(0.5), -10, decimal(0.5)));
+            RaycastInfo raycastInfo;
+            test(heightFieldProxyShape->raycast(ray, raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(0.0)));
+
+            ConcaveCollisionCallback collisionCallback;
+            collisionCallback.convexBody = nearBody;
+            world.testCollisionQuery(heightFieldProxyShape, nearProxyShape, &collisionCallback);
+            test(collisionCallback.nbContacts == 0);
+
+            // Raise a 3x3 region around the near body
+            const uint geometryVersion = heightFieldShape.getGeometryVersion();
+            float regionHeights[3 * 3];
+            for (int i=0; i<9; i++) regionHeights[i] = float(1.2);
+            world.updateHeightFieldHeights(heightFieldProxyShape, 4, 4, 3, 3, regionHeights);
+
+            // The height data has been patched and the cached triangles are invalidated
+            test(approxEqual(heightData[5 * 10 + 5], float(1.2)));
+            test(approxEqual(heightData[3 * 10 + 3], float(0.0)));
+            test(heightFieldShape.getGeometryVersion() != geometryVersion);
+
+            // Only the body in the modified area is woken up
+            test(!nearBody->isSleeping());
+            test(farBody->isSleeping());
+
+            // Queries use the new heights (stored as floats)
+            test(heightFieldProxyShape->raycast(ray, raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(float(1.2))));
+            collisionCallback.reset();
+            world.testCollisionQuery(heightFieldProxyShape, nearProxyShape, &collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+
+            // A height above the maximum height of the constructor enlarges the AABB in the
+            // broad-phase without moving the height field
+            float peakHeight = 5;
+            world.updateHeightFieldHeights(heightFieldProxyShape, 2, 7, 1, 1, &peakHeight);
+            Vector3 min, max;
+            heightFieldShape.getLocalBounds(min, max);
+            test(approxEqual(max.y, decimal(5.0)));
+            test(approxEqual(min.y, decimal(-2.0)));
+            ProxyShape* overlappingShapes[4];
+            const AABB peakAABB(Vector3(decimal(-2.6), decimal(4.5), decimal(2.4)),
+                                Vector3(decimal(-2.4), decimal(4.6), decimal(2.6)));
+            test(world.testAABBOverlap(peakAABB, overlappingShapes, 4) == 1);
+            test(overlappingShapes[0] == heightFieldProxyShape);
+            const Ray peakRay(Vector3(decimal(-2.5), 10, decimal(2.5)), Vector3(decimal(-2.5), -10, decimal(2.5)));
+            test(heightFieldProxyShape->raycast(peakRay, raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(5.0)));
+            test(heightFieldProxyShape->raycast(ray, raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(float(1.2))));
+        }
+
+        void testConcaveMeshRefit() {
+
+            // Flat grid mesh of 8 x 8 quads at height 0
+            std::vector<Vector3> vertices;
+            std::vector<uint> indices;
+            for (int j=0; j<9; j++) {
+                for (int i=0; i<9; i++) {
+                    vertices.push_back(Vector3(decimal(i - 4), 0, decimal(j - 4)));
+                }
+            }
+            for (int j=0; j<8; j++) {
+                for (int i=0; i<8; i++) {
+                    const uint v = j * 9 + i;
+                    indices.push_back(v); indices.push_back(v + 9); indices.push_back(v + 1);
+                    indices.push_back(v + 1); indices.push_back(v + 9); indices.push_back(v + 10);
+                }
+            }
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray vertexArray(81, &(vertices[0]), sizeof(Vector3), 128, &(indices[0]),
+                                            sizeof(uint), vertexType, TriangleVertexArray::INDEX_INTEGER_TYPE);
+            TriangleMesh triangleMesh;
+            triangleMesh.addSubpart(&vertexArray);
+            ConcaveMeshShape meshShape(&triangleMesh);
+            SphereShape sphereShape(decimal(0.5));
+
+            CollisionWorld world;
+            CollisionBody* meshBody = world.createCollisionBody(Transform::identity());
+            ProxyShape* meshProxyShape = meshBody->addCollisionShape(&meshShape, Transform::identity());
+            CollisionBody* nearBody = world.createCollisionBody(
+                        Transform(Vector3(decimal(0.3), 3, decimal(0.3)), Quaternion::identity()));
+            ProxyShape* nearProxyShape = nearBody->addCollisionShape(&sphereShape, Transform::identity());
+            CollisionBody* farBody = world.createCollisionBody(
+                        Transform(Vector3(50, 3, 0), Quaternion::identity()));
+            farBody->addCollisionShape(&sphereShape, Transform::identity());
+            nearBody->setIsSleeping(true);
+            farBody->setIsSleeping(true);
+
+            const Ray ray(Vector3(decimal(0.3), 10, decimal(0.3)), Vector3(decimal(0.3), -10, decimal(0.3)));
+            RaycastInfo raycastInfo;
+            test(meshProxyShape->raycast(ray, raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(0.0)));
+
+            // Move the mesh up under the near body
+            for (uint i=0; i<vertices.size(); i++) vertices[i].y = decimal(2.8);
+            const uint geometryVersion = meshShape.getGeometryVersion();
+            test(!world.refitConcaveMeshShape(meshProxyShape, decimal(1.5)));
+            test(meshShape.getGeometryVersion() != geometryVersion);
+
+            // Only the body around the mesh is woken up
+            test(!nearBody->isSleeping());
+            test(farBody->isSleeping());
+
+            // Queries use the new vertices
+            Vector3 min, max;
+            meshShape.getLocalBounds(min, max);
+            test(min.y > decimal(2.7) && max.y < decimal(2.9));
+            test(meshProxyShape->raycast(ray, raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(2.8), decimal(0.001)));
+            ConcaveCollisionCallback collisionCallback;
+            collisionCallback.convexBody = nearBody;
+            world.testCollisionQuery(meshProxyShape, nearProxyShape, &collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+
+            // Shuffle the vertices such that the triangles become very large. The refitted
+            // tree is too bad and is rebuilt.
+            const std::vector<Vector3> gridVertices = vertices;
+            for (uint i=0; i<vertices.size(); i++) vertices[i] = gridVertices[(i * 37) % 81];
+            test(world.refitConcaveMeshShape(meshProxyShape, decimal(1.5)));
+            test(!world.refitConcaveMeshShape(meshProxyShape, decimal(1.5)));
+
+            // The mesh is still hit by the ray after the rebuild
+            test(meshProxyShape->raycast(Ray(Vector3(0, 10, 0), Vector3(0, -10, 0)), raycastInfo) ||
+                 meshProxyShape->raycast(Ray(Vector3(0, -10, 0), Vector3(0, 10, 0)), raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(2.8), decimal(0.001)));
+        }
+
+        void testConcaveMeshInstanceRefit() {
+
+            // Quad mesh at height 0 and a scaled instance of it
+            std::vector<Vector3> vertices;
+            vertices.push_back(Vector3(-4, 0, -4));
+            vertices.push_back(Vector3(4, 0, -4));
+            vertices.push_back(Vector3(4, 0, 4));
+            vertices.push_back(Vector3(-4, 0, 4));
+            uint indices[6] = {0, 2, 1, 0, 3, 2};
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray vertexArray(4, &(vertices[0]), sizeof(Vector3), 2, indices,
+                                            sizeof(uint), vertexType, TriangleVertexArray::INDEX_INTEGER_TYPE);
+            TriangleMesh triangleMesh;
+            triangleMesh.addSubpart(&vertexArray);
+            ConcaveMeshShape meshShape(&triangleMesh);
+            ConcaveMeshShape instanceShape(&meshShape, Vector3(2, 1, 2));
+            SphereShape sphereShape(decimal(0.5));
+
+            // Sphere penetrating the instance (the cached triangles of the pair are filled)
+            CollisionWorld world;
+            CollisionBody* instanceBody = world.createCollisionBody(Transform::identity());
+            instanceBody->addCollisionShape(&instanceShape, Transform::identity());
+            CollisionBody* sphereBody = world.createCollisionBody(
+                        Transform(Vector3(6, decimal(0.3), 6), Quaternion::identity()));
+            sphereBody->addCollisionShape(&sphereShape, Transform::identity());
+            ConcaveCollisionCallback collisionCallback;
+            collisionCallback.convexBody = sphereBody;
+            world.testCollision(instanceBody, sphereBody, &collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            test(approxEqual(collisionCallback.maxPenetrationDepth, decimal(0.2), decimal(0.001)));
+
+            // Move the mesh down and refit the shape that owns the tree. The instance sees
+            // the new geometry version and does not use its cached triangles anymore.
+            for (uint i=0; i<vertices.size(); i++) vertices[i].y = decimal(-1.0);
+            const uint instanceGeometryVersion = instanceShape.getGeometryVersion();
+            meshShape.refit();
+            test(instanceShape.getGeometryVersion() != instanceGeometryVersion);
+            collisionCallback.reset();
+            world.testCollision(instanceBody, sphereBody, &collisionCallback);
+            test(collisionCallback.nbContacts == 0);
+
+            // Move the mesh up again (refit from the instance this time)
+            for (uint i=0; i<vertices.size(); i++) vertices[i].y = decimal(0.1);
+            const uint meshGeometryVersion = meshShape.getGeometryVersion();
+            instanceShape.refit();
+            test(meshShape.getGeometryVersion() != meshGeometryVersion);
+            collisionCallback.reset();
+            world.testCollision(instanceBody, sphereBody, &collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            test(approxEqual(collisionCallback.maxPenetrationDepth, decimal(0.3), decimal(0.001)));
+        }
+
+        void testCompoundShape() {
+
+            // Compound shape with two boxes and a convex hull rotated around the y axis
+            BoxShape boxShape(Vector3(1, 1, 1));
+            decimal cubePoints[24] = {-1, -1, -1,  1, -1, -1,  1, 1, -1,  -1, 1, -1,
+                                      -1, -1,  1,  1, -1,  1,  1, 1,  1,  -1, 1,  1};
+            ConvexHull convexHull;
+            test(convexHull.compute(cubePoints, 8, 3 * sizeof(decimal)));
+            ConvexMeshShape hullShape(convexHull, decimal(0.0));
+
+            CompoundShape compoundShape;
+            test(compoundShape.addChildShape(&boxShape, Transform::identity()) == 0);
+            test(compoundShape.addChildShape(&boxShape, Transform(Vector3(4, 0, 0),
+                                                                  Quaternion::identity())) == 1);
+            test(compoundShape.addChildShape(&hullShape, Transform(Vector3(8, 0, 0),
+                                                                   Quaternion(0, PI / decimal(4.0), 0))) == 2);
+            test(compoundShape.getNbChildShapes() == 3);
+            test(compoundShape.getChildShape(2) == &hullShape);
+            test(!compoundShape.isConvex());
+            Vector3 min, max;
+            compoundShape.getLocalBounds(min, max);
+            test(min.x < decimal(-0.99) && max.x > decimal(9.4));
+
+            SphereShape sphereShape(decimal(0.5));
+
+            CollisionWorld world;
+            CollisionBody* compoundBody = world.createCollisionBody(
+                        Transform(Vector3(20, 0, 0), Quaternion::identity()));
+            ProxyShape* compoundProxyShape = compoundBody->addCollisionShape(&compoundShape,
+                                                                             Transform::identity());
+            CollisionBody* sphereBody = world.createCollisionBody(
+                        Transform(Vector3(24, decimal(1.4), 0), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(&sphereShape,
+                                                                         Transform::identity());
+
+            // Sphere resting on the second box
+            ConcaveCollisionCallback collisionCallback;
+            collisionCallback.convexBody = sphereBody;
+            world.testCollisionQuery(compoundProxyShape, sphereProxyShape, &collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            test(approxEqual(collisionCallback.maxPenetrationDepth, decimal(0.1), decimal(0.001)));
+            test(approxEqual(collisionCallback.normal.y, decimal(-1.0), decimal(0.001)));
+            collisionCallback.reset();
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+
+            // Sphere above the gap between the two boxes (the AABBs of the shapes overlap)
+            sphereBody->setTransform(Transform(Vector3(22, decimal(1.4), 0), Quaternion::identity()));
+            collisionCallback.reset();
+            world.testCollisionQuery(compoundProxyShape, sphereProxyShape, &collisionCallback);
+            test(collisionCallback.nbContacts == 0);
+
+            // Sphere resting on the rotated convex hull
+            sphereBody->setTransform(Transform(Vector3(decimal(29.2), decimal(1.4), 0), Quaternion::identity()));
+            collisionCallback.reset();
+            world.testCollisionQuery(compoundProxyShape, sphereProxyShape, &collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            test(approxEqual(collisionCallback.maxPenetrationDepth, decimal(0.1), decimal(0.01)));
+            test(approxEqual(collisionCallback.normal.y, decimal(-1.0), decimal(0.01)));
+
+            // Raycasting
+            RaycastInfo raycastInfo;
+            test(compoundProxyShape->raycast(Ray(Vector3(15, 0, 0), Vector3(35, 0, 0)), raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.x, decimal(19.0), decimal(0.05)));
+            test(approxEqual(raycastInfo.worldNormal.x, decimal(-1.0), decimal(0.001)));
+            test(approxEqual(raycastInfo.hitFraction, decimal(0.2), decimal(0.005)));
+            test(compoundProxyShape->raycast(Ray(Vector3(35, 0, 0), Vector3(15, 0, 0)), raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.x, decimal(28.0) + std::sqrt(decimal(2.0)), decimal(0.001)));
+            test(compoundProxyShape->raycast(Ray(Vector3(decimal(29.3), 10, 0), Vector3(decimal(29.3), -10, 0)),
+                                             raycastInfo));
+            test(approxEqual(raycastInfo.worldPoint.y, decimal(1.0), decimal(0.001)));
+            test(approxEqual(raycastInfo.worldNormal.y, decimal(1.0), decimal(0.001)));
+            test(!compoundProxyShape->raycast(Ray(Vector3(decimal(29.5), 10, 0), Vector3(decimal(29.5), -10, 0)),
+                                              raycastInfo));
+            test(!compoundProxyShape->raycast(Ray(Vector3(22, 10, 0), Vector3(22, -10, 0)), raycastInfo));
+
+            // Point inside tests
+            test(compoundProxyShape->testPointInside(Vector3(24, decimal(0.5), 0)));
+            test(compoundProxyShape->testPointInside(Vector3(decimal(29.3), 0, 0)));
+            test(!compoundProxyShape->testPointInside(Vector3(22, 0, 0)));
+            test(!compoundProxyShape->testPointInside(Vector3(decimal(29.5), 0, 0)));
+
+            // Overlap queries
+            ProxyShape* shapes[10];
+            SphereShape querySphere(decimal(0.5));
+            test(world.testOverlap(&querySphere, Transform(Vector3(24, decimal(1.4), 2), Quaternion::identity()),
+                                   shapes, 10, CATEGORY_1) == 0);
+            test(world.testOverlap(&querySphere, Transform(Vector3(24, decimal(1.4), 0), Quaternion::identity()),
+                                   shapes, 10) == 1);
+            test(world.testOverlap(&querySphere, Transform(Vector3(22, 0, 0), Quaternion::identity()),
+                                   shapes, 10) == 0);
+
+            // Convex cast
+            ClosestConvexCastCallback castCallback;
+            world.convexCast(&querySphere, Transform(Vector3(24, 5, 5), Quaternion::identity()),
+                             Transform(Vector3(24, -5, 5), Quaternion::identity()), &castCallback);
+            test(!castCallback.isHit);
+            castCallback.reset();
+            world.convexCast(&querySphere, Transform(Vector3(24, 5, 0), Quaternion::identity()),
+                             Transform(Vector3(24, -5, 0), Quaternion::identity()), &castCallback);
+            test(castCallback.isHit);
+            test(castCallback.body == compoundBody);
+            test(approxEqual(castCallback.hitFraction, decimal(0.35), decimal(0.001)));
+            test(approxEqual(castCallback.worldNormal.y, decimal(1.0), decimal(0.01)));
+
+            // Distance query
+            sphereBody->setTransform(Transform(Vector3(24, 3, 0), Quaternion::identity()));
+            DistanceInfo distanceInfo;
+            test(world.computeDistance(compoundProxyShape, sphereProxyShape, distanceInfo));
+            test(approxEqual(distanceInfo.distance, decimal(1.5), decimal(0.01)));
+            test((distanceInfo.worldPoint1 - Vector3(24, 1, 0)).length() < decimal(0.01));
+
+            // Distance query with the sphere overlapping the second box
+            sphereBody->setTransform(Transform(Vector3(24, decimal(1.4), 0), Quaternion::identity()));
+            DistanceInfo overlapDistanceInfo;
+            test(world.computeDistance(compoundProxyShape, sphereProxyShape, overlapDistanceInfo));
+            test(overlapDistanceInfo.distance == decimal(0.0));
+            test((overlapDistanceInfo.worldPoint1 - Vector3(24, 1, 0)).length() < decimal(0.01));
+            test((overlapDistanceInfo.worldPoint2 - Vector3(24, decimal(0.9), 0)).length() < decimal(0.01));
+        }
+
+        void testCompoundBroadPhase() {
+
+            BoxShape boxShape(Vector3(1, 1, 1));
+            SphereShape sphereShape(decimal(0.5));
+
+            // Body with four boxes along the x axis (the compound mode is enabled after
+            // two boxes have been added)
+            CollisionWorld world;
+            CollisionBody* compoundBody = world.createCollisionBody(
+                        Transform(Vector3(50, 0, 0), Quaternion::identity()));
+            ProxyShape* boxProxyShapes[4];
+            for (uint i=0; i<4; i++) {
+                if (i == 2) {
+                    test(!compoundBody->isCompoundBroadPhaseEnabled());
+                    compoundBody->setIsCompoundBroadPhaseEnabled(true);
+                    test(compoundBody->isCompoundBroadPhaseEnabled());
+                }
+                boxProxyShapes[i] = compoundBody->addCollisionShape(&boxShape,
+                                            Transform(Vector3(decimal(3 * i), 0, 0), Quaternion::identity()));
+            }
+
+            CollisionBody* sphereBody = world.createCollisionBody(
+                        Transform(Vector3(53, decimal(1.4), 0), Quaternion::identity()));
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(&sphereShape, Transform::identity());
+
+            // Sphere resting on the second box
+            ConcaveCollisionCallback collisionCallback;
+            collisionCallback.convexBody = sphereBody;
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            test(approxEqual(collisionCallback.maxPenetrationDepth, decimal(0.1), decimal(0.001)));
+
+            // Sphere above the gap between the second and the third boxes
+            sphereBody->setTransform(Transform(Vector3(decimal(54.5), decimal(1.4), 0), Quaternion::identity()));
+            collisionCallback.reset();
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts == 0);
+
+            // Move the compound body under the sphere
+            compoundBody->setTransform(Transform(Vector3(decimal(51.5), 0, 0), Quaternion::identity()));
+            collisionCallback.reset();
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+
+            // Raycasting
+            Ray rays[3] = {Ray(Vector3(40, 0, 0), Vector3(70, 0, 0)),
+                           Ray(Vector3(decimal(61.0), 10, 0), Vector3(decimal(61.0), -10, 0)),
+                           Ray(Vector3(decimal(59.0), 10, 0), Vector3(decimal(59.0), -10, 0))};
+            RaycastBatchHit hits[3];
+            world.raycastBatch(rays, 3, hits);
+            test(hits[0].hasHit);
+            test(hits[0].proxyShape == boxProxyShapes[0]);
+            test(approxEqual(hits[0].worldPoint.x, decimal(50.5), decimal(0.05)));
+            test(hits[1].hasHit);
+            test(hits[1].proxyShape == boxProxyShapes[3]);
+            test(hits[1].body == compoundBody);
+            test(approxEqual(hits[1].worldPoint.y, decimal(1.0), decimal(0.05)));
+            test(!hits[2].hasHit);
+
+            // Overlap, nearest and culling queries
+            ProxyShape* shapes[10];
+            test(world.testAABBOverlap(AABB(Vector3(57, -1, -1), Vector3(58, 1, 1)), shapes, 10) == 1);
+            test(shapes[0] == boxProxyShapes[2]);
+            test(world.testAABBOverlap(AABB(Vector3(decimal(58.9), -1, -1), Vector3(decimal(59.1), 1, 1)), shapes, 10) == 0);
+            test(world.testOverlap(&sphereShape, Transform(Vector3(decimal(51.5), decimal(1.2), 0),
+                                                           Quaternion::identity()), shapes, 10) == 1);
+            test(shapes[0] == boxProxyShapes[0]);
+            test(world.computeNearestBody(Vector3(70, 0, 0), 100) == compoundBody);
+            decimal distances[10];
+            test(world.computeNearestProxyShapes(Vector3(70, 0, 0), 2, 100, shapes, distances) == 2);
+            test(shapes[0] == boxProxyShapes[3]);
+            test(shapes[1] == sphereProxyShape);
+            test(distances[0] < distances[1]);
+            test(world.computeNearestProxyShapes(Vector3(decimal(54.5), 10, 0), 1, 100, shapes, distances) == 1);
+            test(shapes[0] == sphereProxyShape);
+
+            Plane planes[2];
+            planes[0] = Plane(Vector3(-1, 0, 0), decimal(-59));
+            planes[1] = Plane(Vector3(1, 0, 0), decimal(70));
+            WorldCullingCallback cullingCallback;
+            world.cullProxyShapes(planes, 2, &cullingCallback);
+            test(cullingCallback.reportedShapes.size() == 1);
+            test(cullingCallback.reportedShapes.count(boxProxyShapes[3]) == 1);
+
+            // Remove the box under the sphere
+            compoundBody->removeCollisionShape(boxProxyShapes[1]);
+            collisionCallback.reset();
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts == 0);
+            boxProxyShapes[1] = compoundBody->addCollisionShape(&boxShape,
+                                        Transform(Vector3(3, 0, 0), Quaternion::identity()));
+
+            // Disable the compound mode
+            compoundBody->setIsCompoundBroadPhaseEnabled(false);
+            test(!compoundBody->isCompoundBroadPhaseEnabled());
+            collisionCallback.reset();
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            test(world.testAABBOverlap(AABB(Vector3(57, -1, -1), Vector3(58, 1, 1)), shapes, 10) == 1);
+            test(shapes[0] == boxProxyShapes[2]);
+        }
+
+        void testCompoundCulling() {
+
+            BoxShape boxShape(Vector3(1, 1, 1));
+
+            // Body in compound mode with four boxes along its local x axis. The body is
+            // rotated such that the boxes are along the world y axis at y = 0, 3, 6, 9.
+            CollisionWorld world;
+            CollisionBody* compoundBody = world.createCollisionBody(
+                        Transform(Vector3(100, 0, 0),
+                                  Quaternion(0, 0, PI / decimal(2.0))));
+            compoundBody->setIsCompoundBroadPhaseEnabled(true);
+            ProxyShape* boxProxyShapes[4];
+            for (uint i=0; i<4; i++) {
+                boxProxyShapes[i] = compoundBody->addCollisionShape(&boxShape,
+                                            Transform(Vector3(decimal(3 * i), 0, 0), Quaternion::identity()));
+            }
+
+            // Volume that contains the whole body
+            Plane planes[4];
+            planes[0] = Plane(Vector3(1, 0, 0), decimal(110));
+            planes[1] = Plane(Vector3(-1, 0, 0), decimal(-90));
+            planes[2] = Plane(Vector3(0, 1, 0), decimal(20));
+            planes[3] = Plane(Vector3(0, -1, 0), decimal(10));
+            WorldCullingCallback callback;
+            world.cullProxyShapes(planes, 4, &callback);
+            test(callback.reportedShapes.size() == 4);
+            for (uint i=0; i<4; i++) {
+                test(callback.reportedShapes.count(boxProxyShapes[i]) == 1);
+                test(callback.reportedShapes[boxProxyShapes[i]]);
+            }
+
+            // Plane that straddles the body between the second and the third boxes
+            planes[2] = Plane(Vector3(0, 1, 0), decimal(4.5));
+            WorldCullingCallback straddlingCallback;
+            world.cullProxyShapes(planes, 4, &straddlingCallback);
+            test(straddlingCallback.reportedShapes.size() == 2);
+            test(straddlingCallback.reportedShapes.count(boxProxyShapes[0]) == 1);
+            test(straddlingCallback.reportedShapes[boxProxyShapes[0]]);
+            test(straddlingCallback.reportedShapes.count(boxProxyShapes[1]) == 1);
+            test(straddlingCallback.reportedShapes[boxProxyShapes[1]]);
+
+            // Plane that straddles the second box
+            planes[2] = Plane(Vector3(0, 1, 0), decimal(3.5));
+            WorldCullingCallback boxCallback;
+            world.cullProxyShapes(planes, 4, &boxCallback);
+            test(boxCallback.reportedShapes.size() == 2);
+            test(boxCallback.reportedShapes[boxProxyShapes[0]]);
+            test(boxCallback.reportedShapes.count(boxProxyShapes[1]) == 1);
+            test(!boxCallback.reportedShapes[boxProxyShapes[1]]);
+        }
+
+        void testCollisionShapesEdit() {
+
+            BoxShape boxShape(Vector3(1, 1, 1));
+            SphereShape sphereShape(decimal(0.5));
+
+            // The collision shapes added during the edit are not in the broad-phase
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(Transform::identity());
+            CollisionBody* sphereBody = world.createCollisionBody(
+                        Transform(Vector3(3, decimal(1.4), 1), Quaternion::identity()));
+            sphereBody->addCollisionShape(&sphereShape, Transform::identity());
+            ProxyShape* shapes[10];
+            body->beginCollisionShapesEdit();
+            body->addCollisionShape(&boxShape, Transform::identity());
+            ProxyShape* removedShape = body->addCollisionShape(&boxShape, Transform(Vector3(6, 0, 0),
+                                                                                    Quaternion::identity()));
+            ProxyShape* boxProxyShape = body->addCollisionShape(&boxShape, Transform(Vector3(3, 0, 0),
+                                                                                     Quaternion::identity()));
+            body->removeCollisionShape(removedShape);
+            body->setTransform(Transform(Vector3(0, 0, 1), Quaternion::identity()));
+            test(world.testAABBOverlap(AABB(Vector3(-1, -1, 0), Vector3(4, decimal(0.5), 2)), shapes, 10) == 0);
+            body->endCollisionShapesEdit();
+
+            test(world.testAABBOverlap(AABB(Vector3(-1, -1, 0), Vector3(4, decimal(0.5), 2)), shapes, 10) == 2);
+            test(world.testAABBOverlap(AABB(Vector3(6, -1, 0), Vector3(7, decimal(0.5), 2)), shapes, 10) == 0);
+            ConcaveCollisionCallback collisionCallback;
+            collisionCallback.convexBody = sphereBody;
+            world.testCollision(&collisionCallback);
+            test(collisionCallback.nbContacts > 0);
+            RaycastInfo raycastInfo;
+            test(body->raycast(Ray(Vector3(3, 10, 1), Vector3(3, -10, 1)), raycastInfo));
+            test(raycastInfo.proxyShape == boxProxyShape);
+
+            // The mass properties of a rigid body are recomputed at the end of the edit
+            DynamicsWorld dynamicsWorld(Vector3(0, decimal(-9.81), 0));
+            RigidBody* rigidBody = dynamicsWorld.createRigidBody(Transform::identity());
+            rigidBody->beginCollisionShapesEdit();
+            for (uint i=0; i<4; i++) {
+                rigidBody->addCollisionShape(&boxShape, Transform(Vector3(decimal(2 * i), 0, 0),
+                                                                  Quaternion::identity()), decimal(2.0));
+            }
+            test(approxEqual(rigidBody->getMass(), decimal(1.0), decimal(0.0001)));
+            rigidBody->endCollisionShapesEdit();
+            test(approxEqual(rigidBody->getMass(), decimal(8.0), decimal(0.0001)));
+            RigidBody* referenceBody = dynamicsWorld.createRigidBody(Transform::identity());
+            for (uint i=0; i<4; i++) {
+                referenceBody->addCollisionShape(&boxShape, Transform(Vector3(decimal(2 * i), 0, 0),
+                                                                      Quaternion::identity()), decimal(2.0));
+            }
+            for (int i=0; i<3; i++) {
+                for (int j=0; j<3; j++) {
+                    test(approxEqual(rigidBody->getInertiaTensorLocal()[i][j],
+                                     referenceBody->getInertiaTensorLocal()[i][j], decimal(0.0001)));
+                }
+            }
+        }
  };
 
 }
@@ -0,0 +1,378 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CONVEX_HULL_H
+#define TEST_CONVEX_HULL_H
+
+// Libraries
+#include "reactphysics3d.h"
+#include <vector>
+#include <cmath>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ConvexMeshSupportShape
+/**
+ * Convex mesh shape that gives access to its support points and adjacency arrays
+ * for the tests.
+ */
+class ConvexMeshSupportShape : public ConvexMeshShape {
+
+    public :
+
+        ConvexMeshSupportShape(TriangleVertexArray* triangleVertexArray, bool isEdgesInformationUsed)
+            : ConvexMeshShape(triangleVertexArray, isEdgesInformationUsed, 0) {
+
+        }
+
+        ConvexMeshSupportShape(const ConvexMeshShape* meshShape, const Vector3& scaling)
+            : ConvexMeshShape(meshShape, scaling) {
+
+        }
+
+        Vector3 getSupportPoint(const Vector3& direction, void** cachedCollisionData) const {
+            return getLocalSupportPointWithoutMargin(direction, cachedCollisionData);
+        }
+
+        uint getNbNeighbors(uint vertexIndex) const {
+            return mEdgesAdjacencyOffsets[vertexIndex + 1] -
+                   mEdgesAdjacencyOffsets[vertexIndex];
+        }
+};
+
+// Class TestConvexHull
+/**
+ * Unit test for the ConvexHull class.
+ */
+class TestConvexHull : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Corners of a cube of size 2 with points inside, on the faces and on the edges
+        std::vector<decimal> mCubePoints;
+
+        /// Points on a sphere of radius 1 with points inside
+        std::vector<decimal> mSpherePoints;
+
+        /// Number of points of the sphere that are on its surface
+        uint mNbSphereSurfacePoints;
+
+        // ---------- Methods ---------- //
+
+        void addPoint(std::vector<decimal>& points, decimal x, decimal y, decimal z) {
+            points.push_back(x);
+            points.push_back(y);
+            points.push_back(z);
+        }
+
+        /// Check that a hull is a closed and convex triangle mesh that contains all the points
+        void checkHull(const ConvexHull& hull, const std::vector<decimal>& points) {
+
+            // Euler formula for a closed triangle mesh
+            test(int(hull.getNbVertices()) - int(hull.getNbEdges()) + int(hull.getNbTriangles()) == 2);
+            test(2 * hull.getNbEdges() == 3 * hull.getNbTriangles());
+
+            for (uint t=0; t<hull.getNbTriangles(); t++) {
+
+                const Vector3& v1 = hull.getVertex(hull.getTriangleVertexIndex(t, 0));
+                const Vector3& v2 = hull.getVertex(hull.getTriangleVertexIndex(t, 1));
+                const Vector3& v3 = hull.getVertex(hull.getTriangleVertexIndex(t, 2));
+                const Vector3 normal = (v2 - v1).cross(v3 - v1).getUnit();
+
+                // All the points are behind the plane of the triangle (outward normal)
+                decimal maxDistance = DECIMAL_SMALLEST;
+                for (uint i=0; i<points.size(); i += 3) {
+                    const Vector3 point(points[i], points[i + 1], points[i + 2]);
+                    maxDistance = std::max(maxDistance, normal.dot(point - v1));
+                }
+                test(maxDistance < decimal(0.001));
+
+                // The neighbor of the triangle shares the edge in the opposite direction
+                for (uint k=0; k<3; k++) {
+                    const uint neighbor = hull.getTriangleNeighbor(t, k);
+                    const uint a = hull.getTriangleVertexIndex(t, k);
+                    const uint b = hull.getTriangleVertexIndex(t, (k + 1) % 3);
+                    bool isEdgeShared = false;
+                    for (uint j=0; j<3; j++) {
+                        if (hull.getTriangleVertexIndex(neighbor, j) == b &&
+                            hull.getTriangleVertexIndex(neighbor, (j + 1) % 3) == a &&
+                            hull.getTriangleNeighbor(neighbor, j) == t) {
+                            isEdgeShared = true;
+                        }
+                    }
+                    test(isEdgeShared);
+                }
+            }
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestConvexHull(const std::string& name) : Test(name) {
+
+            // Cube
+            for (int i=0; i<8; i++) {
+                addPoint(mCubePoints, i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1);
+            }
+            for (int i=0; i<50; i++) {
+                addPoint(mCubePoints, decimal(std::sin(i * 1.1)), decimal(std::cos(i * 0.7)),
+                         decimal(std::sin(i * 2.3) * 0.9));
+            }
+            addPoint(mCubePoints, 1, decimal(0.5), decimal(-0.3));
+            addPoint(mCubePoints, decimal(-0.2), -1, decimal(0.7));
+            addPoint(mCubePoints, 1, 1, decimal(0.4));
+            addPoint(mCubePoints, 0, 0, 0);
+
+            // Sphere (points on a spiral)
+            mNbSphereSurfacePoints = 300;
+            for (uint i=0; i<mNbSphereSurfacePoints; i++) {
+                const decimal y = decimal(1.0) - decimal(2.0) * (decimal(i) + decimal(0.5)) /
+                                                 decimal(mNbSphereSurfacePoints);
+                const decimal radius = std::sqrt(decimal(1.0) - y * y);
+                const decimal angle = decimal(2.39996323) * decimal(i);
+                addPoint(mSpherePoints, radius * std::cos(angle), y, radius * std::sin(angle));
+            }
+            for (int i=0; i<200; i++) {
+                const decimal scale = decimal(0.9) * decimal(i) / decimal(200);
+                const Vector3 point = scale * Vector3(decimal(std::cos(i * 0.3)), decimal(std::sin(i * 0.5)),
+                                                      decimal(std::sin(i * 0.3))).getUnit();
+                addPoint(mSpherePoints, point.x, point.y, point.z);
+            }
+        }
+
+        /// Run the tests
+        void run() {
+            testCube();
+            testSphere();
+            testVertexBudget();
+            testDegenerateCases();
+            testConvexMeshShape();
+            testConvexMeshSupport();
+        }
+
+        /// Test the hull of the points of a cube
+        void testCube() {
+
+            ConvexHull hull;
+            test(hull.compute(&mCubePoints[0], mCubePoints.size() / 3, 3 * sizeof(decimal)));
+
+            // Only the corners of the cube are vertices of the hull
+            test(hull.getNbVertices() == 8);
+            test(hull.getNbTriangles() == 12);
+            test(hull.getNbEdges() == 18);
+            for (uint i=0; i<hull.getNbVertices(); i++) {
+                const Vector3& vertex = hull.getVertex(i);
+                test(std::abs(vertex.x) == 1 && std::abs(vertex.y) == 1 && std::abs(vertex.z) == 1);
+            }
+
+            checkHull(hull, mCubePoints);
+        }
+
+        /// Test the hull of points on a sphere
+        void testSphere() {
+
+            ConvexHull hull;
+            test(hull.compute(&mSpherePoints[0], mSpherePoints.size() / 3, 3 * sizeof(decimal)));
+
+            // All the points on the sphere are vertices of the hull
+            test(hull.getNbVertices() == mNbSphereSurfacePoints);
+            for (uint i=0; i<hull.getNbVertices(); i++) {
+                test(approxEqual(hull.getVertex(i).length(), decimal(1.0), decimal(0.001)));
+            }
+
+            checkHull(hull, mSpherePoints);
+        }
+
+        /// Test the hull simplified to a maximum number of vertices
+        void testVertexBudget() {
+
+            ConvexHull hull;
+            test(hull.compute(&mSpherePoints[0], mSpherePoints.size() / 3, 3 * sizeof(decimal), 24));
+
+            test(hull.getNbVertices() <= 24);
+            test(hull.getNbVertices() >= 20);
+            test(int(hull.getNbVertices()) - int(hull.getNbEdges()) + int(hull.getNbTriangles()) == 2);
+
+            // The simplified hull is inside the sphere and still contains its center
+            std::vector<decimal> center(3, decimal(0.0));
+            checkHull(hull, center);
+            for (uint i=0; i<hull.getNbVertices(); i++) {
+                test(approxEqual(hull.getVertex(i).length(), decimal(1.0), decimal(0.001)));
+            }
+
+            // The simplified hull of the cube points is the cube
+            test(hull.compute(&mCubePoints[0], mCubePoints.size() / 3, 3 * sizeof(decimal), 8));
+            test(hull.getNbVertices() == 8);
+            checkHull(hull, mCubePoints);
+        }
+
+        /// Test the points that do not have a hull
+        void testDegenerateCases() {
+
+            ConvexHull hull;
+
+            // Not enough points
+            test(!hull.compute(&mCubePoints[0], 3, 3 * sizeof(decimal)));
+            test(hull.getNbVertices() == 0);
+
+            // Points on a plane
+            std::vector<decimal> planePoints;
+            for (int i=0; i<20; i++) {
+                addPoint(planePoints, decimal(std::cos(i * 0.4)), 2, decimal(std::sin(i * 0.9)));
+            }
+            test(hull.compute(&mCubePoints[0], mCubePoints.size() / 3, 3 * sizeof(decimal)));
+            test(!hull.compute(&planePoints[0], planePoints.size() / 3, 3 * sizeof(decimal)));
+            test(hull.getNbVertices() == 0);
+            test(hull.getNbTriangles() == 0);
+            test(hull.getNbEdges() == 0);
+
+            // Points on a line
+            std::vector<decimal> linePoints;
+            for (int i=0; i<10; i++) {
+                addPoint(linePoints, decimal(i), decimal(2 * i), decimal(-i));
+            }
+            test(!hull.compute(&linePoints[0], linePoints.size() / 3, 3 * sizeof(decimal)));
+        }
+
+        /// Test a convex mesh shape created from a hull
+        void testConvexMeshShape() {
+
+            ConvexHull cubeHull;
+            cubeHull.compute(&mCubePoints[0], mCubePoints.size() / 3, 3 * sizeof(decimal));
+            ConvexHull sphereHull;
+            sphereHull.compute(&mSpherePoints[0], mSpherePoints.size() / 3, 3 * sizeof(decimal));
+
+            ConvexMeshShape cubeShape(cubeHull, 0);
+            ConvexMeshShape sphereShape(sphereHull, 0);
+
+            test(cubeShape.isEdgesInformationUsed());
+            test(cubeShape.hasFacePlanes());
+            test(cubeShape.getNbFacePlanes() == 6);
+            test(sphereShape.hasFacePlanes());
+
+            Vector3 min, max;
+            cubeShape.getLocalBounds(min, max);
+            test(min == Vector3(-1, -1, -1) && max == Vector3(1, 1, 1));
+
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(Transform::identity());
+            ProxyShape* cubeProxyShape = body->addCollisionShape(&cubeShape, Transform::identity());
+            ProxyShape* sphereProxyShape = body->addCollisionShape(&sphereShape, Transform::identity());
+
+            // Raycast against the faces of the cube
+            RaycastInfo raycastInfo;
+            test(cubeProxyShape->raycast(Ray(Vector3(-10, decimal(0.2), 0), Vector3(10, decimal(0.2), 0)),
+                                         raycastInfo));
+            test(approxEqual(raycastInfo.hitFraction, decimal(0.45), decimal(0.0001)));
+            test(approxEqual(raycastInfo.worldNormal.x, decimal(-1.0), decimal(0.0001)));
+
+            // Point inside tests
+            test(cubeProxyShape->testPointInside(Vector3(decimal(0.9), decimal(-0.9), decimal(0.5))));
+            test(!cubeProxyShape->testPointInside(Vector3(decimal(1.1), 0, 0)));
+            for (int i=0; i<20; i++) {
+                const Vector3 direction = Vector3(decimal(std::cos(i * 0.7)), decimal(std::sin(i * 1.3)),
+                                                  decimal(std::sin(i * 0.7))).getUnit();
+                test(sphereProxyShape->testPointInside(decimal(0.9) * direction));
+                test(!sphereProxyShape->testPointInside(decimal(1.1) * direction));
+
+                // The hit point of a ray towards the center is close to the sphere
+                test(sphereProxyShape->raycast(Ray(decimal(3.0) * direction, Vector3(0, 0, 0)),
+                                               raycastInfo));
+                test(raycastInfo.worldPoint.length() > decimal(0.95));
+                test(raycastInfo.worldPoint.length() < decimal(1.0001));
+            }
+        }
+
+        /// Test the support points of a convex mesh built from a triangle vertex array
+        void testConvexMeshSupport() {
+
+            ConvexHull hull;
+            test(hull.compute(&mSpherePoints[0], mSpherePoints.size() / 3, 3 * sizeof(decimal)));
+
+            // Triangle vertex array with the triangles of the hull (each edge is shared by
+            // two triangles)
+            std::vector<float> vertices;
+            for (uint i=0; i<hull.getNbVertices(); i++) {
+                vertices.push_back(float(hull.getVertex(i).x));
+                vertices.push_back(float(hull.getVertex(i).y));
+                vertices.push_back(float(hull.getVertex(i).z));
+            }
+            std::vector<uint> indices;
+            for (uint t=0; t<hull.getNbTriangles(); t++) {
+                for (uint k=0; k<3; k++) indices.push_back(hull.getTriangleVertexIndex(t, k));
+            }
+            TriangleVertexArray vertexArray(hull.getNbVertices(), &vertices[0], 3 * sizeof(float),
+                                            hull.getNbTriangles(), &indices[0], sizeof(uint),
+                                            TriangleVertexArray::VERTEX_FLOAT_TYPE,
+                                            TriangleVertexArray::INDEX_INTEGER_TYPE);
+
+            ConvexMeshSupportShape edgesShape(&vertexArray, true);
+            ConvexMeshSupportShape bruteForceShape(&vertexArray, false);
+
+            // The duplicated edges have been removed from the adjacency arrays
+            uint nbNeighbors = 0;
+            for (uint i=0; i<hull.getNbVertices(); i++) {
+                test(edgesShape.getNbNeighbors(i) >= 3);
+                nbNeighbors += edgesShape.getNbNeighbors(i);
+            }
+            test(nbNeighbors == 2 * hull.getNbEdges());
+
+            // Compare the hill-climbing and brute force support points with non-uniform scaling
+            const Vector3 scaling(3, decimal(0.5), decimal(1.5));
+            ConvexMeshSupportShape scaledEdgesShape(&edgesShape, scaling);
+            ConvexMeshSupportShape scaledBruteForceShape(&bruteForceShape, scaling);
+            void* edgesCache = NULL;
+            void* bruteForceCache = NULL;
+            for (int i=0; i<200; i++) {
+                const Vector3 direction(decimal(std::cos(i * 0.37)), decimal(std::sin(i * 1.13)),
+                                        decimal(std::sin(i * 0.61)));
+                const Vector3 edgesPoint = scaledEdgesShape.getSupportPoint(direction, &edgesCache);
+                const Vector3 bruteForcePoint = scaledBruteForceShape.getSupportPoint(direction,
+                                                                                      &bruteForceCache);
+                test(approxEqual(edgesPoint.dot(direction), bruteForcePoint.dot(direction), decimal(0.0001)));
+
+                // The support point of a direction is the farthest scaled vertex
+                decimal maxDotProduct = DECIMAL_SMALLEST;
+                for (uint v=0; v<hull.getNbVertices(); v++) {
+                    maxDotProduct = std::max(maxDotProduct, (hull.getVertex(v) * scaling).dot(direction));
+                }
+                test(approxEqual(edgesPoint.dot(direction), maxDotProduct, decimal(0.0001)));
+
+                // The same direction returns the cached support point
+                test(scaledEdgesShape.getSupportPoint(direction, &edgesCache) == edgesPoint);
+            }
+            free(edgesCache);
+            free(bruteForceCache);
+        }
+ };
+
+}
+
+#endif
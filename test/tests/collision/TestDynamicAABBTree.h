@@ -30,6 +30,7 @@
 #include "Test.h"
 #include "collision/broadphase/DynamicAABBTree.h"
 #include <vector>
+#include <map>
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -76,6 +77,72 @@ class DynamicTreeRaycastCallback : public DynamicAABBTreeRaycastCallback {
         }
 };
 
+class DynamicTreeNearestCallback : public DynamicAABBTreeNearestCallback {
+
+    public:
+
+        int mIgnoredNodeId;
+
+        DynamicTreeNearestCallback() : mIgnoredNodeId(-1) {
+
+        }
+
+        // Called to compute the distance to a leaf node (the distance to its AABB)
+        virtual decimal computeNodeDistance(int32 nodeId, decimal lowerBoundDistance,
+                                            decimal maxDistance) {
+            return nodeId == mIgnoredNodeId ? decimal(-1.0) : lowerBoundDistance;
+        }
+};
+
+class DynamicTreeCullingCallback : public DynamicAABBTreeCullingCallback {
+
+    public:
+
+        std::map<int, bool> mReportedNodes;
+
+        // Called for each leaf node that is not culled
+        virtual void notifyNodeInsidePlanes(int32 nodeId, bool isFullyInside) {
+            mReportedNodes[nodeId] = isFullyInside;
+        }
+
+        void reset() {
+            mReportedNodes.clear();
+        }
+
+        bool isReported(int nodeId) const {
+            return mReportedNodes.find(nodeId) != mReportedNodes.end();
+        }
+
+        bool isFullyInside(int nodeId) const {
+            std::map<int, bool>::const_iterator it = mReportedNodes.find(nodeId);
+            return it != mReportedNodes.end() && it->second;
+        }
+};
+
+class DynamicTreeRefitCallback : public DynamicAABBTreeRefitCallback {
+
+    public:
+
+        std::map<int, AABB> mLeafAABBs;
+
+        // Called to compute the new AABB of a leaf node
+        virtual AABB computeLeafAABB(int32 nodeId) {
+            return mLeafAABBs[nodeId];
+        }
+};
+
+class DynamicTreeDeserializeCallback : public DynamicAABBTreeDeserializeCallback {
+
+    public:
+
+        int32 mInvalidData;
+
+        // Called to check the data of a leaf node of a loaded tree
+        virtual bool isLeafDataValid(int32 data1, int32 data2) const {
+            return data2 != mInvalidData;
+        }
+};
+
 // Class TestDynamicAABBTree
 /**
  * Unit test for the dynamic AABB tree
@@ -88,8 +155,33 @@ class TestDynamicAABBTree : public Test {
 
         OverlapCallback mOverlapCallback;
         DynamicTreeRaycastCallback mRaycastCallback;
+        DynamicTreeNearestCallback mNearestCallback;
+        DynamicTreeCullingCallback mCullingCallback;
+
+        // ---------- Methods ---------- //
+
+        /// Return the offset (in bytes) of an integer field in a tree node
+        static size_t computeFieldOffset(const TreeNode& node, const int32* field) {
+            return reinterpret_cast<const unsigned char*>(field) - reinterpret_cast<const unsigned char*>(&node);
+        }
 
+        /// Return a copy of a serialized tree where an integer field of a node is replaced
+        /// The serialized header has eight 32-bits integers and is followed by the nodes.
+        std::vector<unsigned char> modifyNodeField(const std::vector<unsigned char>& buffer, int nodeID,
+                                                   size_t fieldOffset, int32 value) const {
+            std::vector<unsigned char> modifiedBuffer(buffer);
+            memcpy(&modifiedBuffer[8 * sizeof(int32) + nodeID * sizeof(TreeNode) + fieldOffset],
+                   &value, sizeof(int32));
+            return modifiedBuffer;
+        }
 
+        /// Return an integer field of a node of a serialized tree
+        int32 getNodeField(const std::vector<unsigned char>& buffer, int nodeID, size_t fieldOffset) const {
+            int32 value;
+            memcpy(&value, &buffer[8 * sizeof(int32) + nodeID * sizeof(TreeNode) + fieldOffset],
+                   sizeof(int32));
+            return value;
+        }
 
     public :
 
@@ -107,6 +199,10 @@ class TestDynamicAABBTree : public Test {
             testBasicsMethods();
             testOverlapping();
             testRaycast();
+            testNearestNodes();
+            testPlanesCulling();
+            testRefit();
+            testSerialization();
 
         }
 
@@ -516,6 +612,342 @@ class TestDynamicAABBTree : public Test {
             test(mRaycastCallback.isHit(object3Id));
             test(mRaycastCallback.isHit(object4Id));
         }
+
+        void testNearestNodes() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree
+            DynamicAABBTree tree;
+
+            int object1Data = 56;
+            int object2Data = 23;
+            int object3Data = 13;
+            int object4Data = 7;
+
+            // First object
+            AABB aabb1 = AABB(Vector3(-6, 4, -3), Vector3(4, 8, 3));
+            int object1Id = tree.addObject(aabb1, &object1Data);
+
+            // Second object
+            AABB aabb2 = AABB(Vector3(5, 2, -3), Vector3(10, 7, 3));
+            int object2Id = tree.addObject(aabb2, &object2Data);
+
+            // Third object
+            AABB aabb3 = AABB(Vector3(-5, 1, -3), Vector3(-2, 3, 3));
+            int object3Id = tree.addObject(aabb3, &object3Data);
+
+            // Fourth object
+            AABB aabb4 = AABB(Vector3(0, -4, -3), Vector3(3, -2, 3));
+            int object4Id = tree.addObject(aabb4, &object4Data);
+
+            // ---------- Tests ---------- //
+
+            const AABB origin(Vector3(0, 0, 0), Vector3(0, 0, 0));
+            int32 nearestNodes[10];
+            decimal distances[10];
+
+            // Two nearest nodes
+            uint nbNodes = tree.reportNearestNodes(origin, 2, DECIMAL_LARGEST, mNearestCallback,
+                                                   nearestNodes, distances);
+            test(nbNodes == 2);
+            test(nearestNodes[0] == object4Id);
+            test(nearestNodes[1] == object3Id);
+            test(approxEqual(distances[0], decimal(2.0)));
+            test(approxEqual(distances[1], std::sqrt(decimal(5.0))));
+
+            // Nearest nodes within a maximum distance
+            nbNodes = tree.reportNearestNodes(origin, 10, decimal(4.5), mNearestCallback,
+                                              nearestNodes, distances);
+            test(nbNodes == 3);
+            test(nearestNodes[0] == object4Id);
+            test(nearestNodes[1] == object3Id);
+            test(nearestNodes[2] == object1Id);
+            test(approxEqual(distances[2], decimal(4.0)));
+
+            nbNodes = tree.reportNearestNodes(origin, 10, decimal(1.0), mNearestCallback,
+                                              nearestNodes, distances);
+            test(nbNodes == 0);
+
+            // Node ignored by the callback
+            mNearestCallback.mIgnoredNodeId = object3Id;
+            nbNodes = tree.reportNearestNodes(origin, 10, DECIMAL_LARGEST, mNearestCallback,
+                                              nearestNodes, distances);
+            test(nbNodes == 3);
+            test(nearestNodes[0] == object4Id);
+            test(nearestNodes[1] == object1Id);
+            test(nearestNodes[2] == object2Id);
+            mNearestCallback.mIgnoredNodeId = -1;
+
+            // ---------- Compare with a brute force search ---------- //
+
+            DynamicAABBTree largeTree;
+            std::vector<AABB> aabbs;
+            std::vector<int> objectIds;
+            for (int i=0; i<200; i++) {
+                const Vector3 position((i * 37) % 100, (i * 53) % 100, (i * 71) % 100);
+                aabbs.push_back(AABB(position, position + Vector3(1, 2, 3)));
+                objectIds.push_back(largeTree.addObject(aabbs[i], &object1Data));
+            }
+
+            const AABB queryAABB(Vector3(48, 49, 50), Vector3(52, 51, 50));
+            std::vector<decimal> bruteForceDistances;
+            for (uint i=0; i<aabbs.size(); i++) {
+                bruteForceDistances.push_back(std::sqrt(queryAABB.computeSquaredDistance(aabbs[i])));
+            }
+            std::sort(bruteForceDistances.begin(), bruteForceDistances.end());
+
+            nbNodes = largeTree.reportNearestNodes(queryAABB, 10, DECIMAL_LARGEST, mNearestCallback,
+                                                   nearestNodes, distances);
+            test(nbNodes == 10);
+            for (uint i=0; i<nbNodes; i++) {
+                test(approxEqual(distances[i], bruteForceDistances[i], decimal(0.0001)));
+                test(approxEqual(std::sqrt(queryAABB.computeSquaredDistance(largeTree.getFatAABB(nearestNodes[i]))),
+                                 distances[i], decimal(0.0001)));
+            }
+        }
+
+        void testPlanesCulling() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree
+            DynamicAABBTree tree;
+
+            int object1Data = 56;
+            int object2Data = 23;
+            int object3Data = 13;
+            int object4Data = 7;
+
+            // First object
+            AABB aabb1 = AABB(Vector3(-6, 4, -3), Vector3(4, 8, 3));
+            int object1Id = tree.addObject(aabb1, &object1Data);
+
+            // Second object
+            AABB aabb2 = AABB(Vector3(5, 2, -3), Vector3(10, 7, 3));
+            int object2Id = tree.addObject(aabb2, &object2Data);
+
+            // Third object
+            AABB aabb3 = AABB(Vector3(-5, 1, -3), Vector3(-2, 3, 3));
+            int object3Id = tree.addObject(aabb3, &object3Data);
+
+            // Fourth object
+            AABB aabb4 = AABB(Vector3(0, -4, -3), Vector3(3, -2, 3));
+            int object4Id = tree.addObject(aabb4, &object4Data);
+
+            // ---------- Tests ---------- //
+
+            // Box volume that contains objects 1 and 3, intersects object 4 and excludes object 2
+            Plane planes[6];
+            planes[0] = Plane(Vector3(1, 0, 0), decimal(4.5));
+            planes[1] = Plane(Vector3(-1, 0, 0), decimal(10));
+            planes[2] = Plane(Vector3(0, 1, 0), decimal(20));
+            planes[3] = Plane(Vector3(0, -1, 0), Vector3(0, -3, 0));
+            planes[4] = Plane(Vector3(0, 0, 1), decimal(10));
+            planes[5] = Plane(Vector3(0, 0, -1), decimal(10));
+
+            mCullingCallback.reset();
+            tree.reportAllNodesInsidePlanes(planes, 6, mCullingCallback);
+            test(mCullingCallback.mReportedNodes.size() == 3);
+            test(mCullingCallback.isFullyInside(object1Id));
+            test(!mCullingCallback.isReported(object2Id));
+            test(mCullingCallback.isFullyInside(object3Id));
+            test(mCullingCallback.isReported(object4Id));
+            test(!mCullingCallback.isFullyInside(object4Id));
+
+            // Single plane
+            mCullingCallback.reset();
+            tree.reportAllNodesInsidePlanes(planes, 1, mCullingCallback);
+            test(mCullingCallback.mReportedNodes.size() == 3);
+            test(!mCullingCallback.isReported(object2Id));
+
+            // No plane (everything is inside)
+            mCullingCallback.reset();
+            tree.reportAllNodesInsidePlanes(planes, 0, mCullingCallback);
+            test(mCullingCallback.mReportedNodes.size() == 4);
+            test(mCullingCallback.isFullyInside(object1Id));
+            test(mCullingCallback.isFullyInside(object2Id));
+            test(mCullingCallback.isFullyInside(object3Id));
+            test(mCullingCallback.isFullyInside(object4Id));
+
+            // Volume that excludes every object
+            planes[0] = Plane(Vector3(1, 0, 0), decimal(-20));
+            mCullingCallback.reset();
+            tree.reportAllNodesInsidePlanes(planes, 6, mCullingCallback);
+            test(mCullingCallback.mReportedNodes.empty());
+        }
+
+        void testRefit() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree
+            DynamicAABBTree tree;
+
+            int object1Data = 56;
+            int object2Data = 23;
+            int object3Data = 13;
+            int object4Data = 7;
+
+            DynamicTreeRefitCallback refitCallback;
+
+            AABB aabb1 = AABB(Vector3(-6, 4, -3), Vector3(4, 8, 3));
+            int object1Id = tree.addObject(aabb1, &object1Data);
+            refitCallback.mLeafAABBs[object1Id] = aabb1;
+
+            AABB aabb2 = AABB(Vector3(5, 2, -3), Vector3(10, 7, 3));
+            int object2Id = tree.addObject(aabb2, &object2Data);
+            refitCallback.mLeafAABBs[object2Id] = aabb2;
+
+            AABB aabb3 = AABB(Vector3(-5, 1, -3), Vector3(-2, 3, 3));
+            int object3Id = tree.addObject(aabb3, &object3Data);
+            refitCallback.mLeafAABBs[object3Id] = aabb3;
+
+            AABB aabb4 = AABB(Vector3(0, -4, -3), Vector3(3, -2, 3));
+            int object4Id = tree.addObject(aabb4, &object4Data);
+            refitCallback.mLeafAABBs[object4Id] = aabb4;
+
+            // ---------- Tests ---------- //
+
+            // Refit with the same AABBs does not change the tree
+            const decimal initialCost = tree.computeSurfaceAreaCost();
+            test(initialCost > 0);
+            tree.refit(refitCallback);
+            test(approxEqual(tree.computeSurfaceAreaCost(), initialCost));
+            test(tree.getFatAABB(object3Id).getMin() == aabb3.getMin());
+            test(tree.getFatAABB(object3Id).getMax() == aabb3.getMax());
+
+            // Move the third and fourth objects far away
+            refitCallback.mLeafAABBs[object3Id] = AABB(Vector3(95, 1, -3), Vector3(98, 3, 3));
+            refitCallback.mLeafAABBs[object4Id] = AABB(Vector3(100, -4, -3), Vector3(103, -2, 3));
+            tree.refit(refitCallback);
+
+            test(tree.getFatAABB(object3Id).getMin() == Vector3(95, 1, -3));
+            test(tree.getRootAABB().getMax().x == decimal(103));
+            test(tree.getRootAABB().getMin().y == decimal(-4));
+            test(tree.computeSurfaceAreaCost() > initialCost);
+
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(90, -5, -5), Vector3(110, 5, 5)),
+                                                    mOverlapCallback);
+            test(mOverlapCallback.mOverlapNodes.size() == 2);
+            test(mOverlapCallback.isOverlapping(object3Id));
+            test(mOverlapCallback.isOverlapping(object4Id));
+
+            mOverlapCallback.reset();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -5, -5), Vector3(20, 10, 5)),
+                                                    mOverlapCallback);
+            test(mOverlapCallback.mOverlapNodes.size() == 2);
+            test(mOverlapCallback.isOverlapping(object1Id));
+            test(mOverlapCallback.isOverlapping(object2Id));
+        }
+
+        void testSerialization() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree (with integer data)
+            DynamicAABBTree tree;
+
+            AABB aabb1 = AABB(Vector3(-6, 4, -3), Vector3(4, 8, 3));
+            int object1Id = tree.addObject(aabb1, 0, 56);
+
+            AABB aabb2 = AABB(Vector3(5, 2, -3), Vector3(10, 7, 3));
+            int object2Id = tree.addObject(aabb2, 0, 23);
+
+            AABB aabb3 = AABB(Vector3(-5, 1, -3), Vector3(-2, 3, 3));
+            int object3Id = tree.addObject(aabb3, 1, 13);
+
+            AABB aabb4 = AABB(Vector3(0, -4, -3), Vector3(3, -2, 3));
+            int object4Id = tree.addObject(aabb4, 1, 7);
+
+            std::vector<unsigned char> buffer(tree.getSerializedSize());
+            tree.serialize(&buffer[0]);
+
+            // ---------- Tests ---------- //
+
+            // Load the tree into another tree
+            DynamicAABBTree loadedTree;
+            test(loadedTree.deserialize(&buffer[0], buffer.size()));
+            test(loadedTree.getNbNodes() == tree.getNbNodes());
+            test(loadedTree.getRootAABB().getMin() == tree.getRootAABB().getMin());
+            test(loadedTree.getRootAABB().getMax() == tree.getRootAABB().getMax());
+            test(approxEqual(loadedTree.computeSurfaceAreaCost(), tree.computeSurfaceAreaCost()));
+            test(loadedTree.getNodeDataInt(object3Id)[0] == 1);
+            test(loadedTree.getNodeDataInt(object3Id)[1] == 13);
+            test(loadedTree.getNodeDataInt(object2Id)[1] == 23);
+
+            mOverlapCallback.reset();
+            loadedTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -5, -5), Vector3(20, 10, 5)),
+                                                          mOverlapCallback);
+            test(mOverlapCallback.mOverlapNodes.size() == 4);
+            test(mOverlapCallback.isOverlapping(object1Id));
+            test(mOverlapCallback.isOverlapping(object4Id));
+
+            // The loaded tree can still be modified
+            int object5Id = loadedTree.addObject(AABB(Vector3(20, 0, 0), Vector3(21, 1, 1)), 2, 3);
+            test(loadedTree.getNodeDataInt(object5Id)[1] == 3);
+            test(loadedTree.getRootAABB().getMax().x == decimal(21));
+            loadedTree.removeObject(object1Id);
+            test(loadedTree.getNbNodes() == tree.getNbNodes());
+
+            // Data with a wrong size are rejected and the tree is unchanged
+            DynamicAABBTree otherTree;
+            test(!otherTree.deserialize(&buffer[0], buffer.size() - 1));
+            test(!otherTree.deserialize(&buffer[0], 4));
+            test(!otherTree.deserialize(NULL, 0));
+            test(otherTree.getNbNodes() == 0);
+
+            // Data with another version of the format are rejected
+            std::vector<unsigned char> wrongVersion(buffer);
+            wrongVersion[4] ^= 0xFF;
+            test(!otherTree.deserialize(&wrongVersion[0], wrongVersion.size()));
+
+            // Data written with another precision are rejected
+            std::vector<unsigned char> wrongPrecision(buffer);
+            wrongPrecision[8] ^= 0x0C;
+            test(!otherTree.deserialize(&wrongPrecision[0], wrongPrecision.size()));
+            test(otherTree.getNbNodes() == 0);
+
+            // Corrupted nodes are rejected
+            TreeNode node;
+            const size_t parentOffset = computeFieldOffset(node, &node.parentID);
+            const size_t leftChildOffset = computeFieldOffset(node, &node.children[0]);
+            const size_t rightChildOffset = computeFieldOffset(node, &node.children[1]);
+            const int32 parentID = getNodeField(buffer, object1Id, parentOffset);
+            const int32 siblingID = getNodeField(buffer, parentID, leftChildOffset) == object1Id ?
+                                    getNodeField(buffer, parentID, rightChildOffset) :
+                                    getNodeField(buffer, parentID, leftChildOffset);
+            const int32 freeNodeID = 7;
+            test(getNodeField(buffer, freeNodeID, parentOffset) == TreeNode::NULL_TREE_NODE);
+
+            // Child out of the node array
+            std::vector<unsigned char> corrupted = modifyNodeField(buffer, parentID, leftChildOffset, 1000);
+            test(!otherTree.deserialize(&corrupted[0], corrupted.size()));
+
+            // Child whose parent is another node
+            corrupted = modifyNodeField(buffer, object1Id, parentOffset, siblingID);
+            test(!otherTree.deserialize(&corrupted[0], corrupted.size()));
+
+            // Cycle in the tree (both children of a node are the same node)
+            corrupted = modifyNodeField(buffer, parentID, leftChildOffset, siblingID);
+            corrupted = modifyNodeField(corrupted, parentID, rightChildOffset, siblingID);
+            test(!otherTree.deserialize(&corrupted[0], corrupted.size()));
+
+            // Free list that goes back into the tree
+            corrupted = modifyNodeField(buffer, freeNodeID, parentOffset, object1Id);
+            test(!otherTree.deserialize(&corrupted[0], corrupted.size()));
+            test(otherTree.getNbNodes() == 0);
+
+            // Leaf data checked by the callback
+            DynamicTreeDeserializeCallback deserializeCallback;
+            deserializeCallback.mInvalidData = 13;
+            test(!otherTree.deserialize(&buffer[0], buffer.size(), &deserializeCallback));
+            test(otherTree.getNbNodes() == 0);
+            deserializeCallback.mInvalidData = 14;
+            test(otherTree.deserialize(&buffer[0], buffer.size(), &deserializeCallback));
+            test(otherTree.getNbNodes() == tree.getNbNodes());
+        }
  };
 
 }
@@ -0,0 +1,473 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_NARROW_PHASE_ALGORITHMS_H
+#define TEST_NARROW_PHASE_ALGORITHMS_H
+
+// Libraries
+#include "Test.h"
+#include "reactphysics3d.h"
+#include "collision/narrowphase/SphereVsSphereAlgorithm.h"
+#include "collision/narrowphase/SphereVsBoxAlgorithm.h"
+#include "collision/narrowphase/CapsuleVsCapsuleAlgorithm.h"
+#include "collision/narrowphase/GJK/GJKAlgorithm.h"
+#include "engine/OverlappingPair.h"
+#include <vector>
+#include <map>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ContactsRecorder
+/**
+ * Record the contacts reported by a narrow-phase algorithm, the collision
+ * queries of a world or the event listener of a dynamics world.
+ */
+class ContactsRecorder : public NarrowPhaseCallback, public CollisionCallback, public EventListener {
+
+    public:
+
+        std::vector<ContactPointInfo> contacts;
+
+        virtual void notifyContact(OverlappingPair* overlappingPair, const ContactPointInfo& contactInfo) {
+            contacts.push_back(contactInfo);
+        }
+
+        virtual void notifyContact(const ContactPointInfo& contactInfo) {
+            contacts.push_back(contactInfo);
+        }
+
+        virtual void newContact(const ContactPointInfo& contactInfo) {
+            contacts.push_back(contactInfo);
+        }
+};
+
+// Class TestNarrowPhaseAlgorithms
+/**
+ * Unit test for the analytic narrow-phase algorithms and the batched narrow-phase.
+ * The contacts of the analytic algorithms are compared with the ones of the GJK
+ * and EPA algorithms.
+ */
+class TestNarrowPhaseAlgorithms : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Memory allocator of the narrow-phase algorithms
+        MemoryAllocator mMemoryAllocator;
+
+        /// Algorithms to test
+        SphereVsSphereAlgorithm mSphereVsSphereAlgorithm;
+        SphereVsBoxAlgorithm mSphereVsBoxAlgorithm;
+        CapsuleVsCapsuleAlgorithm mCapsuleVsCapsuleAlgorithm;
+
+        /// Reference algorithm
+        GJKAlgorithm mGJKAlgorithm;
+
+        // ---------- Methods ---------- //
+
+        /// Compute the contacts between two proxy shapes with a narrow-phase algorithm
+        std::vector<ContactPointInfo> computeContacts(NarrowPhaseAlgorithm& algorithm,
+                                                      ProxyShape* shape1, ProxyShape* shape2) {
+
+            OverlappingPair pair(shape1, shape2, 1, mMemoryAllocator);
+            void* cachedCollisionData1 = NULL;
+            void* cachedCollisionData2 = NULL;
+            CollisionShapeInfo shape1Info(shape1, shape1->getCollisionShape(), shape1->getLocalToWorldTransform(),
+                                          &pair, &cachedCollisionData1);
+            CollisionShapeInfo shape2Info(shape2, shape2->getCollisionShape(), shape2->getLocalToWorldTransform(),
+                                          &pair, &cachedCollisionData2);
+
+            ContactsRecorder recorder;
+            algorithm.setCurrentOverlappingPair(&pair);
+            algorithm.testCollision(shape1Info, shape2Info, &recorder);
+
+            free(cachedCollisionData1);
+            free(cachedCollisionData2);
+
+            return recorder.contacts;
+        }
+
+        /// Test that two contacts have the same normal, penetration depth and local points
+        void testSameContact(const ContactPointInfo& contact, const ContactPointInfo& expectedContact,
+                             decimal tolerance) {
+            test(contact.shape1 == expectedContact.shape1);
+            test(contact.shape2 == expectedContact.shape2);
+            test((contact.normal - expectedContact.normal).length() < tolerance);
+            test(approxEqual(contact.penetrationDepth, expectedContact.penetrationDepth, tolerance));
+            test((contact.localPoint1 - expectedContact.localPoint1).length() < tolerance);
+            test((contact.localPoint2 - expectedContact.localPoint2).length() < tolerance);
+        }
+
+        /// Compare the contact of an algorithm with the one of the GJK and EPA algorithms
+        void testContactAgainstGJK(NarrowPhaseAlgorithm& algorithm, ProxyShape* shape1,
+                                   ProxyShape* shape2, decimal penetrationDepth) {
+
+            std::vector<ContactPointInfo> contacts = computeContacts(algorithm, shape1, shape2);
+            std::vector<ContactPointInfo> gjkContacts = computeContacts(mGJKAlgorithm, shape1, shape2);
+            test(contacts.size() == 1);
+            test(gjkContacts.size() == 1);
+            if (contacts.size() != 1 || gjkContacts.size() != 1) return;
+
+            test(approxEqual(contacts[0].penetrationDepth, penetrationDepth, decimal(0.0001)));
+            testSameContact(contacts[0], gjkContacts[0], decimal(0.01));
+        }
+
+        /// Compare the contacts of the batched version of an algorithm with the ones
+        /// computed pair by pair and return the number of contacts
+        uint testBatchAgainstPerPair(NarrowPhaseAlgorithm& algorithm,
+                                     const std::vector<std::pair<ProxyShape*, ProxyShape*> >& shapePairs) {
+
+            std::vector<OverlappingPair*> pairs;
+            for (uint i=0; i<shapePairs.size(); i++) {
+                pairs.push_back(new OverlappingPair(shapePairs[i].first, shapePairs[i].second, 1,
+                                                    mMemoryAllocator));
+            }
+
+            ContactsRecorder batchedRecorder;
+            algorithm.testCollisionBatch(&(pairs[0]), pairs.size(), &batchedRecorder);
+
+            uint nbContacts = 0;
+            for (uint i=0; i<shapePairs.size(); i++) {
+                std::vector<ContactPointInfo> contacts = computeContacts(algorithm, shapePairs[i].first,
+                                                                         shapePairs[i].second);
+                for (uint j=0; j<contacts.size() && nbContacts < batchedRecorder.contacts.size(); j++) {
+                    testSameContact(batchedRecorder.contacts[nbContacts], contacts[j], decimal(0.0001));
+                    nbContacts++;
+                }
+            }
+            test(batchedRecorder.contacts.size() == nbContacts);
+
+            for (uint i=0; i<pairs.size(); i++) {
+                delete pairs[i];
+            }
+
+            return nbContacts;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestNarrowPhaseAlgorithms(const std::string& name) : Test(name) {
+            mSphereVsSphereAlgorithm.init(NULL, &mMemoryAllocator);
+            mSphereVsBoxAlgorithm.init(NULL, &mMemoryAllocator);
+            mCapsuleVsCapsuleAlgorithm.init(NULL, &mMemoryAllocator);
+            mGJKAlgorithm.init(NULL, &mMemoryAllocator);
+        }
+
+        /// Run the tests
+        void run() {
+            testSphereVsSphereBatch();
+            testSphereVsBox();
+            testCapsuleVsCapsule();
+            testBatchedNarrowPhase();
+        }
+
+        void testSphereVsSphereBatch() {
+
+            SphereShape smallSphereShape(decimal(0.5));
+            SphereShape largeSphereShape(decimal(1.5));
+
+            // Chain of spheres where one pair out of three is separated. There are more
+            // pairs than in a pack of the batched algorithm.
+            CollisionWorld world;
+            const uint nbShapes = 8;
+            ProxyShape* proxyShapes[nbShapes];
+            Vector3 position(1, -2, 3);
+            for (uint i=0; i<nbShapes; i++) {
+                SphereShape* sphereShape = (i % 2 == 0) ? &smallSphereShape : &largeSphereShape;
+                const Quaternion orientation(decimal(0.1) * decimal(i), decimal(-0.3), decimal(0.2), 1);
+                CollisionBody* body = world.createCollisionBody(Transform(position, orientation.getUnit()));
+                proxyShapes[i] = body->addCollisionShape(sphereShape, Transform::identity());
+                const decimal distance = (i % 3 == 2) ? decimal(2.1) : decimal(1.8);
+                position += distance * Vector3(1, decimal(0.5), decimal(-0.2)).getUnit();
+            }
+
+            // Compare the batched contacts with the ones computed pair by pair
+            std::vector<std::pair<ProxyShape*, ProxyShape*> > shapePairs;
+            for (uint i=0; i<nbShapes-1; i++) {
+                shapePairs.push_back(std::make_pair(proxyShapes[i], proxyShapes[i+1]));
+            }
+            test(testBatchAgainstPerPair(mSphereVsSphereAlgorithm, shapePairs) == 5);
+
+            // Compare with the GJK algorithm
+            for (uint i=0; i<nbShapes-1; i++) {
+                if (i % 3 == 2) {
+                    test(computeContacts(mSphereVsSphereAlgorithm, proxyShapes[i], proxyShapes[i+1]).empty());
+                    continue;
+                }
+                testContactAgainstGJK(mSphereVsSphereAlgorithm, proxyShapes[i], proxyShapes[i+1], decimal(0.2));
+            }
+        }
+
+        void testSphereVsBox() {
+
+            SphereShape sphereShape(decimal(1.0));
+            BoxShape boxShape(Vector3(2, 1, decimal(1.5)));
+
+            CollisionWorld world;
+            const Quaternion boxOrientation(decimal(0.2), decimal(0.4), decimal(-0.1), 1);
+            const Transform boxTransform(Vector3(1, 2, 3), boxOrientation.getUnit());
+            CollisionBody* boxBody = world.createCollisionBody(boxTransform);
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(&boxShape, Transform::identity());
+            CollisionBody* sphereBody = world.createCollisionBody(Transform::identity());
+            ProxyShape* sphereProxyShape = sphereBody->addCollisionShape(&sphereShape, Transform::identity());
+            const Quaternion sphereOrientation(decimal(-0.3), decimal(0.1), decimal(0.5), 1);
+
+            // Sphere center outside the box in front of a face, of an edge and of a corner
+            const Vector3 directions[3] = {Vector3(0, 1, 0), Vector3(1, 1, 0).getUnit(),
+                                           Vector3(-1, 1, 1).getUnit()};
+            const Vector3 closestPoints[3] = {Vector3(decimal(0.5), 1, decimal(-0.5)), Vector3(2, 1, decimal(0.3)),
+                                              Vector3(-2, 1, decimal(1.5))};
+            for (int i=0; i<3; i++) {
+
+                // The edges and corners of the box are rounded by its margin
+                const decimal roundingDistance = (std::sqrt(decimal(i + 1)) - decimal(1.0)) * boxShape.getMargin();
+                const decimal penetrationDepth = decimal(0.2) - roundingDistance;
+
+                const Vector3 center = boxTransform * (closestPoints[i] + decimal(0.8) * directions[i]);
+                sphereBody->setTransform(Transform(center, sphereOrientation.getUnit()));
+
+                // Both orders of the shapes
+                testContactAgainstGJK(mSphereVsBoxAlgorithm, sphereProxyShape, boxProxyShape, penetrationDepth);
+                testContactAgainstGJK(mSphereVsBoxAlgorithm, boxProxyShape, sphereProxyShape, penetrationDepth);
+
+                // The normal goes from the first shape toward the second one
+                std::vector<ContactPointInfo> contacts = computeContacts(mSphereVsBoxAlgorithm, sphereProxyShape,
+                                                                         boxProxyShape);
+                test(contacts.size() == 1);
+                test((contacts[0].normal + boxOrientation.getUnit() * directions[i]).length() < decimal(0.0001));
+                test((contacts[0].localPoint2 - (closestPoints[i] - roundingDistance * directions[i])).length() <
+                     decimal(0.0001));
+            }
+
+            // Sphere center inside the box (closest to the face in the +z direction)
+            sphereBody->setTransform(Transform(boxTransform * Vector3(decimal(0.3), decimal(-0.2), decimal(1.2)),
+                                               sphereOrientation.getUnit()));
+            testContactAgainstGJK(mSphereVsBoxAlgorithm, sphereProxyShape, boxProxyShape, decimal(1.3));
+            testContactAgainstGJK(mSphereVsBoxAlgorithm, boxProxyShape, sphereProxyShape, decimal(1.3));
+            std::vector<ContactPointInfo> contacts = computeContacts(mSphereVsBoxAlgorithm, boxProxyShape,
+                                                                     sphereProxyShape);
+            test(contacts.size() == 1);
+            test((contacts[0].normal - boxOrientation.getUnit() * Vector3(0, 0, 1)).length() < decimal(0.0001));
+            test((contacts[0].localPoint1 - Vector3(decimal(0.3), decimal(-0.2), decimal(1.5))).length() <
+                 decimal(0.0001));
+
+            // Separated sphere
+            sphereBody->setTransform(Transform(boxTransform * Vector3(0, decimal(2.1), 0), Quaternion::identity()));
+            test(computeContacts(mSphereVsBoxAlgorithm, sphereProxyShape, boxProxyShape).empty());
+            test(computeContacts(mSphereVsBoxAlgorithm, boxProxyShape, sphereProxyShape).empty());
+
+            // Batch of pairs with spheres in front of a face, an edge and a corner of the
+            // box, inside the box and separated from the box
+            const Vector3 centers[6] = {Vector3(decimal(0.5), decimal(1.8), decimal(-0.5)),
+                                        Vector3(decimal(2.5), decimal(1.5), decimal(0.3)),
+                                        Vector3(decimal(-2.4), decimal(1.4), decimal(1.9)),
+                                        Vector3(decimal(0.3), decimal(-0.2), decimal(1.2)),
+                                        Vector3(0, decimal(2.1), 0),
+                                        Vector3(decimal(-2.7), 0, 0)};
+            std::vector<std::pair<ProxyShape*, ProxyShape*> > sphereBoxPairs;
+            std::vector<std::pair<ProxyShape*, ProxyShape*> > boxSpherePairs;
+            for (int i=0; i<6; i++) {
+                CollisionBody* body = world.createCollisionBody(Transform(boxTransform * centers[i],
+                                                                          sphereOrientation.getUnit()));
+                ProxyShape* proxyShape = body->addCollisionShape(&sphereShape, Transform::identity());
+                sphereBoxPairs.push_back(std::make_pair(proxyShape, boxProxyShape));
+                boxSpherePairs.push_back(std::make_pair(boxProxyShape, proxyShape));
+            }
+            test(testBatchAgainstPerPair(mSphereVsBoxAlgorithm, sphereBoxPairs) == 5);
+            test(testBatchAgainstPerPair(mSphereVsBoxAlgorithm, boxSpherePairs) == 5);
+        }
+
+        void testCapsuleVsCapsule() {
+
+            CapsuleShape capsuleShape1(decimal(0.5), decimal(4.0));
+            CapsuleShape capsuleShape2(decimal(0.7), decimal(2.0));
+
+            CollisionWorld world;
+            CollisionBody* body1 = world.createCollisionBody(Transform::identity());
+            ProxyShape* proxyShape1 = body1->addCollisionShape(&capsuleShape1, Transform::identity());
+            CollisionBody* body2 = world.createCollisionBody(Transform::identity());
+            ProxyShape* proxyShape2 = body2->addCollisionShape(&capsuleShape2, Transform::identity());
+
+            // Crossing segments (the second capsule is along the x axis in front of the first one)
+            const Quaternion alongX(0, 0, decimal(0.7071067811865476), decimal(0.7071067811865476));
+            body1->setTransform(Transform(Vector3(1, 2, 3), Quaternion::identity()));
+            body2->setTransform(Transform(Vector3(1, decimal(2.5), 4), alongX));
+            testContactAgainstGJK(mCapsuleVsCapsuleAlgorithm, proxyShape1, proxyShape2, decimal(0.2));
+            testContactAgainstGJK(mCapsuleVsCapsuleAlgorithm, proxyShape2, proxyShape1, decimal(0.2));
+            std::vector<ContactPointInfo> contacts = computeContacts(mCapsuleVsCapsuleAlgorithm, proxyShape1,
+                                                                     proxyShape2);
+            test(contacts.size() == 1);
+            test((contacts[0].normal - Vector3(0, 0, 1)).length() < decimal(0.0001));
+            test((contacts[0].localPoint1 - Vector3(0, decimal(0.5), decimal(0.5))).length() < decimal(0.0001));
+
+            // Crossing segments that intersect
+            body2->setTransform(Transform(Vector3(1, decimal(2.5), decimal(3.0)), alongX));
+            contacts = computeContacts(mCapsuleVsCapsuleAlgorithm, proxyShape1, proxyShape2);
+            test(contacts.size() == 1);
+            test(approxEqual(contacts[0].penetrationDepth, decimal(1.2), decimal(0.0001)));
+            test(approxEqual(std::abs(contacts[0].normal.z), decimal(1.0), decimal(0.0001)));
+
+            // Parallel segments side by side
+            body2->setTransform(Transform(Vector3(2, decimal(2.5), 3), Quaternion::identity()));
+            contacts = computeContacts(mCapsuleVsCapsuleAlgorithm, proxyShape1, proxyShape2);
+            std::vector<ContactPointInfo> gjkContacts = computeContacts(mGJKAlgorithm, proxyShape1, proxyShape2);
+            test(contacts.size() == 1);
+            test(gjkContacts.size() == 1);
+            test(approxEqual(contacts[0].penetrationDepth, decimal(0.2), decimal(0.0001)));
+            test(approxEqual(gjkContacts[0].penetrationDepth, decimal(0.2), decimal(0.01)));
+            test((contacts[0].normal - Vector3(1, 0, 0)).length() < decimal(0.0001));
+            test((gjkContacts[0].normal - Vector3(1, 0, 0)).length() < decimal(0.01));
+
+            // The two contact points are separated by the penetration depth along the normal
+            const Vector3 worldPoint1 = proxyShape1->getLocalToWorldTransform() * contacts[0].localPoint1;
+            const Vector3 worldPoint2 = proxyShape2->getLocalToWorldTransform() * contacts[0].localPoint2;
+            test((worldPoint1 - worldPoint2 - decimal(0.2) * contacts[0].normal).length() < decimal(0.0001));
+            test(approxEqual(worldPoint1.x, decimal(1.5), decimal(0.0001)));
+            test(worldPoint1.y > decimal(0.9) && worldPoint1.y < decimal(4.1));
+
+            // Parallel segments on the same line
+            body2->setTransform(Transform(Vector3(1, decimal(6.0), 3), Quaternion::identity()));
+            testContactAgainstGJK(mCapsuleVsCapsuleAlgorithm, proxyShape1, proxyShape2, decimal(0.2));
+
+            // Separated capsules
+            body2->setTransform(Transform(Vector3(decimal(2.3), decimal(2.5), 3), Quaternion::identity()));
+            test(computeContacts(mCapsuleVsCapsuleAlgorithm, proxyShape1, proxyShape2).empty());
+
+            // Batch of pairs with crossing, intersecting, parallel, skew and separated segments
+            const Transform transforms[7] = {
+                Transform(Vector3(1, decimal(2.5), 4), alongX),
+                Transform(Vector3(1, decimal(2.5), decimal(3.0)), alongX),
+                Transform(Vector3(2, decimal(2.5), 3), Quaternion::identity()),
+                Transform(Vector3(1, decimal(6.0), 3), Quaternion::identity()),
+                Transform(Vector3(decimal(2.5), decimal(4.5), 3), alongX),
+                Transform(Vector3(decimal(1.8), decimal(1.0), decimal(3.2)),
+                          Quaternion(decimal(-0.5), decimal(0.1), decimal(0.4), 1).getUnit()),
+                Transform(Vector3(decimal(2.3), decimal(2.5), 3), Quaternion::identity())};
+            std::vector<std::pair<ProxyShape*, ProxyShape*> > shapePairs;
+            uint nbExpectedContacts = 0;
+            for (int i=0; i<7; i++) {
+                CollisionBody* body = world.createCollisionBody(transforms[i]);
+                ProxyShape* proxyShape = body->addCollisionShape(&capsuleShape2, Transform::identity());
+                shapePairs.push_back(std::make_pair(proxyShape1, proxyShape));
+                nbExpectedContacts += computeContacts(mGJKAlgorithm, proxyShape1, proxyShape).size();
+            }
+            test(nbExpectedContacts == 6);
+            test(testBatchAgainstPerPair(mCapsuleVsCapsuleAlgorithm, shapePairs) == nbExpectedContacts);
+        }
+
+        void testBatchedNarrowPhase() {
+
+            SphereShape sphereShape(decimal(1.0));
+            BoxShape boxShape(Vector3(1, 1, 1));
+            CapsuleShape capsuleShape(decimal(0.5), decimal(2.0));
+            const Quaternion alongX(0, 0, decimal(0.7071067811865476), decimal(0.7071067811865476));
+
+            std::vector<CollisionShape*> shapes;
+            std::vector<Transform> transforms;
+
+            // Row of spheres (five sphere vs sphere contacts, more than a pack of the batched
+            // algorithm) and a sphere whose AABB overlaps the AABBs of the row without contact
+            for (int i=0; i<6; i++) {
+                shapes.push_back(&sphereShape);
+                transforms.push_back(Transform(Vector3(decimal(1.8) * decimal(i), 0, 0), Quaternion::identity()));
+            }
+            shapes.push_back(&sphereShape);
+            transforms.push_back(Transform(Vector3(decimal(1.5), decimal(1.5), decimal(1.5)), Quaternion::identity()));
+
+            // Sphere vs box
+            shapes.push_back(&boxShape);
+            transforms.push_back(Transform(Vector3(0, decimal(-1.8), 0), Quaternion::identity()));
+
+            // Capsule vs capsule
+            shapes.push_back(&capsuleShape);
+            transforms.push_back(Transform(Vector3(0, 0, 10), Quaternion::identity()));
+            shapes.push_back(&capsuleShape);
+            transforms.push_back(Transform(Vector3(0, decimal(0.5), decimal(10.8)), alongX));
+
+            // Box vs box and sphere vs capsule (GJK and EPA)
+            shapes.push_back(&boxShape);
+            transforms.push_back(Transform(Vector3(0, 0, -10), Quaternion::identity()));
+            shapes.push_back(&boxShape);
+            transforms.push_back(Transform(Vector3(decimal(0.5), decimal(1.9), -10), Quaternion::identity()));
+            shapes.push_back(&sphereShape);
+            transforms.push_back(Transform(Vector3(0, 0, 20), Quaternion::identity()));
+            shapes.push_back(&capsuleShape);
+            transforms.push_back(Transform(Vector3(decimal(1.3), 0, 20), Quaternion::identity()));
+
+            // Contacts computed pair by pair by the collision test of a collision world
+            CollisionWorld collisionWorld;
+            std::map<const ProxyShape*, uint> perPairIndices;
+            for (uint i=0; i<shapes.size(); i++) {
+                CollisionBody* body = collisionWorld.createCollisionBody(transforms[i]);
+                perPairIndices[body->addCollisionShape(shapes[i], Transform::identity())] = i;
+            }
+            ContactsRecorder perPairRecorder;
+            collisionWorld.testCollision(&perPairRecorder);
+            test(perPairRecorder.contacts.size() == 9);
+
+            // Contacts computed by the batched narrow-phase of a simulation step
+            DynamicsWorld dynamicsWorld(Vector3(0, 0, 0));
+            std::map<const ProxyShape*, uint> batchedIndices;
+            for (uint i=0; i<shapes.size(); i++) {
+                RigidBody* body = dynamicsWorld.createRigidBody(transforms[i]);
+                batchedIndices[body->addCollisionShape(shapes[i], Transform::identity(), 1)] = i;
+            }
+            ContactsRecorder batchedRecorder;
+            dynamicsWorld.setEventListener(&batchedRecorder);
+            dynamicsWorld.update(decimal(1.0) / decimal(60.0));
+            test(batchedRecorder.contacts.size() == perPairRecorder.contacts.size());
+
+            // Both paths give the same contacts
+            std::map<std::pair<uint, uint>, uint> perPairContacts;
+            for (uint i=0; i<perPairRecorder.contacts.size(); i++) {
+                const ContactPointInfo& contact = perPairRecorder.contacts[i];
+                perPairContacts[std::make_pair(perPairIndices[contact.shape1],
+                                               perPairIndices[contact.shape2])] = i;
+            }
+            test(perPairContacts.size() == perPairRecorder.contacts.size());
+            for (uint i=0; i<batchedRecorder.contacts.size(); i++) {
+                const ContactPointInfo& contact = batchedRecorder.contacts[i];
+                std::map<std::pair<uint, uint>, uint>::const_iterator it =
+                        perPairContacts.find(std::make_pair(batchedIndices[contact.shape1],
+                                                            batchedIndices[contact.shape2]));
+                test(it != perPairContacts.end());
+                if (it == perPairContacts.end()) continue;
+                const ContactPointInfo& expectedContact = perPairRecorder.contacts[it->second];
+                test((contact.normal - expectedContact.normal).length() < decimal(0.0001));
+                test(approxEqual(contact.penetrationDepth, expectedContact.penetrationDepth, decimal(0.0001)));
+                test((contact.localPoint1 - expectedContact.localPoint1).length() < decimal(0.0001));
+                test((contact.localPoint2 - expectedContact.localPoint2).length() < decimal(0.0001));
+            }
+        }
+ };
+
+}
+
+#endif
@@ -88,6 +88,66 @@ class WorldRaycastCallback : public RaycastCallback {
         }
 };
 
+/// Class ClosestHitRaycastCallback
+class ClosestHitRaycastCallback : public RaycastCallback {
+
+    public:
+
+        bool isHit;
+        decimal hitFraction;
+        Vector3 worldPoint;
+        ProxyShape* proxyShape;
+
+        ClosestHitRaycastCallback() {
+            reset();
+        }
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& info) {
+
+            if (!isHit || info.hitFraction < hitFraction) {
+                isHit = true;
+                hitFraction = info.hitFraction;
+                worldPoint = info.worldPoint;
+                proxyShape = info.proxyShape;
+            }
+
+            // Clip the ray to the current closest hit
+            return info.hitFraction;
+        }
+
+        void reset() {
+            isHit = false;
+            hitFraction = decimal(1.0);
+            worldPoint.setToZero();
+            proxyShape = NULL;
+        }
+};
+
+/// Class TrianglesCollectorCallback
+class TrianglesCollectorCallback : public TriangleCallback {
+
+    public:
+
+        std::vector<Vector3> trianglesPoints;
+
+        virtual void testTriangle(const Vector3* trianglePoints) {
+            trianglesPoints.push_back(trianglePoints[0]);
+            trianglesPoints.push_back(trianglePoints[1]);
+            trianglesPoints.push_back(trianglePoints[2]);
+        }
+
+        bool containsTriangle(const Vector3* trianglePoints) const {
+            for (uint i=0; i<trianglesPoints.size(); i += 3) {
+                if ((trianglesPoints[i] - trianglePoints[0]).lengthSquare() < decimal(0.00001) &&
+                    (trianglesPoints[i + 1] - trianglePoints[1]).lengthSquare() < decimal(0.00001) &&
+                    (trianglesPoints[i + 2] - trianglePoints[2]).lengthSquare() < decimal(0.00001)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
 // Class TestPointInside
 /**
  * Unit test for the CollisionBody::testPointInside() method.
@@ -351,6 +411,13 @@ class TestRaycast : public Test {
             testTriangle();
             testConcaveMesh();
             testHeightField();
+            testRaycastBatch();
+            testConvexMeshFacePlanes();
+            testMeshInstances();
+            testHeightFieldGridWalk();
+            testHeightFieldPyramidCulling();
+            testHeightFieldQuantizedHeights();
+            testConcaveMeshBVHLoading();
         }
 
         /// Test the ProxyBoxShape::raycast(), CollisionBody::raycast() and
@@ -2604,6 +2671,547 @@ class TestRaycast : public Test {
             mWorld->raycast(Ray(ray14.point1, ray14.point2, decimal(0.8)), &mCallback);
             test(mCallback.isHit);
         }
+
+        /// Test the CollisionWorld::raycastBatch() method against the closest hits
+        /// reported by the CollisionWorld::raycast() method
+        void testRaycastBatch() {
+
+            // More rays than RAYCAST_BATCH_BLOCK_SIZE to test several blocks of rays
+            const uint nbRays = 300;
+            std::vector<Ray> rays;
+            for (uint i=0; i<nbRays; i++) {
+
+                // Rays going through the bodies from points around them
+                const decimal angle = decimal(i) * PI_TIMES_2 / decimal(nbRays);
+                const Vector3 localPoint1(decimal(12.0) * std::cos(angle), decimal(i % 7) - decimal(3.0),
+                                          decimal(12.0) * std::sin(angle));
+                const Vector3 localPoint2(decimal(i % 5) - decimal(2.0), decimal(i % 3) - decimal(1.0),
+                                          decimal(0.5));
+                rays.push_back(Ray(mLocalShapeToWorld * localPoint1, mLocalShapeToWorld * localPoint2));
+            }
+
+            // Rays that do not hit anything or that are too short
+            rays.push_back(Ray(Vector3(100, 100, 100), Vector3(120, 100, 100)));
+            rays.push_back(Ray(mLocalShapeToWorld * Vector3(0, 20, 0), mLocalShapeToWorld * Vector3(0, 0, 0),
+                               decimal(0.1)));
+
+            std::vector<RaycastBatchHit> hits(rays.size());
+            mWorld->raycastBatch(&(rays[0]), rays.size(), &(hits[0]));
+
+            ClosestHitRaycastCallback callback;
+            for (uint i=0; i<rays.size(); i++) {
+
+                callback.reset();
+                mWorld->raycast(rays[i], &callback);
+
+                test(hits[i].hasHit == callback.isHit);
+                if (callback.isHit) {
+                    test(approxEqual(hits[i].hitFraction, callback.hitFraction, epsilon));
+                    test(hits[i].proxyShape != NULL);
+                    test(hits[i].proxyShape == callback.proxyShape);
+                    test(hits[i].body == hits[i].proxyShape->getBody());
+                    test(approxEqual(hits[i].worldPoint.x, callback.worldPoint.x, epsilon));
+                    test(approxEqual(hits[i].worldPoint.y, callback.worldPoint.y, epsilon));
+                    test(approxEqual(hits[i].worldPoint.z, callback.worldPoint.z, epsilon));
+                }
+            }
+            test(!hits[nbRays].hasHit);
+            test(!hits[nbRays + 1].hasHit);
+
+            // Test the parallel batch raycast in read-only query mode
+            std::vector<RaycastBatchHit> parallelHits(rays.size());
+            mWorld->beginReadOnlyQueries();
+            test(mWorld->isInReadOnlyQueryMode());
+            mWorld->raycastBatchParallel(&(rays[0]), rays.size(), &(parallelHits[0]), 3);
+            mWorld->endReadOnlyQueries();
+            test(!mWorld->isInReadOnlyQueryMode());
+            for (uint i=0; i<rays.size(); i++) {
+                test(parallelHits[i].hasHit == hits[i].hasHit);
+                test(parallelHits[i].proxyShape == hits[i].proxyShape);
+                test(approxEqual(parallelHits[i].hitFraction, hits[i].hitFraction, epsilon));
+            }
+
+            // Test the category mask
+            mWorld->raycastBatch(&(rays[0]), rays.size(), &(hits[0]), CATEGORY2);
+            for (uint i=0; i<rays.size(); i++) {
+
+                callback.reset();
+                mWorld->raycast(rays[i], &callback, CATEGORY2);
+
+                test(hits[i].hasHit == callback.isHit);
+                if (hits[i].hasHit) {
+                    test(hits[i].proxyShape->getCollisionCategoryBits() == CATEGORY2);
+                    test(approxEqual(hits[i].hitFraction, callback.hitFraction, epsilon));
+                }
+            }
+        }
+
+        /// Test the ConvexMeshShape::raycast() and ConvexMeshShape::testPointInside()
+        /// methods that use the face planes of the mesh against a box shape of the
+        /// same dimension
+        void testConvexMeshFacePlanes() {
+
+            // The convex meshes created with vertices only do not have face planes
+            test(!mConvexMeshShape->hasFacePlanes());
+            test(!mConvexMeshShapeEdgesInfo->hasFacePlanes());
+
+            // The convex meshes created with a closed triangle vertex array have face planes
+            ConvexMeshShape convexMeshShape(mConcaveMeshVertexArray, false, 0);
+            ConvexMeshShape convexMeshShapeEdgesInfo(mConcaveMeshVertexArray, true, 0);
+            test(convexMeshShape.hasFacePlanes());
+            test(convexMeshShape.getNbFacePlanes() == 6);
+            test(convexMeshShapeEdgesInfo.getNbFacePlanes() == 6);
+
+            // An open mesh (without the two last triangles) does not have face planes
+            TriangleVertexArray openVertexArray(8, &(mConcaveMeshVertices[0]), sizeof(Vector3),
+                                                10, &(mConcaveMeshIndices[0]), sizeof(uint),
+                                                mConcaveMeshVertexArray->getVertexDataType(),
+                                                TriangleVertexArray::INDEX_INTEGER_TYPE);
+            ConvexMeshShape openMeshShape(&openVertexArray, false, 0);
+            test(!openMeshShape.hasFacePlanes());
+
+            // Adding a vertex discards the face planes
+            ConvexMeshShape modifiedMeshShape(mConcaveMeshVertexArray, false, 0);
+            modifiedMeshShape.addVertex(Vector3(0, 5, 0));
+            test(!modifiedMeshShape.hasFacePlanes());
+
+            BoxShape boxShape(Vector3(2, 3, 4), 0);
+            CollisionWorld world;
+            CollisionBody* boxBody = world.createCollisionBody(mBodyTransform);
+            CollisionBody* meshBody = world.createCollisionBody(mBodyTransform);
+            ProxyShape* boxProxyShape = boxBody->addCollisionShape(&boxShape, mShapeTransform);
+            ProxyShape* meshProxyShape = meshBody->addCollisionShape(&convexMeshShape,
+                                                                     mShapeTransform);
+
+            // Rays from points around the shape towards points around its center
+            for (int scale=0; scale<2; scale++) {
+
+                if (scale == 1) {
+                    boxProxyShape->setLocalScaling(Vector3(2, decimal(0.5), 3));
+                    meshProxyShape->setLocalScaling(Vector3(2, decimal(0.5), 3));
+                }
+
+                for (int i=0; i<200; i++) {
+
+                    const decimal angle1 = decimal(i) * decimal(0.7);
+                    const decimal angle2 = decimal(i) * decimal(1.3);
+                    Vector3 localPoint1(15 * std::cos(angle1) * std::cos(angle2),
+                                        15 * std::sin(angle2),
+                                        15 * std::sin(angle1) * std::cos(angle2));
+                    Vector3 localPoint2(decimal((i % 7) - 3) + decimal(0.25),
+                                        decimal((i % 5) - 2) + decimal(0.25),
+                                        decimal((i % 9) - 4) + decimal(0.25));
+                    Ray ray(mLocalShapeToWorld * localPoint1, mLocalShapeToWorld * localPoint2,
+                            decimal(0.4) + decimal(i % 4) * decimal(0.3));
+
+                    RaycastInfo boxInfo;
+                    RaycastInfo meshInfo;
+                    bool isBoxHit = boxProxyShape->raycast(ray, boxInfo);
+                    bool isMeshHit = meshProxyShape->raycast(ray, meshInfo);
+                    test(isBoxHit == isMeshHit);
+                    if (isBoxHit && isMeshHit) {
+                        test(meshInfo.proxyShape == meshProxyShape);
+                        test(meshInfo.body == meshBody);
+                        test(approxEqual(meshInfo.hitFraction, boxInfo.hitFraction, epsilon));
+                        test((meshInfo.worldPoint - boxInfo.worldPoint).length() < decimal(0.001));
+                        test((meshInfo.worldNormal - boxInfo.worldNormal).length() < decimal(0.001));
+                    }
+
+                    // Point inside test at the end of the ray
+                    test(boxProxyShape->testPointInside(ray.point2) ==
+                         meshProxyShape->testPointInside(ray.point2));
+                }
+
+                // The origin of a ray inside the mesh does not report a hit
+                RaycastInfo raycastInfo;
+                test(!meshProxyShape->raycast(Ray(mLocalShapeToWorld * Vector3(0, 0, 0),
+                                                  mLocalShapeToWorld * Vector3(30, 0, 0)),
+                                              raycastInfo));
+            }
+        }
+
+        /// Test the HeightFieldShape::raycast() method that walks through the cells of the
+        /// grid against a brute-force raycast on all the triangles of the height field
+        /// Test that the instances of convex and concave mesh shapes with a scaling behave
+        /// like the meshes scaled with the setLocalScaling() method
+        void testMeshInstances() {
+
+            const Vector3 scaling(2, decimal(0.5), 3);
+
+            // Instances that share the mesh data of existing shapes
+            ConvexMeshShape convexMeshShape(mConcaveMeshVertexArray, true, 0);
+            ConvexMeshShape convexInstance(&convexMeshShape, scaling);
+            ConcaveMeshShape concaveMeshShape(&mConcaveTriangleMesh);
+            ConcaveMeshShape concaveInstance(&concaveMeshShape, scaling);
+            test(convexInstance.hasFacePlanes());
+            test(convexInstance.getNbFacePlanes() == 6);
+            test(convexInstance.isEdgesInformationUsed());
+
+            // Reference shapes with their own mesh data
+            ConvexMeshShape convexReference(mConcaveMeshVertexArray, true, 0);
+            ConcaveMeshShape concaveReference(&mConcaveTriangleMesh);
+
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(mBodyTransform);
+            ProxyShape* convexInstanceProxyShape = body->addCollisionShape(&convexInstance,
+                                                                           mShapeTransform);
+            ProxyShape* concaveInstanceProxyShape = body->addCollisionShape(&concaveInstance,
+                                                                            mShapeTransform);
+            ProxyShape* convexReferenceProxyShape = body->addCollisionShape(&convexReference,
+                                                                            mShapeTransform);
+            ProxyShape* concaveReferenceProxyShape = body->addCollisionShape(&concaveReference,
+                                                                             mShapeTransform);
+            convexReferenceProxyShape->setLocalScaling(scaling);
+            concaveReferenceProxyShape->setLocalScaling(scaling);
+
+            // The shapes whose data are shared are not scaled
+            Vector3 min, max;
+            convexMeshShape.getLocalBounds(min, max);
+            test(approxEqual(max.x, decimal(2.0)) && approxEqual(max.z, decimal(4.0)));
+            concaveMeshShape.getLocalBounds(min, max);
+            test(approxEqual(max.x, decimal(2.0)) && approxEqual(max.z, decimal(4.0)));
+
+            // The instances have the bounds of the scaled meshes
+            Vector3 referenceMin, referenceMax;
+            convexInstance.getLocalBounds(min, max);
+            convexReference.getLocalBounds(referenceMin, referenceMax);
+            test(min == referenceMin && max == referenceMax);
+            test(approxEqual(max.x, decimal(4.0)) && approxEqual(max.y, decimal(1.5)) &&
+                 approxEqual(max.z, decimal(12.0)));
+            concaveInstance.getLocalBounds(min, max);
+            concaveReference.getLocalBounds(referenceMin, referenceMax);
+            test(min == referenceMin && max == referenceMax);
+
+            // The concave instance reports the same triangles
+            TrianglesCollectorCallback instanceTriangles;
+            TrianglesCollectorCallback referenceTriangles;
+            const AABB aabb(Vector3(3, -1, -1), Vector3(5, 1, 1));
+            concaveInstance.testAllTriangles(instanceTriangles, aabb);
+            concaveReference.testAllTriangles(referenceTriangles, aabb);
+            test(instanceTriangles.trianglesPoints.size() == 2 * 3);
+            test(instanceTriangles.trianglesPoints.size() == referenceTriangles.trianglesPoints.size());
+            for (uint i=0; i<instanceTriangles.trianglesPoints.size(); i += 3) {
+                test(referenceTriangles.containsTriangle(&(instanceTriangles.trianglesPoints[i])));
+            }
+
+            // Rays from points around the shapes towards points around their center
+            for (int i=0; i<100; i++) {
+
+                const decimal angle1 = decimal(i) * decimal(0.7);
+                const decimal angle2 = decimal(i) * decimal(1.3);
+                Vector3 localPoint1(20 * std::cos(angle1) * std::cos(angle2),
+                                    20 * std::sin(angle2),
+                                    20 * std::sin(angle1) * std::cos(angle2));
+                Vector3 localPoint2(decimal((i % 7) - 3) + decimal(0.25),
+                                    decimal((i % 5) - 2) * decimal(0.5) + decimal(0.25),
+                                    decimal((i % 9) - 4) + decimal(0.25));
+                Ray ray(mLocalShapeToWorld * localPoint1, mLocalShapeToWorld * localPoint2);
+
+                RaycastInfo instanceInfo;
+                RaycastInfo referenceInfo;
+                bool isInstanceHit = convexInstanceProxyShape->raycast(ray, instanceInfo);
+                bool isReferenceHit = convexReferenceProxyShape->raycast(ray, referenceInfo);
+                test(isInstanceHit && isReferenceHit);
+                test(approxEqual(instanceInfo.hitFraction, referenceInfo.hitFraction, epsilon));
+
+                isInstanceHit = concaveInstanceProxyShape->raycast(ray, instanceInfo);
+                isReferenceHit = concaveReferenceProxyShape->raycast(ray, referenceInfo);
+                test(isInstanceHit == isReferenceHit);
+                if (isInstanceHit && isReferenceHit) {
+                    test(approxEqual(instanceInfo.hitFraction, referenceInfo.hitFraction, epsilon));
+                    test(instanceInfo.triangleIndex == referenceInfo.triangleIndex);
+                }
+
+                // Point inside test with the convex instance
+                const Vector3 worldPoint = mLocalShapeToWorld * (decimal(0.3) * localPoint1);
+                test(convexInstanceProxyShape->testPointInside(worldPoint) ==
+                     convexReferenceProxyShape->testPointInside(worldPoint));
+            }
+        }
+
+        void testHeightFieldGridWalk() {
+
+            // Bumpy height field
+            float heightData[20 * 15];
+            for (int j=0; j<15; j++) {
+                for (int i=0; i<20; i++) {
+                    heightData[j * 20 + i] = float(3 * std::sin(i * 0.7) * std::cos(j * 0.4) + 2);
+                }
+            }
+
+            for (int upAxis=0; upAxis<3; upAxis++) {
+
+                HeightFieldShape heightFieldShape(20, 15, -1, 5, heightData,
+                                                  HeightFieldShape::HEIGHT_FLOAT_TYPE, upAxis);
+                CollisionWorld world;
+                CollisionBody* body = world.createCollisionBody(Transform::identity());
+                ProxyShape* proxyShape = body->addCollisionShape(&heightFieldShape,
+                                                                 Transform::identity());
+
+                for (int scale=0; scale<2; scale++) {
+
+                    if (scale == 1) proxyShape->setLocalScaling(Vector3(2, decimal(0.5), 3));
+
+                    Vector3 min, max;
+                    heightFieldShape.getLocalBounds(min, max);
+                    const AABB allTrianglesAABB(min * decimal(2), max * decimal(2));
+
+                    int nbHits = 0;
+                    for (int r=0; r<300; r++) {
+
+                        // Rays between two points in a box around the height field
+                        Vector3 localPoint1(decimal(std::sin(r * 1.1)), decimal(std::cos(r * 0.3)),
+                                            decimal(std::sin(r * 2.3)));
+                        Vector3 localPoint2(decimal(std::cos(r * 0.9)), decimal(std::sin(r * 1.7)),
+                                            decimal(std::cos(r * 0.5)));
+                        localPoint1 = decimal(0.8) * (localPoint1 * max);
+                        localPoint2 = decimal(0.8) * (localPoint2 * max);
+                        localPoint1[upAxis] = decimal(1.5) * max[upAxis];
+                        Ray ray(localPoint1, localPoint2, decimal(0.5) + decimal(r % 3) * decimal(0.5));
+
+                        RaycastInfo raycastInfo;
+                        bool isHit = proxyShape->raycast(ray, raycastInfo);
+
+                        RaycastInfo bruteForceInfo;
+                        TriangleOverlapCallback callback(ray, proxyShape, bruteForceInfo,
+                                                         heightFieldShape);
+                        heightFieldShape.testAllTriangles(callback, allTrianglesAABB);
+
+                        test(isHit == callback.getIsHit());
+                        if (isHit && callback.getIsHit()) {
+                            nbHits++;
+                            test(raycastInfo.proxyShape == proxyShape);
+                            test(approxEqual(raycastInfo.hitFraction, bruteForceInfo.hitFraction,
+                                             epsilon));
+                            test((raycastInfo.worldPoint - bruteForceInfo.worldPoint).length() <
+                                 decimal(0.001));
+                        }
+                    }
+
+                    // Make sure that we have tested both hits and misses
+                    test(nbHits > 10 && nbHits < 290);
+                }
+            }
+        }
+
+        /// Test that the HeightFieldShape::testAllTriangles() method rejects the triangles that
+        /// are above or below the query AABB without missing any overlapping triangle
+        void testHeightFieldPyramidCulling() {
+
+            // Bumpy height field
+            float heightData[37 * 23];
+            for (int j=0; j<23; j++) {
+                for (int i=0; i<37; i++) {
+                    heightData[j * 37 + i] = float(4 * std::sin(i * 0.3) * std::sin(j * 0.5));
+                }
+            }
+            HeightFieldShape heightFieldShape(37, 23, -4, 4, heightData,
+                                              HeightFieldShape::HEIGHT_FLOAT_TYPE);
+
+            // Collect all the triangles of the height field
+            TrianglesCollectorCallback allTriangles;
+            heightFieldShape.testAllTriangles(allTriangles, AABB(Vector3(-100, -100, -100),
+                                                                 Vector3(100, 100, 100)));
+            test(allTriangles.trianglesPoints.size() == 36 * 22 * 2 * 3);
+
+            // An AABB above the height field does not report any triangle
+            TrianglesCollectorCallback aboveTriangles;
+            heightFieldShape.testAllTriangles(aboveTriangles, AABB(Vector3(-100, decimal(4.5), -100),
+                                                                   Vector3(100, 10, 100)));
+            test(aboveTriangles.trianglesPoints.empty());
+
+            for (int k=0; k<50; k++) {
+
+                // Small AABB at different positions and heights
+                const Vector3 center(decimal(17 * std::sin(k * 1.3)), decimal(4 * std::cos(k * 0.7)),
+                                     decimal(10 * std::sin(k * 0.4)));
+                const Vector3 halfExtent(decimal(1 + k % 4), decimal(0.5), decimal(1 + k % 3));
+                const AABB aabb(center - halfExtent, center + halfExtent);
+
+                TrianglesCollectorCallback culledTriangles;
+                heightFieldShape.testAllTriangles(culledTriangles, aabb);
+
+                // Each reported cell (two consecutive triangles) must overlap the AABB
+                // along the up axis
+                test(culledTriangles.trianglesPoints.size() % 6 == 0);
+                for (uint i=0; i<culledTriangles.trianglesPoints.size(); i += 6) {
+                    AABB cellAABB;
+                    cellAABB.mergeTwoAABBs(
+                            AABB::createAABBForTriangle(&(culledTriangles.trianglesPoints[i])),
+                            AABB::createAABBForTriangle(&(culledTriangles.trianglesPoints[i + 3])));
+                    test(cellAABB.getMin().y <= aabb.getMax().y + epsilon);
+                    test(cellAABB.getMax().y >= aabb.getMin().y - epsilon);
+                }
+
+                // Each triangle overlapping the AABB must be reported
+                for (uint i=0; i<allTriangles.trianglesPoints.size(); i += 3) {
+                    const Vector3* trianglePoints = &(allTriangles.trianglesPoints[i]);
+                    if (AABB::createAABBForTriangle(trianglePoints).testCollision(aabb)) {
+                        test(culledTriangles.containsTriangle(trianglePoints));
+                    }
+                }
+            }
+        }
+
+        /// Test that the height fields with 8 and 16 bits quantized height values have the
+        /// same triangles and raycast results as a height field with the dequantized values
+        void testHeightFieldQuantizedHeights() {
+
+            // Quantized height values and the corresponding float height values
+            const decimal scale16 = decimal(0.01);
+            const decimal offset16 = decimal(-3.0);
+            const decimal scale8 = decimal(0.04);
+            const decimal offset8 = decimal(-2.0);
+            uint16 heightData16[17 * 13];
+            uint8 heightData8[17 * 13];
+            float floatHeightData16[17 * 13];
+            float floatHeightData8[17 * 13];
+            for (int j=0; j<13; j++) {
+                for (int i=0; i<17; i++) {
+                    const int index = j * 17 + i;
+                    heightData16[index] = uint16(500 + 500 * std::sin(i * 0.6) * std::cos(j * 0.3));
+                    heightData8[index] = uint8(127 + 127 * std::cos(i * 0.4) * std::sin(j * 0.7));
+                    floatHeightData16[index] = float(decimal(heightData16[index]) * scale16 + offset16);
+                    floatHeightData8[index] = float(decimal(heightData8[index]) * scale8 + offset8);
+                }
+            }
+
+            HeightFieldShape heightField16(17, 13, -3, 7, heightData16,
+                                           HeightFieldShape::HEIGHT_UINT16_TYPE, 1, scale16, offset16);
+            HeightFieldShape floatHeightField16(17, 13, -3, 7, floatHeightData16,
+                                                HeightFieldShape::HEIGHT_FLOAT_TYPE);
+            HeightFieldShape heightField8(17, 13, -2, decimal(8.2), heightData8,
+                                          HeightFieldShape::HEIGHT_UINT8_TYPE, 1, scale8, offset8);
+            HeightFieldShape floatHeightField8(17, 13, -2, decimal(8.2), floatHeightData8,
+                                               HeightFieldShape::HEIGHT_FLOAT_TYPE);
+
+            HeightFieldShape* quantizedShapes[2] = {&heightField16, &heightField8};
+            HeightFieldShape* floatShapes[2] = {&floatHeightField16, &floatHeightField8};
+
+            for (int s=0; s<2; s++) {
+
+                CollisionWorld world;
+                CollisionBody* body = world.createCollisionBody(Transform::identity());
+                ProxyShape* quantizedProxyShape = body->addCollisionShape(quantizedShapes[s],
+                                                                          Transform::identity());
+                ProxyShape* floatProxyShape = body->addCollisionShape(floatShapes[s],
+                                                                      Transform::identity());
+
+                // The two height fields have the same triangles
+                const AABB allTrianglesAABB(Vector3(-100, -100, -100), Vector3(100, 100, 100));
+                TrianglesCollectorCallback quantizedTriangles;
+                TrianglesCollectorCallback floatTriangles;
+                quantizedShapes[s]->testAllTriangles(quantizedTriangles, allTrianglesAABB);
+                floatShapes[s]->testAllTriangles(floatTriangles, allTrianglesAABB);
+                test(quantizedTriangles.trianglesPoints.size() == 16 * 12 * 2 * 3);
+                test(quantizedTriangles.trianglesPoints.size() == floatTriangles.trianglesPoints.size());
+                for (uint i=0; i<quantizedTriangles.trianglesPoints.size(); i += 3) {
+                    test(floatTriangles.containsTriangle(&(quantizedTriangles.trianglesPoints[i])));
+                }
+
+                // The two height fields have the same raycast results
+                int nbHits = 0;
+                for (int r=0; r<100; r++) {
+
+                    const Vector3 point1(decimal(8 * std::sin(r * 1.1)), 12, decimal(6 * std::cos(r * 0.7)));
+                    const Vector3 point2(decimal(8 * std::cos(r * 0.9)), -6, decimal(6 * std::sin(r * 1.3)));
+                    const Ray ray(point1, point2);
+
+                    RaycastInfo quantizedInfo;
+                    RaycastInfo floatInfo;
+                    const bool isQuantizedHit = quantizedProxyShape->raycast(ray, quantizedInfo);
+                    const bool isFloatHit = floatProxyShape->raycast(ray, floatInfo);
+                    test(isQuantizedHit == isFloatHit);
+                    if (isQuantizedHit && isFloatHit) {
+                        nbHits++;
+                        test(approxEqual(quantizedInfo.hitFraction, floatInfo.hitFraction, epsilon));
+                    }
+                }
+                test(nbHits > 50);
+            }
+        }
+
+        void testConcaveMeshBVHLoading() {
+
+            // Save the tree of a concave mesh shape
+            ConcaveMeshShape referenceShape(&mConcaveTriangleMesh);
+            std::vector<unsigned char> bvhData(referenceShape.getBVHDataSize());
+            referenceShape.saveBVH(&bvhData[0]);
+
+            // Shape whose tree is loaded from the saved data
+            ConcaveMeshShape loadedShape(&mConcaveTriangleMesh, &bvhData[0], bvhData.size());
+
+            // Shapes whose tree cannot be loaded (truncated data and tree of another mesh)
+            ConcaveMeshShape truncatedShape(&mConcaveTriangleMesh, &bvhData[0], bvhData.size() / 2);
+            DynamicAABBTree otherTree;
+            otherTree.addObject(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), 0, 0);
+            std::vector<unsigned char> otherData(otherTree.getSerializedSize());
+            otherTree.serialize(&otherData[0]);
+            ConcaveMeshShape otherMeshShape(&mConcaveTriangleMesh, &otherData[0], otherData.size());
+
+            // Shape whose saved tree has one leaf per triangle but refers to triangles that
+            // are not in the mesh
+            uint nbTriangles = 0;
+            for (uint i=0; i<mConcaveTriangleMesh.getNbSubparts(); i++) {
+                nbTriangles += mConcaveTriangleMesh.getSubpart(i)->getNbTriangles();
+            }
+            DynamicAABBTree invalidTree;
+            for (uint i=0; i<nbTriangles; i++) {
+                invalidTree.addObject(AABB(Vector3(decimal(i), 0, 0), Vector3(decimal(i + 1), 1, 1)),
+                                      0, nbTriangles + i);
+            }
+            std::vector<unsigned char> invalidData(invalidTree.getSerializedSize());
+            invalidTree.serialize(&invalidData[0]);
+            ConcaveMeshShape invalidMeshShape(&mConcaveTriangleMesh, &invalidData[0], invalidData.size());
+
+            Vector3 referenceMin, referenceMax, min, max;
+            referenceShape.getLocalBounds(referenceMin, referenceMax);
+            loadedShape.getLocalBounds(min, max);
+            test(min == referenceMin && max == referenceMax);
+            truncatedShape.getLocalBounds(min, max);
+            test(min == referenceMin && max == referenceMax);
+            otherMeshShape.getLocalBounds(min, max);
+            test(min == referenceMin && max == referenceMax);
+            invalidMeshShape.getLocalBounds(min, max);
+            test(min == referenceMin && max == referenceMax);
+
+            CollisionWorld world;
+            CollisionBody* body = world.createCollisionBody(mBodyTransform);
+            ProxyShape* referenceProxyShape = body->addCollisionShape(&referenceShape, mShapeTransform);
+            ProxyShape* loadedProxyShape = body->addCollisionShape(&loadedShape, mShapeTransform);
+            ProxyShape* otherMeshProxyShape = body->addCollisionShape(&otherMeshShape,
+                                                                      mShapeTransform);
+
+            // Rays from points around the shapes towards points around their center
+            int nbHits = 0;
+            for (int i=0; i<100; i++) {
+
+                const decimal angle1 = decimal(i) * decimal(0.7);
+                const decimal angle2 = decimal(i) * decimal(1.3);
+                Vector3 localPoint1(20 * std::cos(angle1) * std::cos(angle2),
+                                    20 * std::sin(angle2),
+                                    20 * std::sin(angle1) * std::cos(angle2));
+                Vector3 localPoint2(decimal((i % 7) - 3) * decimal(0.5) + decimal(0.25),
+                                    decimal((i % 5) - 2) * decimal(0.5) + decimal(0.25),
+                                    decimal((i % 9) - 4) * decimal(0.5) + decimal(0.25));
+                Ray ray(mLocalShapeToWorld * localPoint1, mLocalShapeToWorld * localPoint2);
+
+                RaycastInfo referenceInfo;
+                RaycastInfo loadedInfo;
+                RaycastInfo otherMeshInfo;
+                const bool isReferenceHit = referenceProxyShape->raycast(ray, referenceInfo);
+                const bool isLoadedHit = loadedProxyShape->raycast(ray, loadedInfo);
+                const bool isOtherMeshHit = otherMeshProxyShape->raycast(ray, otherMeshInfo);
+                test(isReferenceHit == isLoadedHit);
+                test(isReferenceHit == isOtherMeshHit);
+                if (isReferenceHit && isLoadedHit) {
+                    nbHits++;
+                    test(approxEqual(loadedInfo.hitFraction, referenceInfo.hitFraction, epsilon));
+                    test(loadedInfo.triangleIndex == referenceInfo.triangleIndex);
+                }
+            }
+            test(nbHits > 0);
+        }
 };
 
 }
@@ -124,6 +124,40 @@ class TestMathematicsFunctions : public Test {
 
             computeBarycentricCoordinatesInTriangle(a, b, c, testPoint, u, v, w);
             test(approxEqual(u + v + w, 1.0, 0.000001));
+
+            // Test computeClosestPointOnTriangle()
+            Vector3 closestPoint = computeClosestPointOnTriangle(a, b, c, Vector3(1, 3, 1));
+            test(approxEqual(closestPoint.x, 1.0, 0.000001));
+            test(approxEqual(closestPoint.y, 0.0, 0.000001));
+            test(approxEqual(closestPoint.z, 1.0, 0.000001));
+            closestPoint = computeClosestPointOnTriangle(a, b, c, Vector3(-2, 1, -3));
+            test(approxEqual(closestPoint.x, 0.0, 0.000001));
+            test(approxEqual(closestPoint.y, 0.0, 0.000001));
+            test(approxEqual(closestPoint.z, 0.0, 0.000001));
+            closestPoint = computeClosestPointOnTriangle(a, b, c, Vector3(2, -1, -4));
+            test(approxEqual(closestPoint.x, 2.0, 0.000001));
+            test(approxEqual(closestPoint.y, 0.0, 0.000001));
+            test(approxEqual(closestPoint.z, 0.0, 0.000001));
+            closestPoint = computeClosestPointOnTriangle(a, b, c, Vector3(4, 0, 4));
+            test(approxEqual(closestPoint.x, 2.5, 0.000001));
+            test(approxEqual(closestPoint.y, 0.0, 0.000001));
+            test(approxEqual(closestPoint.z, 2.5, 0.000001));
+
+            // Test computeClosestPointsBetweenSegments()
+            Vector3 closestPoint1, closestPoint2;
+            decimal distanceSquare = computeClosestPointsBetweenSegments(Vector3(-1, 0, 0), Vector3(1, 0, 0),
+                                                                         Vector3(0, 2, -1), Vector3(0, 2, 1),
+                                                                         closestPoint1, closestPoint2);
+            test(approxEqual(distanceSquare, 4.0, 0.000001));
+            test(approxEqual(closestPoint1.x, 0.0, 0.000001));
+            test(approxEqual(closestPoint2.y, 2.0, 0.000001));
+            test(approxEqual(closestPoint2.z, 0.0, 0.000001));
+            distanceSquare = computeClosestPointsBetweenSegments(Vector3(0, 0, 0), Vector3(1, 0, 0),
+                                                                 Vector3(3, 0, 0), Vector3(5, 0, 0),
+                                                                 closestPoint1, closestPoint2);
+            test(approxEqual(distanceSquare, 4.0, 0.000001));
+            test(approxEqual(closestPoint1.x, 1.0, 0.000001));
+            test(approxEqual(closestPoint2.x, 3.0, 0.000001));
         }
 
  };